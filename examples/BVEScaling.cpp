@@ -0,0 +1,359 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmBVESphere.hpp"
+#include "LpmVorticityGallery.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmBVERK4_Impl.hpp"
+#include "LpmRingSum.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Lpm;
+
+/**
+  Scaling-study driver for BVESphere.  Runs nsteps of BVERK4 on one configuration (MPI ranks x threads per
+  rank), prints per-phase timings, and appends a row to a csv file with the parallel efficiency relative to
+  the smallest configuration already recorded for the same study.
+
+  Phases: refinement (mesh allocation and tree refinement), init (initial vorticity and velocity),
+  velocity (direct sums during time steps), update (the rest of each RK4 step), and output (vtk files,
+  written by rank 0).  Each phase time is the maximum over ranks.
+
+  With more than one rank, every rank holds the whole mesh and BVERK4 distributes its velocity sums with
+  RingDirectSum.  The thread count is the execution space's concurrency (e.g., set by OMP_NUM_THREADS).
+
+  Efficiency is work-normalized, so it applies to both strong scaling (fixed depth) and weak scaling (depth
+  increasing with the number of processing elements):
+    E = (W / W_ref) * (P_ref * T_ref) / (P * T),
+  where T is time stepping time (velocity + update), P = ranks x threads, and W is the number of direct sum
+  pairs per step.  Run configurations from smallest to largest; scripts/bveScalingStudy.sh runs a sweep.
+
+  usage: [OMP_NUM_THREADS=<t>] mpirun -np <r> bveScaling [options]
+    -s <seed>       cubed or icos (default cubed)
+    -d <depth>      mesh tree depth (default 4)
+    -n <steps>      number of time steps (default 10)
+    -dt <dt>        time step (default 0.01)
+    -ic <name>      initial vorticity from LpmVorticityGallery.hpp: rotation or ns (default rotation);
+                    timings do not depend on the vorticity
+    -f <interval>   vtk output interval in time steps; 0 for no output (default 0)
+    -o <root>       vtk output file root (default bve_scaling_)
+    -study <name>   strong or weak (default strong); strong-scaling rows are compared only at equal depth
+    -csv <file>     results file (default bve_scaling.csv)
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  std::string seed;
+  Int depth;
+  Int nsteps;
+  Real dt;
+  std::string ic;
+  Int output_interval;
+  std::string vtk_froot;
+  std::string study;
+  std::string csv_fname;
+
+  VorticityInitialCondition::ptr initialVorticity() const;
+};
+
+/// one row of the results file
+struct ScalingResult {
+  std::string study;
+  std::string seed;
+  std::string ic;
+  Int depth;
+  Index nverts;
+  Index nfaces;
+  Real pairs_per_step;
+  Int nranks;
+  Int nthreads;
+  std::string execution_space;
+  Int nsteps;
+  Real refinement;
+  Real init;
+  Real velocity;
+  Real update;
+  Real output;
+  Real efficiency;
+
+  ScalingResult() : depth(0), nverts(0), nfaces(0), pairs_per_step(0), nranks(1), nthreads(1), nsteps(0),
+    refinement(0), init(0), velocity(0), update(0), output(0), efficiency(1) {}
+
+  inline Int nprocs() const {return nranks*nthreads;}
+  inline Real stepTime() const {return velocity + update;}
+  inline Real total() const {return refinement + init + velocity + update + output;}
+
+  static std::string csvHeader();
+  std::string csvRow() const;
+  /// returns false if the line is not a result row
+  bool fromCsv(const std::string& line);
+
+  /// true if r belongs to the same study (and, for strong scaling, the same problem)
+  bool comparable(const ScalingResult& r) const;
+
+  std::string infoString() const;
+};
+
+template <typename SeedType>
+ScalingResult run(const Input& input, MPI_Comm comm);
+
+/// reads comparable rows of the results file and sets res.efficiency
+void setEfficiency(ScalingResult& res, const std::string& csv_fname);
+
+int main(int argc, char* argv[]) {
+MPI_Init(&argc, &argv);
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  ScalingResult res;
+  if (input.seed == "cubed") {
+    res = run<CubedSphereSeed>(input, MPI_COMM_WORLD);
+  }
+  else {
+    res = run<IcosTriSphereSeed>(input, MPI_COMM_WORLD);
+  }
+
+  if (rank == 0) {
+    setEfficiency(res, input.csv_fname);
+    std::cout << res.infoString();
+    std::ifstream existing(input.csv_fname);
+    const bool write_header = !existing.good();
+    existing.close();
+    std::ofstream csv(input.csv_fname, std::ios::app);
+    LPM_THROW_IF(!csv.is_open(), "bveScaling error: cannot open " << input.csv_fname);
+    if (write_header) csv << ScalingResult::csvHeader() << "\n";
+    csv << res.csvRow() << "\n";
+  }
+}
+ko::finalize();
+MPI_Finalize();
+return 0;
+}
+
+template <typename SeedType>
+ScalingResult run(const Input& input, MPI_Comm comm) {
+  ScalingResult res;
+  MPI_Comm_size(comm, &res.nranks);
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  res.study = input.study;
+  res.seed = input.seed;
+  res.ic = input.ic;
+  res.depth = input.depth;
+  res.nsteps = input.nsteps;
+  res.nthreads = ko::DefaultExecutionSpace::concurrency();
+  res.execution_space = ko::DefaultExecutionSpace::name();
+
+  MPI_Barrier(comm);
+  auto t0 = tic();
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<SeedType> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, input.depth);
+  BVESphere<SeedType> sphere(nmaxverts, nmaxedges, nmaxfaces);
+  sphere.treeInit(input.depth, seed);
+  res.refinement = toc(t0);
+  res.nverts = sphere.nvertsHost();
+  res.nfaces = sphere.nfacesHost();
+  res.pairs_per_step = 4*Real(res.nverts + res.nfaces)*res.nfaces;
+
+  const Real Omega = 2*PI;
+  t0 = tic();
+  sphere.set_omega(Omega);
+  BVERK4 solver(input.dt, Omega);
+  solver.time_velocity = true;
+  sphere.init_vorticity(input.initialVorticity(), solver.symmetric_faces);
+  solver.init(res.nverts, res.nfaces);
+  if (res.nranks > 1) {
+    solver.set_ring(std::shared_ptr<RingDirectSum>(new RingDirectSum(comm)));
+  }
+  res.init = toc(t0);
+
+  Real step_time = 0;
+  for (Int k=0; k<input.nsteps; ++k) {
+    t0 = tic();
+    solver.advance_timestep(sphere.physVerts.crds, sphere.relVortVerts, sphere.velocityVerts,
+      sphere.physFaces.crds, sphere.relVortFaces, sphere.velocityFaces, sphere.faces.area, sphere.faces.mask);
+    step_time += toc(t0);
+    sphere.t = (k+1)*input.dt;
+
+    if (input.output_interval > 0 && (k+1)%input.output_interval == 0 && rank == 0) {
+      t0 = tic();
+      sphere.updateHost();
+      std::ostringstream ss;
+      ss << input.vtk_froot << SeedType::faceStr() << input.depth << "_" << std::setfill('0') << std::setw(4)
+         << k+1 << ".vtk";
+      sphere.outputVtk(ss.str());
+      res.output += toc(t0);
+    }
+  }
+  res.velocity = solver.velocity_time;
+  res.update = step_time - solver.velocity_time;
+
+  /// report the slowest rank for each phase
+  Real phases[5] = {res.refinement, res.init, res.velocity, res.update, res.output};
+  Real max_phases[5];
+  MPI_Allreduce(phases, max_phases, 5, mpi_real_type(), MPI_MAX, comm);
+  res.refinement = max_phases[0];
+  res.init = max_phases[1];
+  res.velocity = max_phases[2];
+  res.update = max_phases[3];
+  res.output = max_phases[4];
+  return res;
+}
+
+void setEfficiency(ScalingResult& res, const std::string& csv_fname) {
+  const ScalingResult* ref = &res;
+  std::vector<ScalingResult> previous;
+  std::ifstream csv(csv_fname);
+  std::string line;
+  while (std::getline(csv, line)) {
+    ScalingResult r;
+    if (r.fromCsv(line) && res.comparable(r)) previous.push_back(r);
+  }
+  for (const auto& r : previous) {
+    if (r.nprocs() < ref->nprocs()) ref = &r;
+  }
+  res.efficiency = (res.pairs_per_step/ref->pairs_per_step) * (ref->nprocs()*ref->stepTime()/ref->nsteps) /
+    (res.nprocs()*res.stepTime()/res.nsteps);
+}
+
+std::string ScalingResult::csvHeader() {
+  return "study,seed,ic,depth,nverts,nfaces,pairs_per_step,nranks,nthreads,execution_space,nsteps,"
+    "refinement_s,init_s,velocity_s,update_s,output_s,total_s,efficiency";
+}
+
+std::string ScalingResult::csvRow() const {
+  std::ostringstream ss;
+  ss << study << "," << seed << "," << ic << "," << depth << "," << nverts << "," << nfaces << ","
+     << pairs_per_step << "," << nranks << "," << nthreads << "," << execution_space << "," << nsteps << ","
+     << std::setprecision(8) << refinement << "," << init << "," << velocity << "," << update << ","
+     << output << "," << total() << "," << efficiency;
+  return ss.str();
+}
+
+bool ScalingResult::fromCsv(const std::string& line) {
+  std::vector<std::string> fields;
+  std::istringstream ss(line);
+  std::string field;
+  while (std::getline(ss, field, ',')) {
+    fields.push_back(field);
+  }
+  if (fields.size() != 18 || fields[0] == "study") return false;
+  study = fields[0];
+  seed = fields[1];
+  ic = fields[2];
+  depth = std::stoi(fields[3]);
+  nverts = std::stoi(fields[4]);
+  nfaces = std::stoi(fields[5]);
+  pairs_per_step = std::stod(fields[6]);
+  nranks = std::stoi(fields[7]);
+  nthreads = std::stoi(fields[8]);
+  execution_space = fields[9];
+  nsteps = std::stoi(fields[10]);
+  refinement = std::stod(fields[11]);
+  init = std::stod(fields[12]);
+  velocity = std::stod(fields[13]);
+  update = std::stod(fields[14]);
+  output = std::stod(fields[15]);
+  efficiency = std::stod(fields[17]);
+  return true;
+}
+
+bool ScalingResult::comparable(const ScalingResult& r) const {
+  return (r.study == study && r.seed == seed && r.ic == ic && r.execution_space == execution_space &&
+    (study != "strong" || r.depth == depth));
+}
+
+std::string ScalingResult::infoString() const {
+  std::ostringstream ss;
+  ss << "BVE scaling (" << study << "): " << seed << " depth " << depth << " (" << nverts << " vertices, "
+     << nfaces << " faces), ic " << ic << ", " << nranks << " ranks x " << nthreads << " threads ("
+     << execution_space << "), " << nsteps << " steps\n";
+  ss << std::setw(12) << "phase" << std::setw(14) << "seconds" << std::setw(10) << "percent" << "\n";
+  const std::string names[5] = {"refinement", "init", "velocity", "update", "output"};
+  const Real times[5] = {refinement, init, velocity, update, output};
+  for (Int i=0; i<5; ++i) {
+    ss << std::setw(12) << names[i] << std::setw(14) << times[i] << std::setw(10) << std::fixed
+       << std::setprecision(1) << 100*times[i]/total() << "\n";
+    ss.unsetf(std::ios::fixed);
+    ss << std::setprecision(6);
+  }
+  ss << std::setw(12) << "total" << std::setw(14) << total() << "\n";
+  const Real pair_rate = (stepTime() > 0 ? pairs_per_step*nsteps/stepTime() : 0);
+  ss << "time per step " << stepTime()/nsteps << " s, " << pair_rate << " pairs/s, parallel efficiency "
+     << efficiency << "\n";
+  return ss.str();
+}
+
+Input::Input(int argc, char* argv[]) {
+  seed = "cubed";
+  depth = 4;
+  nsteps = 10;
+  dt = 0.01;
+  ic = "rotation";
+  output_interval = 0;
+  vtk_froot = "bve_scaling_";
+  study = "strong";
+  csv_fname = "bve_scaling.csv";
+  for (int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-s") {
+      seed = argv[++i];
+    }
+    else if (token == "-d") {
+      depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-n") {
+      nsteps = std::stoi(argv[++i]);
+    }
+    else if (token == "-dt") {
+      dt = std::stod(argv[++i]);
+    }
+    else if (token == "-ic") {
+      ic = argv[++i];
+    }
+    else if (token == "-f") {
+      output_interval = std::stoi(argv[++i]);
+    }
+    else if (token == "-o") {
+      vtk_froot = argv[++i];
+    }
+    else if (token == "-study") {
+      study = argv[++i];
+    }
+    else if (token == "-csv") {
+      csv_fname = argv[++i];
+    }
+  }
+  LPM_THROW_IF(seed != "cubed" && seed != "icos", "bveScaling error: seed must be cubed or icos.");
+  LPM_THROW_IF(depth < 0 || depth > 9, "bveScaling error: invalid mesh tree depth.");
+  LPM_THROW_IF(nsteps < 1, "bveScaling error: at least one time step is required.");
+  LPM_THROW_IF(ic != "rotation" && ic != "ns", "bveScaling error: initial vorticity must be rotation or ns.");
+  LPM_THROW_IF(study != "strong" && study != "weak", "bveScaling error: study must be strong or weak.");
+}
+
+VorticityInitialCondition::ptr Input::initialVorticity() const {
+  VorticityInitialCondition::ptr result;
+  if (ic == "rotation") {
+    result = VorticityInitialCondition::ptr(new SolidBodyRotation());
+  }
+  else {
+    result = VorticityInitialCondition::ptr(new NitscheStricklandVortex());
+  }
+  return result;
+}
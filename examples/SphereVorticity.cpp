@@ -6,6 +6,7 @@
 #include "LpmGeometry.hpp"
 #include "LpmMeshSeed.hpp"
 #include "LpmSpherePoisson.hpp"
+#include "LpmAutotune.hpp"
 #include <iostream>
 #include <sstream>
 
@@ -15,6 +16,7 @@ struct Input {
   int init_depth;
   std::string vtk_froot;
   int nthreads_per_team;
+  bool tune;
 
   Input(int argc, char* argv[]);
 
@@ -50,6 +52,7 @@ ko::initialize(argc, argv);
 
     /** initialize the Poisson problem */
     sphere.init();
+    if (input.tune) TeamPolicyTuner::instance().setMode(TuneOn);
     std::cout << sphere.infoString("sphere_poisson_solver",0,false);
     {
       const auto solve_start_time = tic();
@@ -72,6 +75,7 @@ Input::Input(int argc, char* argv[]) {
   init_depth = 2;
   vtk_froot = "sphere_poisson_";
   nthreads_per_team = 0;
+  tune = false;
   for (int i=1; i<argc; ++i) {
     const std::string& token = argv[i];
     if (token == "-o") {
@@ -83,5 +87,8 @@ Input::Input(int argc, char* argv[]) {
     else if (token == "-n") {
       nthreads_per_team = std::stoi(argv[++i]);
     }
+    else if (token == "-tune") {
+      tune = true;
+    }
   }
 }
@@ -0,0 +1,51 @@
+#!/bin/bash
+#
+# Strong or weak scaling sweep of examples/BVEScaling.cpp over MPI ranks and OpenMP threads per rank.
+# Results (per-phase timings and parallel efficiency) are appended to $CSV, smallest configuration first.
+#
+# usage: bveScalingStudy.sh <path to bveScaling> [strong|weak]
+#
+# Environment (defaults in parentheses):
+#   RANKS    MPI rank counts ("1 2 4")
+#   THREADS  OpenMP threads per rank ("1 2 4 8")
+#   SEED     cubed or icos (cubed)
+#   DEPTH    mesh depth; for weak scaling, the depth at 1 rank x 1 thread (4)
+#   NSTEPS   time steps per run (10)
+#   IC       initial vorticity, rotation or ns (rotation)
+#   CSV      results file (bve_scaling.csv)
+#   MPIEXEC  MPI launcher (mpirun)
+#
+# Direct sum work grows by 16x per level of mesh depth, so weak scaling adds one level of depth for each 16x
+# increase in ranks x threads; efficiency is normalized by the work of each run.
+#
+EXE=$1
+STUDY=${2:-strong}
+RANKS=${RANKS:-"1 2 4"}
+THREADS=${THREADS:-"1 2 4 8"}
+SEED=${SEED:-cubed}
+DEPTH=${DEPTH:-4}
+NSTEPS=${NSTEPS:-10}
+IC=${IC:-rotation}
+CSV=${CSV:-bve_scaling.csv}
+MPIEXEC=${MPIEXEC:-mpirun}
+
+if [ ! -x "$EXE" ]; then
+  echo "usage: $0 <path to bveScaling> [strong|weak]"
+  exit 1
+fi
+
+for r in $RANKS; do
+  for t in $THREADS; do
+    d=$DEPTH
+    if [ "$STUDY" = "weak" ]; then
+      p=$((r*t))
+      while [ $p -ge 16 ]; do
+        d=$((d+1))
+        p=$((p/16))
+      done
+    fi
+    echo "$STUDY: $r ranks x $t threads, depth $d"
+    OMP_NUM_THREADS=$t OMP_PROC_BIND=spread OMP_PLACES=threads $MPIEXEC -np $r "$EXE" -s $SEED -d $d \
+      -n $NSTEPS -ic $IC -study $STUDY -csv $CSV || exit 1
+  done
+done
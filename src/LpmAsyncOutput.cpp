@@ -0,0 +1,171 @@
+#include "LpmAsyncOutput.hpp"
+#include "LpmTimer.hpp"
+#include <sstream>
+
+namespace Lpm {
+
+StagedField& OutputSnapshot::field(const std::string& name, const FieldKind& fk, const bool vector,
+  const Index n, const Index ncols) {
+  for (auto& f : fields) {
+    if (f.name == name && f.kind == fk) {
+      LPM_THROW_IF(f.vector != vector, "OutputSnapshot error: field " << name << " changed rank.");
+      if (f.data.extent(0) < n || f.data.extent(1) != ncols) {
+        f.data = StagedField::staging_view(name, n, ncols);
+      }
+      f.n = n;
+      return f;
+    }
+  }
+  StagedField f;
+  f.name = name;
+  f.kind = fk;
+  f.vector = vector;
+  f.data = StagedField::staging_view(name, n, ncols);
+  f.n = n;
+  fields.push_back(f);
+  return fields.back();
+}
+
+const StagedField& OutputSnapshot::get(const std::string& name, const FieldKind& fk) const {
+  for (const auto& f : fields) {
+    if (f.name == name && f.kind == fk) return f;
+  }
+  std::ostringstream ss;
+  ss << "OutputSnapshot::get error: field " << name << " not found.";
+  throw std::runtime_error(ss.str());
+}
+
+AsyncOutput::AsyncOutput(const bool asnc) : async(asnc), current(-1), completed(0), pending(0),
+  shutdown(false) {
+  for (Int i=0; i<nbuffers; ++i) {
+    busy[i] = false;
+  }
+  if (async) {
+    /// construct the timer registry here, so that the worker thread is not taken as its main thread
+    TimerRegistry::instance();
+    worker = std::thread(&AsyncOutput::run, this);
+  }
+}
+
+AsyncOutput::~AsyncOutput() {
+  if (async) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      shutdown = true;
+    }
+    cv.notify_all();
+    worker.join();
+  }
+}
+
+OutputSnapshot& AsyncOutput::acquire() {
+  std::unique_lock<std::mutex> lock(mtx);
+  rethrow_job_error();
+  if (current >= 0) return buffers[current];
+  cv.wait(lock, [this] {return !busy[0] || !busy[1] || job_error;});
+  rethrow_job_error();
+  current = (busy[0] ? 1 : 0);
+  busy[current] = true;
+  return buffers[current];
+}
+
+void AsyncOutput::submit(const job_type& job) {
+  LPM_THROW_IF(current < 0, "AsyncOutput::submit error: acquire must be called first.");
+  const Int buf = current;
+  current = -1;
+  if (async) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (job_error) {
+        busy[buf] = false;
+        rethrow_job_error();
+      }
+      jobs.push_back(std::make_pair(buf, job));
+      ++pending;
+    }
+    cv.notify_all();
+  }
+  else {
+    busy[buf] = false;
+    job(buffers[buf]);
+    ++completed;
+  }
+}
+
+void AsyncOutput::release() {
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (current < 0) return;
+    busy[current] = false;
+    current = -1;
+  }
+  cv.notify_all();
+}
+
+void AsyncOutput::flush() {
+  if (async) {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this] {return pending == 0 || job_error;});
+    rethrow_job_error();
+  }
+}
+
+Int AsyncOutput::nCompleted() const {
+  std::unique_lock<std::mutex> lock(mtx);
+  return completed;
+}
+
+void AsyncOutput::run() {
+  while (true) {
+    std::pair<Int,job_type> job;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [this] {return shutdown || !jobs.empty();});
+      if (jobs.empty()) return;
+      job = jobs.front();
+      jobs.pop_front();
+    }
+    try {
+      LPM_TIMER_SCOPE("AsyncOutput job");
+      job.second(buffers[job.first]);
+    }
+    catch (...) {
+      std::unique_lock<std::mutex> lock(mtx);
+      job_error = std::current_exception();
+    }
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      busy[job.first] = false;
+      --pending;
+      ++completed;
+    }
+    cv.notify_all();
+  }
+}
+
+void AsyncOutput::rethrow_job_error() {
+  if (job_error) {
+    std::exception_ptr err = job_error;
+    job_error = nullptr;
+    std::rethrow_exception(err);
+  }
+}
+
+#ifdef LPM_HAVE_NETCDF
+void writeNcSnapshot(NcTimeSeriesWriter& writer, const OutputSnapshot& snap) {
+  writer.appendTime(snap.t, snap.get("phys_crds", VertexField).vec(), snap.get("phys_crds", FaceField).vec());
+  for (const auto& f : snap.fields) {
+    if (f.name == "phys_crds") continue;
+    const std::string name = f.name + (f.kind == VertexField ? "_verts" :
+      (f.kind == FaceField ? "_faces" : "_edges"));
+    if (f.vector) {
+      writer.writeVectorField(f.vec(), f.kind, name);
+    }
+    else {
+      writer.writeScalarField(f.scalar(), f.kind, name);
+    }
+  }
+}
+#endif
+
+}
@@ -0,0 +1,213 @@
+#ifndef LPM_ASYNC_OUTPUT_HPP
+#define LPM_ASYNC_OUTPUT_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmPolyMesh2dVtkInterface.hpp"
+#include "LpmPolyMesh2dVtkInterface_Impl.hpp"
+#ifdef LPM_HAVE_NETCDF
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#endif
+#include "Kokkos_Core.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Lpm {
+
+/** @brief Host copy of one field, taken at a snapshot.
+*/
+struct StagedField {
+  typedef ko::View<Real**, ko::LayoutRight, ko::HostSpace> staging_view;
+
+  std::string name;
+  FieldKind kind;
+  bool vector; ///< if false, data has 1 column
+  staging_view data;
+  Index n; ///< number of valid rows in data
+
+  /// rank-1 view of a scalar field's data
+  ko::View<Real*, ko::LayoutStride, ko::HostSpace> scalar() const {
+    return ko::subview(data, std::make_pair(Index(0), n), 0);
+  }
+
+  /// rank-2 view of a vector field's data
+  ko::View<Real**, ko::LayoutRight, ko::HostSpace> vec() const {
+    return ko::subview(data, std::make_pair(Index(0), n), ko::ALL());
+  }
+};
+
+/** @brief One staging buffer: the simulation time and host copies of output fields.
+
+  Storage is allocated the first time a field is staged and reused afterwards.
+*/
+struct OutputSnapshot {
+  Real t;
+  std::vector<StagedField> fields;
+
+  OutputSnapshot() : t(0) {}
+
+  /// copies rows [0,n) of a rank-1 device view into the staging buffer
+  template <typename ViewType>
+  void stageScalar(const ViewType& s, const FieldKind& fk, const std::string& name, const Index n);
+
+  /// copies rows [0,n) of a rank-2 device view into the staging buffer
+  template <typename ViewType>
+  void stageVector(const ViewType& v, const FieldKind& fk, const std::string& name, const Index n);
+
+  /// returns the staged field with the given name and kind; throws if it does not exist
+  const StagedField& get(const std::string& name, const FieldKind& fk) const;
+
+  protected:
+    StagedField& field(const std::string& name, const FieldKind& fk, const bool vector, const Index n,
+      const Index ncols);
+};
+
+/** @brief Serializes output on a dedicated thread while the time loop continues.
+
+  Usage, once per output step:
+    1. auto& snap = out.acquire(); (waits until one of the two staging buffers is free)
+    2. stage views into snap (e.g., BVESphere::stageOutput), on the main thread
+    3. out.submit(f), where f(snap) writes files using only snap and data that do not change
+       during the run (e.g., mesh topology).
+
+  A buffer that is acquired but will not be submitted (e.g., because staging threw) is returned with
+  release(); calling acquire again before submit returns the same buffer.
+
+  Jobs run in submission order.  Writer objects used by jobs (e.g., NcTimeSeriesWriter) must only be
+  touched by jobs until flush() returns.  If async is false, submit runs the job immediately
+  on the calling thread (the synchronous path).
+  Exceptions thrown by a job are rethrown by the next call to acquire, submit, or flush.
+*/
+class AsyncOutput {
+  public:
+    typedef std::function<void(const OutputSnapshot&)> job_type;
+
+    static constexpr Int nbuffers = 2;
+
+    AsyncOutput(const bool async=true);
+
+    ~AsyncOutput();
+
+    AsyncOutput(const AsyncOutput&) = delete;
+    AsyncOutput& operator=(const AsyncOutput&) = delete;
+
+    /// returns a free staging buffer; blocks while both buffers are waiting to be written
+    OutputSnapshot& acquire();
+
+    /// queues job to write the buffer returned by the last call to acquire
+    void submit(const job_type& job);
+
+    /// returns the buffer from the last call to acquire without submitting a job; no-op if there is none
+    void release();
+
+    /// blocks until all submitted jobs have finished; an acquired, unsubmitted buffer does not block
+    void flush();
+
+    /// number of jobs completed
+    Int nCompleted() const;
+
+    inline bool isAsync() const {return async;}
+
+  protected:
+    bool async;
+    OutputSnapshot buffers[nbuffers];
+    bool busy[nbuffers];
+    Int current;
+    Int completed;
+    Int pending; ///< jobs submitted and not yet finished
+
+    std::deque<std::pair<Int,job_type>> jobs;
+    std::thread worker;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    bool shutdown;
+    std::exception_ptr job_error;
+
+    void run();
+    void rethrow_job_error();
+};
+
+/** @brief Writes a staged snapshot to a VTK file.
+
+  Vertex positions come from the staged "phys_crds" VertexField; every other staged field is added
+  as point (VertexField) or cell (FaceField) data.  Topology and face areas are read from mesh.
+*/
+template <typename SeedType>
+void writeVtkSnapshot(const std::string& fname, const OutputSnapshot& snap,
+  const std::shared_ptr<PolyMesh2d<SeedType>>& mesh);
+
+#ifdef LPM_HAVE_NETCDF
+/** @brief Appends a staged snapshot to a time series file.
+
+  Positions come from the staged "phys_crds" fields; other fields are named name_verts or name_faces.
+*/
+void writeNcSnapshot(NcTimeSeriesWriter& writer, const OutputSnapshot& snap);
+#endif
+
+template <typename ViewType>
+void OutputSnapshot::stageScalar(const ViewType& s, const FieldKind& fk, const std::string& name,
+  const Index n) {
+  StagedField& f = field(name, fk, false, n, 1);
+  const auto hs = ko::create_mirror_view(s);
+  if (hs.data() != s.data()) ko::deep_copy(hs, s);
+  const auto fdata = f.data;
+  ko::parallel_for("OutputSnapshot::stageScalar", ko::RangePolicy<HostExe>(0,n),
+    [=] (const Index& i) {
+    fdata(i,0) = hs(i);
+  });
+}
+
+template <typename ViewType>
+void OutputSnapshot::stageVector(const ViewType& v, const FieldKind& fk, const std::string& name,
+  const Index n) {
+  const Index ncols = v.extent(1);
+  StagedField& f = field(name, fk, true, n, ncols);
+  const auto hv = ko::create_mirror_view(v);
+  if (hv.data() != v.data()) ko::deep_copy(hv, v);
+  const auto fdata = f.data;
+  ko::parallel_for("OutputSnapshot::stageVector", ko::RangePolicy<HostExe>(0,n),
+    [=] (const Index& i) {
+    for (Index j=0; j<ncols; ++j) {
+      fdata(i,j) = hv(i,j);
+    }
+  });
+}
+
+template <typename SeedType>
+void writeVtkSnapshot(const std::string& fname, const OutputSnapshot& snap,
+  const std::shared_ptr<PolyMesh2d<SeedType>>& mesh) {
+  Polymesh2dVtkInterface<SeedType> vtk(mesh, snap.get("phys_crds", VertexField).vec());
+  for (const auto& f : snap.fields) {
+    if (f.name == "phys_crds") continue;
+    if (f.kind == VertexField) {
+      if (f.vector) {
+        vtk.addVectorPointData(f.vec(), f.name);
+      }
+      else {
+        vtk.addScalarPointData(f.scalar(), f.name);
+      }
+    }
+    else if (f.kind == FaceField) {
+      if (f.vector) {
+        vtk.addVectorCellData(f.vec(), f.name);
+      }
+      else {
+        vtk.addScalarCellData(f.scalar(), f.name);
+      }
+    }
+  }
+  vtk.write(fname);
+}
+
+}
+#endif
@@ -0,0 +1,174 @@
+#include "LpmAutotune.hpp"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace Lpm {
+
+std::string tuningModeString(const TuningMode m) {
+  std::string result;
+  switch (m) {
+    case (TuneOff) : {
+      result = "off";
+      break;
+    }
+    case (TuneCached) : {
+      result = "cached";
+      break;
+    }
+    case (TuneOn) : {
+      result = "on";
+      break;
+    }
+  }
+  return result;
+}
+
+ko::TeamPolicy<> TeamParams::policy(const Index n) const {
+  return (team_size > 0 ? ko::TeamPolicy<>(n, team_size, vector_length) :
+    ko::TeamPolicy<>(n, ko::AUTO(), vector_length));
+}
+
+std::string TeamParams::infoString() const {
+  std::ostringstream ss;
+  ss << "team size " << (team_size > 0 ? std::to_string(team_size) : std::string("auto"))
+     << ", vector length " << vector_length;
+  if (time > 0) ss << ", " << time << " s";
+  return ss.str();
+}
+
+TeamPolicyTuner& TeamPolicyTuner::instance() {
+  static TeamPolicyTuner tuner;
+  return tuner;
+}
+
+TeamPolicyTuner::TeamPolicyTuner() : cache_fname("lpm_team_tuning.txt"), tmode(TuneCached), loaded(false),
+  verbose(false), ntuned(0) {
+  const char* env_mode = std::getenv("LPM_TEAM_TUNING");
+  if (env_mode) {
+    const std::string m(env_mode);
+    LPM_THROW_IF(m != "off" && m != "cached" && m != "on",
+      "TeamPolicyTuner error: LPM_TEAM_TUNING must be off, cached, or on.");
+    tmode = (m == "off" ? TuneOff : (m == "on" ? TuneOn : TuneCached));
+  }
+  const char* env_file = std::getenv("LPM_TEAM_TUNING_FILE");
+  if (env_file) cache_fname = env_file;
+  const char* env_verbose = std::getenv("LPM_TEAM_TUNING_VERBOSE");
+  if (env_verbose) verbose = (std::string(env_verbose) != "0");
+}
+
+void TeamPolicyTuner::setCacheFile(const std::string& fname) {
+  cache_fname = fname;
+  clear();
+}
+
+void TeamPolicyTuner::clear() {
+  cache.clear();
+  loaded = false;
+}
+
+Int TeamPolicyTuner::sizeBucket(const Index n) {
+  Int b = 0;
+  while ((size_t(1) << b) < size_t(n)) ++b;
+  return b;
+}
+
+std::string TeamPolicyTuner::key(const std::string& kernel, const Index n) {
+  LPM_THROW_IF(kernel.empty() || kernel.find_first_of(" \t\n") != std::string::npos,
+    "TeamPolicyTuner error: kernel names must be nonempty and contain no whitespace.");
+  return kernel + " " + std::to_string(sizeBucket(n));
+}
+
+bool TeamPolicyTuner::lookup(TeamParams& params, const std::string& kernel, const Index n) {
+  if (!loaded) load();
+  const auto it = cache.find(key(kernel, n));
+  if (it == cache.end()) return false;
+  params = it->second;
+  return true;
+}
+
+void TeamPolicyTuner::store(const std::string& kernel, const Index n, const TeamParams& params) {
+  if (!loaded) load();
+  cache[key(kernel, n)] = params;
+  save();
+}
+
+void TeamPolicyTuner::load() {
+  loaded = true;
+  std::ifstream f(cache_fname);
+  if (!f.is_open()) return;
+  const std::string exec_space = ko::DefaultExecutionSpace::name();
+  const Int concurrency = ko::DefaultExecutionSpace::concurrency();
+  std::string line;
+  std::string file_space;
+  Int file_concurrency = -1;
+  std::map<std::string, TeamParams> entries;
+  while (std::getline(f, line)) {
+    std::istringstream ss(line);
+    std::string kernel;
+    if (!(ss >> kernel)) continue;
+    if (kernel == "#") {
+      std::string field;
+      ss >> field;
+      if (field == "execution_space") ss >> file_space;
+      if (field == "concurrency") ss >> file_concurrency;
+      continue;
+    }
+    /// malformed lines (e.g., from a concurrent or interrupted writer) are skipped; those kernels are retuned
+    Int bucket;
+    TeamParams p;
+    if (!(ss >> bucket >> p.team_size >> p.vector_length >> p.time) || bucket < 0 || p.team_size < 0 ||
+      p.vector_length < 1) {
+      if (verbose) {
+        std::cout << "TeamPolicyTuner: skipping bad line '" << line << "' in " << cache_fname << "\n";
+      }
+      continue;
+    }
+    entries[kernel + " " + std::to_string(bucket)] = p;
+  }
+  if (file_space != exec_space || file_concurrency != concurrency) {
+    if (verbose) {
+      std::cout << "TeamPolicyTuner: ignoring " << cache_fname << ", which was recorded for " << file_space
+                << " with concurrency " << file_concurrency << "\n";
+    }
+    return;
+  }
+  cache.insert(entries.begin(), entries.end());
+}
+
+void TeamPolicyTuner::save() const {
+  /// written to a temporary file and renamed when complete, so readers never see a partial file
+  const std::string tmp_fname = cache_fname + ".tmp." + std::to_string(getpid());
+  std::ofstream f(tmp_fname, std::ios::trunc);
+  LPM_THROW_IF(!f.is_open(), "TeamPolicyTuner error: cannot open " << tmp_fname);
+  f << "# TeamPolicyTuner cache: kernel, target-count bucket, team size (0 = auto), vector length, seconds\n";
+  f << "# execution_space " << ko::DefaultExecutionSpace::name() << "\n";
+  f << "# concurrency " << ko::DefaultExecutionSpace::concurrency() << "\n";
+  f << std::setprecision(8);
+  for (const auto& e : cache) {
+    f << e.first << " " << e.second.team_size << " " << e.second.vector_length << " " << e.second.time << "\n";
+  }
+  f.close();
+  if (f.fail() || std::rename(tmp_fname.c_str(), cache_fname.c_str()) != 0) {
+    std::remove(tmp_fname.c_str());
+    LPM_THROW_IF(true, "TeamPolicyTuner error: write failed for " << cache_fname);
+  }
+}
+
+std::string TeamPolicyTuner::infoString() const {
+  std::ostringstream ss;
+  ss << "TeamPolicyTuner info: mode " << tuningModeString(tmode) << ", cache file " << cache_fname << ", "
+     << cache.size() << " cached entries, " << ntuned << " tuned by this process\n";
+  for (const auto& e : cache) {
+    ss << "\t" << e.first << ": " << e.second.infoString() << "\n";
+  }
+  return ss.str();
+}
+
+}
@@ -0,0 +1,141 @@
+#ifndef LPM_AUTOTUNE_HPP
+#define LPM_AUTOTUNE_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmRoofline.hpp"
+#include "Kokkos_Core.hpp"
+#include <map>
+#include <string>
+
+namespace Lpm {
+
+/// How TeamPolicyTuner chooses launch parameters
+enum TuningMode {
+  TuneOff, ///< always Kokkos::AUTO
+  TuneCached, ///< cached parameters where available, Kokkos::AUTO otherwise
+  TuneOn ///< cached parameters where available; tune and cache the rest
+};
+
+std::string tuningModeString(const TuningMode m);
+
+/// Launch parameters of one team kernel
+struct TeamParams {
+  Int team_size; ///< 0 for Kokkos::AUTO
+  Int vector_length;
+  Real time; ///< measured seconds per launch when the parameters were tuned
+
+  TeamParams(const Int ts=0, const Int vl=1, const Real t=0) : team_size(ts), vector_length(vl), time(t) {}
+
+  /// a policy with league size n (one team per target)
+  ko::TeamPolicy<> policy(const Index n) const;
+
+  std::string infoString() const;
+};
+
+/** @brief Process-wide cache of tuned TeamPolicy parameters for team kernels.
+
+  Parameters are kept per kernel name and target-count bucket (targets rounded up to a power of 2).  In
+  TuneOn mode, the first launch of a kernel in a bucket without cached parameters times each candidate
+  team size (Kokkos::AUTO and powers of 2 up to the kernel's maximum) and vector length (powers of 2 up to
+  the backend's maximum), keeps the fastest, and rewrites the cache file.  Later launches, and later runs
+  that load the file, use the cached parameters with no tuning overhead.
+
+  The cache file records the Kokkos execution space and its concurrency; a file recorded on a different
+  configuration is ignored.
+
+  Defaults come from the environment: LPM_TEAM_TUNING (off, cached, or on; default cached),
+  LPM_TEAM_TUNING_FILE (default lpm_team_tuning.txt), and LPM_TEAM_TUNING_VERBOSE (nonzero to print
+  tuning results and skipped cache entries; default off).
+
+  The cache file is replaced atomically (written to a temporary file, then renamed), and malformed lines
+  are skipped when it is loaded, so ranks that tune concurrently never fail on each other's files.
+
+  Tuning launches the kernel repeatedly, so kernels passed to the tuner must compute their outputs from
+  inputs that they do not modify.
+*/
+class TeamPolicyTuner {
+  public:
+    static TeamPolicyTuner& instance();
+
+    inline void setMode(const TuningMode m) {tmode = m;}
+    inline TuningMode mode() const {return tmode;}
+
+    /// if true, tuning results and skipped cache entries are printed to std::cout (default: false)
+    inline void setVerbose(const bool v) {verbose = v;}
+    inline bool isVerbose() const {return verbose;}
+
+    /// sets the cache file and discards parameters loaded from the previous one
+    void setCacheFile(const std::string& fname);
+    inline const std::string& cacheFile() const {return cache_fname;}
+
+    /// target-count bucket: the smallest b with n <= 2^b
+    static Int sizeBucket(const Index n);
+
+    /// finds cached parameters for a kernel launched over n targets; returns false if there are none
+    bool lookup(TeamParams& params, const std::string& kernel, const Index n);
+
+    /// caches parameters for a kernel and rewrites the cache file
+    void store(const std::string& kernel, const Index n, const TeamParams& params);
+
+    /** @brief A policy for kernel f over n targets, tuning first if necessary (see TuningMode).
+
+      @param kernel name under which parameters are cached (no whitespace)
+      @param n number of targets (league size)
+      @param f kernel functor, launched once per candidate if tuning
+    */
+    template <typename FunctorType>
+    ko::TeamPolicy<> policy(const std::string& kernel, const Index n, const FunctorType& f);
+
+    /// number of kernel/bucket pairs tuned by this process
+    inline Int nTuned() const {return ntuned;}
+
+    /// discards all cached parameters (the file is not modified)
+    void clear();
+
+    std::string infoString() const;
+
+  protected:
+    TeamPolicyTuner();
+
+    static std::string key(const std::string& kernel, const Index n);
+
+    void load();
+    void save() const;
+
+    std::map<std::string, TeamParams> cache;
+    std::string cache_fname;
+    TuningMode tmode;
+    bool loaded;
+    bool verbose;
+    Int ntuned;
+};
+
+/** @brief Launches a pairwise team kernel (one team per target) with the TeamPolicyTuner's parameters.
+
+  If the RooflineRegistry is enabled, the launch is fenced, timed, and recorded under kernel with
+  n*nsrc pairs (as rooflineParallelFor); tuning launches are not recorded.
+
+  @param label Kokkos label of the launch
+  @param kernel name under which parameters are cached and work is recorded (no whitespace)
+  @param n number of targets (league size)
+  @param nsrc number of sources summed by each target
+  @param f kernel functor that declares its PairWork (see pairWork)
+*/
+template <typename FunctorType>
+void tunedParallelFor(const std::string& label, const std::string& kernel, const Index n, const Index nsrc,
+  const FunctorType& f) {
+  const auto policy = TeamPolicyTuner::instance().policy(kernel, n, f);
+  RooflineRegistry& reg = RooflineRegistry::instance();
+  if (!reg.enabled()) {
+    ko::parallel_for(label, policy, f);
+    return;
+  }
+  ko::fence();
+  auto t0 = tic();
+  ko::parallel_for(label, policy, f);
+  reg.record(kernel, pairWork<FunctorType>(), Real(n)*nsrc, toc(t0));
+}
+
+}
+#endif
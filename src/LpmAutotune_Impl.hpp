@@ -0,0 +1,56 @@
+#ifndef LPM_AUTOTUNE_IMPL_HPP
+#define LPM_AUTOTUNE_IMPL_HPP
+
+#include "LpmAutotune.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace Lpm {
+
+template <typename FunctorType>
+ko::TeamPolicy<> TeamPolicyTuner::policy(const std::string& kernel, const Index n, const FunctorType& f) {
+  TeamParams params;
+  if (tmode == TuneOff || lookup(params, kernel, n) || tmode == TuneCached) {
+    return params.policy(n);
+  }
+
+  /// candidates: AUTO and powers of 2 up to the maximum team size, for each vector length
+  std::vector<TeamParams> candidates;
+  const Int max_vlen = ko::TeamPolicy<>::vector_length_max();
+  for (Int vlen=1; vlen<=max_vlen; vlen *= 2) {
+    candidates.push_back(TeamParams(0, vlen));
+    const Int max_team = ko::TeamPolicy<>(n, 1, vlen).team_size_max(f, ko::ParallelForTag());
+    for (Int ts=1; ts<=max_team; ts *= 2) {
+      candidates.push_back(TeamParams(ts, vlen));
+    }
+  }
+
+  const Int nrepeat = 3;
+  params.time = std::numeric_limits<Real>::max();
+  for (const auto& c : candidates) {
+    const auto pol = c.policy(n);
+    ko::parallel_for("TeamPolicyTuner " + kernel, pol, f); // warm up
+    Real best = std::numeric_limits<Real>::max();
+    for (Int k=0; k<nrepeat; ++k) {
+      auto t0 = tic();
+      ko::parallel_for("TeamPolicyTuner " + kernel, pol, f);
+      best = std::min(best, Real(toc(t0)));
+    }
+    if (best < params.time) {
+      params = c;
+      params.time = best;
+    }
+  }
+  ++ntuned;
+  if (verbose) {
+    std::cout << "TeamPolicyTuner: " << kernel << " (" << n << " targets, " << candidates.size()
+              << " candidates) " << params.infoString() << "\n";
+  }
+  store(kernel, n, params);
+  return params.policy(n);
+}
+
+}
+#endif
@@ -48,6 +48,9 @@ void biotSavart(ko::Tuple<Real,3>& u, const VecType& tgt_x,
 */
 struct StreamReduceDistinct {
   typedef Real value_type; ///< required by kokkos for custom reducers
+  static constexpr Int flops_per_pair = 10; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = 1;
+  static constexpr Int bytes_per_pair = 41;
   Index i; ///< index of target point in tgtx view
   crd_view tgtx; ///< view holding coordinates of target locations (usually, vertices)
   crd_view srcx; ///< view holding coordinates of source locations (usually, face centers)
@@ -64,8 +67,8 @@ struct StreamReduceDistinct {
   void operator() (const Index& j, value_type& pot) const {
       Real potential = 0;
       if (!facemask(j)) {
-          auto mytgt = ko::subview(tgtx,i,ko::ALL());
-          auto mysrc = ko::subview(srcx,j,ko::ALL());
+          const auto mytgt = vec_at<3>(tgtx, i);
+          const auto mysrc = vec_at<3>(srcx, j);
           greensFn(potential, mytgt, mysrc, srcf(j), srca(j));
       }
       pot += potential;
@@ -77,6 +80,9 @@ struct StreamReduceDistinct {
 */
 struct VelocityReduceDistinct {
   typedef ko::Tuple<Real,3> value_type; ///< required by kokkos for custom reducers
+  static constexpr Int flops_per_pair = 23; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = 0;
+  static constexpr Int bytes_per_pair = 41;
   Index i; ///< index of target point in tgtx view
   crd_view tgtx; ///< view holding coordinates of target locations (usually, vertices)
   crd_view srcx; ///< view holding coordinates of source locations (usually, face centers)
@@ -93,8 +99,8 @@ struct VelocityReduceDistinct {
   void operator() (const Index& j, value_type& vel) const {
       ko::Tuple<Real,3> u;
       if (!facemask(j)) {
-          auto mytgt = ko::subview(tgtx, i, ko::ALL());
-          auto mysrc = ko::subview(srcx, j, ko::ALL());
+          const auto mytgt = vec_at<3>(tgtx, i);
+          const auto mysrc = vec_at<3>(srcx, j);
           biotSavart(u, mytgt, mysrc, srcf(j), srca(j));
       }
       vel += u;
@@ -108,6 +114,13 @@ struct VelocityReduceDistinct {
 */
 
 struct BVEVertexSolve {
+  /// work per pair: both reductions (see PairWork)
+  static constexpr Int flops_per_pair = StreamReduceDistinct::flops_per_pair +
+    VelocityReduceDistinct::flops_per_pair;
+  static constexpr Int transcendentals_per_pair = StreamReduceDistinct::transcendentals_per_pair +
+    VelocityReduceDistinct::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = StreamReduceDistinct::bytes_per_pair +
+    VelocityReduceDistinct::bytes_per_pair;
   scalar_view_type vertpsi; ///< [output] stream function values
   vec_view vertu; ///< [output] velocity values
   crd_view vertx; ///< [input] target coordinates
@@ -138,6 +151,9 @@ struct BVEVertexSolve {
 };
 
 struct BVEVertexStreamFn {
+  static constexpr Int flops_per_pair = StreamReduceDistinct::flops_per_pair; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = StreamReduceDistinct::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = StreamReduceDistinct::bytes_per_pair;
   scalar_view_type psi;
   crd_view vertx;
   crd_view facex;
@@ -161,6 +177,9 @@ struct BVEVertexStreamFn {
 };
 
 struct BVEVertexVelocity {
+  static constexpr Int flops_per_pair = VelocityReduceDistinct::flops_per_pair; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = VelocityReduceDistinct::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = VelocityReduceDistinct::bytes_per_pair;
   vec_view vertvel;
   crd_view vertx;
   crd_view facex;
@@ -187,6 +206,9 @@ struct BVEVertexVelocity {
 
 struct StreamReduceCollocated {
   typedef Real value_type; ///< required by kokkos for custom reducers
+  static constexpr Int flops_per_pair = 10; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = 1;
+  static constexpr Int bytes_per_pair = 41;
   Index i; ///< index of target coordinate vector
   crd_view srcx; ///< collection of source coordinate vectors
   scalar_view_type srcf; ///< source vorticity values
@@ -201,8 +223,8 @@ struct StreamReduceCollocated {
   void operator() (const Index& j, value_type& pot) const {
       Real potential = 0;
       if (!mask(j) && i != j) {
-          auto mtgt = ko::subview(srcx, i, ko::ALL());
-          auto msrc = ko::subview(srcx, j, ko::ALL());
+          const auto mtgt = vec_at<3>(srcx, i);
+          const auto msrc = vec_at<3>(srcx, j);
           greensFn(potential, mtgt, msrc, srcf(j), srca(j));
       }
       pot += potential;
@@ -211,6 +233,9 @@ struct StreamReduceCollocated {
 
 struct VelocityReduceCollocated {
   typedef ko::Tuple<Real,3> value_type; ///< required by kokkos for custom reducers
+  static constexpr Int flops_per_pair = 23; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = 0;
+  static constexpr Int bytes_per_pair = 41;
   Index i; ///< index of target coordinate vector
   crd_view srcx; ///< collection of source coordinates
   scalar_view_type srcf; ///< source vorticity
@@ -225,8 +250,8 @@ struct VelocityReduceCollocated {
   void operator() (const Index& j, value_type& vel) const {
       ko::Tuple<Real,3> u;
       if (!mask(j) && i != j) {
-          auto mtgt = ko::subview(srcx, i, ko::ALL());
-          auto msrc = ko::subview(srcx, j, ko::ALL());
+          const auto mtgt = vec_at<3>(srcx, i);
+          const auto msrc = vec_at<3>(srcx, j);
           biotSavart(u, mtgt, msrc, srcf(j), srca(j));
       }
       vel += u;
@@ -234,6 +259,13 @@ struct VelocityReduceCollocated {
 };
 
 struct BVEFaceSolve {
+  /// work per pair: both reductions (see PairWork)
+  static constexpr Int flops_per_pair = StreamReduceCollocated::flops_per_pair +
+    VelocityReduceCollocated::flops_per_pair;
+  static constexpr Int transcendentals_per_pair = StreamReduceCollocated::transcendentals_per_pair +
+    VelocityReduceCollocated::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = StreamReduceCollocated::bytes_per_pair +
+    VelocityReduceCollocated::bytes_per_pair;
   scalar_view_type facepsi;
   vec_view faceu;
   crd_view facex;
@@ -261,6 +293,9 @@ struct BVEFaceSolve {
 };
 
 struct BVEFaceStreamFn {
+  static constexpr Int flops_per_pair = StreamReduceCollocated::flops_per_pair; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = StreamReduceCollocated::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = StreamReduceCollocated::bytes_per_pair;
   scalar_view_type psi;
   crd_view facex;
   scalar_view_type facevort;
@@ -283,6 +318,9 @@ struct BVEFaceStreamFn {
 };
 
 struct BVEFaceVelocity {
+  static constexpr Int flops_per_pair = VelocityReduceCollocated::flops_per_pair; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = VelocityReduceCollocated::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = VelocityReduceCollocated::bytes_per_pair;
   vec_view faceu;
   crd_view facex;
   scalar_view_type facevort;
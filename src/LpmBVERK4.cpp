@@ -1,8 +1,26 @@
 #include "LpmBVERK4.hpp"
+#include "LpmMemory.hpp"
+#ifdef LPM_HAVE_NETCDF
+#include "LpmNetCDF.hpp"
+#endif
 
 namespace Lpm {
 
+#ifdef LPM_HAVE_NETCDF
+BVERK4::BVERK4(const PolyMeshReader& reader) : dt(reader.getRealAtt("rk4_dt")),
+  Omega(reader.getRealAtt("rk4_Omega")), nverts(0), nfaces(0),
+  symmetric_faces(reader.getIntAtt("rk4_symmetric_faces") != 0), time_velocity(false),
+  velocity_time(0) {}
+
+void BVERK4::writeSettings(NcWriter& writer) const {
+  writer.writeAttribute("rk4_dt", dt);
+  writer.writeAttribute("rk4_Omega", Omega);
+  writer.writeAttribute("rk4_symmetric_faces", Int(symmetric_faces ? 1 : 0));
+}
+#endif
+
 void BVERK4::init(const Index& nv, const Index& nf) {
+  MemoryCategoryScope mem_scope(MemIntegrator);
 
   if (nv != nverts) {
     vertx1 = crd_view("vertex_xyz_stage1", nv);
@@ -6,10 +6,19 @@
 #include "Kokkos_Core.hpp"
 #include "LpmKokkosUtil.hpp"
 #include "LpmBVEKernels.hpp"
+#include "LpmSymmetricPairKernels.hpp"
 #include "LpmGeometry.hpp"
+#include "LpmRingSum.hpp"
+#include <memory>
+#include <string>
 
 namespace Lpm {
 
+#ifdef LPM_HAVE_NETCDF
+  class NcWriter; /// fwd. decl.
+  class PolyMeshReader; /// fwd. decl.
+#endif
+
 class BVERK4 {
   public :
     crd_view vertx;
@@ -26,15 +35,55 @@ class BVERK4 {
     Index nverts;
     Index nfaces;
 
-    BVERK4(const Real& timestep, const Real& omg) : dt(timestep), Omega(omg), nverts(0), nfaces(0) {}
+    bool symmetric_faces; ///< if true, face velocities use symmetric-pair evaluation (sphereCollocatedSymmetricSolve)
+
+    /// if true, velocity sums are fenced and timed into velocity_time (default: false)
+    bool time_velocity;
+
+    /// cumulative seconds spent in velocity sums if time_velocity; the rest of a step is RK updates
+    Real velocity_time;
+
+    BVERK4(const Real& timestep, const Real& omg) : dt(timestep), Omega(omg), nverts(0), nfaces(0),
+      symmetric_faces(SYMMETRIC_PAIRS_DEFAULT), time_velocity(false), velocity_time(0) {}
+
+#ifdef LPM_HAVE_NETCDF
+    /// restores the settings saved by writeSettings (stage buffers are allocated by init)
+    BVERK4(const PolyMeshReader& reader);
+
+    /// saves dt, Omega, and symmetric_faces as attributes of a checkpoint file
+    void writeSettings(NcWriter& writer) const;
+#endif
 
     void init(const Index& nv, const Index& nf);
 
+    /** @brief Distributes the velocity sums over the ranks of a RingDirectSum's communicator.
+
+      Every rank holds and advances all particles.  At each stage, each rank computes velocity at its
+      blockRange of vertices and faces, and the results are gathered; symmetric_faces is not used.
+      A null pointer restores single-process sums.
+    */
+    inline void set_ring(const std::shared_ptr<RingDirectSum>& r) {ring = r;}
+
     void advance_timestep(crd_view& vx, scalar_view_type& vzeta, vec_view& vvel,
       crd_view& fx, scalar_view_type& fzeta, vec_view& fvel, const scalar_view_type& fa, const mask_view_type& fm);
 
 
   protected:
+    /** vertvel <- u(vx; fx, fzeta) and facevel <- u(fx; fzeta); if time_velocity, adds the elapsed time to
+      velocity_time
+    */
+    void velocity(const std::string& label, const crd_view& vx, const crd_view& fx, const scalar_view_type& fzeta);
+
+    /// collocated face-to-face velocity, facevel <- u(fx, fzeta)
+    void face_velocity(const std::string& label, const crd_view& fx, const scalar_view_type& fzeta);
+
+    /** velocity computed by ring; each rank sums for its blockRange of vertices and faces in one ring pass,
+      then all results are gathered
+    */
+    void ring_velocity(const crd_view& vx, const crd_view& fx, const scalar_view_type& fzeta);
+
+    std::shared_ptr<RingDirectSum> ring;
+
     scalar_view_type facearea;
     mask_view_type facemask;
 
@@ -3,6 +3,9 @@
 
 #include "LpmBVERK4.hpp"
 #include "KokkosBlas.hpp"
+#include "LpmTimer.hpp"
+#include "LpmAutotune_Impl.hpp"
+#include "LpmUtilities.hpp"
 #include <cassert>
 #include "Kokkos_Core.hpp"
 
@@ -38,14 +41,47 @@ struct BVERK4Update {
   }
 };
 
+void BVERK4::velocity(const std::string& label, const crd_view& vx, const crd_view& fx,
+  const scalar_view_type& fzeta) {
+  LPM_TIMER_SCOPE("velocity");
+  timeval t0 = timeval();
+  if (time_velocity) {
+    ko::fence();
+    t0 = tic();
+  }
+  if (ring) {
+    ring_velocity(vx, fx, fzeta);
+  }
+  else {
+    tunedParallelFor(label + " vertex velocity", "BVEVertexVelocity", nverts, nfaces,
+      BVEVertexVelocity(vertvel, vx, fx, fzeta, facearea, facemask, nfaces));
+    face_velocity(label + " face velocity", fx, fzeta);
+  }
+  if (time_velocity) velocity_time += toc(t0);
+}
+
+void BVERK4::face_velocity(const std::string& label, const crd_view& fx, const scalar_view_type& fzeta) {
+  if (symmetric_faces) {
+    scalar_view_type nopsi;
+    sphereCollocatedSymmetricSolve(nopsi, facevel, fx, fzeta, facearea, facemask, nfaces, false);
+  }
+  else {
+    tunedParallelFor(label, "BVEFaceVelocity", nfaces, nfaces,
+      BVEFaceVelocity(facevel, fx, fzeta, facearea, facemask, nfaces));
+  }
+}
+
+void BVERK4::ring_velocity(const crd_view& vx, const crd_view& fx, const scalar_view_type& fzeta) {
+  ring->setSources(fx, fzeta, facearea, facemask, nfaces);
+  scalar_view_type nopsi;
+  ring->computeGathered(nopsi, vertvel, nopsi, facevel, vx, nverts, fx, nfaces);
+}
 
 void BVERK4::advance_timestep(crd_view& vx, scalar_view_type& vzeta, vec_view& vvel,
       crd_view& fx, scalar_view_type& fzeta, vec_view& fvel, const scalar_view_type& fa, const mask_view_type& fm) {
 
-  ko::Profiling::pushRegion("BVERK4::advance_timestep");
-
-  ko::TeamPolicy<> vertex_policy(nverts, ko::AUTO());
-  ko::TeamPolicy<> face_policy(nfaces, ko::AUTO());
+  LPM_TIMER_SCOPE("BVERK4::advance_timestep");
+  LPM_COUNTER_ADD("BVE direct sum pairs", 4*Real(nverts + nfaces)*nfaces);
 
   vertx = vx;
   vertvort = vzeta;
@@ -59,6 +95,7 @@ void BVERK4::advance_timestep(crd_view& vx, scalar_view_type& vzeta, vec_view& v
   facemask = fm;
 
   /// RK Stage 1
+  LPM_TIMER_START("stage 1");
 //   KokkosBlas::axpby(dt, vertvel, 0.0, vertx1);
   KokkosBlas::scal(vertx1, dt, vertvel);
   ko::parallel_for("RK4-1 vertex vorticity", nverts, BVEVorticityTendency(vertvort1, vertvel, dt, Omega));
@@ -67,66 +104,64 @@ void BVERK4::advance_timestep(crd_view& vx, scalar_view_type& vzeta, vec_view& v
   KokkosBlas::scal(facex1, dt, facevel);
   ko::parallel_for("RK4-1 face vorticity", nfaces, BVEVorticityTendency(facevort1, facevel, dt, Omega));
 
+  LPM_TIMER_STOP();
+
   /// RK Stage 2
+  LPM_TIMER_START("stage 2");
   KokkosBlas::update(1.0, vertx, 0.5, vertx1, 0.0, vertxwork);
   KokkosBlas::update(1.0, vertvort, 0.5, vertvort1, 0.0, vertvortwork);
 
   KokkosBlas::update(1.0, facex, 0.5, facex1, 0.0, facexwork);
   KokkosBlas::update(1.0, facevort, 0.5, facevort1, 0.0, facevortwork);
 
-  ko::parallel_for("RK4-2 vertex velocity", vertex_policy,
-    BVEVertexVelocity(vertvel, vertxwork, facexwork, facevortwork, facearea, facemask, nfaces));
-  ko::parallel_for("RK4-2 face velocity", face_policy,
-    BVEFaceVelocity(  facevel, facexwork, facevortwork, facearea, facemask, nfaces));
+  velocity("RK4-2", vertxwork, facexwork, facevortwork);
   KokkosBlas::scal(vertx2, dt, vertvel);
   KokkosBlas::scal(facex2, dt, facevel);
   ko::parallel_for("RK4-2 vertex vorticity", nverts, BVEVorticityTendency(vertvort2, vertvel, dt, Omega));
   ko::parallel_for("RK4-2 face vorticity", nfaces, BVEVorticityTendency(facevort2, facevel, dt, Omega));
 
+  LPM_TIMER_STOP();
+
   /// RK Stage 3
+  LPM_TIMER_START("stage 3");
   KokkosBlas::update(1.0, vertx, 0.5, vertx2, 0.0, vertxwork);
   KokkosBlas::update(1.0, vertvort, 0.5, vertvort2, 0.0, vertvortwork);
 
   KokkosBlas::update(1.0, facex, 0.5, facex2, 0.0, facexwork);
   KokkosBlas::update(1.0, facevort, 0.5, facevort2, 0.0, facevortwork);
 
-  ko::parallel_for("RK4-3 vertex velocity", vertex_policy,
-    BVEVertexVelocity(vertvel, vertxwork, facexwork, facevortwork, facearea, facemask, nfaces));
-  ko::parallel_for("RK4-3 face velocity",face_policy,
-    BVEFaceVelocity(facevel, facexwork, facevortwork, facearea, facemask, nfaces));
+  velocity("RK4-3", vertxwork, facexwork, facevortwork);
   KokkosBlas::scal(vertx3, dt, vertvel);
   KokkosBlas::scal(facex3, dt, facevel);
   ko::parallel_for("RK4-3 vertex vorticity", nverts, BVEVorticityTendency(vertvort3, vertvel, dt, Omega));
   ko::parallel_for(nfaces, BVEVorticityTendency(facevort3, facevel, dt, Omega));
 
+  LPM_TIMER_STOP();
+
   /// RK Stage 4
+  LPM_TIMER_START("stage 4");
   KokkosBlas::update(1.0, vertx, 1.0, vertx3, 0.0, vertxwork);
   KokkosBlas::update(1.0, vertvort, 1.0, vertvort3, 0.0, vertvortwork);
 
   KokkosBlas::update(1.0, facex, 1.0, facex3, 0.0, facexwork);
   KokkosBlas::update(1.0, facevort, 1.0, facevort3, 0.0, facevortwork);
 
-  ko::parallel_for("RK4-4 vertex velocity", vertex_policy,
-    BVEVertexVelocity(vertvel, vertxwork, facexwork, facevortwork, facearea, facemask, nfaces));
-  ko::parallel_for("RK4-4 face velocity",face_policy,
-    BVEFaceVelocity(facevel, facexwork, facevortwork, facearea, facemask, nfaces));
+  velocity("RK4-4", vertxwork, facexwork, facevortwork);
   KokkosBlas::scal(vertx4, dt, vertvel);
   KokkosBlas::scal(facex4, dt, facevel);
   ko::parallel_for("RK4-4 vertex vorticity", nverts, BVEVorticityTendency(vertvort4, vertvel, dt, Omega));
   ko::parallel_for("RK4-4 face vorticity", nfaces, BVEVorticityTendency(facevort4, facevel, dt, Omega));
 
+  LPM_TIMER_STOP();
+
+  LPM_TIMER_START("update");
   ko::parallel_for("RK4 vertex update", nverts,
     BVERK4Update(vertx, vertx1, vertx2, vertx3, vertx4, vertvort, vertvort1, vertvort2, vertvort3, vertvort4));
   ko::parallel_for("RK4 face update", nfaces,
     BVERK4Update(facex, facex1, facex2, facex3, facex4, facevort, facevort1, facevort2, facevort4, facevort4));
 
-  ko::parallel_for("RK4-0 vertex velocity", vertex_policy,
-    BVEVertexVelocity(vertvel, vertx, facex, facevort, facearea, facemask, nfaces));
-  ko::parallel_for("RK4-0 face velocity", face_policy,
-    BVEFaceVelocity(facevel, facex, facevort, facearea, facemask, nfaces));
-
-
-  ko::Profiling::popRegion();
+  velocity("RK4-0", vertx, facex, facevort);
+  LPM_TIMER_STOP();
 }
 
 
@@ -0,0 +1,92 @@
+#include "LpmBVERegrid.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmMemory.hpp"
+#include "LpmTimer.hpp"
+#include "Compadre_Evaluator.hpp"
+#ifdef LPM_HAVE_NETCDF
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#endif
+
+namespace Lpm {
+
+BVERegrid::BVERegrid(const LatLonMesh& ll, const CompadreParams& params) :
+  tgt_pts(ll.pts), tgt_pts_host(ll.pts_host), gmls_params(params), nlat(ll.nlat), nlon(ll.nlon) {
+  init();
+}
+
+BVERegrid::BVERegrid(const ko::View<Real*[3]> pts, const CompadreParams& params) :
+  tgt_pts(pts), gmls_params(params), nlat(0), nlon(0) {
+  tgt_pts_host = ko::create_mirror_view(pts);
+  ko::deep_copy(tgt_pts_host, pts);
+  init();
+}
+
+void BVERegrid::init() {
+  MemoryCategoryScope mem_scope(MemRemap);
+  const Index ntgt = tgt_pts.extent(0);
+  tgt_crds = crd_view_type("regrid_crds", ntgt);
+  psi = scalar_view_type("regrid_psi", ntgt);
+  relvort = scalar_view_type("regrid_relvort", ntgt);
+  absvort = scalar_view_type("regrid_absvort", ntgt);
+  velocity = vec_view_type("regrid_velocity", ntgt);
+  const auto pts = tgt_pts;
+  const auto crds = tgt_crds;
+  ko::parallel_for(ntgt, KOKKOS_LAMBDA (const Index& i) {
+    for (Short j=0; j<3; ++j) {
+      crds(i,j) = pts(i,j);
+    }
+  });
+}
+
+template <typename SeedType>
+void BVERegrid::compute(const BVESphere<SeedType>& sphere) {
+  LPM_TIMER_SCOPE("BVERegrid::compute");
+  MemoryCategoryScope mem_scope(MemRemap);
+  const Index ntgt = nTargets();
+  const Index nf = sphere.nfacesHost();
+
+  /// stream function and velocity: direct sum over faces
+  ko::TeamPolicy<> policy(ntgt, ko::AUTO());
+  ko::parallel_for(policy, BVEVertexSolve(psi, velocity, tgt_crds, sphere.physFaces.crds,
+    sphere.relVortFaces, sphere.faces.area, sphere.faces.mask, nf));
+
+  /// relative vorticity: GMLS interpolation from particles
+  const auto src_crds = sourceCoords(sphere);
+  const auto src_vort = sourceValues(sphere, sphere.relVortVerts, sphere.relVortFaces);
+  auto src_host = ko::create_mirror_view(src_crds);
+  ko::deep_copy(src_host, src_crds);
+  CompadreNeighborhoods nn(src_host, tgt_pts_host, gmls_params);
+  std::vector<Compadre::TargetOperation> ops = {Compadre::ScalarPointEvaluation};
+  Compadre::GMLS gmls = scalarGMLS(src_crds, tgt_pts, nn, gmls_params, ops);
+  Compadre::Evaluator eval(&gmls);
+  auto tgt_vort = eval.applyAlphasToDataAllComponentsAllTargetSites<Real*,DevMem>(src_vort, ops[0],
+    Compadre::PointSample);
+  ko::deep_copy(relvort, tgt_vort);
+
+  /// absolute vorticity
+  const Real two_omega = 2*sphere.Omega;
+  const auto pts = tgt_pts;
+  const auto zeta = relvort;
+  const auto abs_zeta = absvort;
+  ko::parallel_for(ntgt, KOKKOS_LAMBDA (const Index& i) {
+    abs_zeta(i) = zeta(i) + two_omega*pts(i,2);
+  });
+}
+
+#ifdef LPM_HAVE_NETCDF
+void BVERegrid::writeNcTimestep(NcTimeSeriesWriter& writer) const {
+  LPM_THROW_IF(nlat == 0, "BVERegrid::writeNcTimestep error: targets are not a lat-lon grid.");
+  writer.writeLatLonScalar(psi, "stream_fn_ll", "length^2/time");
+  writer.writeLatLonScalar(relvort, "relvort_ll", "1/time");
+  writer.writeLatLonScalar(absvort, "absvort_ll", "1/time");
+  writer.writeLatLonVector(velocity, "velocity_ll", "length/time");
+}
+#endif
+
+/// ETI
+template void BVERegrid::compute(const BVESphere<IcosTriSphereSeed>& sphere);
+template void BVERegrid::compute(const BVESphere<CubedSphereSeed>& sphere);
+
+}
@@ -0,0 +1,76 @@
+#ifndef LPM_BVE_REGRID_HPP
+#define LPM_BVE_REGRID_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmLatLonMesh.hpp"
+#include "LpmCompadre.hpp"
+#include "LpmBVESphere.hpp"
+#include "Kokkos_Core.hpp"
+
+namespace Lpm {
+
+#ifdef LPM_HAVE_NETCDF
+  class NcTimeSeriesWriter; /// fwd. decl.
+#endif
+
+/** @brief Evaluates BVE diagnostics from particle data at a fixed set of points on the sphere.
+
+  Stream function and velocity are computed by direct summation over the leaf faces (the same kernels used for
+  vertices in BVESphere).  Vorticity is carried by the particles, so it is interpolated to the targets with GMLS
+  from vertex and leaf face values; neighborhoods are rebuilt at each call because the particles move.
+
+  Targets are usually a LatLonMesh; any point set (e.g., Gaussian latitudes) may be used instead, but only
+  LatLonMesh targets can be written to a NetCDF time series.
+
+  Typical use, each output step:
+    1. writer.appendTime(t) or sphere.writeNcTimestep(writer)
+    2. regrid.compute(sphere)
+    3. regrid.writeNcTimestep(writer)
+*/
+struct BVERegrid {
+  typedef typename SphereGeometry::crd_view_type crd_view_type;
+  typedef typename SphereGeometry::vec_view_type vec_view_type;
+
+  ko::View<Real*[3]> tgt_pts; ///< target points, in the layout used by Compadre
+  typename ko::View<Real*[3]>::HostMirror tgt_pts_host; ///< host copy of target points
+  crd_view_type tgt_crds; ///< target points, in the layout used by BVE kernels
+  scalar_view_type psi; ///< [output] stream function at targets
+  scalar_view_type relvort; ///< [output] relative vorticity at targets
+  scalar_view_type absvort; ///< [output] absolute vorticity at targets
+  vec_view_type velocity; ///< [output] velocity at targets
+  CompadreParams gmls_params; ///< interpolation parameters for vorticity
+  Int nlat; ///< number of latitudes, if targets are a LatLonMesh; 0 otherwise
+  Int nlon; ///< number of longitudes, if targets are a LatLonMesh; 0 otherwise
+
+  /// Targets are the points of a LatLonMesh
+  BVERegrid(const LatLonMesh& ll, const CompadreParams& params=CompadreParams());
+
+  /// Targets are arbitrary points on the unit sphere
+  BVERegrid(const ko::View<Real*[3]> pts, const CompadreParams& params=CompadreParams());
+
+  /// number of target points
+  inline Index nTargets() const {return tgt_pts.extent(0);}
+
+  /** @brief Computes stream function, velocity, and vorticity at the targets from the sphere's current data.
+
+    @param sphere source of particle positions, vorticity, and areas (device data)
+  */
+  template <typename SeedType>
+  void compute(const BVESphere<SeedType>& sphere);
+
+#ifdef LPM_HAVE_NETCDF
+  /** @brief Writes the most recent results to the current record of a time series.
+
+    The writer must have a lat-lon grid (NcTimeSeriesWriter::defineLatLon) matching the targets.
+  */
+  void writeNcTimestep(NcTimeSeriesWriter& writer) const;
+#endif
+
+  protected:
+    void init();
+};
+
+}
+#endif
@@ -4,6 +4,13 @@
 #include "LpmFaces.hpp"
 #include "LpmCoords.hpp"
 #include "LpmPolyMesh2d.hpp"
+#include "LpmSymmetricPairKernels.hpp"
+#include "LpmAsyncOutput.hpp"
+#include "LpmMemory.hpp"
+#ifdef LPM_HAVE_NETCDF
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#endif
 
 namespace Lpm {
 
@@ -47,8 +54,61 @@ BVESphere<SeedType>::BVESphere(const Index nmaxverts, const Index nmaxedges, con
     }
   }
 
+#ifdef LPM_HAVE_NETCDF
+template <typename SeedType>
+BVESphere<SeedType>::BVESphere(const PolyMeshReader& reader) :
+  PolyMesh2d<SeedType>(reader),
+  relVortVerts("relVortVerts", this->physVerts.crds.extent(0)),
+  absVortVerts("absVortVerts", this->physVerts.crds.extent(0)),
+  streamFnVerts("streamFnVerts", this->physVerts.crds.extent(0)),
+  velocityVerts("velocityVerts", this->physVerts.crds.extent(0)),
+  relVortFaces("relVortFaces", this->physFaces.crds.extent(0)),
+  absVortFaces("absVortFaces", this->physFaces.crds.extent(0)),
+  streamFnFaces("streamFnFaces", this->physFaces.crds.extent(0)),
+  velocityFaces("velocityFaces", this->physFaces.crds.extent(0)),
+  ntracers("ntracers"),
+  Omega(reader.getRealAtt("Omega")),
+  t(reader.getRealAtt("t")),
+  omg_set(true)
+  {
+    _hostntracers = ko::create_mirror_view(ntracers);
+    _hostRelVortVerts = ko::create_mirror_view(relVortVerts);
+    _hostAbsVortVerts = ko::create_mirror_view(absVortVerts);
+    _hostStreamFnVerts = ko::create_mirror_view(streamFnVerts);
+    _hostVelocityVerts = ko::create_mirror_view(velocityVerts);
+    _hostRelVortFaces = ko::create_mirror_view(relVortFaces);
+    _hostAbsVortFaces = ko::create_mirror_view(absVortFaces);
+    _hostStreamFnFaces = ko::create_mirror_view(streamFnFaces);
+    _hostVelocityFaces = ko::create_mirror_view(velocityFaces);
+
+    reader.fill_scalar_field(_hostRelVortVerts, "relvort_verts");
+    reader.fill_scalar_field(_hostAbsVortVerts, "absvort_verts");
+    reader.fill_scalar_field(_hostStreamFnVerts, "stream_fn_verts");
+    reader.fill_vector_field(_hostVelocityVerts, "velocity_verts");
+    reader.fill_scalar_field(_hostRelVortFaces, "relvort_faces");
+    reader.fill_scalar_field(_hostAbsVortFaces, "absvort_faces");
+    reader.fill_scalar_field(_hostStreamFnFaces, "stream_fn_faces");
+    reader.fill_vector_field(_hostVelocityFaces, "velocity_faces");
+
+    const Int nq = reader.getIntAtt("ntracers");
+    std::ostringstream ss;
+    for (Int k=0; k<nq; ++k) {
+      ss << "tracer_name" << k;
+      const std::string name = reader.getStringAtt(ss.str());
+      ss.str("");
+      create_tracer(name);
+      reader.fill_scalar_field(_hostTracerVerts[k], name + "_verts");
+      reader.fill_scalar_field(_hostTracerFaces[k], name + "_faces");
+    }
+    _hostntracers() = nq;
+    ko::deep_copy(ntracers, _hostntracers);
+    updateDevice();
+  }
+#endif
+
 template <typename SeedType>
 Short BVESphere<SeedType>::create_tracer(const std::string& name) {
+  MemoryCategoryScope mem_scope(MemFields);
   const Short tracer_ind = tracer_verts.size();
   tracer_verts.push_back(scalar_field(name, relVortVerts.extent(0)));
   _hostTracerVerts.push_back(ko::create_mirror_view(tracer_verts[tracer_ind]));
@@ -124,7 +184,7 @@ void BVESphere<SeedType>::set_omega(const Real& omg) {
 }
 
 template <typename SeedType>
-void BVESphere<SeedType>::init_vorticity(const VorticityInitialCondition::ptr relvort) {
+void BVESphere<SeedType>::init_vorticity(const VorticityInitialCondition::ptr relvort, const bool symmetric) {
   const auto hvertx = this->physVerts.getHostCrdView();
   # pragma omp parallel for
   for (Index i=0; i<this->nvertsHost(); ++i) {
@@ -155,17 +215,22 @@ void BVESphere<SeedType>::init_vorticity(const VorticityInitialCondition::ptr re
     BVEVertexStreamFn(streamFnVerts, this->physVerts.crds, this->physFaces.crds, this->relVortFaces, this->faces.area,
       this->faces.mask, this->faces.nh()));
 
-  ko::parallel_for("init_vorticity: stream fn faces", face_policy,
-    BVEFaceStreamFn(streamFnFaces, this->physFaces.crds, this->relVortFaces, this->faces.area,
-      this->faces.mask, this->faces.nh()));
-
   ko::parallel_for("init_vorticity: velocity verts", vertex_policy,
     BVEVertexVelocity(velocityVerts, this->physVerts.crds, this->physFaces.crds, this->relVortFaces, this->faces.area,
       this->faces.mask, this->faces.nh()));
 
-  ko::parallel_for("init_vorticity: velocity faces", face_policy,
-    BVEFaceVelocity(velocityFaces, this->physFaces.crds, this->relVortFaces, this->faces.area, this->faces.mask,
-      this->faces.nh()));
+  if (symmetric) {
+    sphereCollocatedSymmetricSolve(streamFnFaces, velocityFaces, this->physFaces.crds, this->relVortFaces,
+      this->faces.area, this->faces.mask, this->faces.nh());
+  }
+  else {
+    ko::parallel_for("init_vorticity: stream fn faces", face_policy,
+      BVEFaceStreamFn(streamFnFaces, this->physFaces.crds, this->relVortFaces, this->faces.area,
+        this->faces.mask, this->faces.nh()));
+    ko::parallel_for("init_vorticity: velocity faces", face_policy,
+      BVEFaceVelocity(velocityFaces, this->physFaces.crds, this->relVortFaces, this->faces.area, this->faces.mask,
+        this->faces.nh()));
+  }
 }
 
 template <typename SeedType>
@@ -186,6 +251,75 @@ void BVESphere<SeedType>::addFieldsToVtk(Polymesh2dVtkInterface<SeedType>& vtk)
   }
 }
 
+template <typename SeedType>
+void BVESphere<SeedType>::stageOutput(OutputSnapshot& snap) const {
+  const Index nv = this->nvertsHost();
+  const Index nf = this->nfacesHost();
+  snap.t = t;
+  snap.stageVector(this->physVerts.crds, VertexField, "phys_crds", nv);
+  snap.stageVector(this->physFaces.crds, FaceField, "phys_crds", nf);
+  snap.stageScalar(relVortVerts, VertexField, "relvort", nv);
+  snap.stageScalar(absVortVerts, VertexField, "absvort", nv);
+  snap.stageScalar(streamFnVerts, VertexField, "stream_fn", nv);
+  snap.stageScalar(relVortFaces, FaceField, "relvort", nf);
+  snap.stageScalar(absVortFaces, FaceField, "absvort", nf);
+  snap.stageScalar(streamFnFaces, FaceField, "stream_fn", nf);
+
+  snap.stageVector(velocityVerts, VertexField, "velocity", nv);
+  snap.stageVector(velocityFaces, FaceField, "velocity", nf);
+
+  for (Int k=0; k<tracer_verts.size(); ++k) {
+    snap.stageScalar(tracer_verts[k], VertexField, tracer_verts[k].label(), nv);
+    snap.stageScalar(tracer_faces[k], FaceField, tracer_faces[k].label(), nf);
+  }
+}
+
+#ifdef LPM_HAVE_NETCDF
+template <typename SeedType>
+void BVESphere<SeedType>::writeNcTimestep(NcTimeSeriesWriter& writer) const {
+  writer.appendTime(t, *this);
+  writer.writeScalarField(relVortVerts, VertexField, "relvort_verts", "1/time");
+  writer.writeScalarField(absVortVerts, VertexField, "absvort_verts", "1/time");
+  writer.writeScalarField(streamFnVerts, VertexField, "stream_fn_verts", "length^2/time");
+  writer.writeVectorField(velocityVerts, VertexField, "velocity_verts", "length/time");
+  writer.writeScalarField(relVortFaces, FaceField, "relvort_faces", "1/time");
+  writer.writeScalarField(absVortFaces, FaceField, "absvort_faces", "1/time");
+  writer.writeScalarField(streamFnFaces, FaceField, "stream_fn_faces", "length^2/time");
+  writer.writeVectorField(velocityFaces, FaceField, "velocity_faces", "length/time");
+  for (Int k=0; k<tracer_verts.size(); ++k) {
+    writer.writeScalarField(tracer_verts[k], VertexField, tracer_verts[k].label() + "_verts");
+    writer.writeScalarField(tracer_faces[k], FaceField, tracer_faces[k].label() + "_faces");
+  }
+}
+#endif
+
+#ifdef LPM_HAVE_NETCDF
+template <typename SeedType>
+void BVESphere<SeedType>::writeCheckpoint(NcWriter& writer) const {
+  this->updateHost();
+  writer.writePolymesh(*this);
+  writer.writeAttribute("t", t);
+  writer.writeAttribute("Omega", Omega);
+  writer.writeAttribute("ntracers", Int(tracer_verts.size()));
+  writer.writeScalarField(relVortVerts, VertexField, "relvort_verts", "1/time");
+  writer.writeScalarField(absVortVerts, VertexField, "absvort_verts", "1/time");
+  writer.writeScalarField(streamFnVerts, VertexField, "stream_fn_verts", "length^2/time");
+  writer.writeVectorField(velocityVerts, VertexField, "velocity_verts", "length/time");
+  writer.writeScalarField(relVortFaces, FaceField, "relvort_faces", "1/time");
+  writer.writeScalarField(absVortFaces, FaceField, "absvort_faces", "1/time");
+  writer.writeScalarField(streamFnFaces, FaceField, "stream_fn_faces", "length^2/time");
+  writer.writeVectorField(velocityFaces, FaceField, "velocity_faces", "length/time");
+  std::ostringstream ss;
+  for (Int k=0; k<tracer_verts.size(); ++k) {
+    ss << "tracer_name" << k;
+    writer.writeAttribute(ss.str(), tracer_verts[k].label());
+    ss.str("");
+    writer.writeScalarField(tracer_verts[k], VertexField, tracer_verts[k].label() + "_verts");
+    writer.writeScalarField(tracer_faces[k], FaceField, tracer_faces[k].label() + "_faces");
+  }
+}
+#endif
+
 template <typename SeedType>
 Real BVESphere<SeedType>::avg_mesh_size_radians() const {
   return std::sqrt(4*PI/this->nfacesHost());
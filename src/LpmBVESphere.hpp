@@ -7,6 +7,7 @@
 #include "LpmGeometry.hpp"
 #include "Kokkos_Core.hpp"
 #include "LpmBVEKernels.hpp"
+#include "LpmSymmetricPairKernels.hpp"
 #include "LpmVorticityGallery.hpp"
 #include "LpmPolyMesh2dVtkInterface.hpp"
 #include "LpmPolyMesh2dVtkInterface_Impl.hpp"
@@ -15,10 +16,16 @@
 
 namespace Lpm {
 
+#ifdef LPM_HAVE_NETCDF
+  class NcTimeSeriesWriter; /// fwd. decl.
+  class NcWriter; /// fwd. decl.
+#endif
+  struct OutputSnapshot; /// fwd. decl.
+
 template <typename SeedType> class BVESphere : public PolyMesh2d<SeedType> {
     public:
         typedef scalar_view_type scalar_field;
-        typedef ko::View<Real*[3],Dev> vector_field;
+        typedef typename SphereGeometry::vec_view_type vector_field;
 
         scalar_field relVortVerts;
         scalar_field absVortVerts;
@@ -39,7 +46,23 @@ template <typename SeedType> class BVESphere : public PolyMesh2d<SeedType> {
 
         BVESphere(const Index nmaxverts, const Index nmaxedges, const Index nmaxfaces, const Int nq=0);
 
-        void init_vorticity(const VorticityInitialCondition::ptr relvort);
+#ifdef LPM_HAVE_NETCDF
+        /** @brief Restarts from a file written by writeCheckpoint.
+
+          Memory is allocated for exactly the mesh in the file.  Fields are read in bulk into host mirrors
+          and copied to device.
+        */
+        BVESphere(const PolyMeshReader& reader);
+#endif
+
+        /** @brief Sets vorticity from an initial condition and computes the initial stream function and velocity.
+
+          @param relvort relative vorticity
+          @param symmetric if true, face sums use sphereCollocatedSymmetricSolve; pass BVERK4::symmetric_faces
+            so that initial face velocities come from the same path as the time steps
+        */
+        void init_vorticity(const VorticityInitialCondition::ptr relvort,
+          const bool symmetric=SYMMETRIC_PAIRS_DEFAULT);
 
         void outputVtk(const std::string& fname) const override;
 
@@ -56,6 +79,25 @@ template <typename SeedType> class BVESphere : public PolyMesh2d<SeedType> {
 
         void addFieldsToVtk(Polymesh2dVtkInterface<SeedType>& vtk) const;
 
+        /** @brief Copies time, positions, and the fields written by addFieldsToVtk into an output buffer,
+          for writing on the AsyncOutput thread (see writeVtkSnapshot, writeNcSnapshot).
+          Copies from device views, so updateHost is not needed.
+        */
+        void stageOutput(OutputSnapshot& snap) const;
+
+#ifdef LPM_HAVE_NETCDF
+        /** @brief Appends a time record (time, positions, vorticity, stream function, velocity, tracers)
+          to a time series file.  Call writer.defineMesh(*this) once before the first record.
+        */
+        void writeNcTimestep(NcTimeSeriesWriter& writer) const;
+
+        /** @brief Writes a restart file: the mesh, all fields and tracers, t, and Omega.
+
+          Integrator settings may be added to the same file, e.g., with BVERK4::writeSettings(writer).
+        */
+        void writeCheckpoint(NcWriter& writer) const;
+#endif
+
     protected:
         typedef typename scalar_field::HostMirror scalar_host;
         typedef typename vector_field::HostMirror vector_host;
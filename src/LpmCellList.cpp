@@ -0,0 +1,85 @@
+#include "LpmCellList.hpp"
+#include <sstream>
+
+namespace Lpm {
+
+void PlaneCellList::build(const crd_view& x, const Index n, const Real h, const mask_view_type& mask) {
+  LPM_THROW_IF(n < 1, "PlaneCellList::build error: no points.");
+  LPM_THROW_IF(h <= 0, "PlaneCellList::build error: cell size must be positive.");
+  LPM_THROW_IF(n > x.extent(0), "PlaneCellList::build error: not enough coordinates.");
+  const bool use_mask = (mask.extent(0) > 0);
+
+  /// bounding box
+  Real x0, x1, y0, y1;
+  ko::parallel_reduce("PlaneCellList::xmin", n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    if (x(i,0) < m) m = x(i,0);}, ko::Min<Real>(x0));
+  ko::parallel_reduce("PlaneCellList::xmax", n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    if (x(i,0) > m) m = x(i,0);}, ko::Max<Real>(x1));
+  ko::parallel_reduce("PlaneCellList::ymin", n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    if (x(i,1) < m) m = x(i,1);}, ko::Min<Real>(y0));
+  ko::parallel_reduce("PlaneCellList::ymax", n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    if (x(i,1) > m) m = x(i,1);}, ko::Max<Real>(y1));
+
+  /// grid; limit the number of cells to a small multiple of the number of points
+  Real hh = h;
+  const Real max_cells = 4*Real(n) + 1;
+  while ( (std::floor((x1-x0)/hh)+1) * (std::floor((y1-y0)/hh)+1) > max_cells) {
+    hh *= 2;
+  }
+  const Int nxx = Int(std::floor((x1-x0)/hh)) + 1;
+  const Int nyy = Int(std::floor((y1-y0)/hh)) + 1;
+  xmin = x0;
+  ymin = y0;
+  cell_size = hh;
+  nx = nxx;
+  ny = nyy;
+  npts = n;
+  const Index nc = nxx*nyy;
+
+  if (cell_start.extent(0) < nc+1) cell_start = index_view_type("cell_start", nc+1);
+  if (pts.extent(0) < n) pts = index_view_type("cell_pts", n);
+
+  /// counting sort
+  index_view_type cell_id("cell_id", n);
+  index_view_type counts("cell_counts", nc+1);
+  const index_view_type cstart = cell_start;
+  const index_view_type cpts = pts;
+  ko::parallel_for("PlaneCellList::bin", n, KOKKOS_LAMBDA (const Index& j) {
+    if (use_mask && mask(j)) {
+      cell_id(j) = NULL_IND;
+    }
+    else {
+      Int ix = Int(std::floor((x(j,0) - x0)/hh));
+      Int iy = Int(std::floor((x(j,1) - y0)/hh));
+      ix = (ix < nxx ? ix : nxx-1);
+      iy = (iy < nyy ? iy : nyy-1);
+      const Index c = iy*nxx + ix;
+      cell_id(j) = c;
+      ko::atomic_increment(&counts(c));
+    }
+  });
+  ko::parallel_scan("PlaneCellList::offsets", nc+1, KOKKOS_LAMBDA (const Index& c, Index& sum, const bool& final_pass) {
+    const Index cnt = counts(c);
+    if (final_pass) cstart(c) = sum;
+    sum += cnt;
+  });
+  ko::deep_copy(counts, 0);
+  ko::parallel_for("PlaneCellList::fill", n, KOKKOS_LAMBDA (const Index& j) {
+    const Index c = cell_id(j);
+    if (c != NULL_IND) {
+      const Index pos = cstart(c) + ko::atomic_fetch_add(&counts(c), 1);
+      cpts(pos) = j;
+    }
+  });
+}
+
+std::string PlaneCellList::infoString(const std::string& label, const int& tab_level) const {
+  std::ostringstream ss;
+  const std::string tabstr = indentString(tab_level);
+  ss << tabstr << "PlaneCellList " << label << " info:\n";
+  ss << tabstr << "\tnpts = " << npts << ", (nx, ny) = (" << nx << ", " << ny << ")\n";
+  ss << tabstr << "\tcell_size = " << cell_size << ", (xmin, ymin) = (" << xmin << ", " << ymin << ")\n";
+  return ss.str();
+}
+
+}
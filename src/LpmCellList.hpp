@@ -0,0 +1,123 @@
+#ifndef LPM_CELL_LIST_HPP
+#define LPM_CELL_LIST_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmKokkosUtil.hpp"
+#include "LpmUtilities.hpp"
+#include "Kokkos_Core.hpp"
+#include <string>
+
+namespace Lpm {
+
+/** @brief Uniform-grid cell list for particles in the plane.
+
+  Sources are binned into square cells of side cell_size (a counting sort, built on device).
+  Cells are numbered row-major, c = iy*nx + ix, so that the points of the cells
+  ix0, ..., ix1 in one row are contiguous in pts: [cell_start(iy*nx+ix0), cell_start(iy*nx+ix1+1)).
+
+  Used by compact-support kernels (e.g., PSE) to visit only the sources within a cutoff radius of a target.
+*/
+class PlaneCellList {
+  public:
+    typedef typename PlaneGeometry::crd_view_type crd_view;
+
+    index_view_type cell_start; ///< offsets into pts; size ncells()+1
+    index_view_type pts; ///< source indices, sorted by cell
+    Real xmin; ///< lower left corner of grid, x coordinate
+    Real ymin; ///< lower left corner of grid, y coordinate
+    Real cell_size; ///< side length of each cell
+    Int nx; ///< number of cells in x direction
+    Int ny; ///< number of cells in y direction
+    Index npts; ///< number of binned sources
+
+    PlaneCellList() : xmin(0), ymin(0), cell_size(1), nx(0), ny(0), npts(0) {}
+
+    /** @brief (Re)builds the cell list.
+
+      @hostfn
+
+      @param x source coordinates
+      @param n number of sources (x.extent(0) may be larger)
+      @param h requested cell size (typically, the kernel cutoff radius); increased if the grid would be too large
+      @param mask if nonempty, sources with mask(j) == true are excluded (e.g., divided panels)
+    */
+    void build(const crd_view& x, const Index n, const Real h, const mask_view_type& mask=mask_view_type());
+
+    /// total number of cells
+    KOKKOS_INLINE_FUNCTION
+    Index ncells() const {return nx*ny;}
+
+    /// cell column containing x-coordinate xx (not clamped)
+    KOKKOS_INLINE_FUNCTION
+    Int cell_x(const Real& xx) const {return Int(std::floor((xx - xmin)/cell_size));}
+
+    /// cell row containing y-coordinate yy (not clamped)
+    KOKKOS_INLINE_FUNCTION
+    Int cell_y(const Real& yy) const {return Int(std::floor((yy - ymin)/cell_size));}
+
+    std::string infoString(const std::string& label="", const int& tab_level=0) const;
+};
+
+/** @brief Restricts a pair reducer to the sources in a cell-list range that lie within a cutoff radius.
+
+  PairReducer must define value_type and operator() (const Index& j, value_type& v),
+  where j is the source index (e.g., PlanePSELaplacian8Reduce).
+*/
+template <typename PairReducer> struct PlaneCutoffReduce {
+  typedef typename PairReducer::value_type value_type;
+  typedef typename PlaneGeometry::crd_view_type crd_view;
+  PairReducer pair;
+  crd_view srcx;
+  index_view_type pts;
+  ko::Tuple<Real,2> tgtx;
+  Real rcut2;
+
+  KOKKOS_INLINE_FUNCTION
+  PlaneCutoffReduce(const PairReducer& pr, const crd_view& sx, const index_view_type& p,
+    const ko::Tuple<Real,2>& xt, const Real& rc) : pair(pr), srcx(sx), pts(p), tgtx(xt), rcut2(rc*rc) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& k, value_type& v) const {
+    const Index j = pts(k);
+    const Real sqdist = square(srcx(j,0) - tgtx[0]) + square(srcx(j,1) - tgtx[1]);
+    if (sqdist <= rcut2) {
+      pair(j, v);
+    }
+  }
+};
+
+/** @brief Team reduction of a pair reducer over all sources within rcut of a target.
+
+  Visits the rows of cells that intersect the square [x-rcut, x+rcut]^2; each row is one
+  contiguous TeamThreadRange reduction.
+
+  @device
+*/
+template <typename PairReducer> KOKKOS_INLINE_FUNCTION
+void plane_cutoff_team_reduce(const member_type& mbr, const PlaneCellList& cells,
+  const typename PlaneGeometry::crd_view_type& srcx, const ko::Tuple<Real,2>& tgtx, const Real& rcut,
+  const PairReducer& pair, typename PairReducer::value_type& result) {
+  typedef typename PairReducer::value_type value_type;
+  result = value_type();
+  const Int r = Int(std::ceil(rcut/cells.cell_size));
+  const Int cx = cells.cell_x(tgtx[0]);
+  const Int cy = cells.cell_y(tgtx[1]);
+  const Int ix0 = (cx - r > 0 ? cx - r : 0);
+  const Int ix1 = (cx + r < cells.nx-1 ? cx + r : cells.nx-1);
+  const Int iy0 = (cy - r > 0 ? cy - r : 0);
+  const Int iy1 = (cy + r < cells.ny-1 ? cy + r : cells.ny-1);
+  if (ix0 > ix1) return;
+  const PlaneCutoffReduce<PairReducer> cutoff_pair(pair, srcx, cells.pts, tgtx, rcut);
+  for (Int iy=iy0; iy<=iy1; ++iy) {
+    const Index kbegin = cells.cell_start(iy*cells.nx + ix0);
+    const Index kend = cells.cell_start(iy*cells.nx + ix1 + 1);
+    value_type rowsum;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, kbegin, kend), cutoff_pair, rowsum);
+    result += rowsum;
+  }
+}
+
+}
+#endif
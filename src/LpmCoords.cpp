@@ -8,7 +8,7 @@ template <typename Geo>
 std::string Coords<Geo>::infoString(const std::string& label, const short& tab_level, const bool& dump_all) const {
   std::ostringstream oss;
   const std::string tabstr = indentString(tab_level);
-  oss << tabstr << "Coords " << label << " info: nh = (" << _nh() << ") of nmax = " << _nmax << " in memory" << std::endl;
+  oss << tabstr << "Coords " << label << " info: nh = (" << _nh() << ") of nmax = " << _nmax << " in memory, layout = " << layout_policy::idString() << std::endl;
   if (dump_all) {
     for (Index i=0; i<_nmax; ++i) {
       if (i==_nh()) oss << tabstr <<  "---------------------------------" << std::endl;
@@ -94,6 +94,14 @@ void Coords<Geo>::initInteriorCrdsFromSeed(const MeshSeed<SeedType>& seed) {
   _nh() = SeedType::nfaces;
 }
 
+template <typename Geo>
+void Coords<Geo>::initFromCache(const MeshCacheReader& cache, const MeshCacheArray& arr) {
+  LPM_THROW_IF(cache.ndim() != Geo::ndim, "Coords::initFromCache error: dimension mismatch.");
+  LPM_THROW_IF(_nmax < cache.nRows(arr), "Coords::initFromCache error: not enough memory.");
+  cache.fill(_hostcrds, arr);
+  _nh() = cache.nRows(arr);
+}
+
 /// ETI
 template class Coords<PlaneGeometry>;
 template class Coords<SphereGeometry>;
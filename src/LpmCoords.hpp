@@ -6,6 +6,7 @@
 #include "LpmUtilities.hpp"
 #include "LpmGeometry.hpp"
 #include "LpmMeshSeed.hpp"
+#include "LpmMeshCache.hpp"
 #include "Kokkos_Core.hpp"
 #include "Kokkos_View.hpp"
 #include <cassert>
@@ -23,6 +24,7 @@ Templated on Geometry Type (e.g., SphereGeometry, PlaneGeometry).
 template <typename Geo> class Coords {
   public:
     typedef typename Geo::crd_view_type crd_view_type; ///< basic array type defined from Geometry type
+    typedef CrdLayout layout_policy; ///< storage policy (AoSCrdLayout or SoACrdLayout), see LpmDefs.hpp
     crd_view_type crds; ///< primary container --- a view of vectors
     n_view_type n; ///< number of vectors currently intialized
 
@@ -39,12 +41,26 @@ template <typename Geo> class Coords {
       _nh() = 0;
     };
 
-    Coords(const ko::View<Real**> cv) : crds(cv), _nmax(cv.extent(0)), n("n") {
+    /** @brief Constructor from a pre-filled array (e.g., from a file reader).
+
+      Data are copied (not aliased) so that the input may use a different layout than layout_policy.
+
+      @param cv array of coordinate vectors, cv.extent(1) must equal Geo::ndim
+    */
+    Coords(const ko::View<Real**> cv) : crds("crds", cv.extent(0)), _nmax(cv.extent(0)), n("n") {
+      LPM_THROW_IF(cv.extent(1) != Geo::ndim, "Coords error: input dimension mismatch.");
       _hostcrds = ko::create_mirror_view(crds);
       _nh = ko::create_mirror_view(n);
       _nh() = cv.extent(0);
       ko::deep_copy(n, _nh);
-      ko::deep_copy(_hostcrds, crds);
+      auto hcv = ko::create_mirror_view(cv);
+      ko::deep_copy(hcv, cv);
+      for (Index i=0; i<_nh(); ++i) {
+        for (Short j=0; j<Geo::ndim; ++j) {
+          _hostcrds(i,j) = hcv(i,j);
+        }
+      }
+      ko::deep_copy(crds, _hostcrds);
     }
 
     /**
@@ -159,6 +175,15 @@ template <typename Geo> class Coords {
     template <typename SeedType>
     void initInteriorCrdsFromSeed(const MeshSeed<SeedType>& seed);
 
+    /** \brief Initializes coordinates from a mesh cache file
+
+      \hostfn
+
+      \param cache mapped mesh cache file
+      \param arr which cached coordinate array to copy (e.g., CachePhysVerts)
+    */
+    void initFromCache(const MeshCacheReader& cache, const MeshCacheArray& arr);
+
     /** \brief Output all data to a stream, writing it in matlab format.
 
     \hostfn
@@ -172,7 +197,7 @@ template <typename Geo> class Coords {
 
     \hostfn
     */
-    typename crd_view_type::HostMirror getHostCrdView() {return _hostcrds;}
+    typename crd_view_type::HostMirror getHostCrdView() const {return _hostcrds;}
   protected:
     typename crd_view_type::HostMirror _hostcrds; ///< host view of primary data
     Index _nmax; ///< maximum number of coordinates allowed in memory
@@ -0,0 +1,208 @@
+#include "LpmDecomposition.hpp"
+#include "LpmDecomposition_Impl.hpp"
+#include "LpmOctreeKernels.hpp"
+#include "LpmUtilities.hpp"
+#include "Kokkos_Sort.hpp"
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+namespace Lpm {
+
+using namespace Octree;
+
+MortonDecomposition::MortonDecomposition(MPI_Comm c, const Int depth) : comm(c),
+  key_depth(depth > 0 ? depth : MAX_OCTREE_DEPTH) {
+  LPM_THROW_IF(key_depth > MAX_OCTREE_DEPTH, "MortonDecomposition error: key depth exceeds octree max depth.");
+  MPI_Comm_rank(comm, &comm_rank);
+  MPI_Comm_size(comm, &comm_size);
+}
+
+template <typename SeedType>
+void MortonDecomposition::init(const PolyMesh2d<SeedType>& mesh) {
+  const Index nv = mesh.nvertsHost();
+  const Index nf = mesh.nfacesHost();
+  const Index nleaves = mesh.faces.nLeavesHost();
+
+  host_index_view leaves_host("leaves_host", nleaves);
+  Index ct = 0;
+  for (Index i=0; i<nf; ++i) {
+    if (!mesh.faces.hasKidsHost(i)) {
+      leaves_host(ct++) = i;
+    }
+  }
+  LPM_THROW_IF(ct != nleaves, "MortonDecomposition::init error: leaf count mismatch.");
+
+  /// Morton keys of leaf face centers; planar coordinates have z = 0
+  ko::View<Index*> leaves("leaves", nleaves);
+  ko::deep_copy(leaves, leaves_host);
+  ko::View<Real*[3]> pts("decomp_leaf_pts", nleaves);
+  const auto fx = mesh.physFaces.crds;
+  ko::parallel_for(nleaves, KOKKOS_LAMBDA (const Index& i) {
+    for (Short j=0; j<3; ++j) {
+      pts(i,j) = (j < SeedType::geo::ndim ? fx(leaves(i), j) : 0);
+    }
+  });
+  ko::View<BBox> box("bbox");
+  ko::parallel_reduce(nleaves, BoxFunctor(pts), BBoxReducer<Dev>(box));
+  ko::View<code_type*> codes("decomp_codes", nleaves);
+  ko::parallel_for(nleaves, EncodeFunctor(codes, pts, box, key_depth));
+  ko::sort(codes);
+  ko::View<Index*> sorted_leaves("sorted_leaves", nleaves);
+  ko::parallel_for(nleaves, KOKKOS_LAMBDA (const Index& i) {
+    sorted_leaves(i) = leaves(decode_id(codes(i)));
+  });
+  morton_leaves = host_index_view("morton_leaves", nleaves);
+  ko::deep_copy(morton_leaves, sorted_leaves);
+
+  const auto fverts = mesh.faces.getVertsHost();
+  face_verts = ko::View<Index**,Host>("face_verts", nf, SeedType::nfaceverts);
+  for (Index i=0; i<nf; ++i) {
+    for (Short j=0; j<SeedType::nfaceverts; ++j) {
+      face_verts(i,j) = fverts(i,j);
+    }
+  }
+
+  leaf_weights = ko::View<Real*,Host>("leaf_weights", nleaves);
+  ko::deep_copy(leaf_weights, 1);
+  face_owner = host_owner_view("face_owner", nf);
+  vert_owner = host_owner_view("vert_owner", nv);
+  prev_face_owner = host_owner_view("prev_face_owner", nf);
+  prev_vert_owner = host_owner_view("prev_vert_owner", nv);
+  partition();
+  ko::deep_copy(prev_face_owner, face_owner);
+  ko::deep_copy(prev_vert_owner, vert_owner);
+}
+
+void MortonDecomposition::partition() {
+  const Index nleaves = morton_leaves.extent(0);
+  std::vector<Real> cumulative(nleaves+1, 0);
+  for (Index k=0; k<nleaves; ++k) {
+    cumulative[k+1] = cumulative[k] + leaf_weights(k);
+  }
+  const Real total = cumulative[nleaves];
+
+  /// split where the cumulative weight is closest to each rank's share
+  rank_offsets.assign(comm_size+1, 0);
+  rank_offsets[comm_size] = nleaves;
+  for (Int r=1; r<comm_size; ++r) {
+    const Real target = r*total/comm_size;
+    Index k = std::lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+    if (k > 0 && target - cumulative[k-1] < cumulative[k] - target) --k;
+    rank_offsets[r] = std::min(nleaves, std::max(rank_offsets[r-1], k));
+  }
+  rank_work.assign(comm_size, 0);
+  for (Int r=0; r<comm_size; ++r) {
+    rank_work[r] = cumulative[rank_offsets[r+1]] - cumulative[rank_offsets[r]];
+  }
+
+  ko::deep_copy(face_owner, -1);
+  for (Int r=0; r<comm_size; ++r) {
+    for (Index k=rank_offsets[r]; k<rank_offsets[r+1]; ++k) {
+      face_owner(morton_leaves(k)) = r;
+    }
+  }
+  /// leaves are visited in rank order, so each vertex goes to the lowest rank that owns one of its faces
+  ko::deep_copy(vert_owner, -1);
+  for (Index k=0; k<nleaves; ++k) {
+    const Index f = morton_leaves(k);
+    for (Index j=0; j<Index(face_verts.extent(1)); ++j) {
+      const Index v = face_verts(f,j);
+      if (vert_owner(v) < 0) vert_owner(v) = face_owner(f);
+    }
+  }
+
+  const Index nowned = rank_offsets[comm_rank+1] - rank_offsets[comm_rank];
+  owned_faces_host = host_index_view("owned_faces", nowned);
+  for (Index k=0; k<nowned; ++k) {
+    owned_faces_host(k) = morton_leaves(rank_offsets[comm_rank] + k);
+  }
+  Index nowned_verts = 0;
+  for (Index v=0; v<Index(vert_owner.extent(0)); ++v) {
+    if (vert_owner(v) < 0) vert_owner(v) = 0;
+    if (vert_owner(v) == comm_rank) ++nowned_verts;
+  }
+  owned_verts_host = host_index_view("owned_verts", nowned_verts);
+  Index ct = 0;
+  for (Index v=0; v<Index(vert_owner.extent(0)); ++v) {
+    if (vert_owner(v) == comm_rank) owned_verts_host(ct++) = v;
+  }
+  owned_faces = ko::View<Index*,Dev>("owned_faces", nowned);
+  owned_verts = ko::View<Index*,Dev>("owned_verts", nowned_verts);
+  ko::deep_copy(owned_faces, owned_faces_host);
+  ko::deep_copy(owned_verts, owned_verts_host);
+}
+
+void MortonDecomposition::setRankWork(const Real work) {
+  rank_work.resize(comm_size);
+  MPI_Allgather(&work, 1, mpi_real_type(), rank_work.data(), 1, mpi_real_type(), comm);
+  for (Int r=0; r<comm_size; ++r) {
+    const Index n = rank_offsets[r+1] - rank_offsets[r];
+    for (Index k=rank_offsets[r]; k<rank_offsets[r+1]; ++k) {
+      leaf_weights(k) = rank_work[r]/n;
+    }
+  }
+}
+
+void MortonDecomposition::setLeafWork(const ko::View<Real*,Host>& work) {
+  LPM_THROW_IF(work.extent(0) != owned_faces_host.extent(0),
+    "MortonDecomposition::setLeafWork error: work must have one entry per owned leaf.");
+  std::vector<Int> counts(comm_size), displs(comm_size);
+  for (Int r=0; r<comm_size; ++r) {
+    counts[r] = rank_offsets[r+1] - rank_offsets[r];
+    displs[r] = rank_offsets[r];
+  }
+  MPI_Allgatherv(work.data(), counts[comm_rank], mpi_real_type(), leaf_weights.data(), counts.data(),
+    displs.data(), mpi_real_type(), comm);
+  for (Int r=0; r<comm_size; ++r) {
+    rank_work[r] = 0;
+    for (Index k=rank_offsets[r]; k<rank_offsets[r+1]; ++k) {
+      rank_work[r] += leaf_weights(k);
+    }
+  }
+}
+
+Real MortonDecomposition::imbalance() const {
+  const Real total = std::accumulate(rank_work.begin(), rank_work.end(), Real(0));
+  const Real max_work = *std::max_element(rank_work.begin(), rank_work.end());
+  return (total > 0 ? max_work*comm_size/total : 1);
+}
+
+bool MortonDecomposition::rebalance(const Real threshold) {
+  ko::deep_copy(prev_face_owner, face_owner);
+  ko::deep_copy(prev_vert_owner, vert_owner);
+  if (imbalance() <= threshold) return false;
+  partition();
+  return true;
+}
+
+void MortonDecomposition::migrationLists(std::vector<std::vector<Index>>& send,
+  std::vector<std::vector<Index>>& recv, const host_owner_view& old_owner,
+  const host_owner_view& new_owner) const {
+  send.assign(comm_size, std::vector<Index>());
+  recv.assign(comm_size, std::vector<Index>());
+  for (Index i=0; i<Index(new_owner.extent(0)); ++i) {
+    const Int src = old_owner(i);
+    const Int dst = new_owner(i);
+    if (src < 0 || dst < 0 || src == dst) continue;
+    if (src == comm_rank) send[dst].push_back(i);
+    if (dst == comm_rank) recv[src].push_back(i);
+  }
+}
+
+std::string MortonDecomposition::infoString() const {
+  std::ostringstream ss;
+  ss << "MortonDecomposition info: rank " << comm_rank << " of " << comm_size << ", key depth " << key_depth
+     << ", " << owned_faces_host.extent(0) << " of " << morton_leaves.extent(0) << " leaf faces, "
+     << owned_verts_host.extent(0) << " of " << vert_owner.extent(0) << " vertices, imbalance "
+     << imbalance() << "\n";
+  return ss.str();
+}
+
+/// ETI
+template void MortonDecomposition::init(const PolyMesh2d<CubedSphereSeed>& mesh);
+template void MortonDecomposition::init(const PolyMesh2d<IcosTriSphereSeed>& mesh);
+template void MortonDecomposition::init(const PolyMesh2d<QuadRectSeed>& mesh);
+template void MortonDecomposition::init(const PolyMesh2d<TriHexSeed>& mesh);
+
+}
@@ -0,0 +1,131 @@
+#ifndef LPM_DECOMPOSITION_HPP
+#define LPM_DECOMPOSITION_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmOctreeUtil.hpp"
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+namespace Lpm {
+
+/** @brief Spatial partition of a PolyMesh2d's particles over MPI ranks along the octree's Morton order.
+
+  Every rank holds the same mesh connectivity.  Leaf faces are sorted by the Morton keys of their centers
+  (EncodeFunctor, as in Octree::NodeArrayD), and each rank owns one contiguous range of keys, chosen so that
+  all ranks carry about the same total work.  Each vertex is owned by the lowest rank that owns one of its
+  leaf faces, so each rank owns a subset of leaf faces and their vertices.
+
+  A rank's data are valid only at the particles it owns.  When the partition changes, migrate sends each
+  particle's values from its old owner to its new owner with MPI_Alltoallv.
+
+  Typical use:
+    1. decomp.init(mesh) -- partition by leaf count
+    2. each time step: measure this rank's work, then decomp.setRankWork(seconds) (or setLeafWork)
+    3. if (decomp.rebalance(threshold)) {decomp.migrate(mesh); decomp.migrate(field, FaceField); ...}
+*/
+class MortonDecomposition {
+  public:
+    typedef ko::View<Index*,Host> host_index_view;
+    typedef ko::View<Int*,Host> host_owner_view;
+
+    /// depth is the number of octree levels in each Morton key; 0 uses the octree's maximum depth
+    MortonDecomposition(MPI_Comm c=MPI_COMM_WORLD, const Int depth=0);
+
+    /** @brief Sorts the mesh's leaf faces by Morton key and partitions them with unit weights.
+
+      Must be called again if the mesh is refined.
+    */
+    template <typename SeedType>
+    void init(const PolyMesh2d<SeedType>& mesh);
+
+    /** @brief Sets per-leaf weights from this rank's measured work, distributed evenly over its leaves.
+
+      Collective.
+    */
+    void setRankWork(const Real work);
+
+    /** @brief Sets per-leaf weights from measured work at each of this rank's leaves.
+
+      Collective.
+      @param work work(i) is the cost of ownedFacesHost()(i)
+    */
+    void setLeafWork(const ko::View<Real*,Host>& work);
+
+    /// max. rank work / mean rank work, from the most recent setRankWork/setLeafWork (1 = perfect balance)
+    Real imbalance() const;
+
+    /** @brief Repartitions with the current weights if imbalance() > threshold.
+
+      @return true if the partition changed; particle data must then be migrated
+    */
+    bool rebalance(const Real threshold=1.1);
+
+    /** @brief Moves one field's values from each particle's previous owner to its current owner.
+
+      Only rows [0, nverts) or [0, nfaces) are touched; rows not owned by this rank are unchanged.
+      Collective; call after each rebalance that returns true.
+    */
+    template <typename ViewType>
+    void migrate(ViewType& field, const FieldKind kind) const;
+
+    /// migrates the physical coordinates of vertices and faces
+    template <typename SeedType>
+    void migrate(PolyMesh2d<SeedType>& mesh) const;
+
+    inline Int rank() const {return comm_rank;}
+    inline Int nranks() const {return comm_size;}
+
+    /// leaf faces owned by this rank, in Morton order
+    inline host_index_view ownedFacesHost() const {return owned_faces_host;}
+    inline ko::View<Index*,Dev> ownedFaces() const {return owned_faces;}
+
+    /// vertices owned by this rank, in increasing index order
+    inline host_index_view ownedVertsHost() const {return owned_verts_host;}
+    inline ko::View<Index*,Dev> ownedVerts() const {return owned_verts;}
+
+    /// owning rank of each face (-1 for divided faces) and each vertex
+    inline host_owner_view faceOwnersHost() const {return face_owner;}
+    inline host_owner_view vertOwnersHost() const {return vert_owner;}
+
+    /// all leaf faces, in Morton order; rank r owns entries [leafOffset(r), leafOffset(r+1))
+    inline host_index_view mortonLeavesHost() const {return morton_leaves;}
+    inline Index leafOffset(const Int r) const {return rank_offsets[r];}
+
+    std::string infoString() const;
+
+  protected:
+    /// splits the Morton-ordered leaves into nranks ranges of equal weight and updates ownership
+    void partition();
+
+    /// rows this rank sends to (or receives from) each rank when ownership changes from old to new
+    void migrationLists(std::vector<std::vector<Index>>& send, std::vector<std::vector<Index>>& recv,
+      const host_owner_view& old_owner, const host_owner_view& new_owner) const;
+
+    MPI_Comm comm;
+    Int comm_rank;
+    Int comm_size;
+    Int key_depth;
+
+    host_index_view morton_leaves;
+    ko::View<Real*,Host> leaf_weights;
+    std::vector<Index> rank_offsets;
+    std::vector<Real> rank_work;
+
+    ko::View<Index**,Host> face_verts; ///< face vertices, (nfaces, nfaceverts)
+    host_owner_view face_owner;
+    host_owner_view vert_owner;
+    host_owner_view prev_face_owner;
+    host_owner_view prev_vert_owner;
+
+    host_index_view owned_faces_host;
+    host_index_view owned_verts_host;
+    ko::View<Index*,Dev> owned_faces;
+    ko::View<Index*,Dev> owned_verts;
+};
+
+}
+#endif
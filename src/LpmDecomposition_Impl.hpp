@@ -0,0 +1,63 @@
+#ifndef LPM_DECOMPOSITION_IMPL_HPP
+#define LPM_DECOMPOSITION_IMPL_HPP
+
+#include "LpmDecomposition.hpp"
+#include "LpmUtilities.hpp"
+#include <vector>
+
+namespace Lpm {
+
+template <typename ViewType>
+void MortonDecomposition::migrate(ViewType& field, const FieldKind kind) const {
+  LPM_THROW_IF(kind == EdgeField, "MortonDecomposition::migrate error: edges are not partitioned.");
+  const auto& old_owner = (kind == FaceField ? prev_face_owner : prev_vert_owner);
+  const auto& new_owner = (kind == FaceField ? face_owner : vert_owner);
+  std::vector<std::vector<Index>> send, recv;
+  migrationLists(send, recv, old_owner, new_owner);
+
+  const Int ncols = (ViewType::Rank == 1 ? 1 : field.extent(1));
+  std::vector<Int> scounts(comm_size), sdispls(comm_size), rcounts(comm_size), rdispls(comm_size);
+  Int nsend = 0;
+  Int nrecv = 0;
+  for (Int r=0; r<comm_size; ++r) {
+    scounts[r] = ncols*send[r].size();
+    sdispls[r] = nsend;
+    nsend += scounts[r];
+    rcounts[r] = ncols*recv[r].size();
+    rdispls[r] = nrecv;
+    nrecv += rcounts[r];
+  }
+
+  auto field_host = ko::create_mirror_view(field);
+  ko::deep_copy(field_host, field);
+  std::vector<Real> sbuf(nsend);
+  std::vector<Real> rbuf(nrecv);
+  for (Int r=0; r<comm_size; ++r) {
+    for (size_t k=0; k<send[r].size(); ++k) {
+      for (Int j=0; j<ncols; ++j) {
+        sbuf[sdispls[r] + k*ncols + j] = field_host.access(send[r][k], j);
+      }
+    }
+  }
+  MPI_Alltoallv(sbuf.data(), scounts.data(), sdispls.data(), mpi_real_type(),
+    rbuf.data(), rcounts.data(), rdispls.data(), mpi_real_type(), comm);
+  for (Int r=0; r<comm_size; ++r) {
+    for (size_t k=0; k<recv[r].size(); ++k) {
+      for (Int j=0; j<ncols; ++j) {
+        field_host.access(recv[r][k], j) = rbuf[rdispls[r] + k*ncols + j];
+      }
+    }
+  }
+  ko::deep_copy(field, field_host);
+}
+
+template <typename SeedType>
+void MortonDecomposition::migrate(PolyMesh2d<SeedType>& mesh) const {
+  migrate(mesh.physVerts.crds, VertexField);
+  migrate(mesh.physFaces.crds, FaceField);
+  mesh.physVerts.updateHost();
+  mesh.physFaces.updateHost();
+}
+
+}
+#endif
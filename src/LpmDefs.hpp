@@ -9,6 +9,8 @@
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <algorithm>
+#include <string>
+#include <type_traits>
 #include "LpmConfig.h"
 #include "Kokkos_Core.hpp"
 
@@ -46,6 +48,41 @@ typedef ko::LayoutLeft Layout;
 typedef ko::LayoutRight Layout;
 #endif
 
+/** @brief Coordinate storage policy: array of structures.
+
+  Components of each vector are contiguous, e.g., x0 y0 z0 x1 y1 z1 ...
+*/
+struct AoSCrdLayout {
+  typedef ko::LayoutRight array_layout;
+  static std::string idString() {return "AoS";}
+};
+
+/** @brief Coordinate storage policy: structure of arrays.
+
+  Each component is contiguous across all vectors, e.g., x0 x1 ... y0 y1 ... z0 z1 ...,
+  so that inner loops over particles use unit-stride loads.
+*/
+struct SoACrdLayout {
+  typedef ko::LayoutLeft array_layout;
+  static std::string idString() {return "SoA";}
+};
+
+/** @brief Coordinate storage policy used by all Geometry vector views (and therefore by Coords).
+
+  Selected at configure time, independent of the execution space:
+    -DLPM_USE_SOA_COORDS=ON forces SoA, -DLPM_USE_AOS_COORDS=ON forces AoS.
+  Otherwise, CUDA builds default to SoA and host builds default to AoS.
+*/
+#if defined(LPM_USE_SOA_COORDS)
+typedef SoACrdLayout CrdLayout;
+#elif defined(LPM_USE_AOS_COORDS)
+typedef AoSCrdLayout CrdLayout;
+#elif defined(LPM_HAVE_CUDA)
+typedef SoACrdLayout CrdLayout;
+#else
+typedef AoSCrdLayout CrdLayout;
+#endif
+
 /// Execution spaces
 typedef ko::DefaultExecutionSpace DevExe;
 typedef ko::HostSpace::execution_space HostExe;
@@ -69,13 +106,29 @@ typedef ko::Device<HostExe, HostMem> Host;
   ko::View<typename VT::const_value_type*, ko::LayoutStride, typename VT::device_type, ko::MemoryTraits<ko::Unmanaged>>
   const_slice(const VT& v, Int i) {return ko::subview(v, i, ko::ALL());}
 #else
+  /// 1d slice of a row-major array (raw pointer)
   template <typename VT> KOKKOS_FORCEINLINE_FUNCTION
-  typename VT::value_type*
+  typename std::enable_if<std::is_same<typename VT::array_layout, ko::LayoutRight>::value,
+    typename VT::value_type*>::type
   slice(const VT& v, Int i) {return v.data() + v.extent(1)*i;}
 
+  /// 1d slice of a column-major (SoA) array (strided view)
   template <typename VT> KOKKOS_FORCEINLINE_FUNCTION
-  typename VT::const_value_type*
+  typename std::enable_if<!std::is_same<typename VT::array_layout, ko::LayoutRight>::value,
+    ko::View<typename VT::value_type*, ko::LayoutStride, typename VT::device_type,
+    ko::MemoryTraits<ko::Unmanaged>>>::type
+  slice(const VT& v, Int i) {return ko::subview(v, i, ko::ALL());}
+
+  template <typename VT> KOKKOS_FORCEINLINE_FUNCTION
+  typename std::enable_if<std::is_same<typename VT::array_layout, ko::LayoutRight>::value,
+    typename VT::const_value_type*>::type
   const_slice(const VT& v, Int i) {return v.data() + v.extent(1)*i;}
+
+  template <typename VT> KOKKOS_FORCEINLINE_FUNCTION
+  typename std::enable_if<!std::is_same<typename VT::array_layout, ko::LayoutRight>::value,
+    ko::View<typename VT::const_value_type*, ko::LayoutStride, typename VT::device_type,
+    ko::MemoryTraits<ko::Unmanaged>>>::type
+  const_slice(const VT& v, Int i) {return ko::subview(v, i, ko::ALL());}
 #endif
 
 /// Pi
@@ -51,6 +51,18 @@ void Edges::initFromSeed(const MeshSeed<SeedType>& seed) {
   _hnLeaves() = SeedType::nedges;
 }
 
+void Edges::initFromCache(const MeshCacheReader& cache) {
+  LPM_THROW_IF(_nmax < cache.nEdges(), "Edges::initFromCache error: not enough memory.");
+  cache.fill(_ho, CacheEdgeOrigs);
+  cache.fill(_hd, CacheEdgeDests);
+  cache.fill(_hl, CacheEdgeLefts);
+  cache.fill(_hr, CacheEdgeRights);
+  cache.fill(_hp, CacheEdgeParents);
+  cache.fill(_hk, CacheEdgeKids);
+  _nh() = cache.nEdges();
+  _hnLeaves() = cache.nEdgeLeaves();
+}
+
 
 template <typename Geo> void Edges::divide(const Index ind, Coords<Geo>& crds, Coords<Geo>& lagcrds) {
   assert(ind < _nh());
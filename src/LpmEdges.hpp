@@ -188,6 +188,20 @@ class Edges {
     template <typename SeedType>
     void initFromSeed(const MeshSeed<SeedType>& seed);
 
+    /** Initialize a set of Edges from a mesh cache file
+
+    \hostfn
+
+    \param cache mapped mesh cache file
+    */
+    void initFromCache(const MeshCacheReader& cache);
+
+    /** Number of leaf edges.
+
+    \hostfn
+    */
+    inline Index nLeavesHost() const {return _hnLeaves();}
+
     /** Return the requested child (0 or 1) of an edge.
 
     \hostfn
@@ -62,6 +62,22 @@ void Faces<FaceKind>::initFromSeed(const MeshSeed<SeedType>& seed) {
   if (seed.idString() == "UnitDiskSeed") _hostkids(0,1) = 0;
 }
 
+template <typename FaceKind>
+void Faces<FaceKind>::initFromCache(const MeshCacheReader& cache) {
+  LPM_THROW_IF(cache.nfaceverts() != FaceKind::nverts, "Faces::initFromCache error: face kind mismatch.");
+  LPM_THROW_IF(_nmax < cache.nFaces(), "Faces::initFromCache error: not enough memory.");
+  cache.fill(_hostverts, CacheFaceVerts);
+  cache.fill(_hostedges, CacheFaceEdges);
+  cache.fill(_hostcenters, CacheFaceCenters);
+  cache.fill(_hlevel, CacheFaceLevels);
+  cache.fill(_hostparent, CacheFaceParents);
+  cache.fill(_hostkids, CacheFaceKids);
+  cache.fill(_hmask, CacheFaceMask);
+  cache.fill(_hostarea, CacheFaceArea);
+  _nh() = cache.nFaces();
+  _hnLeaves() = cache.nFaceLeaves();
+}
+
 template <typename FaceKind>
 Real Faces<FaceKind>::surfAreaHost() const {
   Real result = 0;
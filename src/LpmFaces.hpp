@@ -290,6 +290,14 @@ template <typename FaceKind> class Faces {
     template <typename SeedType>
     void initFromSeed(const MeshSeed<SeedType>& seed);
 
+    /** @brief Initialize a collection of Faces from a mesh cache file
+
+    @hostfn
+
+    @param cache mapped mesh cache file
+    */
+    void initFromCache(const MeshCacheReader& cache);
+
     /** @brief Returns the number of leaves in the Faces tree.
 
     @hostfn
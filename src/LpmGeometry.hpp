@@ -11,6 +11,23 @@
 
 namespace Lpm {
 
+/** @brief Uniform accessor for rows of vector-valued views.
+
+  Copies v(i,:) into a register-resident tuple.  Kernels use this instead of pointers or subviews
+  so that the same code is correct (and vectorizes) for both AoSCrdLayout and SoACrdLayout storage.
+
+  @param v view of vectors, e.g., Geo::crd_view_type
+  @param i row index
+*/
+template <int ndim, typename VT> KOKKOS_FORCEINLINE_FUNCTION
+ko::Tuple<Real,ndim> vec_at(const VT& v, const Index& i) {
+  ko::Tuple<Real,ndim> result;
+  for (Short j=0; j<ndim; ++j) {
+    result[j] = v(i,j);
+  }
+  return result;
+}
+
 /**
   Required members:
     Int ndim : number of dimensions in Euclidean space
@@ -25,8 +42,8 @@ namespace Lpm {
 struct PlaneGeometry {
   static std::string idString() {return "PlaneGeometry";}
   static constexpr Int ndim = 2;
-  typedef ko::View<Real*[ndim],Dev> crd_view_type;
-  typedef ko::View<Real*[ndim],Dev> vec_view_type;
+  typedef ko::View<Real*[ndim],CrdLayout::array_layout,Dev> crd_view_type;
+  typedef ko::View<Real*[ndim],CrdLayout::array_layout,Dev> vec_view_type;
 
   template <typename V> KOKKOS_INLINE_FUNCTION
   static void setzero(V v) {
@@ -204,8 +221,8 @@ struct SphereGeometry {
   static std::string idString() {return "SphereGeometry";}
   static constexpr Int ndim = 3; ///<  number of components in a position vector
 
-  typedef ko::View<Real*[ndim],Dev> crd_view_type; ///< vector array type for, e.g., position and velocity
-  typedef ko::View<Real*[ndim],Dev> vec_view_type;
+  typedef ko::View<Real*[ndim],CrdLayout::array_layout,Dev> crd_view_type; ///< vector array type for, e.g., position and velocity
+  typedef ko::View<Real*[ndim],CrdLayout::array_layout,Dev> vec_view_type;
 
   /** \brief Returns the latitude of a point represented in Cartesian coordinates.
 
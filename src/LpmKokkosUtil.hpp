@@ -60,6 +60,14 @@ template <typename T, int ndim> struct Tuple : public Array<T,ndim> {
     }
   }
 
+  KOKKOS_FORCEINLINE_FUNCTION
+  T& operator[] (const int& i) {
+    return this->m_internal_implementation_private_member_data[i];}
+
+  KOKKOS_FORCEINLINE_FUNCTION
+  const T& operator[] (const int& i) const {
+    return this->m_internal_implementation_private_member_data[i];}
+
   KOKKOS_INLINE_FUNCTION
   volatile T& operator[] (const int& i) volatile {
     return this->m_internal_implementation_private_member_data[i];}
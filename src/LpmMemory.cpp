@@ -0,0 +1,223 @@
+#include "LpmMemory.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace Lpm {
+
+std::string memCategoryString(const MemCategory cat) {
+  std::string result;
+  switch (cat) {
+    case (MemMesh) : {
+      result = "mesh";
+      break;
+    }
+    case (MemFields) : {
+      result = "fields";
+      break;
+    }
+    case (MemIntegrator) : {
+      result = "integrator";
+      break;
+    }
+    case (MemTree) : {
+      result = "tree";
+      break;
+    }
+    case (MemRemap) : {
+      result = "remap";
+      break;
+    }
+    default : {
+      result = "other";
+      break;
+    }
+  }
+  return result;
+}
+
+/// category of the calling thread's innermost MemoryCategoryScope
+static MemCategory& thread_category() {
+  static thread_local MemCategory cat = MemNCategories;
+  return cat;
+}
+
+MemoryCategoryScope::MemoryCategoryScope(const MemCategory cat) : prev(thread_category()) {
+  thread_category() = cat;
+}
+
+MemoryCategoryScope::~MemoryCategoryScope() {
+  thread_category() = prev;
+}
+
+MemCategory MemoryCategoryScope::current() {
+  return thread_category();
+}
+
+/// callbacks that were active before MemoryAccounting::enable
+static ko::Tools::Experimental::EventSet& prev_callbacks() {
+  static ko::Tools::Experimental::EventSet events;
+  return events;
+}
+
+static void lpm_allocate_data(const ko::Tools::SpaceHandle handle, const char* label, const void* ptr,
+  const uint64_t size) {
+  MemoryAccounting::instance().allocate(handle.name, label, ptr, size);
+  if (prev_callbacks().allocate_data) prev_callbacks().allocate_data(handle, label, ptr, size);
+}
+
+static void lpm_deallocate_data(const ko::Tools::SpaceHandle handle, const char* label, const void* ptr,
+  const uint64_t size) {
+  MemoryAccounting::instance().deallocate(handle.name, ptr, size);
+  if (prev_callbacks().deallocate_data) prev_callbacks().deallocate_data(handle, label, ptr, size);
+}
+
+MemoryAccounting::MemoryAccounting() : is_enabled(false), report_at_finalize(true) {
+  const std::string mesh_labels[] = {"crds", "n", "origs", "dests", "lefts", "rights", "parent", "kids",
+    "nLeaves", "faceverts", "faceedges", "centers", "area", "mask", "level"};
+  const std::string field_labels[] = {"relVortVerts", "absVortVerts", "streamFnVerts", "velocityVerts",
+    "relVortFaces", "absVortFaces", "streamFnFaces", "velocityFaces", "ntracers",
+    "relative_vorticity_vertices", "potential_vorticity_vertices", "divergence_vertices",
+    "fluid_sfc_hght_vertices", "fluid_depth_vertices", "bottom_topography_vertices", "velocity_vertices",
+    "relative_vorticity_faces", "potential_vorticity_faces", "divergence_faces", "fluid_sfc_hgt_faces",
+    "fluid_depth_faces", "bottom_topography_faces", "mass_faces", "velocity_faces"};
+  const std::string tree_labels[] = {"sorted_pts", "pt_in_leaf", "pt_orig_id", "base_address",
+    "nnodes_per_level", "bbox", "node_keys", "node_kids", "node_parents", "node_neighbors", "node_pt_inds",
+    "nverts_at_node", "vertex_address", "vertex_flags", "vertex_owners", "ParentLUT", "ChildLUT",
+    "NeighborsAtVertexLUT"};
+  const std::string remap_labels[] = {"source_coords", "source_values", "neighbor_lists",
+    "neighborhood_radii", "regrid_crds", "regrid_psi", "regrid_relvort", "regrid_absvort", "regrid_velocity"};
+  for (const auto& l : mesh_labels) label_cats[l] = MemMesh;
+  for (const auto& l : field_labels) label_cats[l] = MemFields;
+  for (const auto& l : tree_labels) label_cats[l] = MemTree;
+  for (const auto& l : remap_labels) label_cats[l] = MemRemap;
+
+  ko::push_finalize_hook([] () {
+    auto& mem = MemoryAccounting::instance();
+    if (mem.is_enabled && mem.report_at_finalize) {
+      std::cout << mem.breakdownString();
+    }
+    mem.disable();
+  });
+}
+
+MemoryAccounting& MemoryAccounting::instance() {
+  static MemoryAccounting mem;
+  return mem;
+}
+
+void MemoryAccounting::enable() {
+  LPM_THROW_IF(!ko::is_initialized(), "MemoryAccounting::enable error: Kokkos is not initialized.");
+  if (is_enabled) return;
+  prev_callbacks() = ko::Tools::Experimental::get_callbacks();
+  ko::Tools::Experimental::set_allocate_data_callback(lpm_allocate_data);
+  ko::Tools::Experimental::set_deallocate_data_callback(lpm_deallocate_data);
+  is_enabled = true;
+}
+
+void MemoryAccounting::disable() {
+  if (!is_enabled) return;
+  ko::Tools::Experimental::set_allocate_data_callback(prev_callbacks().allocate_data);
+  ko::Tools::Experimental::set_deallocate_data_callback(prev_callbacks().deallocate_data);
+  is_enabled = false;
+}
+
+void MemoryAccounting::setLabelCategory(const std::string& label, const MemCategory cat) {
+  std::lock_guard<std::mutex> lock(mtx);
+  label_cats[label] = cat;
+}
+
+MemCategory MemoryAccounting::labelCategory(const std::string& label) const {
+  const std::string suffix = "_mirror";
+  auto it = label_cats.find(label);
+  if (it == label_cats.end() && label.size() > suffix.size() &&
+      label.compare(label.size() - suffix.size(), suffix.size(), suffix) == 0) {
+    it = label_cats.find(label.substr(0, label.size() - suffix.size()));
+  }
+  return (it == label_cats.end() ? MemOther : it->second);
+}
+
+void MemoryAccounting::allocate(const std::string& space, const std::string& label, const void* ptr,
+  const uint64_t size) {
+  std::lock_guard<std::mutex> lock(mtx);
+  const MemCategory scope_cat = MemoryCategoryScope::current();
+  const MemCategory cat = (scope_cat == MemNCategories ? labelCategory(label) : scope_cat);
+  live_allocs[ptr] = Record{cat, space, size};
+  auto& u = usages[std::make_pair(space, Int(cat))];
+  u.live += size;
+  u.high_water = std::max(u.high_water, u.live);
+  ++u.nallocs;
+  auto& t = space_totals[space];
+  t.live += size;
+  t.high_water = std::max(t.high_water, t.live);
+  ++t.nallocs;
+}
+
+void MemoryAccounting::deallocate(const std::string& space, const void* ptr, const uint64_t size) {
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto it = live_allocs.find(ptr);
+  if (it == live_allocs.end()) return;
+  const Record& rec = it->second;
+  auto& u = usages[std::make_pair(rec.space, Int(rec.cat))];
+  u.live -= std::min(u.live, rec.size);
+  auto& t = space_totals[rec.space];
+  t.live -= std::min(t.live, rec.size);
+  live_allocs.erase(it);
+}
+
+MemoryAccounting::Usage MemoryAccounting::usage(const MemCategory cat, const std::string& space) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto it = usages.find(std::make_pair(space, Int(cat)));
+  return (it == usages.end() ? Usage() : it->second);
+}
+
+MemoryAccounting::Usage MemoryAccounting::spaceUsage(const std::string& space) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto it = space_totals.find(space);
+  return (it == space_totals.end() ? Usage() : it->second);
+}
+
+uint64_t MemoryAccounting::liveBytes(const MemCategory cat) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  uint64_t result = 0;
+  for (const auto& u : usages) {
+    if (u.first.second == Int(cat)) result += u.second.live;
+  }
+  return result;
+}
+
+void MemoryAccounting::reset() {
+  std::lock_guard<std::mutex> lock(mtx);
+  live_allocs.clear();
+  usages.clear();
+  space_totals.clear();
+}
+
+std::string MemoryAccounting::breakdownString() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  std::ostringstream ss;
+  const Real mb = 1.0/(1024*1024);
+  const Int nw = 16;
+  const Int fw = 16;
+  ss << "Lpm memory (MB):\n";
+  ss << std::left << std::setw(nw) << "space" << std::setw(nw) << "category" << std::right
+     << std::setw(fw) << "live" << std::setw(fw) << "high water" << std::setw(10) << "allocs" << "\n";
+  ss << std::fixed << std::setprecision(3);
+  for (const auto& t : space_totals) {
+    for (Int c=0; c<MemNCategories; ++c) {
+      const auto it = usages.find(std::make_pair(t.first, c));
+      if (it == usages.end()) continue;
+      ss << std::left << std::setw(nw) << t.first << std::setw(nw) << memCategoryString(MemCategory(c))
+         << std::right << std::setw(fw) << it->second.live*mb << std::setw(fw) << it->second.high_water*mb
+         << std::setw(10) << it->second.nallocs << "\n";
+    }
+    ss << std::left << std::setw(nw) << t.first << std::setw(nw) << "total" << std::right
+       << std::setw(fw) << t.second.live*mb << std::setw(fw) << t.second.high_water*mb
+       << std::setw(10) << t.second.nallocs << "\n";
+  }
+  ss << "max resident memory: " << get_memusage() << " MB\n";
+  return ss.str();
+}
+
+}
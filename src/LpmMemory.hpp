@@ -0,0 +1,124 @@
+#ifndef LPM_MEMORY_HPP
+#define LPM_MEMORY_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "Kokkos_Core.hpp"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace Lpm {
+
+/// Subsystems used to group View allocations in MemoryAccounting
+enum MemCategory {MemMesh, MemFields, MemIntegrator, MemTree, MemRemap, MemOther, MemNCategories};
+
+std::string memCategoryString(const MemCategory cat);
+
+/** @brief Process-wide accounting of live View bytes by subsystem and memory space.
+
+  Once enabled, every Kokkos allocation and deallocation is reported to this class through the
+  Kokkos Tools data callbacks (previously installed callbacks, e.g. from a loaded tool library, are
+  still called).  Each allocation is assigned a category:
+
+    1. the category of the calling thread's innermost MemoryCategoryScope, if one is open;
+    2. otherwise, the category registered for its label (see setLabelCategory); host mirrors
+      ("<label>_mirror") share the category of their source View;
+    3. otherwise, MemOther.
+
+  Live bytes, high-water marks, and allocation counts are kept for each (category, memory space)
+  pair and for each memory space in total.  Only allocations made after enable() are counted.
+
+  Defaults cover the labels used by Coords, Edges, Faces (mesh), BVESphere and SWE fields, Octree
+  trees, and GMLS remapping; BVERK4 and SWERK4 allocate their stage arrays inside integrator scopes.
+*/
+class MemoryAccounting {
+  public:
+    /// usage counters for one category in one memory space
+    struct Usage {
+      uint64_t live;
+      uint64_t high_water;
+      Int nallocs;
+
+      Usage() : live(0), high_water(0), nallocs(0) {}
+    };
+
+    static MemoryAccounting& instance();
+
+    /// installs the Kokkos Tools callbacks; must be called after Kokkos::initialize
+    void enable();
+
+    /// restores the callbacks that were active before enable()
+    void disable();
+
+    inline bool enabled() const {return is_enabled;}
+
+    /// assigns allocations labeled label to cat (when no scope is open)
+    void setLabelCategory(const std::string& label, const MemCategory cat);
+
+    /// usage of one category in one memory space (e.g., "Host", "Cuda")
+    Usage usage(const MemCategory cat, const std::string& space) const;
+
+    /// usage of one memory space summed over categories; high_water is the high-water mark of the total
+    Usage spaceUsage(const std::string& space) const;
+
+    /// live bytes of one category summed over memory spaces
+    uint64_t liveBytes(const MemCategory cat) const;
+
+    /// clears all counters and high-water marks; allocations that are still live are no longer tracked
+    void reset();
+
+    /// table of live and high-water bytes per memory space and category
+    std::string breakdownString() const;
+
+    /// if true, breakdownString is printed to std::cout at Kokkos::finalize (default: true)
+    inline void setReportAtFinalize(const bool r) {report_at_finalize = r;}
+
+    /// callback entry points (called by Kokkos Tools)
+    void allocate(const std::string& space, const std::string& label, const void* ptr, const uint64_t size);
+    void deallocate(const std::string& space, const void* ptr, const uint64_t size);
+
+  protected:
+    MemoryAccounting();
+
+    /// category of an allocation outside any MemoryCategoryScope
+    MemCategory labelCategory(const std::string& label) const;
+
+    struct Record {
+      MemCategory cat;
+      std::string space;
+      uint64_t size;
+    };
+
+    mutable std::mutex mtx;
+    std::unordered_map<const void*, Record> live_allocs;
+    std::map<std::pair<std::string, Int>, Usage> usages;
+    std::map<std::string, Usage> space_totals;
+    std::map<std::string, MemCategory> label_cats;
+    bool is_enabled;
+    bool report_at_finalize;
+};
+
+/** @brief Assigns all View allocations made by the calling thread to a category for the lifetime
+  of the object.  Scopes nest; the innermost scope wins.
+*/
+class MemoryCategoryScope {
+  public:
+    MemoryCategoryScope(const MemCategory cat);
+    ~MemoryCategoryScope();
+
+    MemoryCategoryScope(const MemoryCategoryScope&) = delete;
+    MemoryCategoryScope& operator=(const MemoryCategoryScope&) = delete;
+
+    /// category of the calling thread's innermost scope, or MemNCategories if none is open
+    static MemCategory current();
+
+  protected:
+    MemCategory prev;
+};
+
+}
+#endif
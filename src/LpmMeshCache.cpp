@@ -0,0 +1,156 @@
+#include "LpmMeshCache.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmTimer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+namespace Lpm {
+
+static const char mesh_cache_magic[8] = "LPMMESH";
+
+std::string meshCacheFilename(const std::string& seed_id, const Int depth, const std::string& cache_dir) {
+  std::ostringstream ss;
+  if (!cache_dir.empty()) {
+    ss << cache_dir << (cache_dir.back() == '/' ? "" : "/");
+  }
+  ss << seed_id << "_depth" << depth << ".lpmcache";
+  return ss.str();
+}
+
+MeshCacheReader::MeshCacheReader(const std::string& fn) : map_ptr(NULL), map_size(0), fname(fn) {
+  const int fd = open(fname.c_str(), O_RDONLY);
+  LPM_THROW_IF(fd < 0, "MeshCacheReader error: cannot open file " << fname);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(MeshCacheHeader)) {
+    close(fd);
+    LPM_THROW_IF(true, "MeshCacheReader error: " << fname << " is not a mesh cache file.");
+  }
+  map_size = st.st_size;
+  map_ptr = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  LPM_THROW_IF(map_ptr == MAP_FAILED, "MeshCacheReader error: mmap failed for " << fname);
+  std::memcpy(&header, map_ptr, sizeof(MeshCacheHeader));
+
+  bool valid = (std::strncmp(header.magic, mesh_cache_magic, 8) == 0 && header.version == mesh_cache_version &&
+    header.nverts > 0 && header.nedges > 0 && header.nfaces > 0);
+  for (Int k=0; k<CacheNArrays && valid; ++k) {
+    const std::int64_t expected_rows = (k <= CacheLagVerts ? header.nverts :
+      (k <= CacheEdgeKids ? header.nedges : header.nfaces));
+    valid = (header.nrows[k] == expected_rows && header.offset[k] >= std::int64_t(sizeof(MeshCacheHeader)) &&
+      header.offset[k] % mesh_cache_alignment == 0 &&
+      size_t(header.offset[k] + header.nrows[k]*header.ncols[k]*header.elem_size[k]) <= map_size);
+  }
+  if (!valid) {
+    munmap(map_ptr, map_size);
+    map_ptr = NULL;
+    LPM_THROW_IF(true, "MeshCacheReader error: " << fname << " is truncated or has an incompatible format.");
+  }
+}
+
+MeshCacheReader::~MeshCacheReader() {
+  if (map_ptr) munmap(map_ptr, map_size);
+}
+
+/// appends rows [0,nrows) of a host view to a mesh cache file, row-major, and records its table entry
+template <typename HostViewType>
+void write_cache_array(std::ofstream& os, MeshCacheHeader& header, const MeshCacheArray& arr,
+  const HostViewType& hv, const Index nrows) {
+  typedef typename HostViewType::non_const_value_type value_type;
+  const Int ncols = (HostViewType::rank == 1 ? 1 : hv.extent(1));
+  std::int64_t pos = os.tellp();
+  const std::int64_t pad = (mesh_cache_alignment - pos % mesh_cache_alignment) % mesh_cache_alignment;
+  const char zeros[mesh_cache_alignment] = {0};
+  os.write(zeros, pad);
+  header.offset[arr] = pos + pad;
+  header.nrows[arr] = nrows;
+  header.ncols[arr] = ncols;
+  header.elem_size[arr] = sizeof(value_type);
+  const bool packed = (HostViewType::rank == 1 ? hv.stride_0() == 1 :
+    (hv.stride_0() == size_t(ncols) && hv.stride_1() == 1));
+  if (packed) {
+    os.write(reinterpret_cast<const char*>(hv.data()), size_t(nrows)*ncols*sizeof(value_type));
+  }
+  else {
+    /// not std::vector, which has no data() for bool (the face mask)
+    const size_t n = size_t(nrows)*ncols;
+    std::unique_ptr<value_type[]> buf(new value_type[n]);
+    for (Index i=0; i<nrows; ++i) {
+      for (Int j=0; j<ncols; ++j) {
+        buf[size_t(i)*ncols + j] = hv.access(i,j);
+      }
+    }
+    os.write(reinterpret_cast<const char*>(buf.get()), n*sizeof(value_type));
+  }
+}
+
+template <typename SeedType>
+void writeMeshCache(const std::string& fname, const PolyMesh2d<SeedType>& mesh) {
+  LPM_TIMER_SCOPE("writeMeshCache");
+  MeshCacheHeader header;
+  std::memset(&header, 0, sizeof(MeshCacheHeader));
+  std::memcpy(header.magic, mesh_cache_magic, 8);
+  header.version = mesh_cache_version;
+  header.ndim = SeedType::geo::ndim;
+  header.nfaceverts = SeedType::nfaceverts;
+  header.depth = mesh.baseTreeDepth;
+  const std::string id = SeedType::idString();
+  LPM_THROW_IF(id.size() >= sizeof(header.seed_id), "writeMeshCache error: seed id too long.");
+  std::strncpy(header.seed_id, id.c_str(), sizeof(header.seed_id)-1);
+  const Index nv = mesh.nvertsHost();
+  const Index ne = mesh.nedgesHost();
+  const Index nf = mesh.nfacesHost();
+  header.nverts = nv;
+  header.nedges = ne;
+  header.nfaces = nf;
+  header.nedge_leaves = mesh.edges.nLeavesHost();
+  header.nface_leaves = mesh.faces.nLeavesHost();
+
+  /// written to a temporary file and renamed when complete, so readers never see a partial file
+  const std::string tmp_fname = fname + ".tmp." + std::to_string(getpid());
+  std::ofstream os(tmp_fname, std::ios::binary | std::ios::trunc);
+  LPM_THROW_IF(!os.is_open(), "writeMeshCache error: cannot open file " << tmp_fname);
+  /// placeholder header; rewritten once the array offsets are known
+  os.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+  write_cache_array(os, header, CachePhysVerts, mesh.physVerts.getHostCrdView(), nv);
+  write_cache_array(os, header, CacheLagVerts, mesh.lagVerts.getHostCrdView(), nv);
+  write_cache_array(os, header, CacheEdgeOrigs, mesh.edges.getOrigsHost(), ne);
+  write_cache_array(os, header, CacheEdgeDests, mesh.edges.getDestsHost(), ne);
+  write_cache_array(os, header, CacheEdgeLefts, mesh.edges.getLeftsHost(), ne);
+  write_cache_array(os, header, CacheEdgeRights, mesh.edges.getRightsHost(), ne);
+  write_cache_array(os, header, CacheEdgeParents, mesh.edges.getParentsHost(), ne);
+  write_cache_array(os, header, CacheEdgeKids, mesh.edges.getKidsHost(), ne);
+  write_cache_array(os, header, CacheFaceVerts, mesh.faces.getVertsHost(), nf);
+  write_cache_array(os, header, CacheFaceEdges, mesh.faces.getEdgesHost(), nf);
+  write_cache_array(os, header, CacheFaceCenters, mesh.faces.getCentersHost(), nf);
+  write_cache_array(os, header, CacheFaceLevels, mesh.faces.getLevelsHost(), nf);
+  write_cache_array(os, header, CacheFaceParents, mesh.faces.getParentsHost(), nf);
+  write_cache_array(os, header, CacheFaceKids, mesh.faces.getKidsHost(), nf);
+  write_cache_array(os, header, CacheFaceMask, mesh.faces.getMaskHost(), nf);
+  write_cache_array(os, header, CacheFaceArea, mesh.faces.getAreaHost(), nf);
+  write_cache_array(os, header, CachePhysFaces, mesh.physFaces.getHostCrdView(), nf);
+  write_cache_array(os, header, CacheLagFaces, mesh.lagFaces.getHostCrdView(), nf);
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+  os.close();
+  if (os.fail() || std::rename(tmp_fname.c_str(), fname.c_str()) != 0) {
+    std::remove(tmp_fname.c_str());
+    LPM_THROW_IF(true, "writeMeshCache error: write failed for " << fname);
+  }
+}
+
+/// ETI
+template void writeMeshCache(const std::string& fname, const PolyMesh2d<TriHexSeed>& mesh);
+template void writeMeshCache(const std::string& fname, const PolyMesh2d<QuadRectSeed>& mesh);
+template void writeMeshCache(const std::string& fname, const PolyMesh2d<IcosTriSphereSeed>& mesh);
+template void writeMeshCache(const std::string& fname, const PolyMesh2d<CubedSphereSeed>& mesh);
+template void writeMeshCache(const std::string& fname, const PolyMesh2d<UnitDiskSeed>& mesh);
+
+}
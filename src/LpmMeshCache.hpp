@@ -0,0 +1,157 @@
+#ifndef LPM_MESH_CACHE_HPP
+#define LPM_MESH_CACHE_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace Lpm {
+
+/** @file Binary cache of uniformly refined PolyMesh2d meshes.
+
+  treeInit refines a MeshSeed one face at a time on the host; at high depth this dominates startup.
+  A mesh cache file stores the result of treeInit (coordinates, edges, faces, and the edge and face trees)
+  as raw arrays, so that later runs can map the file into memory and copy it directly into the host mirrors
+  of a PolyMesh2d.
+
+  File layout: a fixed-size MeshCacheHeader followed by one array per MeshCacheArray,
+  each stored row-major and aligned to mesh_cache_alignment bytes.
+  Cache files are not portable between machines with different endianness or integer sizes;
+  the header records element sizes so that a mismatch is detected rather than misread.
+*/
+
+/// Arrays stored in a mesh cache file, in file order
+enum MeshCacheArray {CachePhysVerts, CacheLagVerts,
+  CacheEdgeOrigs, CacheEdgeDests, CacheEdgeLefts, CacheEdgeRights, CacheEdgeParents, CacheEdgeKids,
+  CacheFaceVerts, CacheFaceEdges, CacheFaceCenters, CacheFaceLevels, CacheFaceParents, CacheFaceKids,
+  CacheFaceMask, CacheFaceArea, CachePhysFaces, CacheLagFaces, CacheNArrays};
+
+static constexpr std::int32_t mesh_cache_version = 1;
+static constexpr std::int64_t mesh_cache_alignment = 64;
+
+/// Fixed-size header at the start of each mesh cache file
+struct MeshCacheHeader {
+  char magic[8]; ///< "LPMMESH" + null
+  std::int32_t version; ///< mesh_cache_version
+  std::int32_t ndim; ///< spatial dimension of the mesh coordinates
+  std::int32_t nfaceverts; ///< number of vertices per face
+  std::int32_t depth; ///< tree depth passed to treeInit
+  char seed_id[32]; ///< SeedType::idString()
+  std::int64_t nverts; ///< number of vertices
+  std::int64_t nedges; ///< number of edges (leaves and non-leaves)
+  std::int64_t nfaces; ///< number of faces (leaves and non-leaves)
+  std::int64_t nedge_leaves; ///< number of leaf edges
+  std::int64_t nface_leaves; ///< number of leaf faces
+  std::int64_t offset[CacheNArrays]; ///< byte offset of each array from the start of the file
+  std::int64_t nrows[CacheNArrays]; ///< number of rows in each array
+  std::int64_t ncols[CacheNArrays]; ///< number of columns in each array (1 for rank-1 arrays)
+  std::int64_t elem_size[CacheNArrays]; ///< sizeof one array entry
+};
+
+/** @brief Default cache file name for a SeedType refined to a given depth.
+
+  @param seed_id SeedType::idString()
+  @param depth tree depth
+  @param cache_dir directory for cache files; empty for the working directory
+*/
+std::string meshCacheFilename(const std::string& seed_id, const Int depth, const std::string& cache_dir="");
+
+template <typename SeedType> class PolyMesh2d; /// fwd. decl.
+
+/** @brief Writes a mesh's host data to a mesh cache file.
+
+  Writes the current host mirrors; the mesh depth is recorded from PolyMesh2d::baseTreeDepth.
+
+  @hostfn
+
+  @param fname output file name
+  @param mesh mesh to cache
+*/
+template <typename SeedType>
+void writeMeshCache(const std::string& fname, const PolyMesh2d<SeedType>& mesh);
+
+/** @brief Read-only, memory-mapped view of a mesh cache file.
+
+  The file stays mapped for the lifetime of the reader; fill() copies one array into a host view.
+  The reader is used by the initFromCache methods of Coords, Edges, Faces, and PolyMesh2d.
+
+  @hostfn
+*/
+class MeshCacheReader {
+  public:
+    /** @brief Maps the file and validates its header.
+
+      Throws if the file cannot be opened, is truncated, or was written by an incompatible version.
+    */
+    MeshCacheReader(const std::string& fname);
+
+    /// Unmaps the file
+    ~MeshCacheReader();
+
+    MeshCacheReader(const MeshCacheReader&) = delete;
+    MeshCacheReader& operator = (const MeshCacheReader&) = delete;
+
+    inline std::string seedId() const {return std::string(header.seed_id);}
+    inline Int getTreeDepth() const {return header.depth;}
+    inline Int ndim() const {return header.ndim;}
+    inline Int nfaceverts() const {return header.nfaceverts;}
+    inline Index nVerts() const {return header.nverts;}
+    inline Index nEdges() const {return header.nedges;}
+    inline Index nFaces() const {return header.nfaces;}
+    inline Index nEdgeLeaves() const {return header.nedge_leaves;}
+    inline Index nFaceLeaves() const {return header.nface_leaves;}
+    inline Index nRows(const MeshCacheArray& arr) const {return header.nrows[arr];}
+
+    /// Size of the mapped file in bytes
+    inline size_t nbytes() const {return map_size;}
+
+    /** @brief Copies one cached array into rows [0, nRows(arr)) of a host view.
+
+      Packed row-major views are filled with a single memcpy from the mapped file;
+      other layouts fall back to an entry-by-entry copy.
+
+      @param hv host view (rank 1 or 2) with at least nRows(arr) rows
+      @param arr array to copy
+    */
+    template <typename HostViewType>
+    void fill(const HostViewType& hv, const MeshCacheArray& arr) const;
+
+  protected:
+    MeshCacheHeader header;
+    void* map_ptr;
+    size_t map_size;
+    std::string fname;
+};
+
+template <typename HostViewType>
+void MeshCacheReader::fill(const HostViewType& hv, const MeshCacheArray& arr) const {
+  typedef typename HostViewType::non_const_value_type value_type;
+  const Index nrows = header.nrows[arr];
+  const Int ncols = header.ncols[arr];
+  LPM_THROW_IF(header.elem_size[arr] != sizeof(value_type),
+    "MeshCacheReader::fill error: entry size mismatch in " << fname);
+  LPM_THROW_IF(hv.extent(0) < nrows, "MeshCacheReader::fill error: not enough memory.");
+  LPM_THROW_IF((HostViewType::rank == 1 ? 1 : hv.extent(1)) != ncols,
+    "MeshCacheReader::fill error: column mismatch in " << fname);
+  const value_type* src = reinterpret_cast<const value_type*>(
+    static_cast<const char*>(map_ptr) + header.offset[arr]);
+  const bool packed = (HostViewType::rank == 1 ? hv.stride_0() == 1 :
+    (hv.stride_0() == size_t(ncols) && hv.stride_1() == 1));
+  if (packed) {
+    std::memcpy(hv.data(), src, size_t(nrows)*ncols*sizeof(value_type));
+  }
+  else {
+    for (Index i=0; i<nrows; ++i) {
+      for (Int j=0; j<ncols; ++j) {
+        hv.access(i,j) = src[size_t(i)*ncols + j];
+      }
+    }
+  }
+}
+
+}
+#endif
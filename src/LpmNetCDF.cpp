@@ -1,16 +1,294 @@
 #include "LpmNetCDF.hpp"
 #ifdef LPM_HAVE_NETCDF
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+#include <netcdf_par.h>
+#endif
 
 namespace Lpm {
 
 using namespace netCDF;
 
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+/** @brief NcFile opened with the parallel NetCDF-4 C interface.
+
+  netcdf-cxx4 has no MPI constructor; the file is created or opened with nc_create_par/nc_open_par
+  and its id handed to NcFile, which closes it on destruction.
+*/
+class NcParFile : public NcFile {
+  public:
+    NcParFile(const std::string& filename, MPI_Comm comm, const bool create) : NcFile() {
+      int id;
+      if (create) {
+        ncCheck(nc_create_par(filename.c_str(), NC_NETCDF4 | NC_CLOBBER, comm, MPI_INFO_NULL, &id),
+          __FILE__, __LINE__);
+      }
+      else {
+        ncCheck(nc_open_par(filename.c_str(), NC_NOWRITE, comm, MPI_INFO_NULL, &id), __FILE__, __LINE__);
+      }
+      myId = id;
+      nullObject = false;
+    }
+};
+#endif
+
 bool has_nc_file_extension(const std::string& filename) {
   const auto dot_pos = filename.find_last_of('.');
   const bool nc = filename.substr(dot_pos+1) == "nc";
   return nc;
 }
 
+NcWriter::NcWriter(const std::string& filename, const NcVarStorage& storage) :
+  fname(filename), parallel(false), comm_rank(0), comm_size(1), default_storage(storage) {
+  if (has_nc_file_extension(fname)) {
+    ncfile =
+      std::unique_ptr<NcFile>(new NcFile(fname, NcFile::replace, NcFile::nc4));
+  }
+  else {
+    std::ostringstream ss;
+    ss << "NcWriter::NcWriter error: file "
+      << filename << " has invalid extension (must be .nc)";
+    throw std::runtime_error(ss.str());
+  }
+}
+
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+NcWriter::NcWriter(const std::string& filename, MPI_Comm comm, const NcVarStorage& storage) :
+  fname(filename), parallel(true), default_storage(storage) {
+  LPM_THROW_IF(!has_nc_file_extension(fname),
+    "NcWriter::NcWriter error: file " << filename << " has invalid extension (must be .nc)");
+  MPI_Comm_rank(comm, &comm_rank);
+  MPI_Comm_size(comm, &comm_size);
+  ncfile = std::unique_ptr<NcFile>(new NcParFile(fname, comm, true));
+}
+#endif
+
+NcReader::NcReader(const std::string& filename) : fname(filename), parallel(false) {
+  if (has_nc_file_extension(fname)) {
+    ncfile =
+      std::unique_ptr<const NcFile>(new NcFile(fname, NcFile::read));
+
+    dims = ncfile->getDims();
+    vars = ncfile->getVars();
+    atts = ncfile->getAtts();
+  }
+  else {
+    std::ostringstream ss;
+    ss << "NcReader::NcReader error: file "
+      << filename << " has invalid extension (must be .nc)";
+    throw std::runtime_error(ss.str());
+  }
+}
+
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+NcReader::NcReader(const std::string& filename, MPI_Comm comm) : fname(filename), parallel(true) {
+  LPM_THROW_IF(!has_nc_file_extension(fname),
+    "NcReader::NcReader error: file " << filename << " has invalid extension (must be .nc)");
+  ncfile = std::unique_ptr<const NcFile>(new NcParFile(fname, comm, false));
+  dims = ncfile->getDims();
+  vars = ncfile->getVars();
+  atts = ncfile->getAtts();
+}
+#endif
+
+void NcReader::setCollective(const NcVar& var) const {
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+  if (parallel) {
+    ncCheck(nc_var_par_access(ncfile->getId(), var.getId(), NC_COLLECTIVE), __FILE__, __LINE__);
+  }
+#endif
+}
+
+void NcWriter::setVarStorage(const std::string& varname, const NcVarStorage& storage) {
+  var_storage[varname] = storage;
+}
+
+const NcVarStorage& NcWriter::varStorage(const std::string& varname) const {
+  const auto st_it = var_storage.find(varname);
+  return (st_it == var_storage.end() ? default_storage : st_it->second);
+}
+
+NcVar NcWriter::defineVar(const std::string& name, const NcType& type, const std::vector<NcDim>& vdims) {
+  NcVar result = ncfile->addVar(name, type, vdims);
+
+  const NcVarStorage& st = varStorage(name);
+  LPM_THROW_IF(st.deflate_level < 0 || st.deflate_level > 9,
+    "NcWriter::defineVar error: deflate level must be in [0,9].");
+
+  const size_t nrows = vdims[0].getSize();
+  size_t chunk_rows = st.chunk_rows;
+  if (chunk_rows == 0 && (st.deflate_level > 0 || st.shuffle)) chunk_rows = NC_WRITE_CHUNK_ROWS;
+  if (chunk_rows > 0 && nrows > 0) {
+    std::vector<size_t> chunk_sizes(vdims.size());
+    chunk_sizes[0] = std::min(chunk_rows, nrows);
+    for (size_t i=1; i<vdims.size(); ++i) {
+      chunk_sizes[i] = vdims[i].getSize();
+    }
+    result.setChunking(NcVar::nc_CHUNKED, chunk_sizes);
+    if (st.deflate_level > 0 || st.shuffle) {
+      result.setCompression(st.shuffle, st.deflate_level > 0, st.deflate_level);
+    }
+  }
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+  if (parallel) {
+    ncCheck(nc_var_par_access(ncfile->getId(), result.getId(), NC_COLLECTIVE), __FILE__, __LINE__);
+  }
+#endif
+  return result;
+}
+
+NcDim NcWriter::fieldDim(const FieldKind& fk) const {
+  std::string dim_name;
+  switch (fk) {
+    case (VertexField) : {
+      dim_name = "nverts";
+      break;
+    }
+    case (EdgeField) : {
+      dim_name = "nedges";
+      break;
+    }
+    case (FaceField) : {
+      dim_name = "nfaces";
+      break;
+    }
+  }
+  const auto dim_it = dims.find(dim_name);
+  LPM_THROW_IF(dim_it == dims.end(), "NcWriter::fieldDim error: dimension " << dim_name << " is not defined.");
+  return dim_it->second;
+}
+
+void NcWriter::defineFieldDims(const Index nverts, const Index nedges, const Index nfaces, const Int ndim) {
+  LPM_THROW_IF(dims.find("nverts") != dims.end(), "NcWriter::defineFieldDims error: dimensions already defined.");
+  dims.emplace("crd_dim", ncfile->addDim("ndim", ndim));
+  dims.emplace("nverts", ncfile->addDim("nverts", nverts));
+  dims.emplace("nedges", ncfile->addDim("nedges", nedges));
+  dims.emplace("nfaces", ncfile->addDim("nfaces", nfaces));
+}
+
+NcTimeSeriesWriter::NcTimeSeriesWriter(const std::string& filename, const NcVarStorage& storage) :
+  NcWriter(filename, storage), nrec(0) {}
+
+void NcTimeSeriesWriter::defineTime() {
+  if (time_dim.isNull()) {
+    time_dim = ncfile->addDim("time");
+    dims.emplace("time", time_dim);
+    time_var = ncfile->addVar("time", nc_real_type(), time_dim);
+  }
+}
+
+void NcTimeSeriesWriter::appendTime(const Real& t) {
+  LPM_THROW_IF(time_dim.isNull(),
+    "NcTimeSeriesWriter::appendTime error: defineMesh or defineLatLon must be called first.");
+  const std::vector<size_t> tind(1, nrec);
+  time_var.putVar(tind, &t);
+  ++nrec;
+}
+
+void NcTimeSeriesWriter::defineLatLon(const LatLonMesh& ll) {
+  LPM_THROW_IF(dims.find("nlat") != dims.end(), "NcTimeSeriesWriter::defineLatLon error: grid already defined.");
+  LPM_THROW_IF(nrec > 0, "NcTimeSeriesWriter::defineLatLon error: records have already been written.");
+  NcDim nlat = ncfile->addDim("nlat", ll.nlat);
+  NcDim nlon = ncfile->addDim("nlon", ll.nlon);
+  NcDim ll_crd_dim = ncfile->addDim("ll_crd_dim", 3);
+  dims.emplace("nlat", nlat);
+  dims.emplace("nlon", nlon);
+  dims.emplace("ll_crd_dim", ll_crd_dim);
+  defineTime();
+
+  std::vector<Real> lats(ll.nlat);
+  std::vector<Real> lons(ll.nlon);
+  for (Int i=0; i<ll.nlat; ++i) {
+    lats[i] = -0.5*PI + i*ll.dthe;
+  }
+  for (Int j=0; j<ll.nlon; ++j) {
+    lons[j] = j*ll.dlam;
+  }
+  NcVar lat_var = ncfile->addVar("lat", nc_real_type(), nlat);
+  NcVar lon_var = ncfile->addVar("lon", nc_real_type(), nlon);
+  lat_var.putAtt("units", "radians");
+  lon_var.putAtt("units", "radians");
+  lat_var.putVar(lats.data());
+  lon_var.putVar(lons.data());
+}
+
+NcVar NcTimeSeriesWriter::latLonRecordVar(const std::string& name, const bool vector, const std::string& units) {
+  const auto var_it = record_vars.find(name);
+  if (var_it != record_vars.end()) return var_it->second;
+
+  LPM_THROW_IF(dims.find("nlat") == dims.end(),
+    "NcTimeSeriesWriter error: defineLatLon must be called first.");
+  std::vector<NcDim> vardims = {time_dim, dims.find("nlat")->second, dims.find("nlon")->second};
+  if (vector) vardims.push_back(dims.find("ll_crd_dim")->second);
+  NcVar result = ncfile->addVar(name, nc_real_type(), vardims);
+  result.putAtt("units", units);
+
+  /// one record per chunk
+  const NcVarStorage& st = varStorage(name);
+  LPM_THROW_IF(st.deflate_level < 0 || st.deflate_level > 9,
+    "NcTimeSeriesWriter::latLonRecordVar error: deflate level must be in [0,9].");
+  std::vector<size_t> chunk_sizes(vardims.size());
+  chunk_sizes[0] = 1;
+  for (size_t i=1; i<vardims.size(); ++i) {
+    chunk_sizes[i] = vardims[i].getSize();
+  }
+  result.setChunking(NcVar::nc_CHUNKED, chunk_sizes);
+  if (st.deflate_level > 0 || st.shuffle) {
+    result.setCompression(st.shuffle, st.deflate_level > 0, st.deflate_level);
+  }
+  record_vars.emplace(name, result);
+  return result;
+}
+
+NcVar NcTimeSeriesWriter::recordVar(const std::string& name, const FieldKind& fk, const bool vector,
+  const std::string& units) {
+  const auto var_it = record_vars.find(name);
+  if (var_it != record_vars.end()) return var_it->second;
+
+  LPM_THROW_IF(dims.find("nverts") == dims.end(), "NcTimeSeriesWriter error: defineMesh must be called first.");
+  std::multimap<std::string, NcDim>::const_iterator dim_it;
+  switch (fk) {
+    case (VertexField) : {
+      dim_it = dims.find("nverts");
+      break;
+    }
+    case (EdgeField) : {
+      dim_it = dims.find("nedges");
+      break;
+    }
+    case (FaceField) : {
+      dim_it = dims.find("nfaces");
+      break;
+    }
+  }
+  std::vector<NcDim> vardims = {time_dim, dim_it->second};
+  if (vector) vardims.push_back(dims.find("crd_dim")->second);
+  NcVar result = ncfile->addVar(name, nc_real_type(), vardims);
+  result.putAtt("units", units);
+
+  /// one record per chunk; unlimited dimensions always use chunked storage
+  const NcVarStorage& st = varStorage(name);
+  LPM_THROW_IF(st.deflate_level < 0 || st.deflate_level > 9,
+    "NcTimeSeriesWriter::recordVar error: deflate level must be in [0,9].");
+  const size_t nrows = dim_it->second.getSize();
+  if (nrows > 0) {
+    std::vector<size_t> chunk_sizes(vardims.size());
+    chunk_sizes[0] = 1;
+    chunk_sizes[1] = (st.chunk_rows > 0 ? std::min(st.chunk_rows, nrows) : nrows);
+    if (vector) chunk_sizes[2] = vardims[2].getSize();
+    result.setChunking(NcVar::nc_CHUNKED, chunk_sizes);
+    if (st.deflate_level > 0 || st.shuffle) {
+      result.setCompression(st.shuffle, st.deflate_level > 0, st.deflate_level);
+    }
+  }
+  record_vars.emplace(name, result);
+  return result;
+}
+
 ko::View<Real**> PolyMeshReader::getVertPhysCrdView() const {
   std::multimap<std::string,NcVar>::const_iterator var_it;
   var_it = vars.find("phys_crds_verts");
@@ -42,20 +320,41 @@ ko::View<Real**> NcReader::getCrdView(const NcVar& crd_var) const {
 
   ko::View<Real**> result("crds", ncrds, ndim);
   auto hcrds = ko::create_mirror_view(result);
+  fill_host_array_view(hcrds, crd_var);
+  ko::deep_copy(result, hcrds);
+  return result;
+}
 
-  std::vector<size_t> ind(2,0), count(2);
-  count[0] = 1;
-  count[1] = ndim;
-  for (Index i=0; i<ncrds; ++i) {
-    ind[0] = i;
-    Real crdvals[3];
-    crd_var.getVar(ind, count, &crdvals[0]);
-    for (Short j=0; j<ndim; ++j) {
-      hcrds(i,j) = crdvals[j];
+template <typename HostViewType>
+void NcReader::fill_host_array_view(HostViewType& hv, const NcVar& var) const {
+  typedef typename HostViewType::non_const_value_type value_type;
+  const size_t nrows = var.getDim(0).getSize();
+  const size_t ncols = var.getDim(1).getSize();
+  LPM_THROW_IF(hv.extent(0) < nrows || hv.extent(1) < ncols,
+    "NcReader::fill_host_array_view error: view is too small for variable " << var.getName());
+
+  if (std::is_same<typename HostViewType::array_layout, ko::LayoutRight>::value &&
+      hv.extent(1) == ncols) {
+    const std::vector<size_t> start = {0, 0};
+    const std::vector<size_t> count = {nrows, ncols};
+    var.getVar(start, count, hv.data());
+  }
+  else {
+    const size_t chunk_rows = std::min(nrows, size_t(NC_READ_CHUNK_ROWS));
+    std::vector<value_type> buf(chunk_rows*ncols);
+    std::vector<size_t> start = {0, 0};
+    std::vector<size_t> count = {chunk_rows, ncols};
+    for (size_t row0=0; row0<nrows; row0 += chunk_rows) {
+      start[0] = row0;
+      count[0] = std::min(chunk_rows, nrows - row0);
+      var.getVar(start, count, buf.data());
+      for (size_t i=0; i<count[0]; ++i) {
+        for (size_t j=0; j<ncols; ++j) {
+          hv(row0 + i, j) = buf[i*ncols + j];
+        }
+      }
     }
   }
-  ko::deep_copy(result, hcrds);
-  return result;
 }
 
 Index PolyMeshReader::nEdges() const {
@@ -84,17 +383,7 @@ void NcReader::fill_host_scalar_view(host_scalar_view& hv,
 
 void NcReader::fill_host_vector_view(host_vector_view& hv,
   const netCDF::NcVar& fvar) const {
-  const Int ndim = dims.find("crd_dim")->second.getSize();
-  std::vector<size_t> ind(2,0);
-  const std::vector<size_t> count = {1,ndim};
-  for (Index i=0; i<hv.extent(0); ++i) {
-    ind[0] = i;
-    Real vvals[3];
-    fvar.getVar(ind, count, &vvals[0]);
-    for (Short j=0; j<ndim; ++j) {
-      hv(i,j) = vvals[j];
-    }
-  }
+  fill_host_array_view(hv, fvar);
 }
 
 void PolyMeshReader::fill_origs(host_index_view& hv) const {
@@ -122,18 +411,11 @@ void PolyMeshReader::fill_edge_tree(host_index_view& hv,
   const auto pvar_it = vars.find("edge_parents");
   const auto kvar_it = vars.find("edge_kids");
   fill_host_index_view(hv, pvar_it->second);
+  fill_host_array_view(hk, kvar_it->second);
 
   nleaves = 0;
-  std::vector<size_t> ind(2,0);
-  const std::vector<size_t> count = {1,2};
   for (Index i=0; i<pvar_it->second.getDim(0).getSize(); ++i) {
-    ind[0] = i;
-    Index kids[2];
-    kvar_it->second.getVar(ind, count, &kids[0]);
-    for (Short j=0; j<2; ++j) {
-      hk(i,j) = kids[j];
-    }
-    if (kids[0] == NULL_IND && kids[1] == NULL_IND) ++nleaves;
+    if (hk(i,0) == NULL_IND && hk(i,1) == NULL_IND) ++nleaves;
   }
 }
 
@@ -159,21 +441,8 @@ void PolyMeshReader::fill_face_connectivity(host_topo_view_tri& faceverts,
 
   assert(nfaceverts == 3);
 
-  std::vector<size_t> ind(2,0);
-  const std::vector<size_t> count = {1,nfaceverts};
-  const auto vert_var = vit->second;
-  const auto edge_var = eit->second;
-  for (Index i=0; i<faceverts.extent(0); ++i) {
-    ind[0] = i;
-    Index verts[nfaceverts];
-    Index edges[nfaceverts];
-    vert_var.getVar(ind, count, &verts[0]);
-    edge_var.getVar(ind, count, &edges[0]);
-    for (Short j=0; j<nfaceverts; ++j) {
-      faceverts(i,j) = verts[j];
-      faceedges(i,j) = edges[j];
-    }
-  }
+  fill_host_array_view(faceverts, vit->second);
+  fill_host_array_view(faceedges, eit->second);
 }
 
 void PolyMeshReader::fill_face_connectivity(host_topo_view_quad& faceverts,
@@ -184,21 +453,8 @@ void PolyMeshReader::fill_face_connectivity(host_topo_view_quad& faceverts,
 
   assert(nfaceverts == 4);
 
-  std::vector<size_t> ind(2,0);
-  const std::vector<size_t> count = {1,nfaceverts};
-  const auto vert_var = vit->second;
-  const auto edge_var = eit->second;
-  for (Index i=0; i<faceverts.extent(0); ++i) {
-    ind[0] = i;
-    Index verts[nfaceverts];
-    Index edges[nfaceverts];
-    vert_var.getVar(ind, count, &verts[0]);
-    edge_var.getVar(ind, count, &edges[0]);
-    for (Short j=0; j<nfaceverts; ++j) {
-      faceverts(i,j) = verts[j];
-      faceedges(i,j) = edges[j];
-    }
-  }
+  fill_host_array_view(faceverts, vit->second);
+  fill_host_array_view(faceedges, eit->second);
 }
 
 void PolyMeshReader::fill_face_centers(host_index_view& hv) const {
@@ -216,19 +472,13 @@ void PolyMeshReader::fill_face_tree(host_index_view& hp,
   const auto pvar_it = vars.find("face_parents");
   const auto kvar_it = vars.find("face_kids");
   fill_host_index_view(hp, pvar_it->second);
+  fill_host_array_view(hk, kvar_it->second);
 
   nleaves = 0;
-  std::vector<size_t> ind(2,0);
-  const std::vector<size_t> count = {1,4};
-  const auto kvar = kvar_it->second;
   for (Index i=0; i<hp.extent(0); ++i) {
-    ind[0] = i;
-    Index kids[4];
-    kvar.getVar(ind, count, &kids[0]);
     Short kid_counter = 0;
     for (Short j=0; j<4; ++j) {
-      hk(i,j) = kids[j];
-      if (kids[j] != NULL_IND) ++kid_counter;
+      if (hk(i,j) != NULL_IND) ++kid_counter;
     }
     if (kid_counter == 0) ++nleaves;
   }
@@ -239,5 +489,119 @@ void PolyMeshReader::fill_face_area(typename scalar_view_type::HostMirror& hv) c
   fill_host_scalar_view(hv, it->second);
 }
 
+const NcVar& PolyMeshReader::findVar(const std::string& name) const {
+  const auto it = vars.find(name);
+  LPM_THROW_IF(it == vars.end(), "PolyMeshReader error: variable " << name << " not found in " << fname);
+  return it->second;
+}
+
+const NcGroupAtt& PolyMeshReader::findAtt(const std::string& name) const {
+  const auto it = atts.find(name);
+  LPM_THROW_IF(it == atts.end(), "PolyMeshReader error: attribute " << name << " not found in " << fname);
+  return it->second;
+}
+
+bool PolyMeshReader::hasVar(const std::string& name) const {
+  return vars.find(name) != vars.end();
+}
+
+Real PolyMeshReader::getRealAtt(const std::string& name) const {
+  Real result;
+  findAtt(name).getValues(&result);
+  return result;
+}
+
+Int PolyMeshReader::getIntAtt(const std::string& name) const {
+  Int result;
+  findAtt(name).getValues(&result);
+  return result;
+}
+
+std::string PolyMeshReader::getStringAtt(const std::string& name) const {
+  std::string result;
+  findAtt(name).getValues(result);
+  return result;
+}
+
+void PolyMeshReader::fill_scalar_field(typename scalar_view_type::HostMirror& hv,
+  const std::string& name) const {
+  const NcVar& var = findVar(name);
+  const size_t n = var.getDim(0).getSize();
+  LPM_THROW_IF(hv.extent(0) < n, "PolyMeshReader::fill_scalar_field error: view is too small for " << name);
+  const std::vector<size_t> start(1,0);
+  const std::vector<size_t> count(1,n);
+  var.getVar(start, count, hv.data());
+}
+
+template <typename HostViewType>
+void PolyMeshReader::fill_vector_field(HostViewType& hv, const std::string& name) const {
+  fill_host_array_view(hv, findVar(name));
+}
+
+Index PolyMeshReader::fieldRows(const std::string& name) const {
+  return findVar(name).getDim(0).getSize();
+}
+
+void PolyMeshReader::fill_scalar_field_range(typename scalar_view_type::HostMirror& hv,
+  const std::string& name, const Index offset, const Index nlocal) const {
+  const NcVar& var = findVar(name);
+  LPM_THROW_IF(offset < 0 || nlocal < 0 || size_t(offset + nlocal) > var.getDim(0).getSize() ||
+    hv.extent(0) < size_t(nlocal), "PolyMeshReader::fill_scalar_field_range error: rows out of range for " << name);
+  setCollective(var);
+  const std::vector<size_t> start(1, offset);
+  const std::vector<size_t> count(1, nlocal);
+  var.getVar(start, count, hv.data());
+}
+
+template <typename HostViewType>
+void PolyMeshReader::fill_vector_field_range(HostViewType& hv, const std::string& name,
+  const Index offset, const Index nlocal) const {
+  typedef typename HostViewType::non_const_value_type value_type;
+  const NcVar& var = findVar(name);
+  const size_t ncols = var.getDim(1).getSize();
+  LPM_THROW_IF(offset < 0 || nlocal < 0 || size_t(offset + nlocal) > var.getDim(0).getSize() ||
+    hv.extent(0) < size_t(nlocal) || hv.extent(1) < ncols,
+    "PolyMeshReader::fill_vector_field_range error: rows out of range for " << name);
+  setCollective(var);
+  const std::vector<size_t> start = {size_t(offset), 0};
+  const std::vector<size_t> count = {size_t(nlocal), ncols};
+  if (std::is_same<typename HostViewType::array_layout, ko::LayoutRight>::value &&
+      hv.extent(1) == ncols) {
+    var.getVar(start, count, hv.data());
+  }
+  else {
+    /// collective reads require one getVar call per rank, so the whole range is staged at once
+    std::vector<value_type> buf(size_t(nlocal)*ncols);
+    var.getVar(start, count, buf.data());
+    for (Index i=0; i<nlocal; ++i) {
+      for (size_t j=0; j<ncols; ++j) {
+        hv(i,j) = buf[i*ncols + j];
+      }
+    }
+  }
+}
+
+void NcWriter::writeAttribute(const std::string& name, const Real& val) {
+  ncfile->putAtt(name, nc_real_type(), val);
+}
+
+void NcWriter::writeAttribute(const std::string& name, const Int& val) {
+  ncfile->putAtt(name, NcInt(), val);
+}
+
+void NcWriter::writeAttribute(const std::string& name, const std::string& val) {
+  ncfile->putAtt(name, val);
+}
+
+/// ETI
+template void PolyMeshReader::fill_vector_field(typename PlaneGeometry::vec_view_type::HostMirror& hv,
+  const std::string& name) const;
+template void PolyMeshReader::fill_vector_field(typename SphereGeometry::vec_view_type::HostMirror& hv,
+  const std::string& name) const;
+template void PolyMeshReader::fill_vector_field_range(typename PlaneGeometry::vec_view_type::HostMirror& hv,
+  const std::string& name, const Index offset, const Index nlocal) const;
+template void PolyMeshReader::fill_vector_field_range(typename SphereGeometry::vec_view_type::HostMirror& hv,
+  const std::string& name, const Index offset, const Index nlocal) const;
+
 }
 #endif
@@ -7,9 +7,15 @@
 #include "LpmDefs.hpp"
 #include "LpmPolyMesh2d.hpp"
 #include "LpmEdges.hpp"
+#include "LpmLatLonMesh.hpp"
+#include "LpmUtilities.hpp"
 #include <netcdf>
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+#include <mpi.h>
+#endif
 #include <memory>
 #include <map>
+#include <vector>
 
 namespace Lpm {
 
@@ -20,13 +26,56 @@ typedef std::conditional<std::is_same<int,Index>::value,
 typedef std::conditional<std::is_same<double,Real>::value,
   netCDF::NcDouble, netCDF::NcFloat>::type nc_real_type;
 
+/// Max. number of rows per hyperslab when a 2d variable must be staged before copying to a host view
+static constexpr Index NC_READ_CHUNK_ROWS = 65536;
+
+/// Default rows per chunk for compressed variables that do not specify a chunk size
+static constexpr Index NC_WRITE_CHUNK_ROWS = 65536;
+
+/** @brief NetCDF-4 storage options for one output variable.
+
+  Filters require chunked storage; if deflate_level > 0 or shuffle is set, and chunk_rows == 0,
+  chunks of NC_WRITE_CHUNK_ROWS rows are used.
+*/
+struct NcVarStorage {
+  size_t chunk_rows; ///< rows (along the first dimension) per chunk; 0 = contiguous storage
+  Int deflate_level; ///< 0 (no compression) to 9
+  bool shuffle; ///< apply the shuffle filter before compression
+
+  NcVarStorage(const size_t cr=0, const Int dl=0, const bool sh=false) :
+    chunk_rows(cr), deflate_level(dl), shuffle(sh) {}
+};
+
+/** @brief Writes PolyMesh2d data and fields to NetCDF-4 files.
+
+  Each variable is written with a single putVar call from the host mirrors.
+  Storage (chunking, deflate, shuffle) is set by the default NcVarStorage given to the constructor,
+  and may be changed for individual variables with setVarStorage before they are written.
+
+  With LPM_HAVE_PARALLEL_NETCDF, the MPI constructor opens one shared file on all ranks of a communicator.
+  Every call that defines or writes data is then collective: all ranks must make the same calls, in the same order,
+  with the same names and global sizes.  Replicated data (e.g., writePolymesh) are split so that each rank writes
+  one block of rows; distributed fields are written with writeScalarFieldRange and writeVectorFieldRange.
+*/
 class NcWriter {
   public:
-    NcWriter(const std::string& filename);
+    NcWriter(const std::string& filename, const NcVarStorage& storage=NcVarStorage());
+
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+    /// opens filename for collective (HDF5 MPI-IO) writes by all ranks of comm
+    NcWriter(const std::string& filename, MPI_Comm comm, const NcVarStorage& storage=NcVarStorage());
+#endif
+
+    /// overrides the default storage options for the variable with name varname
+    void setVarStorage(const std::string& varname, const NcVarStorage& storage);
 
     template <typename SeedType>
     void writePolymesh(const std::shared_ptr<PolyMesh2d<SeedType>>& mesh);
 
+    /// writes mesh topology and coordinates from host views (call mesh.updateHost() first, if necessary)
+    template <typename SeedType>
+    void writePolymesh(const PolyMesh2d<SeedType>& mesh);
+
     template <typename ViewType>
     void writeScalarField(const ViewType& s,
       const FieldKind& fk, const std::string& name="", const std::string& units="null");
@@ -34,11 +83,162 @@ class NcWriter {
     template <typename ViewType>
     void writeVectorField(const ViewType& v,
       const FieldKind& fk, const std::string& name="", const std::string& units="null");
+
+    /// writes a global attribute (e.g., simulation time or solver settings for a checkpoint)
+    void writeAttribute(const std::string& name, const Real& val);
+    void writeAttribute(const std::string& name, const Int& val);
+    void writeAttribute(const std::string& name, const std::string& val);
+
+    /** @brief Defines the dimensions used by fields (nverts, nedges, nfaces, crd_dim) without writing a mesh.
+
+      Not needed if writePolymesh has been called.
+    */
+    void defineFieldDims(const Index nverts, const Index nedges, const Index nfaces, const Int ndim);
+
+    /** @brief Writes rows [0, nlocal) of a scalar field to global rows [offset, offset + nlocal).
+
+      The variable is defined with the global size of the FieldKind's dimension.
+    */
+    template <typename ViewType>
+    void writeScalarFieldRange(const ViewType& s, const Index offset, const Index nlocal,
+      const FieldKind& fk, const std::string& name="", const std::string& units="null");
+
+    /// Writes rows [0, nlocal) of a vector field to global rows [offset, offset + nlocal).
+    template <typename ViewType>
+    void writeVectorFieldRange(const ViewType& v, const Index offset, const Index nlocal,
+      const FieldKind& fk, const std::string& name="", const std::string& units="null");
+
+    /// true if the file was opened for collective parallel writes
+    inline bool isParallel() const {return parallel;}
   protected:
     std::string fname;
     std::unique_ptr<netCDF::NcFile> ncfile;
+    bool parallel;
+    Int comm_rank;
+    Int comm_size;
 
     std::multimap<std::string,netCDF::NcDim> dims;
+
+    NcVarStorage default_storage;
+    std::map<std::string,NcVarStorage> var_storage;
+
+    /// storage options for the variable with name varname
+    const NcVarStorage& varStorage(const std::string& varname) const;
+
+    /// adds a variable to the file and applies its storage options
+    netCDF::NcVar defineVar(const std::string& name, const netCDF::NcType& type,
+      const std::vector<netCDF::NcDim>& vdims);
+
+    /// dimension of a field's rows
+    netCDF::NcDim fieldDim(const FieldKind& fk) const;
+
+    /** @brief writes rows [0, var.getDim(0).getSize()) of a rank-1 host view
+
+      In parallel, each rank writes only its blockRange of rows.
+    */
+    template <typename HostViewType>
+    void putScalarVar(netCDF::NcVar& var, const HostViewType& hv) const;
+
+    /** @brief writes rows [0, var.getDim(0).getSize()) and columns [0, var.getDim(1).getSize()) of a rank-2 host view
+
+      In parallel, each rank writes only its blockRange of rows.
+    */
+    template <typename HostViewType>
+    void putArrayVar(netCDF::NcVar& var, const HostViewType& hv) const;
+
+    /// writes rows [row0, row0 + nlocal) of a rank-1 host view to rows [offset, offset + nlocal) of var
+    template <typename HostViewType>
+    void putScalarRows(netCDF::NcVar& var, const HostViewType& hv, const size_t row0, const size_t offset,
+      const size_t nlocal) const;
+
+    /// writes rows [row0, row0 + nlocal) of a rank-2 host view to rows [offset, offset + nlocal) of var
+    template <typename HostViewType>
+    void putArrayRows(netCDF::NcVar& var, const HostViewType& hv, const size_t row0, const size_t offset,
+      const size_t nlocal) const;
+};
+
+/** @brief Writes a sequence of time steps to one NetCDF-4 file.
+
+  Mesh topology (and the initial coordinates) are written once, by defineMesh.
+  Each call to appendTime starts a new record along the unlimited "time" dimension and writes
+  the time value and the current physical coordinates of vertices and faces
+  (variables phys_crds_verts_t and phys_crds_faces_t).
+  Fields written by writeScalarField and writeVectorField go to the current record; each field's
+  variable is defined the first time it is written.
+
+  The number of vertices and faces must not change after defineMesh
+  (adaptive refinement during a run requires a new file).
+
+  Regridded diagnostics go on a lat-lon grid added by defineLatLon, with or without a mesh; files that hold
+  only lat-lon data start each record with appendTime(t).
+
+  Fields and coordinates are copied from device views, so updateHost is not needed before appendTime.
+*/
+class NcTimeSeriesWriter : public NcWriter {
+  public:
+    NcTimeSeriesWriter(const std::string& filename, const NcVarStorage& storage=NcVarStorage());
+
+    template <typename SeedType>
+    void defineMesh(const PolyMesh2d<SeedType>& mesh);
+
+    /// starts a new time record; writes t and the mesh's physical coordinates
+    template <typename SeedType>
+    void appendTime(const Real& t, const PolyMesh2d<SeedType>& mesh);
+
+    /// starts a new time record; writes t and physical coordinates from host views (e.g., staged copies)
+    template <typename VertViewType, typename FaceViewType>
+    void appendTime(const Real& t, const VertViewType& vert_crds, const FaceViewType& face_crds);
+
+    /// starts a new time record and writes only t
+    void appendTime(const Real& t);
+
+    /// adds dimensions nlat and nlon, and variables lat and lon (radians), for LatLonMesh data
+    void defineLatLon(const LatLonMesh& ll);
+
+    /// writes a scalar at LatLonMesh points to the current time record; dimensions (time, nlat, nlon)
+    template <typename ViewType>
+    void writeLatLonScalar(const ViewType& s, const std::string& name, const std::string& units="null");
+
+    /// writes a vector at LatLonMesh points to the current time record; dimensions (time, nlat, nlon, ll_crd_dim)
+    template <typename ViewType>
+    void writeLatLonVector(const ViewType& v, const std::string& name, const std::string& units="null");
+
+    /// writes a scalar field to the current time record
+    template <typename ViewType>
+    void writeScalarField(const ViewType& s,
+      const FieldKind& fk, const std::string& name="", const std::string& units="null");
+
+    /// writes a vector field to the current time record
+    template <typename ViewType>
+    void writeVectorField(const ViewType& v,
+      const FieldKind& fk, const std::string& name="", const std::string& units="null");
+
+    /// number of time records written so far
+    inline size_t nRecords() const {return nrec;}
+
+  protected:
+    netCDF::NcDim time_dim;
+    netCDF::NcVar time_var;
+    size_t nrec;
+    std::map<std::string,netCDF::NcVar> record_vars;
+
+    /// defines the unlimited time dimension and the time variable, if they do not exist
+    void defineTime();
+
+    /// returns the time-dependent variable with dimensions (time, fk, [crd_dim]), defining it if needed
+    netCDF::NcVar recordVar(const std::string& name, const FieldKind& fk, const bool vector,
+      const std::string& units);
+
+    /// returns the time-dependent variable with dimensions (time, nlat, nlon, [ll_crd_dim]), defining it if needed
+    netCDF::NcVar latLonRecordVar(const std::string& name, const bool vector, const std::string& units);
+
+    /// writes rows [0, n) of a rank-1 host view to the current record of var
+    template <typename HostViewType>
+    void putScalarRecord(netCDF::NcVar& var, const HostViewType& hv) const;
+
+    /// writes rows [0, n) of a rank-2 host view to the current record of var
+    template <typename HostViewType>
+    void putVectorRecord(netCDF::NcVar& var, const HostViewType& hv) const;
 };
 
 class NcReader {
@@ -49,9 +249,15 @@ class NcReader {
 
     NcReader(const std::string& filename);
 
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+    /// opens filename for collective (HDF5 MPI-IO) reads by all ranks of comm
+    NcReader(const std::string& filename, MPI_Comm comm);
+#endif
+
   protected:
     std::string fname;
     std::unique_ptr<const netCDF::NcFile> ncfile;
+    bool parallel;
 
     std::multimap<std::string, netCDF::NcDim> dims;
     std::multimap<std::string, netCDF::NcVar> vars;
@@ -61,6 +267,17 @@ class NcReader {
     void fill_host_index_view(host_index_view& hv, const netCDF::NcVar& ind_var) const;
     void fill_host_scalar_view(host_scalar_view& hv, const netCDF::NcVar& fvar) const;
     void fill_host_vector_view(host_vector_view& hv, const netCDF::NcVar& fvar) const;
+
+    /** @brief Reads a 2d variable into rows [0, nrows) and columns [0, ncols) of a rank-2 host view.
+
+      LayoutRight views whose column extent matches the variable are filled with a single
+      hyperslab read; all others are read NC_READ_CHUNK_ROWS rows at a time through a row-major buffer.
+    */
+    template <typename HostViewType>
+    void fill_host_array_view(HostViewType& hv, const netCDF::NcVar& var) const;
+
+    /// switches var to collective access if the file was opened in parallel
+    void setCollective(const netCDF::NcVar& var) const;
 };
 
 class PolyMeshReader : NcReader {
@@ -72,6 +289,10 @@ class PolyMeshReader : NcReader {
 
     PolyMeshReader(const std::string& filename) : NcReader(filename) {}
 
+#ifdef LPM_HAVE_PARALLEL_NETCDF
+    PolyMeshReader(const std::string& filename, MPI_Comm comm) : NcReader(filename, comm) {}
+#endif
+
     Int getTreeDepth() const;
 
     ko::View<Real**> getVertPhysCrdView() const;
@@ -101,7 +322,42 @@ class PolyMeshReader : NcReader {
     ko::View<Real**> getFacePhysCrdView() const;
     ko::View<Real**> getFaceLagCrdView() const;
 
+    /// true if the file has a variable with the given name
+    bool hasVar(const std::string& name) const;
+
+    /// global attributes written by NcWriter::writeAttribute; throw if the attribute does not exist
+    Real getRealAtt(const std::string& name) const;
+    Int getIntAtt(const std::string& name) const;
+    std::string getStringAtt(const std::string& name) const;
+
+    /// reads a field written by NcWriter::writeScalarField into the first rows of a host view
+    void fill_scalar_field(typename scalar_view_type::HostMirror& hv, const std::string& name) const;
+
+    /// reads a field written by NcWriter::writeVectorField into the first rows of a host view
+    template <typename HostViewType>
+    void fill_vector_field(HostViewType& hv, const std::string& name) const;
+
+    /// number of rows in a field variable
+    Index fieldRows(const std::string& name) const;
 
+    /** @brief reads global rows [offset, offset + nlocal) of a scalar field into rows [0, nlocal) of a host view
+
+      Collective if the file was opened in parallel.
+    */
+    void fill_scalar_field_range(typename scalar_view_type::HostMirror& hv, const std::string& name,
+      const Index offset, const Index nlocal) const;
+
+    /** @brief reads global rows [offset, offset + nlocal) of a vector field into rows [0, nlocal) of a host view
+
+      Collective if the file was opened in parallel.
+    */
+    template <typename HostViewType>
+    void fill_vector_field_range(HostViewType& hv, const std::string& name,
+      const Index offset, const Index nlocal) const;
+
+  protected:
+    const netCDF::NcVar& findVar(const std::string& name) const;
+    const netCDF::NcGroupAtt& findAtt(const std::string& name) const;
 
 };
 
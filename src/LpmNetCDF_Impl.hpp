@@ -4,51 +4,89 @@
 #include "LpmConfig.h"
 #ifdef LPM_HAVE_NETCDF
 #include "LpmNetCDF.hpp"
+#include "LpmTimer.hpp"
 #include <string>
 #include <sstream>
 #include <exception>
+#include <type_traits>
+#include <vector>
 
 namespace Lpm {
 
 using namespace netCDF;
 
-NcWriter::NcWriter(const std::string& filename) :
-  fname(filename) {
-  if (has_nc_file_extension(fname)) {
-    ncfile =
-      std::unique_ptr<NcFile>(new NcFile(fname, NcFile::replace, NcFile::nc4));
+/// element type of host staging buffers; std::vector<bool> has no data(), so bools are staged as bytes (NC_BYTE)
+template <typename T> struct NcBufferType {typedef T type;};
+template <> struct NcBufferType<bool> {typedef signed char type;};
+
+template <typename HostViewType>
+void NcWriter::putScalarVar(NcVar& var, const HostViewType& hv) const {
+  Index offset = 0;
+  Index nlocal = var.getDim(0).getSize();
+  if (parallel) blockRange(offset, nlocal, var.getDim(0).getSize(), comm_rank, comm_size);
+  putScalarRows(var, hv, offset, offset, nlocal);
+}
+
+template <typename HostViewType>
+void NcWriter::putArrayVar(NcVar& var, const HostViewType& hv) const {
+  Index offset = 0;
+  Index nlocal = var.getDim(0).getSize();
+  if (parallel) blockRange(offset, nlocal, var.getDim(0).getSize(), comm_rank, comm_size);
+  putArrayRows(var, hv, offset, offset, nlocal);
+}
+
+template <typename HostViewType>
+void NcWriter::putScalarRows(NcVar& var, const HostViewType& hv, const size_t row0, const size_t offset,
+  const size_t nlocal) const {
+  typedef typename NcBufferType<typename HostViewType::non_const_value_type>::type value_type;
+  const std::vector<size_t> start(1, offset);
+  const std::vector<size_t> count(1, nlocal);
+  if (hv.stride(0) == 1) {
+    var.putVar(start, count, hv.data() + row0);
   }
   else {
-    std::ostringstream ss;
-    ss << "NcWriter::NcWriter error: file "
-      << filename << " has invalid extension (must be .nc)";
-    throw std::runtime_error(ss.str());
+    std::vector<value_type> buf(nlocal);
+    for (size_t i=0; i<nlocal; ++i) {
+      buf[i] = hv(row0 + i);
+    }
+    var.putVar(start, count, buf.data());
   }
 }
 
-NcReader::NcReader(const std::string& filename) : fname(filename) {
-  if (has_nc_file_extension(fname)) {
-    ncfile =
-      std::unique_ptr<const NcFile>(new NcFile(fname, NcFile::read));
-
-    dims = ncfile->getDims();
-    vars = ncfile->getVars();
-    atts = ncfile->getAtts();
+template <typename HostViewType>
+void NcWriter::putArrayRows(NcVar& var, const HostViewType& hv, const size_t row0, const size_t offset,
+  const size_t nlocal) const {
+  typedef typename NcBufferType<typename HostViewType::non_const_value_type>::type value_type;
+  const size_t ncols = var.getDim(1).getSize();
+  const std::vector<size_t> start = {offset, 0};
+  const std::vector<size_t> count = {nlocal, ncols};
+  if (std::is_same<typename HostViewType::array_layout, ko::LayoutRight>::value &&
+      hv.extent(1) == ncols) {
+    var.putVar(start, count, hv.data() + row0*ncols);
   }
   else {
-    std::ostringstream ss;
-    ss << "NcWriter::NcWriter error: file "
-      << filename << " has invalid extension (must be .nc)";
-    throw std::runtime_error(ss.str());
+    std::vector<value_type> buf(nlocal*ncols);
+    for (size_t i=0; i<nlocal; ++i) {
+      for (size_t j=0; j<ncols; ++j) {
+        buf[i*ncols + j] = hv(row0 + i,j);
+      }
+    }
+    var.putVar(start, count, buf.data());
   }
 }
 
 template <typename SeedType>
 void NcWriter::writePolymesh(const std::shared_ptr<PolyMesh2d<SeedType>>& mesh) {
+  writePolymesh(*mesh);
+}
+
+template <typename SeedType>
+void NcWriter::writePolymesh(const PolyMesh2d<SeedType>& mesh) {
+  LPM_TIMER_SCOPE("NcWriter::writePolymesh");
   NcDim crd_dim = ncfile->addDim("ndim", SeedType::geo::ndim);
-  NcDim nvertices = ncfile->addDim("nverts", mesh->nvertsHost());
-  NcDim nedges = ncfile->addDim("nedges", mesh->nedgesHost());
-  NcDim nfaces = ncfile->addDim("nfaces", mesh->nfacesHost());
+  NcDim nvertices = ncfile->addDim("nverts", mesh.nvertsHost());
+  NcDim nedges = ncfile->addDim("nedges", mesh.nedgesHost());
+  NcDim nfaces = ncfile->addDim("nfaces", mesh.nfacesHost());
   NcDim nfaceverts = ncfile->addDim("nfaceverts", SeedType::nfaceverts);
   NcDim two = ncfile->addDim("two", 2);
   NcDim four = ncfile->addDim("four", 4);
@@ -65,159 +103,70 @@ void NcWriter::writePolymesh(const std::shared_ptr<PolyMesh2d<SeedType>>& mesh)
     /**
       Vertices
     */
-    std::vector<NcDim> vert_dims = {nvertices, crd_dim};
-    NcVar vert_phys = ncfile->addVar("phys_crds_verts", nc_real_type(), vert_dims);
-    NcVar vert_lag = ncfile->addVar("lag_crds_verts", nc_real_type(), vert_dims);
-
-    const auto physx = ko::subview(mesh->physVerts.getHostCrdView(), ko::ALL(), 0);
-    const auto physy = ko::subview(mesh->physVerts.getHostCrdView(), ko::ALL(), 1);
-    const auto physz = ko::subview(mesh->physVerts.getHostCrdView(), ko::ALL(), 0);
-    const auto lagx = ko::subview(mesh->lagVerts.getHostCrdView(), ko::ALL(), 0);
-    const auto lagy = ko::subview(mesh->lagVerts.getHostCrdView(), ko::ALL(), 1);
-    const auto lagz = ko::subview(mesh->lagVerts.getHostCrdView(), ko::ALL(), 0);
-    if (SeedType::geo::ndim == 3) {
-      const auto physz = ko::subview(mesh->physVerts.getHostCrdView(), ko::ALL(), 2);
-      const auto lagz = ko::subview(mesh->lagVerts.getHostCrdView(), ko::ALL(), 2);
-    }
+    const std::vector<NcDim> vert_dims = {nvertices, crd_dim};
+    NcVar vert_phys = defineVar("phys_crds_verts", nc_real_type(), vert_dims);
+    NcVar vert_lag = defineVar("lag_crds_verts", nc_real_type(), vert_dims);
 
-    std::vector<size_t> start_ind(2), count(2);
-    start_ind[0] = 0;
-    start_ind[1] = 0;
-    count[0] = 1;
-    count[1] = SeedType::geo::ndim;
-    for (Index i=0; i<mesh->nvertsHost(); ++i) {
-      Real phys_xyz[3] = {physx(i), physy(i), (SeedType::geo::ndim == 3 ? physz(i) : 0.0)};
-      Real lag_xyz[3] = {lagx(i), lagy(i), (SeedType::geo::ndim == 3 ? lagz(i) : 0.0)};
-      start_ind[0] = i;
-      vert_phys.putVar(start_ind, count, &phys_xyz[0]);
-      vert_lag.putVar(start_ind, count, &lag_xyz[0]);
-    }
+    putArrayVar(vert_phys, mesh.physVerts.getHostCrdView());
+    putArrayVar(vert_lag, mesh.lagVerts.getHostCrdView());
   }
 
   {
     /**
       edges
     */
-    NcVar edge_origs = ncfile->addVar("edge_origs", nc_index_type(), nedges);
-    NcVar edge_dests = ncfile->addVar("edge_dests", nc_index_type(), nedges);
-    NcVar edge_lefts = ncfile->addVar("edge_lefts", nc_index_type(), nedges);
-    NcVar edge_rights = ncfile->addVar("edge_rights", nc_index_type(), nedges);
-    NcVar edge_parents = ncfile->addVar("edge_parents", nc_index_type(), nedges);
-    std::vector<NcDim> tree_dims = {nedges, two};
-    NcVar edge_kids = ncfile->addVar("edge_kids", nc_index_type(), tree_dims);
-
-    std::vector<size_t> scalar_start_ind(1), scalar_count(1);
-    scalar_start_ind[0] = 0;
-    scalar_count[0] = mesh->nedgesHost();
-    const auto eo = mesh->edges.getOrigsHost();
-    const auto ed = mesh->edges.getDestsHost();
-    const auto el = mesh->edges.getLeftsHost();
-    const auto er = mesh->edges.getRightsHost();
-    const auto ep = mesh->edges.getParentsHost();
-    const auto ek = mesh->edges.getKidsHost();
-
-    edge_origs.putVar(scalar_start_ind, scalar_count, eo.data());
-    edge_dests.putVar(scalar_start_ind, scalar_count, ed.data());
-    edge_lefts.putVar(scalar_start_ind, scalar_count, el.data());
-    edge_rights.putVar(scalar_start_ind, scalar_count, er.data());
-    edge_parents.putVar(scalar_start_ind, scalar_count, ep.data());
-
-    std::vector<size_t> tree_start_ind(2), tree_count(2);
-    tree_start_ind[0] = 0;
-    tree_start_ind[1] = 0;
-    tree_count[0] = 1;
-    tree_count[1] = 2;
-    for (Index i = 0; i<mesh->nedgesHost(); ++i) {
-      tree_start_ind[0] = i;
-      Index kids[2] = {ek(i,0), ek(i,1)};
-      edge_kids.putVar(tree_start_ind, tree_count, &kids[0]);
-    }
+    const std::vector<NcDim> edge_dims = {nedges};
+    NcVar edge_origs = defineVar("edge_origs", nc_index_type(), edge_dims);
+    NcVar edge_dests = defineVar("edge_dests", nc_index_type(), edge_dims);
+    NcVar edge_lefts = defineVar("edge_lefts", nc_index_type(), edge_dims);
+    NcVar edge_rights = defineVar("edge_rights", nc_index_type(), edge_dims);
+    NcVar edge_parents = defineVar("edge_parents", nc_index_type(), edge_dims);
+    const std::vector<NcDim> tree_dims = {nedges, two};
+    NcVar edge_kids = defineVar("edge_kids", nc_index_type(), tree_dims);
+
+    putScalarVar(edge_origs, mesh.edges.getOrigsHost());
+    putScalarVar(edge_dests, mesh.edges.getDestsHost());
+    putScalarVar(edge_lefts, mesh.edges.getLeftsHost());
+    putScalarVar(edge_rights, mesh.edges.getRightsHost());
+    putScalarVar(edge_parents, mesh.edges.getParentsHost());
+    putArrayVar(edge_kids, mesh.edges.getKidsHost());
   }
 
   {
     /**
       faces
     */
-    std::vector<NcDim> face_dims = {nfaces, crd_dim};
-    NcVar face_phys = ncfile->addVar("phys_crds_faces", nc_real_type(), face_dims);
-    NcVar face_lag = ncfile->addVar("lag_crds_faces", nc_real_type(), face_dims);
-    NcVar face_area = ncfile->addVar("face_area", nc_real_type(), nfaces);
-    NcVar face_mask = ncfile->addVar("face_mask", ncByte, nfaces);
-    std::vector<NcDim> topo_dims = {nfaces, nfaceverts};
-    NcVar face_edges = ncfile->addVar("face_edges", nc_index_type(), topo_dims);
-    NcVar face_verts = ncfile->addVar("face_verts", nc_index_type(), topo_dims);
-    NcVar face_centers = ncfile->addVar("face_centers", nc_index_type(), nfaces);
-    NcVar face_tree_level = ncfile->addVar("face_tree_level", ncInt, nfaces);
-    NcVar face_parents = ncfile->addVar("face_parents", nc_index_type(), nfaces);
-    std::vector<NcDim> tree_dims = {nfaces, four};
-    NcVar face_kids = ncfile->addVar("face_kids", nc_index_type(), tree_dims);
-
-    const auto physx = ko::subview(mesh->physFaces.getHostCrdView(), ko::ALL(), 0);
-    const auto physy = ko::subview(mesh->physFaces.getHostCrdView(), ko::ALL(), 1);
-    const auto physz = ko::subview(mesh->physFaces.getHostCrdView(), ko::ALL(), 0);
-    const auto lagx = ko::subview(mesh->lagFaces.getHostCrdView(), ko::ALL(), 0);
-    const auto lagy = ko::subview(mesh->lagFaces.getHostCrdView(), ko::ALL(), 1);
-    const auto lagz = ko::subview(mesh->lagFaces.getHostCrdView(), ko::ALL(), 0);
-    if (SeedType::geo::ndim == 3) {
-      const auto physz = ko::subview(mesh->physFaces.getHostCrdView(), ko::ALL(), 2);
-      const auto lagz = ko::subview(mesh->lagFaces.getHostCrdView(), ko::ALL(), 2);
-    }
-
-    const auto fmask = mesh->faces.getMaskHost();
-    const auto fverts = mesh->faces.getVertsHost();
-    const auto fedges = mesh->faces.getEdgesHost();
-    const auto fcenters = mesh->faces.getCentersHost();
-    const auto flev = mesh->faces.getLevelsHost();
-    const auto fp = mesh->faces.getParentsHost();
-    const auto fkids = mesh->faces.getKidsHost();
-    const auto farea = mesh->faces.getAreaHost();
-
-    std::vector<size_t> start_ind(2), count(2), tree_count(2);
-    std::vector<size_t> topo_count(2);
-    start_ind[0] = 0;
-    start_ind[1] = 0;
-    count[0] = 1;
-    count[1] = SeedType::geo::ndim;
-    tree_count[0] = 1;
-    tree_count[1] = 4;
-    topo_count[0] = 1;
-    topo_count[1] = SeedType::nfaceverts;
-    for (Index i=0; i<mesh->nfacesHost(); ++i) {
-      Real phys_xyz[3] = {physx(i), physy(i), (SeedType::geo::ndim == 3 ? physz(i) : 0.0)};
-      Real lag_xyz[3] = {lagx(i), lagy(i), (SeedType::geo::ndim == 3 ? lagz(i) : 0.0)};
-      start_ind[0] = i;
-      face_phys.putVar(start_ind, count, &phys_xyz[0]);
-      face_lag.putVar(start_ind, count, &lag_xyz[0]);
-
-      Index fv[SeedType::nfaceverts];
-      Index fe[SeedType::nfaceverts];
-      Index fk[4];
-      for (Short j=0; j<SeedType::nfaceverts; ++j) {
-        fv[j] = fverts(i,j);
-        fe[j] = fedges(i,j);
-      }
-      for (Short j=0; j<4; ++j) {
-        fk[j] = fkids(i,j);
-      }
-
-      face_verts.putVar(start_ind, topo_count, &fv[0]);
-      face_edges.putVar(start_ind, topo_count, &fe[0]);
-      face_kids.putVar(start_ind, tree_count, &fk[0]);
-    }
-    std::vector<size_t> scalar_start_ind(1), scalar_count(1);
-    scalar_start_ind[0] = 0;
-    scalar_count[0] = mesh->nfacesHost();
-    face_mask.putVar(scalar_start_ind, scalar_count, fmask.data());
-    face_area.putVar(scalar_start_ind, scalar_count, farea.data());
-    face_parents.putVar(scalar_start_ind, scalar_count, fp.data());
-    face_centers.putVar(scalar_start_ind, scalar_count, fcenters.data());
-    face_tree_level.putVar(scalar_start_ind, scalar_count, flev.data());
+    const std::vector<NcDim> face_dims = {nfaces, crd_dim};
+    const std::vector<NcDim> face_scalar_dims = {nfaces};
+    NcVar face_phys = defineVar("phys_crds_faces", nc_real_type(), face_dims);
+    NcVar face_lag = defineVar("lag_crds_faces", nc_real_type(), face_dims);
+    NcVar face_area = defineVar("face_area", nc_real_type(), face_scalar_dims);
+    NcVar face_mask = defineVar("face_mask", ncByte, face_scalar_dims);
+    const std::vector<NcDim> topo_dims = {nfaces, nfaceverts};
+    NcVar face_edges = defineVar("face_edges", nc_index_type(), topo_dims);
+    NcVar face_verts = defineVar("face_verts", nc_index_type(), topo_dims);
+    NcVar face_centers = defineVar("face_centers", nc_index_type(), face_scalar_dims);
+    NcVar face_tree_level = defineVar("face_tree_level", ncInt, face_scalar_dims);
+    NcVar face_parents = defineVar("face_parents", nc_index_type(), face_scalar_dims);
+    const std::vector<NcDim> tree_dims = {nfaces, four};
+    NcVar face_kids = defineVar("face_kids", nc_index_type(), tree_dims);
+
+    putArrayVar(face_phys, mesh.physFaces.getHostCrdView());
+    putArrayVar(face_lag, mesh.lagFaces.getHostCrdView());
+    putArrayVar(face_verts, mesh.faces.getVertsHost());
+    putArrayVar(face_edges, mesh.faces.getEdgesHost());
+    putArrayVar(face_kids, mesh.faces.getKidsHost());
+    putScalarVar(face_mask, mesh.faces.getMaskHost());
+    putScalarVar(face_area, mesh.faces.getAreaHost());
+    putScalarVar(face_parents, mesh.faces.getParentsHost());
+    putScalarVar(face_centers, mesh.faces.getCentersHost());
+    putScalarVar(face_tree_level, mesh.faces.getLevelsHost());
   }
 
   ncfile->putAtt("MeshSeed", SeedType::idString());
   ncfile->putAtt("FaceKind", SeedType::faceStr());
   ncfile->putAtt("Geom", SeedType::geo::idString());
-  ncfile->putAtt("baseTreeDepth", ncInt, mesh->baseTreeDepth);
+  ncfile->putAtt("baseTreeDepth", ncInt, mesh.baseTreeDepth);
 }
 
 template <typename ViewType>
@@ -225,7 +174,7 @@ void NcWriter::writeScalarField(const ViewType& s,
   const FieldKind& fk, const std::string& name, const std::string& units) {
 
   const auto hs = ko::create_mirror_view(s);
-  ko::deep_copy(hs,s);
+  if (hs.data() != s.data()) ko::deep_copy(hs, s);
 
   std::multimap<std::string, NcDim>::iterator dim_it;
   switch (fk) {
@@ -242,14 +191,11 @@ void NcWriter::writeScalarField(const ViewType& s,
       break;
     }
   }
-  NcVar scalar_var = ncfile->addVar((name.empty() ? s.label() : name),
-    nc_real_type(), dim_it->second);
+  const std::vector<NcDim> vardims = {dim_it->second};
+  NcVar scalar_var = defineVar((name.empty() ? s.label() : name),
+    nc_real_type(), vardims);
   scalar_var.putAtt("units",units);
-  std::vector<size_t> ind(1);
-  for (Index i=0; i<dim_it->second.getSize(); ++i) {
-    ind[0] = i;
-    scalar_var.putVar(ind, hs.data() + i);
-  }
+  putScalarVar(scalar_var, hs);
 }
 
 template <typename ViewType>
@@ -257,7 +203,7 @@ void NcWriter::writeVectorField(const ViewType& v, const FieldKind& fk, const st
   const std::string& units) {
 
   const auto hv = ko::create_mirror_view(v);
-  ko::deep_copy(hv,v);
+  if (hv.data() != v.data()) ko::deep_copy(hv, v);
 
   std::multimap<std::string, NcDim>::iterator dim_it, crd_it;
   switch (fk) {
@@ -276,24 +222,194 @@ void NcWriter::writeVectorField(const ViewType& v, const FieldKind& fk, const st
   }
   crd_it = dims.find("crd_dim");
 
-  std::vector<NcDim> vardims = {dim_it->second, crd_it->second};
-  NcVar vec_var = ncfile->addVar((name.empty() ? v.label() : name),
+  const std::vector<NcDim> vardims = {dim_it->second, crd_it->second};
+  NcVar vec_var = defineVar((name.empty() ? v.label() : name),
     nc_real_type(), vardims);
   vec_var.putAtt("units", units);
-  std::vector<size_t> ind(2), count(2);
-  ind[0] = 0;
-  ind[1] = 0;
-  count[0] = 1;
-  const Int ndim = crd_it->second.getSize();
-  count[1] = ndim;
-  for (Index i=0; i<dim_it->second.getSize(); ++i) {
-    ind[0] = i;
-    Real vecvals[3] = {hv(i,0), hv(i,1), (ndim == 3 ? hv(i,2) : 0.0)};
-    vec_var.putVar(ind, count, &vecvals[0]);
+  putArrayVar(vec_var, hv);
+}
+
+template <typename ViewType>
+void NcWriter::writeScalarFieldRange(const ViewType& s, const Index offset, const Index nlocal,
+  const FieldKind& fk, const std::string& name, const std::string& units) {
+  const auto hs = ko::create_mirror_view(s);
+  if (hs.data() != s.data()) ko::deep_copy(hs, s);
+
+  const NcDim row_dim = fieldDim(fk);
+  LPM_THROW_IF(offset < 0 || nlocal < 0 || size_t(offset + nlocal) > row_dim.getSize() ||
+    size_t(nlocal) > hs.extent(0),
+    "NcWriter::writeScalarFieldRange error: rows out of range.");
+  const std::vector<NcDim> vardims = {row_dim};
+  NcVar scalar_var = defineVar((name.empty() ? s.label() : name), nc_real_type(), vardims);
+  scalar_var.putAtt("units", units);
+  putScalarRows(scalar_var, hs, 0, offset, nlocal);
+}
+
+template <typename ViewType>
+void NcWriter::writeVectorFieldRange(const ViewType& v, const Index offset, const Index nlocal,
+  const FieldKind& fk, const std::string& name, const std::string& units) {
+  const auto hv = ko::create_mirror_view(v);
+  if (hv.data() != v.data()) ko::deep_copy(hv, v);
+
+  const NcDim row_dim = fieldDim(fk);
+  LPM_THROW_IF(offset < 0 || nlocal < 0 || size_t(offset + nlocal) > row_dim.getSize() ||
+    size_t(nlocal) > hv.extent(0),
+    "NcWriter::writeVectorFieldRange error: rows out of range.");
+  const auto crd_it = dims.find("crd_dim");
+  LPM_THROW_IF(crd_it == dims.end(), "NcWriter::writeVectorFieldRange error: crd_dim is not defined.");
+  const std::vector<NcDim> vardims = {row_dim, crd_it->second};
+  NcVar vec_var = defineVar((name.empty() ? v.label() : name), nc_real_type(), vardims);
+  vec_var.putAtt("units", units);
+  putArrayRows(vec_var, hv, 0, offset, nlocal);
+}
+
+template <typename SeedType>
+void NcTimeSeriesWriter::defineMesh(const PolyMesh2d<SeedType>& mesh) {
+  LPM_THROW_IF(dims.find("nverts") != dims.end(), "NcTimeSeriesWriter::defineMesh error: mesh already defined.");
+  LPM_THROW_IF(nrec > 0, "NcTimeSeriesWriter::defineMesh error: records have already been written.");
+  writePolymesh(mesh);
+  defineTime();
+}
+
+template <typename SeedType>
+void NcTimeSeriesWriter::appendTime(const Real& t, const PolyMesh2d<SeedType>& mesh) {
+  LPM_THROW_IF(mesh.nvertsHost() != dims.find("nverts")->second.getSize() ||
+    mesh.nfacesHost() != dims.find("nfaces")->second.getSize(),
+    "NcTimeSeriesWriter::appendTime error: mesh size changed after defineMesh.");
+  const auto hvx = ko::create_mirror_view(mesh.physVerts.crds);
+  ko::deep_copy(hvx, mesh.physVerts.crds);
+  const auto hfx = ko::create_mirror_view(mesh.physFaces.crds);
+  ko::deep_copy(hfx, mesh.physFaces.crds);
+  appendTime(t, hvx, hfx);
+}
+
+template <typename VertViewType, typename FaceViewType>
+void NcTimeSeriesWriter::appendTime(const Real& t, const VertViewType& vert_crds,
+  const FaceViewType& face_crds) {
+  LPM_TIMER_SCOPE("NcTimeSeriesWriter::appendTime");
+  LPM_THROW_IF(dims.find("nverts") == dims.end(),
+    "NcTimeSeriesWriter::appendTime error: defineMesh must be called first.");
+  appendTime(t);
+
+  NcVar vert_var = recordVar("phys_crds_verts_t", VertexField, true, "null");
+  putVectorRecord(vert_var, vert_crds);
+  NcVar face_var = recordVar("phys_crds_faces_t", FaceField, true, "null");
+  putVectorRecord(face_var, face_crds);
+}
+
+template <typename ViewType>
+void NcTimeSeriesWriter::writeScalarField(const ViewType& s,
+  const FieldKind& fk, const std::string& name, const std::string& units) {
+  LPM_THROW_IF(nrec == 0, "NcTimeSeriesWriter::writeScalarField error: appendTime must be called first.");
+  const auto hs = ko::create_mirror_view(s);
+  if (hs.data() != s.data()) ko::deep_copy(hs, s);
+  NcVar var = recordVar((name.empty() ? s.label() : name), fk, false, units);
+  putScalarRecord(var, hs);
+}
+
+template <typename ViewType>
+void NcTimeSeriesWriter::writeVectorField(const ViewType& v,
+  const FieldKind& fk, const std::string& name, const std::string& units) {
+  LPM_THROW_IF(nrec == 0, "NcTimeSeriesWriter::writeVectorField error: appendTime must be called first.");
+  const auto hv = ko::create_mirror_view(v);
+  if (hv.data() != v.data()) ko::deep_copy(hv, v);
+  NcVar var = recordVar((name.empty() ? v.label() : name), fk, true, units);
+  putVectorRecord(var, hv);
+}
+
+template <typename ViewType>
+void NcTimeSeriesWriter::writeLatLonScalar(const ViewType& s, const std::string& name,
+  const std::string& units) {
+  typedef typename ViewType::non_const_value_type value_type;
+  LPM_THROW_IF(nrec == 0, "NcTimeSeriesWriter::writeLatLonScalar error: appendTime must be called first.");
+  const auto hs = ko::create_mirror_view(s);
+  if (hs.data() != s.data()) ko::deep_copy(hs, s);
+  NcVar var = latLonRecordVar(name, false, units);
+  const size_t nlat = var.getDim(1).getSize();
+  const size_t nlon = var.getDim(2).getSize();
+  LPM_THROW_IF(hs.extent(0) < nlat*nlon, "NcTimeSeriesWriter::writeLatLonScalar error: view is too small.");
+  const std::vector<size_t> start = {nrec-1, 0, 0};
+  const std::vector<size_t> count = {1, nlat, nlon};
+  if (hs.stride(0) == 1) {
+    var.putVar(start, count, hs.data());
+  }
+  else {
+    std::vector<value_type> buf(nlat*nlon);
+    for (size_t i=0; i<nlat*nlon; ++i) {
+      buf[i] = hs(i);
+    }
+    var.putVar(start, count, buf.data());
+  }
+}
+
+template <typename ViewType>
+void NcTimeSeriesWriter::writeLatLonVector(const ViewType& v, const std::string& name,
+  const std::string& units) {
+  typedef typename ViewType::non_const_value_type value_type;
+  LPM_THROW_IF(nrec == 0, "NcTimeSeriesWriter::writeLatLonVector error: appendTime must be called first.");
+  const auto hv = ko::create_mirror_view(v);
+  if (hv.data() != v.data()) ko::deep_copy(hv, v);
+  NcVar var = latLonRecordVar(name, true, units);
+  const size_t nlat = var.getDim(1).getSize();
+  const size_t nlon = var.getDim(2).getSize();
+  const size_t ncomp = var.getDim(3).getSize();
+  LPM_THROW_IF(hv.extent(0) < nlat*nlon || hv.extent(1) != ncomp,
+    "NcTimeSeriesWriter::writeLatLonVector error: view size mismatch.");
+  const std::vector<size_t> start = {nrec-1, 0, 0, 0};
+  const std::vector<size_t> count = {1, nlat, nlon, ncomp};
+  if (std::is_same<typename ViewType::array_layout, ko::LayoutRight>::value) {
+    var.putVar(start, count, hv.data());
+  }
+  else {
+    std::vector<value_type> buf(nlat*nlon*ncomp);
+    for (size_t i=0; i<nlat*nlon; ++i) {
+      for (size_t j=0; j<ncomp; ++j) {
+        buf[i*ncomp + j] = hv(i,j);
+      }
+    }
+    var.putVar(start, count, buf.data());
   }
 }
 
+template <typename HostViewType>
+void NcTimeSeriesWriter::putScalarRecord(NcVar& var, const HostViewType& hv) const {
+  typedef typename HostViewType::non_const_value_type value_type;
+  const size_t n = var.getDim(1).getSize();
+  const std::vector<size_t> start = {nrec-1, 0};
+  const std::vector<size_t> count = {1, n};
+  if (hv.stride(0) == 1) {
+    var.putVar(start, count, hv.data());
+  }
+  else {
+    std::vector<value_type> buf(n);
+    for (size_t i=0; i<n; ++i) {
+      buf[i] = hv(i);
+    }
+    var.putVar(start, count, buf.data());
+  }
+}
 
+template <typename HostViewType>
+void NcTimeSeriesWriter::putVectorRecord(NcVar& var, const HostViewType& hv) const {
+  typedef typename HostViewType::non_const_value_type value_type;
+  const size_t nrows = var.getDim(1).getSize();
+  const size_t ncols = var.getDim(2).getSize();
+  const std::vector<size_t> start = {nrec-1, 0, 0};
+  const std::vector<size_t> count = {1, nrows, ncols};
+  if (std::is_same<typename HostViewType::array_layout, ko::LayoutRight>::value &&
+      hv.extent(1) == ncols) {
+    var.putVar(start, count, hv.data());
+  }
+  else {
+    std::vector<value_type> buf(nrows*ncols);
+    for (size_t i=0; i<nrows; ++i) {
+      for (size_t j=0; j<ncols; ++j) {
+        buf[i*ncols + j] = hv(i,j);
+      }
+    }
+    var.putVar(start, count, buf.data());
+  }
+}
 
 }
 #endif
@@ -1,4 +1,5 @@
 #include "LpmOctree.hpp"
+#include "LpmMemory.hpp"
 #include <vector>
 #include <iostream>
 #include <iomanip>
@@ -21,6 +22,7 @@ namespace Octree {
 */
 void Tree::initNodes() {
     assert(max_depth >= 1 && max_depth <= MAX_OCTREE_DEPTH);
+    MemoryCategoryScope mem_scope(MemTree);
     
     /// Build leaves
     NodeArrayD leaves(presorted_pts, max_depth);
@@ -6,6 +6,7 @@
 #include "LpmGeometry.hpp"
 #include "LpmUtilities.hpp"
 #include "LpmKokkosUtil.hpp"
+#include "LpmCellList.hpp"
 
 #include <cassert>
 
@@ -13,6 +14,9 @@
 
 namespace Lpm {
 
+/// Default cutoff radius for compactly evaluated PSE kernels, as a multiple of pse_eps
+static constexpr Real PSE_CUTOFF_MULTIPLE = 6.0;
+
 KOKKOS_INLINE_FUNCTION
 static Real pse_eps(const Real& dx, const Real& p=17.0/20.0 /* default value p = 0.85 */) {
   assert(p<1);
@@ -64,8 +68,8 @@ struct PlanePSEDelta8Reduce {
   void operator() (const Index& j, value_type& f) const {
     Real fj = 0;
     if (!srcmask(j)) {
-      const auto mytgt = ko::subview(tgtx, i, ko::ALL());
-      const auto mysrc = ko::subview(srcx, j, ko::ALL());
+      const auto mytgt = vec_at<2>(tgtx, i);
+      const auto mysrc = vec_at<2>(srcx, j);
       const Real rscaled = PlaneGeometry::distance(mytgt,mysrc)/pse_eps;
       fj = srcdata(j)*srcarea(j)*bivariateDeltaOrder8(rscaled)/eps2;
     }
@@ -76,6 +80,9 @@ struct PlanePSEDelta8Reduce {
 struct PlanePSELaplacian8Reduce {
   typedef Real value_type;
   typedef typename PlaneGeometry::crd_view_type crd_view;
+  static constexpr Int flops_per_pair = 23; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = 2;
+  static constexpr Int bytes_per_pair = 32;
   Index tgt_ind;
   crd_view tgtx;
   scalar_view_type tgtf;
@@ -92,8 +99,8 @@ struct PlanePSELaplacian8Reduce {
 
   KOKKOS_INLINE_FUNCTION
   void operator() (const Index& j, value_type& lap) const {
-    const auto mtgt = ko::subview(tgtx, tgt_ind, ko::ALL);
-    const auto msrc = ko::subview(srcx, j, ko::ALL);
+    const auto mtgt = vec_at<2>(tgtx, tgt_ind);
+    const auto msrc = vec_at<2>(srcx, j);
     const Real rscl = PlaneGeometry::distance(mtgt,msrc)/eps;
     const Real kern = bivariateLaplacianOrder8(rscl)/square(eps);
     const Real val = (srcf(j)-tgtf(tgt_ind))*kern*srcarea(j);
@@ -103,6 +110,9 @@ struct PlanePSELaplacian8Reduce {
 
 struct PlanePSELaplacian {
   typedef typename PlaneGeometry::crd_view_type crd_view;
+  static constexpr Int flops_per_pair = PlanePSELaplacian8Reduce::flops_per_pair; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = PlanePSELaplacian8Reduce::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = PlanePSELaplacian8Reduce::bytes_per_pair;
   scalar_view_type laplacian;
   crd_view tgtx;
   scalar_view_type tgtf;
@@ -154,5 +164,73 @@ struct PlanePSEScalarInterp {
   }
 };
 
+/** @brief PSE Laplacian using only sources within rcut = cutoff_multiple*eps of each target.
+
+  The order 8 kernel decays like exp(-r^2/eps^2), so the truncation error is below
+  roundoff for cutoff_multiple >= 6.  Complexity is O(N) per evaluation for quasi-uniform particles,
+  instead of O(N^2) for PlanePSELaplacian.
+
+  @param cells cell list of the sources, built with PlaneCellList::build and cell size ~ rcut
+*/
+struct PlanePSELaplacianCutoff {
+  typedef typename PlaneGeometry::crd_view_type crd_view;
+  scalar_view_type laplacian;
+  crd_view tgtx;
+  scalar_view_type tgtf;
+  crd_view srcx;
+  scalar_view_type srcf;
+  scalar_view_type srcarea;
+  Real eps;
+  PlaneCellList cells;
+  Real rcut;
+
+  PlanePSELaplacianCutoff(scalar_view_type& lap_out, const crd_view& tx, const scalar_view_type& tf,
+    const crd_view& sx, const scalar_view_type& sf, const scalar_view_type& sa,
+    const Real& pe, const PlaneCellList& cl, const Real& cutoff_multiple=PSE_CUTOFF_MULTIPLE) :
+    laplacian(lap_out), tgtx(tx), tgtf(tf), srcx(sx), srcf(sf), srcarea(sa), eps(pe), cells(cl),
+    rcut(cutoff_multiple*pe) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const member_type& mbr) const {
+    const Index i = mbr.league_rank();
+    Real lap = 0;
+    plane_cutoff_team_reduce(mbr, cells, srcx, vec_at<2>(tgtx, i), rcut,
+      PlanePSELaplacian8Reduce(i, tgtx, tgtf, srcx, srcf, srcarea, eps), lap);
+    laplacian(i) = lap/square(eps);
+  }
+};
+
+/** @brief PSE scalar interpolation using only sources within rcut = cutoff_multiple*eps of each target.
+
+  @see PlanePSELaplacianCutoff
+*/
+struct PlanePSEScalarInterpCutoff {
+  typedef typename PlaneGeometry::crd_view_type crd_view;
+  scalar_view_type finterp;
+  crd_view tgtx;
+  crd_view srcx;
+  scalar_view_type srcdata;
+  scalar_view_type srcarea;
+  mask_view_type srcmask;
+  Real eps;
+  PlaneCellList cells;
+  Real rcut;
+
+  PlanePSEScalarInterpCutoff(scalar_view_type& f, const crd_view& t, const crd_view& s,
+    const scalar_view_type& fs, const scalar_view_type& sa, const mask_view_type& sm,
+    const Real& ep, const PlaneCellList& cl, const Real& cutoff_multiple=PSE_CUTOFF_MULTIPLE) :
+    finterp(f), tgtx(t), srcx(s), srcdata(fs), srcarea(sa), srcmask(sm), eps(ep), cells(cl),
+    rcut(cutoff_multiple*ep) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator () (const member_type& mbr) const {
+    const Index i = mbr.league_rank();
+    Real f = 0;
+    plane_cutoff_team_reduce(mbr, cells, srcx, vec_at<2>(tgtx, i), rcut,
+      PlanePSEDelta8Reduce(i, tgtx, srcx, srcdata, srcarea, srcmask, eps), f);
+    finterp(i) = f;
+  }
+};
+
 }
 #endif
@@ -1,6 +1,11 @@
 #include "LpmPolyMesh2d.hpp"
 #include "LpmKokkosUtil.hpp"
 #include "LpmVtkIO.hpp"
+#include "LpmMemory.hpp"
+#include "LpmTimer.hpp"
+#include <mpi.h>
+#include <fstream>
+#include <iostream>
 #ifdef LPM_HAVE_NETCDF
 #include "LpmNetCDF.hpp"
 #endif
@@ -27,24 +32,87 @@ PolyMesh2d<SeedType>::PolyMesh2d(const PolyMeshReader& reader) :
   updateDevice();}
 #endif
 
+template <typename SeedType>
+PolyMesh2d<SeedType>::PolyMesh2d(const MeshCacheReader& cache) :
+  physVerts(cache.nVerts()), lagVerts(cache.nVerts()), edges(cache.nEdges()), faces(cache.nFaces()),
+  physFaces(cache.nFaces()), lagFaces(cache.nFaces()) {
+  initFromCache(cache);
+}
+
+template <typename SeedType>
+void PolyMesh2d<SeedType>::initFromCache(const MeshCacheReader& cache) {
+  LPM_TIMER_SCOPE("PolyMesh2d::initFromCache");
+  LPM_THROW_IF(cache.seedId() != SeedType::idString(), "PolyMesh2d::initFromCache error: cache holds a "
+    << cache.seedId() << " mesh, expected " << SeedType::idString());
+  physVerts.initFromCache(cache, CachePhysVerts);
+  lagVerts.initFromCache(cache, CacheLagVerts);
+  edges.initFromCache(cache);
+  faces.initFromCache(cache);
+  physFaces.initFromCache(cache, CachePhysFaces);
+  lagFaces.initFromCache(cache, CacheLagFaces);
+  baseTreeDepth = cache.getTreeDepth();
+  updateDevice();
+}
+
+template <typename SeedType>
+bool PolyMesh2d<SeedType>::treeInitCached(const Int initDepth, const MeshSeed<SeedType>& seed,
+  const std::string& cache_dir) {
+  const std::string fname = meshCacheFilename(SeedType::idString(), initDepth, cache_dir);
+  if (std::ifstream(fname).good()) {
+    try {
+      MeshCacheReader cache(fname);
+      if (cache.getTreeDepth() == initDepth) {
+        initFromCache(cache);
+        return true;
+      }
+    }
+    catch (std::logic_error&) {
+      std::cerr << "PolyMesh2d::treeInitCached: ignoring unusable cache file " << fname << "\n";
+    }
+  }
+  treeInit(initDepth, seed);
+  /// one writer per run; a failed write only costs the next run a treeInit
+  int mpi_initialized = 0;
+  int rank = 0;
+  MPI_Initialized(&mpi_initialized);
+  if (mpi_initialized) MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    try {
+      writeMeshCache(fname, *this);
+    }
+    catch (std::exception& e) {
+      std::cerr << "PolyMesh2d::treeInitCached warning: mesh cache not written (" << e.what() << ")\n";
+    }
+  }
+  return false;
+}
+
 template <typename SeedType>
 void PolyMesh2d<SeedType>::treeInit(const Int initDepth, const MeshSeed<SeedType>& seed) {
+    LPM_TIMER_SCOPE("PolyMesh2d::treeInit");
+    MemoryCategoryScope mem_scope(MemMesh);
     seedInit(seed);
     baseTreeDepth=initDepth;
     for (int i=0; i<initDepth; ++i) {
+        LPM_TIMER_SCOPE("refine level");
         Index startInd = 0;
         Index stopInd = faces.nh();
+        /// every leaf face is divided at each level
+        LPM_COUNTER_ADD("faces divided", faces.nLeavesHost());
         for (Index j=startInd; j<stopInd; ++j) {
             if (!faces.hasKidsHost(j)) {
                 divider::divide(j, physVerts, lagVerts, edges, faces, physFaces, lagFaces);
             }
         }
     }
+    LPM_TIMER_START("updateDevice");
     updateDevice();
+    LPM_TIMER_STOP();
 }
 
 template <>
 void PolyMesh2d<UnitDiskSeed>::treeInit(const Int initDepth, const MeshSeed<UnitDiskSeed>& seed) {
+  MemoryCategoryScope mem_scope(MemMesh);
   seedInit(seed);
   baseTreeDepth=initDepth;
   ko::View<Real[2],Host> vcrd("vcrd");
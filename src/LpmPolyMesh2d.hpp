@@ -50,6 +50,12 @@ template <typename SeedType> class PolyMesh2d {
   PolyMesh2d(const PolyMeshReader& reader);
 #endif
 
+  /** @brief Constructor.  Allocates exactly enough memory for a cached mesh and copies it from the cache.
+
+    @param cache mapped mesh cache file
+  */
+  PolyMesh2d(const MeshCacheReader& cache);
+
     /// Destructor
     virtual ~PolyMesh2d() {}
 
@@ -170,6 +176,30 @@ template <typename SeedType> class PolyMesh2d {
     */
     void treeInit(const Int initDepth, const MeshSeed<SeedType>& seed);
 
+    /** @brief Equivalent to treeInit, but reuses a binary mesh cache when one exists.
+
+    If the cache file for this SeedType and depth exists, the mesh is copied from it.
+    Otherwise (or if the file is unreadable), treeInit builds the mesh and the cache file is (re)written
+    by rank 0 of MPI_COMM_WORLD (if MPI is initialized); a failed write is reported as a warning.
+
+    @hostfn
+
+    @param initDepth Max depth of initially refined mesh
+    @param seed Mesh seed used to initialize particles and panels
+    @param cache_dir directory for mesh cache files
+    @return true if the mesh was loaded from the cache
+    @see meshCacheFilename()
+    */
+    bool treeInitCached(const Int initDepth, const MeshSeed<SeedType>& seed, const std::string& cache_dir="");
+
+    /** @brief Initializes the mesh from a mapped cache file, then copies it to device.
+
+    @hostfn
+
+    @param cache mapped mesh cache file; its seed type must match SeedType
+    */
+    void initFromCache(const MeshCacheReader& cache);
+
 
     /// @brief Construct relevant Vtk objects for visualization of a PolyMesh2d instance
     virtual void outputVtk(const std::string& fname) const;
@@ -203,20 +233,25 @@ template <typename SeedType> class PolyMesh2d {
 */
 template <typename SeedType> struct FaceCentroidFunctor {
   typedef typename SeedType::geo::crd_view_type crd_view;
+  /// thread-private scratch for one face's vertex coordinates
+  typedef ko::View<Real[SeedType::nfaceverts][SeedType::geo::ndim], ko::LayoutRight, Dev,
+    ko::MemoryTraits<ko::Unmanaged>> local_crd_view;
   crd_view face_crds;
   crd_view vert_crds;
   ko::View<Index*[SeedType::nfaceverts]> face_verts;
-  ko::View<Real[SeedType::nfaceverts][SeedType::geo::ndim]> local_vcrds;
 
   FaceCentroidFunctor(crd_view& fc, const crd_view& vc,
     const ko::View<Index*[SeedType::nfaceverts]>& fv) : face_crds(fc), vert_crds(vc),
-      face_verts(fv), local_vcrds("local_vcrds") {}
+      face_verts(fv) {}
 
   KOKKOS_INLINE_FUNCTION
   void operator() (const Index& i) const {
+    Real vbuf[SeedType::nfaceverts*SeedType::geo::ndim];
+    local_crd_view local_vcrds(vbuf);
     for (Int j=0; j<SeedType::nfaceverts; ++j) {
+      const auto vx = vec_at<SeedType::geo::ndim>(vert_crds, face_verts(i,j));
       for (Int k=0; k<SeedType::geo::ndim; ++k) {
-        local_vcrds(j,k) = vert_crds(face_verts(i,j),k);
+        local_vcrds(j,k) = vx[k];
       }
     }
     auto fcrd = ko::subview(face_crds, i, ko::ALL);
@@ -255,5 +290,33 @@ ko::View<Real*[3]> sourceCoords(const PolyMesh2d<SeedType>& pm) {
   return result;
 }
 
+/** @brief Collects vertex and leaf face values of a scalar field, in the same order as sourceCoords.
+
+  @param pm PolyMesh2d mesh used as data source
+  @param vert_vals field values at vertices
+  @param face_vals field values at faces
+*/
+template <typename SeedType>
+scalar_view_type sourceValues(const PolyMesh2d<SeedType>& pm, const scalar_view_type& vert_vals,
+  const scalar_view_type& face_vals) {
+  const Index nv = pm.nvertsHost();
+  const Index nf = pm.nfacesHost();
+  const Index nl = pm.faces.nLeavesHost();
+  const auto facemask = pm.faces.mask;
+  scalar_view_type result("source_values", nv + nl);
+  ko::parallel_for(nv, KOKKOS_LAMBDA (int i) {
+    result(i) = vert_vals(i);
+  });
+  ko::parallel_for(1, KOKKOS_LAMBDA (int i) {
+    Int offset = nv;
+    for (int j=0; j<nf; ++j) {
+      if (!facemask(j)) {
+        result(offset++) = face_vals(j);
+      }
+    }
+  });
+  return result;
+}
+
 }
 #endif
@@ -6,18 +6,29 @@
 #include "LpmUtilities.hpp"
 #include "LpmCoords.hpp"
 #include "LpmPolyMesh2d.hpp"
+#include "LpmVtkIO.hpp"
 #include "vtkSmartPointer.h"
 #include "vtkPointData.h"
 #include "vtkCellData.h"
 #include "vtkPolyData.h"
 #include "vtkXMLPolyDataWriter.h"
 #include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
 
 #include "Kokkos_Core.hpp"
 #include <memory>
+#include <vector>
 
 namespace Lpm {
 
+/** @brief Builds vtkPolyData from a PolyMesh2d and writes it to a .vtp file.
+
+  Arrays are filled through raw pointers, without per-tuple Insert calls, and without Kokkos
+  kernels, so the class may be used from an AsyncOutput thread.  Cells and copied arrays are
+  prepared by several host threads (see vtkHostThreads).  Point data from host views
+  whose rows are packed (e.g., LayoutRight vectors, contiguous scalars) are passed to VTK by
+  pointer, not copied; those views must not change until write returns.
+*/
 template <typename SeedType> class Polymesh2dVtkInterface {
   public:
     Polymesh2dVtkInterface(const std::shared_ptr<PolyMesh2d<SeedType>>& pm);
@@ -28,8 +39,15 @@ template <typename SeedType> class Polymesh2dVtkInterface {
     Polymesh2dVtkInterface(const std::shared_ptr<PolyMesh2d<SeedType>>& pm,
       const typename scalar_view_type::HostMirror& height_field);
 
+    /// uses vertex positions from a host copy (e.g., a StagedField) instead of the mesh's host view
+    Polymesh2dVtkInterface(const std::shared_ptr<PolyMesh2d<SeedType>>& pm,
+      const ko::View<Real**, ko::LayoutRight, ko::HostSpace>& vert_crds);
+
     void write(const std::string& ofname);
 
+    /// sets the data encoding used by write (default: VtkXmlDefault)
+    inline void setEncoding(const VtkXmlEncoding& enc) {encoding = enc;}
+
     void updatePositions();
 //     void updateAreas();
 
@@ -55,10 +73,29 @@ template <typename SeedType> class Polymesh2dVtkInterface {
     vtkSmartPointer<vtkCellData> celldata;
 
     vtkSmartPointer<vtkXMLPolyDataWriter> writer;
+    VtkXmlEncoding encoding;
+
+    /// position of each leaf face in the cell arrays; -1 for divided faces
+    std::vector<Index> leaf_ids;
+    Index nleaves;
+
+    /// host views referenced (not copied) by vtk arrays
+    std::vector<std::shared_ptr<void>> held_views;
+
+    void init(const vtkSmartPointer<vtkPoints>& pts);
+
+    template <typename ViewType>
+    vtkSmartPointer<vtkDoubleArray> point_array(const ViewType& hv, const Int ncomp, const std::string& name);
+
+    template <typename ViewType>
+    vtkSmartPointer<vtkDoubleArray> cell_array(const ViewType& hv, const Int ncomp, const std::string& name) const;
+
+    template <typename ViewType>
+    vtkSmartPointer<vtkPoints> points_from(const ViewType& vx);
 
-    vtkSmartPointer<vtkPoints> make_points() const;
+    vtkSmartPointer<vtkPoints> make_points();
     vtkSmartPointer<vtkPoints> make_points(const typename scalar_view_type::HostMirror& h) const;
-    vtkSmartPointer<vtkCellArray> make_cells() const;
+    vtkSmartPointer<vtkPoints> make_points(const ko::View<Real**, ko::LayoutRight, ko::HostSpace>& vx);
     vtkSmartPointer<vtkDoubleArray> make_cell_area() const;
 };
 }
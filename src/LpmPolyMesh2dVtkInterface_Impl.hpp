@@ -2,98 +2,171 @@
 
 #define LPM_POLYMESH2D_VTK_INTERFACE_IMPL_HPP
 #include "LpmPolyMesh2dVtkInterface.hpp"
+#include "LpmTimer.hpp"
 #include <cassert>
 
 namespace Lpm {
 
-template <typename SeedType>
-Polymesh2dVtkInterface<SeedType>::Polymesh2dVtkInterface(const std::shared_ptr<PolyMesh2d<SeedType>>& pm) :
-  mesh(pm) {
+/// entry (i,j) of a rank-1 (j ignored) or rank-2 host view
+template <typename ViewType> inline
+typename std::enable_if<ViewType::rank == 1, Real>::type vtk_host_entry(const ViewType& v, const Index i,
+  const Int j) {return v(i);}
 
-  polydata = vtkSmartPointer<vtkPolyData>::New();
+template <typename ViewType> inline
+typename std::enable_if<ViewType::rank == 2, Real>::type vtk_host_entry(const ViewType& v, const Index i,
+  const Int j) {return v(i,j);}
 
-  const auto pts = make_points();
-  const auto polys = make_cells();
-  const auto ca = make_cell_area();
-  polydata->SetPoints(pts);
-  polydata->SetPolys(polys);
-  polydata->GetCellData()->AddArray(ca);
+template <typename SeedType>
+Polymesh2dVtkInterface<SeedType>::Polymesh2dVtkInterface(const std::shared_ptr<PolyMesh2d<SeedType>>& pm) :
+  mesh(pm), encoding(VtkXmlDefault) {
+  init(make_points());
 }
 
 template <typename SeedType>
 Polymesh2dVtkInterface<SeedType>::Polymesh2dVtkInterface(
   const std::shared_ptr<PolyMesh2d<SeedType>>& pm, const scalar_view_type& height_field):
-  mesh(pm) {
-
-  polydata = vtkSmartPointer<vtkPolyData>::New();
+  mesh(pm), encoding(VtkXmlDefault) {
 
   auto hh = ko::create_mirror_view(height_field);
   ko::deep_copy(hh, height_field);
 
-  const auto pts = make_points(hh);
-  const auto polys = make_cells();
-  const auto ca = make_cell_area();
-  polydata->SetPoints(pts);
-  polydata->SetPolys(polys);
-  polydata->GetCellData()->AddArray(ca);
+  init(make_points(hh));
 }
 
 template <typename SeedType>
 Polymesh2dVtkInterface<SeedType>::Polymesh2dVtkInterface(
   const std::shared_ptr<PolyMesh2d<SeedType>>& pm,
   const typename scalar_view_type::HostMirror& height_field):
-  mesh(pm) {
+  mesh(pm), encoding(VtkXmlDefault) {
+  init(make_points(height_field));
+}
+
+template <typename SeedType>
+Polymesh2dVtkInterface<SeedType>::Polymesh2dVtkInterface(
+  const std::shared_ptr<PolyMesh2d<SeedType>>& pm,
+  const ko::View<Real**, ko::LayoutRight, ko::HostSpace>& vert_crds):
+  mesh(pm), encoding(VtkXmlDefault) {
+  init(make_points(vert_crds));
+}
 
+template <typename SeedType>
+void Polymesh2dVtkInterface<SeedType>::init(const vtkSmartPointer<vtkPoints>& pts) {
   polydata = vtkSmartPointer<vtkPolyData>::New();
 
-  const auto pts = make_points(height_field);
-  const auto polys = make_cells();
+  VtkLeafCells leaves(mesh->faces);
+  leaf_ids.swap(leaves.leaf_ids);
+  nleaves = leaves.nleaves;
+
   const auto ca = make_cell_area();
   polydata->SetPoints(pts);
-  polydata->SetPolys(polys);
+  polydata->SetPolys(leaves.cells);
   polydata->GetCellData()->AddArray(ca);
 }
 
-template <typename SeedType>
-vtkSmartPointer<vtkPoints> Polymesh2dVtkInterface<SeedType>::make_points() const {
-  auto result = vtkSmartPointer<vtkPoints>::New();
-  const auto vx = mesh->physVerts.getHostCrdView();
-  Real crds[SeedType::geo::ndim];
-  for (Index i=0; i<mesh->nvertsHost(); ++i) {
-    for (Short j=0; j<SeedType::geo::ndim; ++j) {
-      crds[j] = vx(i,j);
-    }
-    result->InsertNextPoint(crds[0], crds[1], (SeedType::geo::ndim == 3 ? crds[2] : 0.0));
+template <typename SeedType> template <typename ViewType>
+vtkSmartPointer<vtkDoubleArray> Polymesh2dVtkInterface<SeedType>::point_array(const ViewType& hv,
+  const Int ncomp, const std::string& name) {
+  auto result = vtkSmartPointer<vtkDoubleArray>::New();
+  result->SetName(name.c_str());
+  result->SetNumberOfComponents(ncomp);
+  const Index n = mesh->nvertsHost();
+  const bool packed = (ViewType::rank == 1 ? hv.stride_0() == 1 :
+    (hv.stride_0() == size_t(ncomp) && hv.stride_1() == 1));
+  if (packed) {
+    /// vtk does not free or write to the array (save = 1); held_views keeps it allocated
+    result->SetArray(const_cast<Real*>(hv.data()), vtkIdType(n)*ncomp, 1);
+    held_views.push_back(std::make_shared<ViewType>(hv));
+  }
+  else {
+    result->SetNumberOfTuples(n);
+    Real* ptr = result->GetPointer(0);
+    vtkHostBlocks(n, vtkHostBlockCount(n), [&](const Index begin, const Index end, const Int b) {
+      for (Index i=begin; i<end; ++i) {
+        for (Int j=0; j<ncomp; ++j) {
+          ptr[vtkIdType(i)*ncomp + j] = vtk_host_entry(hv, i, j);
+        }
+      }
+    });
   }
   return result;
 }
 
-template <typename SeedType>
-vtkSmartPointer<vtkPoints> Polymesh2dVtkInterface<SeedType>::make_points(
-  const typename scalar_view_type::HostMirror& height_field) const {
-  auto result = vtkSmartPointer<vtkPoints>::New();
-  const auto vx = mesh->physVerts.getHostCrdView();
-  Real crds[2];
-  for (Index i=0; i<mesh->nvertsHost(); ++i) {
-    for (Short j=0; j<2; ++j) {
-      crds[j] = vx(i,j);
+template <typename SeedType> template <typename ViewType>
+vtkSmartPointer<vtkDoubleArray> Polymesh2dVtkInterface<SeedType>::cell_array(const ViewType& hv,
+  const Int ncomp, const std::string& name) const {
+  auto result = vtkSmartPointer<vtkDoubleArray>::New();
+  result->SetName(name.c_str());
+  result->SetNumberOfComponents(ncomp);
+  result->SetNumberOfTuples(nleaves);
+  Real* ptr = result->GetPointer(0);
+  const Index nf = mesh->nfacesHost();
+  vtkHostBlocks(nf, vtkHostBlockCount(nf), [&](const Index begin, const Index end, const Int b) {
+    for (Index i=begin; i<end; ++i) {
+      const Index k = leaf_ids[i];
+      if (k >= 0) {
+        for (Int j=0; j<ncomp; ++j) {
+          ptr[vtkIdType(k)*ncomp + j] = vtk_host_entry(hv, i, j);
+        }
+      }
     }
-    result->InsertNextPoint(crds[0], crds[1], height_field(i));
+  });
+  return result;
+}
+
+template <typename SeedType> template <typename ViewType>
+vtkSmartPointer<vtkPoints> Polymesh2dVtkInterface<SeedType>::points_from(const ViewType& vx) {
+  auto result = vtkSmartPointer<vtkPoints>::New();
+  if (SeedType::geo::ndim == 3) {
+    result->SetData(point_array(vx, 3, "points"));
+  }
+  else {
+    /// vtk points always have 3 components
+    const Index n = mesh->nvertsHost();
+    auto pts = vtkSmartPointer<vtkDoubleArray>::New();
+    pts->SetNumberOfComponents(3);
+    pts->SetNumberOfTuples(n);
+    Real* ptr = pts->GetPointer(0);
+    vtkHostBlocks(n, vtkHostBlockCount(n), [&](const Index begin, const Index end, const Int b) {
+      for (Index i=begin; i<end; ++i) {
+        ptr[3*vtkIdType(i)] = vx(i,0);
+        ptr[3*vtkIdType(i)+1] = vx(i,1);
+        ptr[3*vtkIdType(i)+2] = 0;
+      }
+    });
+    result->SetData(pts);
   }
   return result;
 }
 
 template <typename SeedType>
-vtkSmartPointer<vtkCellArray> Polymesh2dVtkInterface<SeedType>::make_cells() const {
-  auto result = vtkSmartPointer<vtkCellArray>::New();
-  for (Index i=0; i<mesh->nfacesHost(); ++i) {
-    if (!mesh->faces.hasKidsHost(i)) {
-      result->InsertNextCell(SeedType::nfaceverts);
-      for (Int j=0; j<SeedType::nfaceverts; ++j) {
-        result->InsertCellPoint(mesh->faces.getVertHost(i,j));
-      }
+vtkSmartPointer<vtkPoints> Polymesh2dVtkInterface<SeedType>::make_points(
+  const ko::View<Real**, ko::LayoutRight, ko::HostSpace>& vx) {
+  return points_from(vx);
+}
+
+template <typename SeedType>
+vtkSmartPointer<vtkPoints> Polymesh2dVtkInterface<SeedType>::make_points() {
+  return points_from(mesh->physVerts.getHostCrdView());
+}
+
+template <typename SeedType>
+vtkSmartPointer<vtkPoints> Polymesh2dVtkInterface<SeedType>::make_points(
+  const typename scalar_view_type::HostMirror& height_field) const {
+  auto result = vtkSmartPointer<vtkPoints>::New();
+  const auto vx = mesh->physVerts.getHostCrdView();
+  const Index n = mesh->nvertsHost();
+  auto pts = vtkSmartPointer<vtkDoubleArray>::New();
+  pts->SetNumberOfComponents(3);
+  pts->SetNumberOfTuples(n);
+  Real* ptr = pts->GetPointer(0);
+  vtkHostBlocks(n, vtkHostBlockCount(n), [&](const Index begin, const Index end, const Int b) {
+    for (Index i=begin; i<end; ++i) {
+      ptr[3*vtkIdType(i)] = vx(i,0);
+      ptr[3*vtkIdType(i)+1] = vx(i,1);
+      ptr[3*vtkIdType(i)+2] = height_field(i);
     }
-  }
+  });
+  result->SetData(pts);
   return result;
 }
 
@@ -111,17 +184,7 @@ void Polymesh2dVtkInterface<SeedType>::addTracers(const std::vector<scalar_view_
 
 template <typename SeedType>
 vtkSmartPointer<vtkDoubleArray> Polymesh2dVtkInterface<SeedType>::make_cell_area() const {
-  auto result = vtkSmartPointer<vtkDoubleArray>::New();
-  result->SetName("area");
-  result->SetNumberOfComponents(1);
-  result->SetNumberOfTuples(mesh->faces.nLeavesHost());
-  Index ctr = 0;
-  for (Index i=0; i<mesh->nfacesHost(); ++i) {
-    if (!mesh->faces.hasKidsHost(i)) {
-      result->InsertTuple1(ctr++,mesh->faces.getAreaHost(i));
-    }
-  }
-  return result;
+  return cell_array(mesh->faces.getAreaHost(), 1, "area");
 }
 
 template <typename SeedType>
@@ -140,7 +203,9 @@ void Polymesh2dVtkInterface<SeedType>::updatePositions() {
 
 template <typename SeedType>
 void Polymesh2dVtkInterface<SeedType>::write(const std::string& ofname){
+  LPM_TIMER_SCOPE("Polymesh2dVtkInterface::write");
   this->writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+  setVtkXmlEncoding(writer, encoding);
   writer->SetInputData(this->polydata);
   writer->SetFileName(ofname.c_str());
   writer->Write();
@@ -149,83 +214,33 @@ void Polymesh2dVtkInterface<SeedType>::write(const std::string& ofname){
 template <typename SeedType> template <typename ViewType>
 void Polymesh2dVtkInterface<SeedType>::addScalarPointData(const ViewType& s, const std::string& name) {
   auto pdata_host = ko::create_mirror_view(s);
-  ko::deep_copy(pdata_host, s);
-
-  auto pd = vtkSmartPointer<vtkDoubleArray>::New();
-  pd->SetName((name.empty() ? s.label().c_str() : name.c_str()));
-  pd->SetNumberOfComponents(1);
-  pd->SetNumberOfTuples(mesh->nvertsHost());
-  for (Index i=0; i<mesh->nvertsHost(); ++i) {
-    pd->InsertTuple1(i, pdata_host(i));
-  }
-  polydata->GetPointData()->AddArray(pd);
+  if (pdata_host.data() != s.data()) ko::deep_copy(pdata_host, s);
+
+  polydata->GetPointData()->AddArray(point_array(pdata_host, 1, (name.empty() ? s.label() : name)));
 }
 
 template <typename SeedType> template <typename ViewType>
 void Polymesh2dVtkInterface<SeedType>::addVectorPointData(const ViewType& v, const std::string& name) {
   auto pdata_host = ko::create_mirror_view(v);
-  ko::deep_copy(pdata_host, v);
+  if (pdata_host.data() != v.data()) ko::deep_copy(pdata_host, v);
 
-  auto pd = vtkSmartPointer<vtkDoubleArray>::New();
-  pd->SetName((name.empty() ? v.label().c_str() : name.c_str()));
-  pd->SetNumberOfComponents(v.extent(1));
-  pd->SetNumberOfTuples(mesh->nvertsHost());
-  if (SeedType::geo::ndim == 3) {
-    for (Index i=0; i<mesh->nvertsHost(); ++i) {
-      pd->InsertTuple3(i,pdata_host(i,0), pdata_host(i,1), (SeedType::geo::ndim == 3 ? pdata_host(i,2) : 0.0));
-    }
-  }
-  else {
-    for (Index i=0; i<mesh->nvertsHost(); ++i) {
-      pd->InsertTuple2(i,pdata_host(i,0), pdata_host(i,1));
-    }
-  }
-  polydata->GetPointData()->AddArray(pd);
+  polydata->GetPointData()->AddArray(point_array(pdata_host, v.extent(1), (name.empty() ? v.label() : name)));
 }
 
 template <typename SeedType> template <typename ViewType>
 void Polymesh2dVtkInterface<SeedType>::addScalarCellData(const ViewType& s, const std::string& name) {
   auto cdata_host = ko::create_mirror_view(s);
-  ko::deep_copy(cdata_host, s);
-
-  auto cd = vtkSmartPointer<vtkDoubleArray>::New();
-  cd->SetName((name.empty() ? s.label().c_str() : name.c_str()));
-  cd->SetNumberOfComponents(1);
-  cd->SetNumberOfTuples(mesh->faces.nLeavesHost());
-  Index ctr = 0;
-  for (Index i=0; i<mesh->nfacesHost(); ++i) {
-    if (!mesh->faces.hasKidsHost(i)) {
-      cd->InsertTuple1(ctr++, cdata_host(i));
-    }
-  }
-  polydata->GetCellData()->AddArray(cd);
+  if (cdata_host.data() != s.data()) ko::deep_copy(cdata_host, s);
+
+  polydata->GetCellData()->AddArray(cell_array(cdata_host, 1, (name.empty() ? s.label() : name)));
 }
 
 template <typename SeedType> template <typename ViewType>
 void Polymesh2dVtkInterface<SeedType>::addVectorCellData(const ViewType& v, const std::string& name) {
   auto cdata_host = ko::create_mirror_view(v);
-  ko::deep_copy(cdata_host, v);
+  if (cdata_host.data() != v.data()) ko::deep_copy(cdata_host, v);
 
-  auto cd = vtkSmartPointer<vtkDoubleArray>::New();
-  cd->SetName((name.empty() ? v.label().c_str() : name.c_str()));
-  cd->SetNumberOfComponents(v.extent(1));
-  cd->SetNumberOfTuples(mesh->faces.nLeavesHost());
-  Index ctr = 0;
-  if (SeedType::geo::ndim == 3) {
-  for (Index i=0; i<mesh->nfacesHost(); ++i) {
-    if (!mesh->faces.hasKidsHost(i)) {
-      cd->InsertTuple3(ctr++, cdata_host(i,0),cdata_host(i,1), (SeedType::geo::ndim == 3 ? cdata_host(i,2) : 0.0));
-    }
-  }
-  }
-  else {
-    for (Index i=0; i<mesh->nfacesHost(); ++i) {
-      if (!mesh->faces.hasKidsHost(i)) {
-        cd->InsertTuple2(ctr++, cdata_host(i,0), cdata_host(i,1));
-      }
-    }
-  }
-  polydata->GetCellData()->AddArray(cd);
+  polydata->GetCellData()->AddArray(cell_array(cdata_host, v.extent(1), (name.empty() ? v.label() : name)));
 }
 
 }
@@ -0,0 +1,275 @@
+#include "LpmRingSum.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmUtilities.hpp"
+#include "LpmTimer.hpp"
+#include <algorithm>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace Lpm {
+
+/** @brief Adds the contributions of one block of packed sources to the stream function and velocity
+  at each target.
+ @device
+ @par Parallel pattern:
+ 1 thread team per target site performs two reductions -- 1 for stream function and 1 for velocity
+*/
+struct RingBlockSum {
+  scalar_view_type psi; ///< [in/out] stream function at targets
+  vec_view u; ///< [in/out] velocity at targets
+  crd_view tgtx; ///< [input] target coordinates
+  ko::View<Index*,Dev> tgt_ids; ///< [input] global source index of each target, or -1
+  RingDirectSum::block_view src; ///< [input] packed sources
+  Index nsrc; ///< [input] number of sources in src
+
+  RingBlockSum(scalar_view_type& p, vec_view& vel, const crd_view& x, const ko::View<Index*,Dev>& ids,
+    const RingDirectSum::block_view& s, const Index n) : psi(p), u(vel), tgtx(x), tgt_ids(ids), src(s), nsrc(n) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const member_type& mbr) const {
+    const Index i = mbr.league_rank();
+    const auto mytgt = vec_at<3>(tgtx, i);
+    const Index myid = tgt_ids(i);
+    Real p = 0;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, nsrc), [=] (const Index& j, Real& pot) {
+      if (Index(src(j,4)) != myid) {
+        const ko::Tuple<Real,3> mysrc(src(j,0), src(j,1), src(j,2));
+        Real potential;
+        greensFn(potential, mytgt, mysrc, src(j,3), 1);
+        pot += potential;
+      }
+    }, p);
+    ko::Tuple<Real,3> vel;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, nsrc), [=] (const Index& j, ko::Tuple<Real,3>& v) {
+      if (Index(src(j,4)) != myid) {
+        const ko::Tuple<Real,3> mysrc(src(j,0), src(j,1), src(j,2));
+        ko::Tuple<Real,3> uj;
+        biotSavart(uj, mytgt, mysrc, src(j,3), 1);
+        v += uj;
+      }
+    }, vel);
+    ko::single(ko::PerTeam(mbr), [=] () {
+      psi(i) += p;
+      for (Short j=0; j<3; ++j) {
+        u(i,j) += vel[j];
+      }
+    });
+  }
+};
+
+RingDirectSum::RingDirectSum(MPI_Comm c) : comm(c), nsrc_local(0), nmax_block(0), wait_time(0) {
+  MPI_Comm_rank(comm, &comm_rank);
+  MPI_Comm_size(comm, &comm_size);
+}
+
+void RingDirectSum::setSources(const crd_view_type& srcx, const scalar_view_type& vort,
+  const scalar_view_type& area, const mask_view_type& mask, const Index nsrc) {
+  Index offset, nlocal;
+  blockRange(offset, nlocal, nsrc, comm_rank, comm_size);
+  if (local_block.extent(0) < nlocal) {
+    local_block = block_view("ring_local_sources", nlocal);
+  }
+
+  /// compact this rank's leaf sources
+  const auto blk = local_block;
+  Index nleaves = 0;
+  ko::parallel_scan(nlocal, KOKKOS_LAMBDA (const Index& i, Index& ct, const bool final) {
+    const Index k = offset + i;
+    if (!mask(k)) {
+      if (final) {
+        for (Short j=0; j<3; ++j) {
+          blk(ct,j) = srcx(k,j);
+        }
+        blk(ct,3) = vort(k)*area(k);
+        blk(ct,4) = k;
+      }
+      ++ct;
+    }
+  }, nleaves);
+  nsrc_local = nleaves;
+
+  Index nmax;
+  MPI_Allreduce(&nsrc_local, &nmax, 1, MPI_INT, MPI_MAX, comm);
+  if (nmax > nmax_block) {
+    current_block = block_view("ring_current_sources", nmax);
+    send_buf = host_block_view("ring_send_buffer", nmax);
+    recv_buf = host_block_view("ring_recv_buffer", nmax);
+  }
+  nmax_block = std::max(nmax, nmax_block);
+}
+
+void RingDirectSum::resizeTargets(const Index ntgt) {
+  if (Index(local_tgt_ids.extent(0)) != ntgt) {
+    local_tgt_ids = ko::View<Index*,Dev>("ring_tgt_ids", ntgt);
+  }
+}
+
+void RingDirectSum::compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx) {
+  resizeTargets(tgtx.extent(0));
+  ko::deep_copy(local_tgt_ids, NULL_IND);
+  compute(psi, u, tgtx, local_tgt_ids);
+}
+
+void RingDirectSum::compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx,
+  const Index tgt_offset) {
+  resizeTargets(tgtx.extent(0));
+  const auto ids = local_tgt_ids;
+  ko::parallel_for(tgtx.extent(0), KOKKOS_LAMBDA (const Index& i) {
+    ids(i) = tgt_offset + i;
+  });
+  compute(psi, u, tgtx, local_tgt_ids);
+}
+
+void RingDirectSum::computeGathered(scalar_view_type& vert_psi, vec_view_type& vert_u,
+  scalar_view_type& face_psi, vec_view_type& face_u, const crd_view_type& vx, const Index nv,
+  const crd_view_type& fx, const Index nf) {
+  Index voffset, nvlocal, foffset, nflocal;
+  blockRange(voffset, nvlocal, nv, comm_rank, comm_size);
+  blockRange(foffset, nflocal, nf, comm_rank, comm_size);
+
+  /// one target set: local vertices, then local faces
+  const Index ntgt = nvlocal + nflocal;
+  resizeTargets(ntgt);
+  if (Index(local_tgtx.extent(0)) != ntgt) {
+    local_tgtx = crd_view_type("ring_tgts", ntgt);
+    local_psi = scalar_view_type("ring_psi", ntgt);
+    local_u = vec_view_type("ring_u", ntgt);
+  }
+  const auto tgtx = local_tgtx;
+  const auto ids = local_tgt_ids;
+  ko::parallel_for("RingDirectSum targets", ntgt, KOKKOS_LAMBDA (const Index& i) {
+    const bool is_vert = (i < nvlocal);
+    const Index k = (is_vert ? voffset + i : foffset + i - nvlocal);
+    for (Short j=0; j<3; ++j) {
+      tgtx(i,j) = (is_vert ? vx(k,j) : fx(k,j));
+    }
+    ids(i) = (is_vert ? NULL_IND : k);
+  });
+
+  compute(local_psi, local_u, local_tgtx, local_tgt_ids);
+
+  if (vert_psi.extent(0) > 0) allgather(vert_psi, local_psi, nv);
+  allgather(vert_u, local_u, nv);
+  if (face_psi.extent(0) > 0) allgather(face_psi, local_psi, nf, nvlocal);
+  allgather(face_u, local_u, nf, nvlocal);
+}
+
+void RingDirectSum::compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx,
+  const ko::View<Index*,Dev>& tgt_ids) {
+  LPM_TIMER_SCOPE("RingDirectSum::compute");
+  const Index ntgt = tgtx.extent(0);
+  ko::deep_copy(psi, 0);
+  ko::deep_copy(u, 0);
+
+  const Int right = (comm_rank + 1) % comm_size;
+  const Int left = (comm_rank + comm_size - 1) % comm_size;
+  const Int nreal = 5;
+  const Int tag = 44;
+
+  /// step 0 uses this rank's own sources
+  ko::deep_copy(ko::subview(current_block, std::make_pair(Index(0), nsrc_local), ko::ALL()),
+    ko::subview(local_block, std::make_pair(Index(0), nsrc_local), ko::ALL()));
+  ko::deep_copy(send_buf, current_block);
+  Index ncur = nsrc_local;
+
+  ko::TeamPolicy<> policy(ntgt, ko::AUTO());
+  for (Int step=0; step<comm_size; ++step) {
+    const bool pass = (step < comm_size-1);
+    MPI_Request reqs[2];
+    if (pass) {
+      MPI_Irecv(recv_buf.data(), nreal*nmax_block, mpi_real_type(), left, tag, comm, &reqs[0]);
+      MPI_Isend(send_buf.data(), nreal*ncur, mpi_real_type(), right, tag, comm, &reqs[1]);
+    }
+    /// local kernel overlaps the exchange of the next block
+    ko::parallel_for(policy, RingBlockSum(psi, u, tgtx, tgt_ids, current_block, ncur));
+    ko::fence();
+    if (pass) {
+      MPI_Status stats[2];
+      const Real t0 = MPI_Wtime();
+      MPI_Waitall(2, reqs, stats);
+      wait_time += MPI_Wtime() - t0;
+      Int nrecv;
+      MPI_Get_count(&stats[0], mpi_real_type(), &nrecv);
+      ncur = nrecv/nreal;
+      ko::deep_copy(current_block, recv_buf);
+      std::swap(send_buf, recv_buf);
+    }
+  }
+}
+
+template <typename SeedType>
+void RingDirectSum::solve(scalar_view_type& vert_psi, vec_view_type& vert_u, scalar_view_type& face_psi,
+  vec_view_type& face_u, const PolyMesh2d<SeedType>& mesh, const scalar_view_type& face_vort) {
+  const Index nv = mesh.nvertsHost();
+  const Index nf = mesh.nfacesHost();
+  setSources(mesh.physFaces.crds, face_vort, mesh.faces.area, mesh.faces.mask, nf);
+  computeGathered(vert_psi, vert_u, face_psi, face_u, mesh.physVerts.crds, nv, mesh.physFaces.crds, nf);
+}
+
+/// receive counts and displacements (in Reals) for a blockRange partition with ncols values per row
+static void gather_counts(std::vector<Int>& counts, std::vector<Int>& displs, const Index nglobal,
+  const Int ncols, const Int nranks) {
+  counts.resize(nranks);
+  displs.resize(nranks);
+  for (Int r=0; r<nranks; ++r) {
+    Index offset, nlocal;
+    blockRange(offset, nlocal, nglobal, r, nranks);
+    counts[r] = ncols*nlocal;
+    displs[r] = ncols*offset;
+  }
+}
+
+void RingDirectSum::allgather(scalar_view_type& dst, const scalar_view_type& src, const Index nglobal,
+  const Index src_offset) const {
+  std::vector<Int> counts, displs;
+  gather_counts(counts, displs, nglobal, 1, comm_size);
+  auto src_host = ko::create_mirror_view(src);
+  ko::deep_copy(src_host, src);
+  ko::View<Real*, ko::HostSpace> dst_host("ring_gather_scalar", nglobal);
+  MPI_Allgatherv(src_host.data() + src_offset, counts[comm_rank], mpi_real_type(), dst_host.data(), counts.data(),
+    displs.data(), mpi_real_type(), comm);
+  ko::deep_copy(ko::subview(dst, std::make_pair(Index(0), nglobal)), dst_host);
+}
+
+void RingDirectSum::allgather(vec_view_type& dst, const vec_view_type& src, const Index nglobal,
+  const Index src_offset) const {
+  std::vector<Int> counts, displs;
+  gather_counts(counts, displs, nglobal, 3, comm_size);
+  const Index nlocal = counts[comm_rank]/3;
+  auto src_host = ko::create_mirror_view(src);
+  ko::deep_copy(src_host, src);
+  ko::View<Real*[3], ko::LayoutRight, ko::HostSpace> send("ring_gather_send", nlocal);
+  for (Index i=0; i<nlocal; ++i) {
+    for (Short j=0; j<3; ++j) {
+      send(i,j) = src_host(src_offset+i,j);
+    }
+  }
+  ko::View<Real*[3], ko::LayoutRight, ko::HostSpace> recv("ring_gather_recv", nglobal);
+  MPI_Allgatherv(send.data(), counts[comm_rank], mpi_real_type(), recv.data(), counts.data(),
+    displs.data(), mpi_real_type(), comm);
+  auto dst_host = ko::create_mirror_view(dst);
+  for (Index i=0; i<nglobal; ++i) {
+    for (Short j=0; j<3; ++j) {
+      dst_host(i,j) = recv(i,j);
+    }
+  }
+  ko::deep_copy(dst, dst_host);
+}
+
+std::string RingDirectSum::infoString() const {
+  std::ostringstream ss;
+  ss << "RingDirectSum info: rank " << comm_rank << " of " << comm_size << ", " << nsrc_local
+     << " local sources (max. block " << nmax_block << "), comm. wait time " << wait_time << " s\n";
+  return ss.str();
+}
+
+/// ETI
+template void RingDirectSum::solve(scalar_view_type& vert_psi, vec_view_type& vert_u,
+  scalar_view_type& face_psi, vec_view_type& face_u, const PolyMesh2d<IcosTriSphereSeed>& mesh,
+  const scalar_view_type& face_vort);
+template void RingDirectSum::solve(scalar_view_type& vert_psi, vec_view_type& vert_u,
+  scalar_view_type& face_psi, vec_view_type& face_u, const PolyMesh2d<CubedSphereSeed>& mesh,
+  const scalar_view_type& face_vort);
+
+}
@@ -0,0 +1,152 @@
+#ifndef LPM_RING_SUM_HPP
+#define LPM_RING_SUM_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <string>
+
+namespace Lpm {
+
+/** @brief Distributed direct sum for the sphere's stream function and Biot-Savart velocity.
+
+  Computes, at each target x,
+    psi(x) = -sum_j log(1 - x.y_j) zeta_j A_j / (4 pi),
+    u(x) = -sum_j (x cross y_j) zeta_j A_j / (4 pi (1 - x.y_j)),
+  which is the sum used by BVEVertexSolve/BVEFaceSolve (BVE) and VertexSolve/FaceSolve (SpherePoisson).
+
+  Every rank holds the same mesh.  Each rank owns a blockRange of source faces and a blockRange of targets.
+  Its leaf sources are packed into a block (coordinates, strength zeta*A, and global face index); blocks
+  travel around a ring of ranks (rank r sends to r+1 and receives from r-1).  At each of the nranks steps,
+  the next block is exchanged with non-blocking MPI while the kernel sums the current block into the local
+  targets, so communication overlaps computation.
+
+  Blocks are exchanged through host buffers; MPI need not be device-aware.
+
+  Typical use, each time step:
+    1. ring.setSources(face_crds, face_vort, face_area, face_mask, nfaces)
+    2. ring.computeGathered(vert_psi, vert_u, face_psi, face_u, vert_crds, nverts, face_crds, nfaces),
+       which sums at this rank's vertices and faces with one pass of the ring and gathers the results.
+       Lower level: ring.compute(psi, u, tgt_crds) for distinct targets (vertices), or
+       ring.compute(psi, u, tgt_crds, offset) for targets collocated with the sources (faces).
+  Each call to compute rotates all source blocks around the ring, so vertices and faces should share one call.
+*/
+class RingDirectSum {
+  public:
+    typedef typename SphereGeometry::crd_view_type crd_view_type;
+    typedef typename SphereGeometry::vec_view_type vec_view_type;
+    /// packed sources: x, y, z, strength, global index
+    typedef ko::View<Real*[5], ko::LayoutRight, Dev> block_view;
+    typedef ko::View<Real*[5], ko::LayoutRight, ko::HostSpace> host_block_view;
+
+    RingDirectSum(MPI_Comm c=MPI_COMM_WORLD);
+
+    /** @brief Packs this rank's leaf sources.
+
+      Sources are rows [src_offset, src_offset + n_local) of the global arrays, with (src_offset, n_local)
+      given by blockRange(src_offset, n_local, nsrc, rank, nranks).
+
+      @param srcx source coordinates (all rows, identical on every rank)
+      @param vort source vorticity
+      @param area source areas
+      @param mask sources with mask = true (divided panels) are excluded
+      @param nsrc global number of sources
+    */
+    void setSources(const crd_view_type& srcx, const scalar_view_type& vort, const scalar_view_type& area,
+      const mask_view_type& mask, const Index nsrc);
+
+    /** @brief Computes psi and u at targets distinct from all sources.
+
+      @param [out] psi stream function at local targets
+      @param [out] u velocity at local targets
+      @param [in] tgtx coordinates of this rank's targets
+    */
+    void compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx);
+
+    /** @brief Computes psi and u at targets that coincide with sources; local target i is global source
+      tgt_offset + i, and it does not contribute to its own sum.
+    */
+    void compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx, const Index tgt_offset);
+
+    /** @brief Computes psi and u at local targets with one pass of the ring.
+
+      @param [out] psi stream function at local targets
+      @param [out] u velocity at local targets
+      @param [in] tgtx coordinates of this rank's targets
+      @param [in] tgt_ids global source index of each target (excluded from its own sum), or NULL_IND
+    */
+    void compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx,
+      const ko::View<Index*,Dev>& tgt_ids);
+
+    /** @brief Computes psi and u at all vertices and faces, then gathers them on every rank.
+
+      This rank's targets are its blockRange of the nv vertices followed by its blockRange of the nf faces;
+      both are summed in one pass of the ring.  setSources must be called first.
+
+      @param [out] vert_psi stream function at all vertices; not gathered if it has extent 0
+      @param [out] vert_u velocity at all vertices
+      @param [out] face_psi stream function at all faces; not gathered if it has extent 0
+      @param [out] face_u velocity at all faces
+      @param [in] vx vertex coordinates (all rows, identical on every rank)
+      @param [in] nv global number of vertices
+      @param [in] fx face coordinates (all rows, identical on every rank)
+      @param [in] nf global number of faces
+    */
+    void computeGathered(scalar_view_type& vert_psi, vec_view_type& vert_u, scalar_view_type& face_psi,
+      vec_view_type& face_u, const crd_view_type& vx, const Index nv, const crd_view_type& fx, const Index nf);
+
+    /** @brief Solves for the stream function and velocity at all vertices and faces of a mesh.
+
+      Targets are partitioned over ranks; the local results are then gathered, so on return every rank holds
+      complete arrays (as if BVEVertexSolve and BVEFaceSolve had been called).
+    */
+    template <typename SeedType>
+    void solve(scalar_view_type& vert_psi, vec_view_type& vert_u, scalar_view_type& face_psi,
+      vec_view_type& face_u, const PolyMesh2d<SeedType>& mesh, const scalar_view_type& face_vort);
+
+    /** @brief Gathers rows from all ranks' blockRange partitions of nglobal rows.
+
+      Local rows [src_offset, src_offset + nlocal) of src are copied to rows [offset, offset + nlocal) of dst
+      on every rank.
+    */
+    void allgather(scalar_view_type& dst, const scalar_view_type& src, const Index nglobal,
+      const Index src_offset=0) const;
+    void allgather(vec_view_type& dst, const vec_view_type& src, const Index nglobal,
+      const Index src_offset=0) const;
+
+    inline Int rank() const {return comm_rank;}
+    inline Int nranks() const {return comm_size;}
+
+    /// number of leaf sources owned by this rank
+    inline Index nLocalSources() const {return nsrc_local;}
+
+    /// cumulative time (seconds) this rank has spent waiting for ring messages after its local kernel finished
+    inline Real commWaitTime() const {return wait_time;}
+
+    std::string infoString() const;
+
+  protected:
+    /// reallocates the target work arrays if their size changes
+    void resizeTargets(const Index ntgt);
+
+    MPI_Comm comm;
+    Int comm_rank;
+    Int comm_size;
+    Index nsrc_local;
+    Index nmax_block;
+    block_view local_block;
+    block_view current_block;
+    host_block_view send_buf;
+    host_block_view recv_buf;
+    ko::View<Index*,Dev> local_tgt_ids; ///< ids of local targets
+    crd_view_type local_tgtx; ///< local targets of computeGathered
+    scalar_view_type local_psi;
+    vec_view_type local_u;
+    Real wait_time;
+};
+
+}
+#endif
@@ -0,0 +1,139 @@
+#include "LpmRoofline.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace Lpm {
+
+/// Each thread runs nchains independent multiply-add chains of length niter
+struct FmaProbe {
+  static constexpr Int nchains = 8;
+  scalar_view_type out;
+  Int niter;
+  Real a;
+  Real b;
+
+  FmaProbe(const scalar_view_type& o, const Int n) : out(o), niter(n), a(0.999999), b(1.0e-6) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& i) const {
+    Real x[nchains];
+    for (Int k=0; k<nchains; ++k) {
+      x[k] = 1 + 1.0e-3*(i%7) + k;
+    }
+    for (Int j=0; j<niter; ++j) {
+      for (Int k=0; k<nchains; ++k) {
+        x[k] = x[k]*a + b;
+      }
+    }
+    Real sum = 0;
+    for (Int k=0; k<nchains; ++k) {
+      sum += x[k];
+    }
+    out(i) = sum;
+  }
+};
+
+MachinePeaks MachinePeaks::measure(const Index stream_size, const Int nrepeat) {
+  MachinePeaks result;
+  {
+    scalar_view_type a("triad_a", stream_size);
+    scalar_view_type b("triad_b", stream_size);
+    scalar_view_type c("triad_c", stream_size);
+    ko::deep_copy(b, 1);
+    ko::deep_copy(c, 2);
+    const Real s = 3;
+    Real best = std::numeric_limits<Real>::max();
+    for (Int k=0; k<=nrepeat; ++k) {
+      auto t0 = tic();
+      ko::parallel_for("STREAM triad", stream_size, KOKKOS_LAMBDA (const Index& i) {
+        a(i) = b(i) + s*c(i);
+      });
+      const Real elapsed = toc(t0);
+      if (k > 0) best = std::min(best, elapsed); // first run is a warm up
+    }
+    result.gbytes_per_s = 3*sizeof(Real)*Real(stream_size)/best*1.0e-9;
+  }
+  {
+    const Index nthreads = (1<<18);
+    const Int niter = 256;
+    scalar_view_type out("fma_out", nthreads);
+    Real best = std::numeric_limits<Real>::max();
+    for (Int k=0; k<=nrepeat; ++k) {
+      auto t0 = tic();
+      ko::parallel_for("FMA probe", nthreads, FmaProbe(out, niter));
+      const Real elapsed = toc(t0);
+      if (k > 0) best = std::min(best, elapsed);
+    }
+    result.gflops = 2*Real(FmaProbe::nchains)*niter*Real(nthreads)/best*1.0e-9;
+  }
+  return result;
+}
+
+std::string MachinePeaks::infoString() const {
+  std::ostringstream ss;
+  ss << "MachinePeaks (" << ko::DefaultExecutionSpace::name() << "): " << gflops << " GFLOP/s, "
+     << gbytes_per_s << " GB/s, balance " << balance() << " flops/byte\n";
+  return ss.str();
+}
+
+RooflineRegistry& RooflineRegistry::instance() {
+  static RooflineRegistry reg;
+  return reg;
+}
+
+void RooflineRegistry::record(const std::string& name, const PairWork& work, const Real npairs,
+  const Real seconds, const Int nlaunches) {
+  std::lock_guard<std::mutex> lock(mtx);
+  KernelStats& s = kernels[name];
+  s.launches += nlaunches;
+  s.pairs += npairs;
+  s.seconds += seconds;
+  s.work = work;
+}
+
+RooflineRegistry::KernelStats RooflineRegistry::stats(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto it = kernels.find(name);
+  return (it != kernels.end() ? it->second : KernelStats());
+}
+
+std::string RooflineRegistry::bound(const PairWork& work) const {
+  return (work.intensity() < peaks.balance() ? "memory" : "compute");
+}
+
+void RooflineRegistry::reset() {
+  std::lock_guard<std::mutex> lock(mtx);
+  kernels.clear();
+}
+
+std::string RooflineRegistry::summaryString() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  std::ostringstream ss;
+  ss << "Roofline summary";
+  if (peaks.gflops > 0) {
+    ss << ": peak " << peaks.gflops << " GFLOP/s, " << peaks.gbytes_per_s << " GB/s";
+  }
+  ss << "\n" << std::setw(28) << std::left << "kernel" << std::right << std::setw(10) << "launches"
+     << std::setw(12) << "seconds" << std::setw(10) << "flops/B" << std::setw(12) << "GFLOP/s"
+     << std::setw(12) << "GB/s";
+  if (peaks.gflops > 0) {
+    ss << std::setw(10) << "%flops" << std::setw(10) << "%bw" << std::setw(10) << "bound";
+  }
+  ss << "\n";
+  for (const auto& k : kernels) {
+    const KernelStats& s = k.second;
+    ss << std::setw(28) << std::left << k.first << std::right << std::setw(10) << s.launches
+       << std::setw(12) << s.seconds << std::setw(10) << s.work.intensity() << std::setw(12) << s.gflops()
+       << std::setw(12) << s.gbytesPerSecond();
+    if (peaks.gflops > 0) {
+      ss << std::setw(10) << 100*s.gflops()/peaks.gflops << std::setw(10)
+         << 100*s.gbytesPerSecond()/peaks.gbytes_per_s << std::setw(10) << bound(s.work);
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+}
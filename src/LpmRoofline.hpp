@@ -0,0 +1,147 @@
+#ifndef LPM_ROOFLINE_HPP
+#define LPM_ROOFLINE_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "Kokkos_Core.hpp"
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Lpm {
+
+/** @brief Analytic work of one source-target interaction.
+
+  Pairwise kernel functors declare their work with three static members,
+
+    static constexpr Int flops_per_pair;            // adds, multiplies, divides
+    static constexpr Int transcendentals_per_pair;  // log, exp, sqrt calls
+    static constexpr Int bytes_per_pair;            // source data loaded per pair
+
+  Target data is loaded once per target and is not counted, and bytes assume no cache reuse of source data
+  between targets, so bytes_per_pair is an upper bound on memory traffic.  Team functors that perform
+  several reductions per target declare the sum of their reductions' work.
+*/
+struct PairWork {
+  Real flops;
+  Real transcendentals;
+  Real bytes;
+
+  PairWork(const Real f=0, const Real t=0, const Real b=0) : flops(f), transcendentals(t), bytes(b) {}
+
+  /// floating point operations per pair, counting each transcendental call as 1
+  inline Real totalFlops() const {return flops + transcendentals;}
+
+  /// arithmetic intensity (flops/byte)
+  inline Real intensity() const {return (bytes > 0 ? totalFlops()/bytes : 0);}
+};
+
+/// The work declared by a pairwise kernel functor
+template <typename FunctorType>
+PairWork pairWork() {
+  return PairWork(FunctorType::flops_per_pair, FunctorType::transcendentals_per_pair,
+    FunctorType::bytes_per_pair);
+}
+
+/** @brief Measured peak floating point rate and memory bandwidth of the default execution space.
+
+  The bandwidth probe is the STREAM triad, a(i) = b(i) + s*c(i), counting 24 bytes per entry; the compute
+  probe runs 8 independent fused multiply-add chains per thread, counting 2 flops per multiply-add.
+*/
+struct MachinePeaks {
+  Real gflops; ///< GFLOP/s
+  Real gbytes_per_s; ///< GB/s
+
+  MachinePeaks() : gflops(0), gbytes_per_s(0) {}
+
+  /// flops/byte at which a kernel moves from memory bound to compute bound
+  inline Real balance() const {return (gbytes_per_s > 0 ? gflops/gbytes_per_s : 0);}
+
+  /** @brief Runs the STREAM triad and FMA probes; each result is the best of nrepeat runs.
+
+    @param stream_size number of entries in each of the 3 triad arrays
+    @param nrepeat number of timed runs of each probe
+  */
+  static MachinePeaks measure(const Index stream_size=(1<<24), const Int nrepeat=5);
+
+  std::string infoString() const;
+};
+
+/** @brief Process-wide accumulator of kernel work and time.
+
+  Launch wrappers (rooflineParallelFor, tunedParallelFor, and the benchmark drivers) record each kernel's
+  pair count and elapsed time under the kernel's name; with machine peaks set, the summary reports each
+  kernel's achieved rates as fractions of peak and whether its arithmetic intensity makes it compute or
+  memory bound.
+*/
+class RooflineRegistry {
+  public:
+    /// accumulated work and time for one kernel
+    struct KernelStats {
+      Int launches;
+      Real pairs;
+      Real seconds;
+      PairWork work; ///< per pair
+
+      KernelStats() : launches(0), pairs(0), seconds(0) {}
+
+      inline Real gflops() const {return (seconds > 0 ? pairs*work.totalFlops()/seconds*1.0e-9 : 0);}
+      inline Real gbytesPerSecond() const {return (seconds > 0 ? pairs*work.bytes/seconds*1.0e-9 : 0);}
+    };
+
+    static RooflineRegistry& instance();
+
+    /// if false (default), rooflineParallelFor and tunedParallelFor launch without fencing or recording
+    inline void setEnabled(const bool e) {enabled_on = e;}
+    inline bool enabled() const {return enabled_on;}
+
+    inline void setPeaks(const MachinePeaks& p) {peaks = p;}
+    inline const MachinePeaks& machinePeaks() const {return peaks;}
+
+    /// adds one or more launches of kernel name, with npairs interactions in total, to its statistics
+    void record(const std::string& name, const PairWork& work, const Real npairs, const Real seconds,
+      const Int nlaunches=1);
+
+    /// statistics for a kernel (all zero if it has not been recorded)
+    KernelStats stats(const std::string& name) const;
+
+    /// "compute" or "memory", by comparing a kernel's arithmetic intensity to the machine balance
+    std::string bound(const PairWork& work) const;
+
+    void reset();
+
+    /// table of all recorded kernels
+    std::string summaryString() const;
+
+  protected:
+    RooflineRegistry() : enabled_on(false) {}
+
+    mutable std::mutex mtx;
+    std::map<std::string, KernelStats> kernels;
+    MachinePeaks peaks;
+    bool enabled_on;
+};
+
+/** @brief Launches a pairwise kernel and, if the RooflineRegistry is enabled, records its work and time.
+
+  @param name kernel name used in the registry
+  @param policy execution policy
+  @param f kernel functor that declares its PairWork (see pairWork)
+  @param npairs number of source-target interactions evaluated by this launch
+*/
+template <typename PolicyType, typename FunctorType>
+void rooflineParallelFor(const std::string& name, const PolicyType& policy, const FunctorType& f,
+  const Real npairs) {
+  RooflineRegistry& reg = RooflineRegistry::instance();
+  if (!reg.enabled()) {
+    ko::parallel_for(name, policy, f);
+    return;
+  }
+  ko::fence();
+  auto t0 = tic();
+  ko::parallel_for(name, policy, f);
+  reg.record(name, pairWork<FunctorType>(), npairs, toc(t0));
+}
+
+}
+#endif
@@ -196,5 +196,46 @@ struct SimpleGravityWave {
   }
 };
 
+/** @brief Steady, geostrophically balanced zonal flow on the rotating unit sphere.
+
+  Williamson et al. (1992) test case 2 with rotation axis alpha = 0, nondimensionalized so
+  that the sphere has unit radius and rotates once per unit time.
+  The initial condition is an exact steady state of the SWE.
+*/
+struct SphereGeostrophicBalance {
+  static constexpr Real OMEGA = 2*PI;
+  static constexpr Real u_max = 2*PI/12; ///< max. zonal velocity (1 revolution per 12 rotations)
+  static constexpr Real g = 1;
+  static constexpr Real equator_depth = 5;
+  static constexpr Real f0 = 0;
+  static constexpr Real beta = 0;
+
+  template <typename CV> KOKKOS_INLINE_FUNCTION
+  static Real bottom_height(const CV& xyz) {return 0;}
+
+  template <typename CV> KOKKOS_INLINE_FUNCTION
+  static Real sfc0(const CV& xyz) {
+    return equator_depth - (OMEGA*u_max + 0.5*square(u_max))*square(xyz(2))/g;
+  }
+
+  template <typename CV> KOKKOS_INLINE_FUNCTION
+  static Real h0(const CV& xyz) {
+    return sfc0(xyz) - bottom_height(xyz);
+  }
+
+  template <typename CV> KOKKOS_INLINE_FUNCTION
+  static Real zeta0(const CV& xyz) {return 2*u_max*xyz(2);}
+
+  template <typename CV> KOKKOS_INLINE_FUNCTION
+  static Real sigma0(const CV& xyz) {return 0;}
+
+  template <typename V, typename CV> KOKKOS_INLINE_FUNCTION
+  static void u0(V& uv, const CV& xyz) {
+    uv(0) = -u_max*xyz(1);
+    uv(1) =  u_max*xyz(0);
+    uv(2) = 0;
+  }
+};
+
 }
 #endif
@@ -29,10 +29,13 @@ void velocityKernel(ko::Tuple<Real,2>& u, const VecType& tgt_x,
   u[1] =  (tgt_x[0] - src_x[0])*vort_str + (tgt_x[1] - src_x[1])*div_str;
 }
 
-template <typename VecType> KOKKOS_INLINE_FUNCTION
-void planeSweRhsPse(ko::Tuple<Real,7>& res, const VecType& tgt_x, const Real& tgt_s,
-  const VecType& src_x, const Real& src_vort, const Real& src_div,
-  const Real& src_area, const Real& src_s, const Real& pse_eps) {
+/** @brief Velocity and velocity gradient contributions of one source to one target in the plane.
+
+  Fills res[0..5] (see PlanarSWEDirectSum); res[6], if present, is not modified.
+*/
+template <int N, typename VecType> KOKKOS_INLINE_FUNCTION
+void planeSweVelocityGradient(ko::Tuple<Real,N>& res, const VecType& tgt_x,
+  const VecType& src_x, const Real& src_vort, const Real& src_div, const Real& src_area) {
 
   Real sqdist = 0;
   for (Short k=0; k<2; ++k) {
@@ -46,9 +49,6 @@ void planeSweRhsPse(ko::Tuple<Real,7>& res, const VecType& tgt_x, const Real& tg
   const Real rot_strength = src_vort*src_area/denom;
   const Real pot_strength = src_div*src_area/denom;
 
-  const Real pse_scaled_r = pse_kernel_input<PlaneGeometry,VecType>(tgt_x, src_x, pse_eps);
-  const Real lap_ker = bivariateLaplacianOrder8(pse_scaled_r);
-
   // u = velocity, x component
   res[0] = -(tgt_x[1] - src_x[1])*rot_strength + (tgt_x[0] - src_x[0])*pot_strength;
   // v = velocity, y component
@@ -65,6 +65,19 @@ void planeSweRhsPse(ko::Tuple<Real,7>& res, const VecType& tgt_x, const Real& tg
   // dv/dy
   res[5] =  pot_strength - (tgt_x[1] - src_x[1])*((tgt_x[1] - src_x[1])*src_div +
     (tgt_x[0] - src_x[0])*src_vort)*src_area/denom2;
+  }
+}
+
+template <typename VecType> KOKKOS_INLINE_FUNCTION
+void planeSweRhsPse(ko::Tuple<Real,7>& res, const VecType& tgt_x, const Real& tgt_s,
+  const VecType& src_x, const Real& src_vort, const Real& src_div,
+  const Real& src_area, const Real& src_s, const Real& pse_eps) {
+
+  planeSweVelocityGradient(res, tgt_x, src_x, src_vort, src_div, src_area);
+
+  const Real pse_scaled_r = pse_kernel_input<PlaneGeometry,VecType>(tgt_x, src_x, pse_eps);
+  if (pse_scaled_r*pse_eps > 1E-6) {
+  const Real lap_ker = bivariateLaplacianOrder8(pse_scaled_r);
   // laplacian(s)
   res[6] = (src_s - tgt_s) * src_area * lap_ker / square(pse_eps);
   }
@@ -80,11 +93,15 @@ void planeSweRhsPse(ko::Tuple<Real,7>& res, const VecType& tgt_x, const Real& tg
     index 3: du/dy
     index 4: dv/dx
     index 5: dv/dy
-    index 6: laplacian(s) from PSE
+    index 6: laplacian(s) from PSE (zero if do_pse is false, e.g., when the PSE term is computed
+      separately with PlanePSELaplacianCutoff)
 */
 struct PlanarSWEDirectSum {
   typedef typename PlaneGeometry::crd_view_type crd_view;
   typedef ko::Tuple<Real,7> value_type;
+  static constexpr Int flops_per_pair = 62; ///< work per pair with do_pse; without it, as PlanarSWEVelocityReduce
+  static constexpr Int transcendentals_per_pair = 2;
+  static constexpr Int bytes_per_pair = 48;
   Index i; ///< index of target point
   crd_view tgtx;
   scalar_view_type tgt_sfc;
@@ -95,30 +112,115 @@ struct PlanarSWEDirectSum {
   scalar_view_type src_sfc;
   Real pse_eps;
   bool collocated_src_tgt;
+  bool do_pse;
 
   KOKKOS_INLINE_FUNCTION
   PlanarSWEDirectSum(const Index& tind, const crd_view& tx, const scalar_view_type& tgtsfc,
     const crd_view& sx, const scalar_view_type& z, const scalar_view_type& sdiv,
-    const scalar_view_type& a, const scalar_view_type& ssfc, const Real& eps) :
+    const scalar_view_type& a, const scalar_view_type& ssfc, const Real& eps, const bool pse=true) :
     i(tind), tgtx(tx), tgt_sfc(tgtsfc), srcx(sx), src_zeta(z), src_sigma(sdiv),
-    src_area(a), src_sfc(ssfc), pse_eps(eps), collocated_src_tgt(tx==sx) {}
+    src_area(a), src_sfc(ssfc), pse_eps(eps), collocated_src_tgt(tx==sx), do_pse(pse) {}
 
   KOKKOS_INLINE_FUNCTION
   void operator() (const Index& j, value_type& r) const {
     if (!collocated_src_tgt || i != j) {
-      const auto mtgt = ko::subview(tgtx, i, ko::ALL);
-      const auto msrc = ko::subview(srcx, j, ko::ALL);
+      const auto mtgt = vec_at<2>(tgtx, i);
+      const auto msrc = vec_at<2>(srcx, j);
       ko::Tuple<Real,7> lsum;
-      planeSweRhsPse(lsum, mtgt, tgt_sfc(i), msrc, src_zeta(j), src_sigma(j), src_area(j),
-        src_sfc(j), pse_eps);
+      if (do_pse) {
+        planeSweRhsPse(lsum, mtgt, tgt_sfc(i), msrc, src_zeta(j), src_sigma(j), src_area(j),
+          src_sfc(j), pse_eps);
+      }
+      else {
+        planeSweVelocityGradient(lsum, mtgt, msrc, src_zeta(j), src_sigma(j), src_area(j));
+      }
       r += lsum;
     }
   }
 };
 
+/**
+  Reduction functor for the velocity and velocity gradient (far-field) part of the
+  Shallow Water direct sum in the plane; no PSE term, so no exponentials are evaluated.
+
+  Results contained in a 6-tuple, indices 0-5 as in PlanarSWEDirectSum.
+*/
+struct PlanarSWEVelocityReduce {
+  typedef typename PlaneGeometry::crd_view_type crd_view;
+  typedef ko::Tuple<Real,6> value_type;
+  static constexpr Int flops_per_pair = 40; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = 0;
+  static constexpr Int bytes_per_pair = 40;
+  Index i; ///< index of target point
+  crd_view tgtx;
+  crd_view srcx;
+  scalar_view_type src_zeta;
+  scalar_view_type src_sigma;
+  scalar_view_type src_area;
+  bool collocated_src_tgt;
+
+  KOKKOS_INLINE_FUNCTION
+  PlanarSWEVelocityReduce(const Index& tind, const crd_view& tx, const crd_view& sx,
+    const scalar_view_type& z, const scalar_view_type& sdiv, const scalar_view_type& a) :
+    i(tind), tgtx(tx), srcx(sx), src_zeta(z), src_sigma(sdiv), src_area(a),
+    collocated_src_tgt(tx==sx) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& j, value_type& r) const {
+    if (!collocated_src_tgt || i != j) {
+      ko::Tuple<Real,6> lsum;
+      planeSweVelocityGradient(lsum, vec_at<2>(tgtx, i), vec_at<2>(srcx, j),
+        src_zeta(j), src_sigma(j), src_area(j));
+      r += lsum;
+    }
+  }
+};
+
+/** @brief Computes velocity and the double dot product of the velocity gradient at each target
+  (vertices or faces) in the plane.
+
+  @device
+  @par Parallel pattern:
+  1 thread team per target performs 1 reduction (PlanarSWEVelocityReduce)
+*/
+struct PlanarSWEVelocitySums {
+  typedef typename PlaneGeometry::crd_view_type crd_view;
+  typedef typename PlaneGeometry::vec_view_type vec_view;
+  static constexpr Int flops_per_pair = PlanarSWEVelocityReduce::flops_per_pair; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = PlanarSWEVelocityReduce::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = PlanarSWEVelocityReduce::bytes_per_pair;
+  vec_view tgtvel;
+  scalar_view_type tgtddot;
+  crd_view tgtx;
+  crd_view srcx;
+  scalar_view_type srcvort;
+  scalar_view_type srcdiv;
+  scalar_view_type srcarea;
+  Index nsrc;
+
+  PlanarSWEVelocitySums(vec_view& tvel, scalar_view_type& tdd, const crd_view& tx,
+    const crd_view& sx, const scalar_view_type& sz, const scalar_view_type& sdiv,
+    const scalar_view_type& sa, const Index& ns) : tgtvel(tvel), tgtddot(tdd), tgtx(tx),
+    srcx(sx), srcvort(sz), srcdiv(sdiv), srcarea(sa), nsrc(ns) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const member_type& mbr) const {
+    const Index i = mbr.league_rank();
+    ko::Tuple<Real,6> red;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, nsrc),
+      PlanarSWEVelocityReduce(i, tgtx, srcx, srcvort, srcdiv, srcarea), red);
+    tgtvel(i,0) = red[0];
+    tgtvel(i,1) = red[1];
+    tgtddot(i) = square(red[2]) + 2*red[3]*red[4] + square(red[5]);
+  }
+};
+
 struct PlanarSWEVertexSums {
   typedef typename PlaneGeometry::crd_view_type crd_view;
   typedef typename PlaneGeometry::vec_view_type vec_view;
+  static constexpr Int flops_per_pair = PlanarSWEDirectSum::flops_per_pair; ///< work per pair with do_pse (see PairWork)
+  static constexpr Int transcendentals_per_pair = PlanarSWEDirectSum::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = PlanarSWEDirectSum::bytes_per_pair;
   vec_view vertvel;
   scalar_view_type vertddot;
   scalar_view_type vertlaps;
@@ -131,13 +233,14 @@ struct PlanarSWEVertexSums {
   scalar_view_type facesfc;
   Real eps;
   Index nf;
+  bool do_pse; ///< if false, vertlaps is not computed (see PlanePSELaplacianCutoff)
 
   PlanarSWEVertexSums(vec_view& vvel, scalar_view_type& vdd, scalar_view_type& vlap,
     const crd_view& vx, const scalar_view_type& vsfc, const crd_view& fx,
     const scalar_view_type& fz, const scalar_view_type& fdiv, const scalar_view_type& fa,
-    const scalar_view_type& fsfc, const Real& ep) : vertvel(vvel), vertddot(vdd),
+    const scalar_view_type& fsfc, const Real& ep, const bool pse=true) : vertvel(vvel), vertddot(vdd),
     vertlaps(vlap), vertx(vx), vertsfc(vsfc), facex(fx), facevort(fz), facediv(fdiv),
-    facearea(fa), facesfc(fsfc), eps(ep), nf(fx.extent(0)) {}
+    facearea(fa), facesfc(fsfc), eps(ep), nf(fx.extent(0)), do_pse(pse) {}
 
   KOKKOS_INLINE_FUNCTION
   void operator() (const member_type& mbr) const {
@@ -145,11 +248,11 @@ struct PlanarSWEVertexSums {
     ko::Tuple<Real,7> red;
     /* reduction over faces */
     ko::parallel_reduce(ko::TeamThreadRange(mbr, nf),
-      PlanarSWEDirectSum(i, vertx, vertsfc, facex, facevort, facediv, facearea, facesfc, eps), red);
+      PlanarSWEDirectSum(i, vertx, vertsfc, facex, facevort, facediv, facearea, facesfc, eps, do_pse), red);
     vertvel(i,0) = red[0];
     vertvel(i,1) = red[1];
     vertddot(i) = red[2]*red[2] + 2*red[3]*red[4] + red[5]*red[5];
-    vertlaps(i) = red[6]/square(eps);
+    if (do_pse) vertlaps(i) = red[6]/square(eps);
   }
 };
 
@@ -192,16 +295,19 @@ struct PlanarSWEVertexRHS {
   }
 };
 
-template <typename ProblemType>
-struct PlanarSWESetVertexSfc {
-  typedef typename PlaneGeometry::crd_view_type crd_view;
-  typedef typename PlaneGeometry::vec_view_type vec_view;
+/** @brief Sets vertex bottom topography and surface height from the current depth.
+
+  Geometry-independent; Geo determines only the coordinate view type.
+*/
+template <typename Geo, typename ProblemType>
+struct SWESetVertexSfc {
+  typedef typename Geo::crd_view_type crd_view;
   scalar_view_type sfc;
   scalar_view_type topo;
   scalar_view_type depth;
   crd_view vertx;
 
-  PlanarSWESetVertexSfc(scalar_view_type& s, scalar_view_type& sb, const scalar_view_type& h,
+  SWESetVertexSfc(scalar_view_type& s, scalar_view_type& sb, const scalar_view_type& h,
     const crd_view& vx) : sfc(s), topo(sb), depth(h), vertx(vx) {}
 
   KOKKOS_INLINE_FUNCTION
@@ -218,10 +324,13 @@ struct PlanarSWESetVertexSfc {
   }
 };
 
-template <typename ProblemType>
-struct PlanarSWESetFaceSfc {
-  typedef typename PlaneGeometry::crd_view_type crd_view;
-  typedef typename PlaneGeometry::vec_view_type vec_view;
+/** @brief Sets face bottom topography, depth, and surface height from the (conserved) face mass.
+
+  Geometry-independent; Geo determines only the coordinate view type.
+*/
+template <typename Geo, typename ProblemType>
+struct SWESetFaceSfc {
+  typedef typename Geo::crd_view_type crd_view;
   scalar_view_type sfc;
   scalar_view_type depth;
   scalar_view_type topo;
@@ -230,7 +339,7 @@ struct PlanarSWESetFaceSfc {
   mask_view_type mask;
   crd_view facex;
 
-  PlanarSWESetFaceSfc(scalar_view_type& s, scalar_view_type& h, scalar_view_type& sb,
+  SWESetFaceSfc(scalar_view_type& s, scalar_view_type& h, scalar_view_type& sb,
   const scalar_view_type& mm, const scalar_view_type& fa, const mask_view_type& fm, const crd_view& fx) :
     sfc(s), depth(h), topo(sb), mass(mm), area(fa), mask(fm), facex(fx) {}
 
@@ -251,6 +360,9 @@ struct PlanarSWESetFaceSfc {
   }
 };
 
+template <typename ProblemType> using PlanarSWESetVertexSfc = SWESetVertexSfc<PlaneGeometry,ProblemType>;
+template <typename ProblemType> using PlanarSWESetFaceSfc = SWESetFaceSfc<PlaneGeometry,ProblemType>;
+
 struct PlanarSWEFaceSums {
   typedef typename PlaneGeometry::crd_view_type crd_view;
   typedef typename PlaneGeometry::vec_view_type vec_view;
@@ -264,23 +376,24 @@ struct PlanarSWEFaceSums {
   scalar_view_type facesfc;
   Real eps;
   Index nf;
+  bool do_pse; ///< if false, facelaps is not computed (see PlanePSELaplacianCutoff)
 
   PlanarSWEFaceSums(vec_view& fv, scalar_view_type& fdd, scalar_view_type flap,
     const crd_view& fx, const scalar_view_type& fz, const scalar_view_type& fdiv,
-    const scalar_view_type& fa, const scalar_view_type& fsfc, const Real& ep) :
+    const scalar_view_type& fa, const scalar_view_type& fsfc, const Real& ep, const bool pse=true) :
     facevel(fv), faceddot(fdd), facelaps(flap), facex(fx), facevort(fz), facediv(fdiv),
-    facearea(fa), facesfc(fsfc), eps(ep), nf(fx.extent(0)) {}
+    facearea(fa), facesfc(fsfc), eps(ep), nf(fx.extent(0)), do_pse(pse) {}
 
   KOKKOS_INLINE_FUNCTION
   void operator() (const member_type& mbr) const {
     const Index i = mbr.league_rank();
     ko::Tuple<Real,7> red;
     ko::parallel_reduce(ko::TeamThreadRange(mbr, nf),
-      PlanarSWEDirectSum(i, facex, facesfc, facex, facevort, facediv, facearea, facesfc, eps), red);
+      PlanarSWEDirectSum(i, facex, facesfc, facex, facevort, facediv, facearea, facesfc, eps, do_pse), red);
     facevel(i,0) = red[0];
     facevel(i,1) = red[1];
-    faceddot(i) = square(red[2]) + 2*red[3]*red[5] + square(red[5]);
-    facelaps(i) = red[6]/square(eps);
+    faceddot(i) = square(red[2]) + 2*red[3]*red[4] + square(red[5]);
+    if (do_pse) facelaps(i) = red[6]/square(eps);
   }
 };
 
@@ -328,6 +441,292 @@ struct PlanarSWEFaceRHS {
 };
 
 
+/** @brief Velocity and velocity gradient contributions of one source to one target on the unit sphere.
+
+  With \f$G(x,y) = \log(1 - x\cdot y)/(4\pi)\f$, the velocity is \f$u = x \times \nabla\psi + \nabla\chi\f$,
+  where \f$\psi = G * \zeta\f$ and \f$\chi = G * \sigma\f$, so that each source contributes
+
+  \f$ -\frac{A_j}{4\pi(1-x\cdot y_j)}\left[\zeta_j (x \times y_j) + \sigma_j (y_j - (x\cdot y_j)x)\right].\f$
+
+  Fills res[0..11] (see SphereSWEDirectSum); res[12] is not modified.
+  The gradient res[3 + 3*k + i] = d u_i / d x_k is taken with respect to x in R^3; it must be
+  projected onto the tangent plane after the reduction (see SphereSWESums).
+*/
+template <typename VecType> KOKKOS_INLINE_FUNCTION
+void sphereSweVelocityGradient(ko::Tuple<Real,13>& res, const VecType& tgt_x,
+  const VecType& src_x, const Real& src_vort, const Real& src_div, const Real& src_area) {
+
+  const Real xdoty = SphereGeometry::dot(tgt_x, src_x);
+  if (1 - xdoty > 1E-12) {
+  const Real s = 1/(4*PI*(1 - xdoty));
+  const Real rot_strength = -src_vort*src_area*s;
+  const Real pot_strength = -src_div*src_area*s;
+  const ko::Tuple<Real,3> xcy = SphereGeometry::cross(tgt_x, src_x);
+  Real ytan[3];
+  for (Short i=0; i<3; ++i) {
+    ytan[i] = src_x[i] - xdoty*tgt_x[i];
+  }
+  // d(x cross y)_i / dx_k
+  const Real dcross[3][3] = {{0, -src_x[2], src_x[1]},
+                             {src_x[2], 0, -src_x[0]},
+                             {-src_x[1], src_x[0], 0}};
+  for (Short i=0; i<3; ++i) {
+    res[i] = rot_strength*xcy[i] + pot_strength*ytan[i];
+  }
+  for (Short k=0; k<3; ++k) {
+    // (ds/dx_k)/s
+    const Real dsk = 4*PI*s*src_x[k];
+    for (Short i=0; i<3; ++i) {
+      res[3 + 3*k + i] = rot_strength*(dcross[k][i] + xcy[i]*dsk) +
+        pot_strength*(-src_x[k]*tgt_x[i] - (i==k ? xdoty : 0) + ytan[i]*dsk);
+    }
+  }
+  }
+}
+
+/** @brief All SWE direct-sum contributions of one source to one target on the unit sphere.
+
+  The PSE surface Laplacian uses the planar order-8 kernel of the chord distance,
+  which agrees with the geodesic distance to O(eps^3) within the kernel's support.
+*/
+template <typename VecType> KOKKOS_INLINE_FUNCTION
+void sphereSweRhsPse(ko::Tuple<Real,13>& res, const VecType& tgt_x, const Real& tgt_s,
+  const VecType& src_x, const Real& src_vort, const Real& src_div,
+  const Real& src_area, const Real& src_s, const Real& pse_eps) {
+
+  sphereSweVelocityGradient(res, tgt_x, src_x, src_vort, src_div, src_area);
+
+  const Real one_minus_xdoty = 1 - SphereGeometry::dot(tgt_x, src_x);
+  const Real chord = std::sqrt(2*(one_minus_xdoty > 0 ? one_minus_xdoty : 0));
+  if (chord > 1E-6) {
+  const Real lap_ker = bivariateLaplacianOrder8(chord/pse_eps);
+  // laplacian(s)
+  res[12] = (src_s - tgt_s) * src_area * lap_ker / square(pse_eps);
+  }
+}
+
+/**
+  Reduction functor for Shallow Water direct summation on the sphere
+
+  All sums needed by the right-hand side share a single pass over the sources;
+  results contained in a 13-tuple as follows:
+    index 0-2: velocity (x, y, z components)
+    index 3-11: velocity gradient in R^3, d u_i / d x_k = r[3 + 3*k + i]
+    index 12: laplacian(s) from PSE (before division by eps^2)
+
+  Divided (masked) panels are excluded.
+*/
+struct SphereSWEDirectSum {
+  typedef typename SphereGeometry::crd_view_type crd_view;
+  typedef ko::Tuple<Real,13> value_type;
+  static constexpr Int flops_per_pair = 174; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = 2;
+  static constexpr Int bytes_per_pair = 56;
+  Index i; ///< index of target point
+  crd_view tgtx;
+  scalar_view_type tgt_sfc;
+  crd_view srcx;
+  scalar_view_type src_zeta;
+  scalar_view_type src_sigma;
+  scalar_view_type src_area;
+  scalar_view_type src_sfc;
+  mask_view_type src_mask;
+  Real pse_eps;
+  bool collocated_src_tgt;
+
+  KOKKOS_INLINE_FUNCTION
+  SphereSWEDirectSum(const Index& tind, const crd_view& tx, const scalar_view_type& tgtsfc,
+    const crd_view& sx, const scalar_view_type& z, const scalar_view_type& sdiv,
+    const scalar_view_type& a, const scalar_view_type& ssfc, const mask_view_type& sm, const Real& eps) :
+    i(tind), tgtx(tx), tgt_sfc(tgtsfc), srcx(sx), src_zeta(z), src_sigma(sdiv),
+    src_area(a), src_sfc(ssfc), src_mask(sm), pse_eps(eps), collocated_src_tgt(tx==sx) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& j, value_type& r) const {
+    if (!src_mask(j) && (!collocated_src_tgt || i != j)) {
+      const auto mtgt = vec_at<3>(tgtx, i);
+      const auto msrc = vec_at<3>(srcx, j);
+      ko::Tuple<Real,13> lsum;
+      sphereSweRhsPse(lsum, mtgt, tgt_sfc(i), msrc, src_zeta(j), src_sigma(j), src_area(j),
+        src_sfc(j), pse_eps);
+      r += lsum;
+    }
+  }
+};
+
+/** @brief Computes velocity, the double dot product of the velocity gradient, and the
+  surface Laplacian of the surface height at each target (vertices or faces) on the sphere.
+
+  @device
+  @par Parallel pattern:
+  1 thread team per target performs 1 reduction (SphereSWEDirectSum)
+
+  ddot is the trace of \f$(P\nabla u)^2\f$, where \f$P = I - xx^T\f$ projects the R^3 gradient
+  onto the tangent plane at the target.
+*/
+struct SphereSWESums {
+  typedef typename SphereGeometry::crd_view_type crd_view;
+  typedef typename SphereGeometry::vec_view_type vec_view;
+  static constexpr Int flops_per_pair = SphereSWEDirectSum::flops_per_pair; ///< work per pair (see PairWork)
+  static constexpr Int transcendentals_per_pair = SphereSWEDirectSum::transcendentals_per_pair;
+  static constexpr Int bytes_per_pair = SphereSWEDirectSum::bytes_per_pair;
+  vec_view tgtvel;
+  scalar_view_type tgtddot;
+  scalar_view_type tgtlaps;
+  crd_view tgtx;
+  scalar_view_type tgtsfc;
+  crd_view srcx;
+  scalar_view_type srcvort;
+  scalar_view_type srcdiv;
+  scalar_view_type srcarea;
+  scalar_view_type srcsfc;
+  mask_view_type srcmask;
+  Real eps;
+  Index nsrc;
+
+  SphereSWESums(vec_view& tvel, scalar_view_type& tdd, scalar_view_type& tlap,
+    const crd_view& tx, const scalar_view_type& tsfc, const crd_view& sx,
+    const scalar_view_type& sz, const scalar_view_type& sdiv, const scalar_view_type& sa,
+    const scalar_view_type& ssfc, const mask_view_type& sm, const Real& ep) : tgtvel(tvel), tgtddot(tdd),
+    tgtlaps(tlap), tgtx(tx), tgtsfc(tsfc), srcx(sx), srcvort(sz), srcdiv(sdiv),
+    srcarea(sa), srcsfc(ssfc), srcmask(sm), eps(ep), nsrc(sx.extent(0)) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const member_type& mbr) const {
+    const Index i = mbr.league_rank();
+    ko::Tuple<Real,13> red;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, nsrc),
+      SphereSWEDirectSum(i, tgtx, tgtsfc, srcx, srcvort, srcdiv, srcarea, srcsfc, srcmask, eps), red);
+    const auto mtgt = vec_at<3>(tgtx, i);
+    Real gradu[3][3];
+    for (Short ii=0; ii<3; ++ii) {
+      Real xdotg = 0;
+      for (Short m=0; m<3; ++m) {
+        xdotg += mtgt[m]*red[3 + 3*m + ii];
+      }
+      for (Short k=0; k<3; ++k) {
+        gradu[k][ii] = red[3 + 3*k + ii] - mtgt[k]*xdotg;
+      }
+    }
+    Real dd = 0;
+    for (Short k=0; k<3; ++k) {
+      for (Short ii=0; ii<3; ++ii) {
+        dd += gradu[k][ii]*gradu[ii][k];
+      }
+    }
+    for (Short k=0; k<3; ++k) {
+      tgtvel(i,k) = red[k];
+    }
+    tgtddot(i) = dd;
+    tgtlaps(i) = red[12]/square(eps);
+  }
+};
+
+/** @brief Lagrangian SWE right-hand side at vertices on the rotating unit sphere.
+
+  With \f$f = 2\Omega z\f$,
+    dx/dt = u
+    dzeta/dt = -(zeta + f) sigma - u.grad(f)
+    dsigma/dt = f zeta - (x cross u).grad(f) - ddot - |u|^2 - g lap(s)
+    dh/dt = -sigma h
+
+  The |u|^2 term is the divergence of the centripetal acceleration that keeps particles on the sphere.
+*/
+struct SphereSWEVertexRHS {
+  typedef typename SphereGeometry::crd_view_type crd_view;
+  typedef typename SphereGeometry::vec_view_type vec_view;
+  crd_view dx;
+  scalar_view_type dzeta;
+  scalar_view_type dsigma;
+  scalar_view_type dh;
+  crd_view vertx;
+  vec_view vertvel;
+  scalar_view_type vertvort;
+  scalar_view_type vertdiv;
+  scalar_view_type vertddot;
+  scalar_view_type vertlaps;
+  scalar_view_type vertdepth;
+  Real Omega;
+  Real g;
+  Real dt;
+
+  SphereSWEVertexRHS(crd_view& dx_, scalar_view_type& dz, scalar_view_type& dsig,
+   scalar_view_type& ddepth, const crd_view& vx, const vec_view& uv,
+   const scalar_view_type& vvort, const scalar_view_type& vdiv, const scalar_view_type& vdd,
+   const scalar_view_type& vls, const scalar_view_type& h, const Real& omg,
+   const Real& gg, const Real& dt_) :
+   dx(dx_), dzeta(dz), dsigma(dsig), dh(ddepth), vertx(vx), vertvel(uv), vertvort(vvort),
+   vertdiv(vdiv), vertddot(vdd), vertlaps(vls), vertdepth(h), Omega(omg), g(gg), dt(dt_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& i) const {
+    const bool hasmass = vertdepth(i) > 0;
+    const auto x = vec_at<3>(vertx, i);
+    const auto u = vec_at<3>(vertvel, i);
+    for (Short j=0; j<3; ++j) {
+      dx(i,j) = (hasmass ? dt*u[j] : 0);
+    }
+    const Real f = 2*Omega*x[2];
+    const Real udotgradf = 2*Omega*u[2];
+    const Real xcudotgradf = 2*Omega*(x[0]*u[1] - x[1]*u[0]);
+    const Real usq = SphereGeometry::norm2(u);
+    dzeta(i) = (hasmass ? dt*(-udotgradf - (vertvort(i) + f)*vertdiv(i)) : 0);
+    dsigma(i) = (hasmass ? dt*(f*vertvort(i) - xcudotgradf - vertddot(i) - usq - g*vertlaps(i)) : 0);
+    dh(i) = (hasmass ? dt*(-vertdiv(i)*vertdepth(i)) : 0);
+  }
+};
+
+/** @brief Lagrangian SWE right-hand side at faces on the rotating unit sphere.
+
+  Same equations as SphereSWEVertexRHS, with the face area equation dA/dt = sigma A in place of depth
+  (face mass is conserved).
+*/
+struct SphereSWEFaceRHS {
+  typedef typename SphereGeometry::crd_view_type crd_view;
+  typedef typename SphereGeometry::vec_view_type vec_view;
+  crd_view dx;
+  scalar_view_type dzeta;
+  scalar_view_type dsigma;
+  scalar_view_type darea;
+  crd_view facex;
+  vec_view facevel;
+  scalar_view_type facevort;
+  scalar_view_type facediv;
+  scalar_view_type faceddot;
+  scalar_view_type facelaps;
+  scalar_view_type facearea;
+  mask_view_type mask;
+  Real Omega;
+  Real g;
+  Real dt;
+
+  SphereSWEFaceRHS(crd_view& dx_, scalar_view_type& dz, scalar_view_type& dsig,
+    scalar_view_type& da, const crd_view& fx, const vec_view& uv, const scalar_view_type& fzeta,
+    const scalar_view_type& fdiv, const scalar_view_type& fdd, const scalar_view_type& flaps,
+    const scalar_view_type& fa, const mask_view_type& fm, const Real& omg,
+    const Real& gg, const Real& dt_) :
+    dx(dx_), dzeta(dz), dsigma(dsig), darea(da), facex(fx), facevel(uv), facevort(fzeta),
+    facediv(fdiv), faceddot(fdd), facelaps(flaps), facearea(fa), mask(fm), Omega(omg),
+    g(gg), dt(dt_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& i) const {
+    if (!mask(i)) {
+      const auto x = vec_at<3>(facex, i);
+      const auto u = vec_at<3>(facevel, i);
+      for (Short j=0; j<3; ++j) {
+        dx(i,j) = dt*u[j];
+      }
+      const Real f = 2*Omega*x[2];
+      const Real udotgradf = 2*Omega*u[2];
+      const Real xcudotgradf = 2*Omega*(x[0]*u[1] - x[1]*u[0]);
+      const Real usq = SphereGeometry::norm2(u);
+      dzeta(i) = dt*(-udotgradf - (facevort(i) + f)*facediv(i));
+      dsigma(i) = dt*(f*facevort(i) - xcudotgradf - faceddot(i) - usq - g*facelaps(i));
+      darea(i) = dt*(facediv(i)*facearea(i));
+    }
+  }
+};
 
 }
 #endif
@@ -5,10 +5,16 @@
 #include "LpmDefs.hpp"
 #include "Kokkos_Core.hpp"
 #include "LpmShallowWater.hpp"
+#include "LpmSWERhsEngine.hpp"
 
 namespace Lpm {
 
 
+/** @brief Classic 4th order Runge-Kutta time stepper for the Lagrangian shallow water equations.
+
+  Supports planar (f-plane or beta-plane) and spherical (rotating unit sphere) geometries;
+  the direct-sum and right-hand side kernels are chosen at compile time from SeedType::geo.
+*/
 template <typename SeedType, typename ProblemType>
 class SWERK4 {
   public:
@@ -41,19 +47,25 @@ class SWERK4 {
     Real Omega;
     Real g;
     Real eps_pse;
+    Real pse_cutoff; ///< if > 0, the PSE term uses only sources within pse_cutoff*eps_pse; otherwise, all sources (plane only)
 
     Index nverts;
     Index nfaces;
 
-    SWERK4(const std::shared_ptr<ShallowWater<SeedType>> pm, const Real& tstep, const Real& eps) :
+    PlanarSWERhsEngine rhs_engine; ///< direct-sum algorithms (plane only); set by pse_cutoff, may be reconfigured
+
+    SWERK4(const std::shared_ptr<ShallowWater<SeedType>> pm, const Real& tstep, const Real& eps,
+      const Real& cutoff=0) :
       vertx(pm->physVerts.crds), vertvel(pm->velocityVerts), vertvort(pm->relVortVerts),
       vertdiv(pm->divVerts), vertsfc(pm->surfaceHeightVerts), vertdepth(pm->depthVerts),
       verttopo(pm->topoVerts),
       facex(pm->physFaces.crds), facevel(pm->velocityFaces), facevort(pm->relVortFaces),
       facediv(pm->divFaces), facesfc(pm->surfaceHeightFaces), facedepth(pm->depthFaces),
       facetopo(pm->topoFaces), facearea(pm->faces.area), dt(tstep), f0(ProblemType::f0),
-      beta(ProblemType::beta), Omega(ProblemType::OMEGA), g(ProblemType::g), eps_pse(eps),
-      nverts(pm->nvertsHost()), nfaces(pm->nfacesHost()), facemass(pm->massFaces),
+      beta(ProblemType::beta), Omega(ProblemType::OMEGA), g(ProblemType::g), eps_pse(eps), pse_cutoff(cutoff),
+      nverts(pm->nvertsHost()), nfaces(pm->nfacesHost()),
+      rhs_engine((cutoff > 0 ? CutoffPSE : FusedPSE), (cutoff > 0 ? cutoff : PSE_CUTOFF_MULTIPLE)),
+      facemass(pm->massFaces),
       facemask(pm->faces.mask) {init();}
 
     void advance_timestep();
@@ -156,10 +168,34 @@ class SWERK4 {
 
     void update_sfc();
 
-    void compute_direct_sums();
-
-    std::unique_ptr<ko::TeamPolicy<>> vertex_policy;
-    std::unique_ptr<ko::TeamPolicy<>> face_policy;
+    void compute_direct_sums(const crd_view& vx, const crd_view& fx, const scalar_view_type& fzeta,
+      const scalar_view_type& fdiv, const scalar_view_type& fa);
+
+    /// Evaluates the right-hand side for one RK stage; outputs are the stage increments (scaled by dt).
+    void compute_rhs(const Int stage, crd_view& vdx, scalar_view_type& vdzeta, scalar_view_type& vdsigma,
+      scalar_view_type& vdh, crd_view& fdx, scalar_view_type& fdzeta, scalar_view_type& fdsigma,
+      scalar_view_type& fda, const crd_view& vx, const scalar_view_type& vzeta,
+      const scalar_view_type& vsigma, const scalar_view_type& vh, const crd_view& fx,
+      const scalar_view_type& fzeta, const scalar_view_type& fsigma, const scalar_view_type& fa);
+
+    /** Geometry-specific kernels, selected by overload resolution on SeedType::geo.
+      Only the overload that matches SeedType::geo is instantiated.
+    */
+    void compute_direct_sums(const PlaneGeometry& geo, const crd_view& vx, const crd_view& fx,
+      const scalar_view_type& fzeta, const scalar_view_type& fdiv, const scalar_view_type& fa);
+    void compute_direct_sums(const SphereGeometry& geo, const crd_view& vx, const crd_view& fx,
+      const scalar_view_type& fzeta, const scalar_view_type& fdiv, const scalar_view_type& fa);
+
+    void compute_rhs(const PlaneGeometry& geo, const Int stage, crd_view& vdx, scalar_view_type& vdzeta,
+      scalar_view_type& vdsigma, scalar_view_type& vdh, crd_view& fdx, scalar_view_type& fdzeta,
+      scalar_view_type& fdsigma, scalar_view_type& fda, const crd_view& vx, const scalar_view_type& vzeta,
+      const scalar_view_type& vsigma, const scalar_view_type& vh, const crd_view& fx,
+      const scalar_view_type& fzeta, const scalar_view_type& fsigma, const scalar_view_type& fa);
+    void compute_rhs(const SphereGeometry& geo, const Int stage, crd_view& vdx, scalar_view_type& vdzeta,
+      scalar_view_type& vdsigma, scalar_view_type& vdh, crd_view& fdx, scalar_view_type& fdzeta,
+      scalar_view_type& fdsigma, scalar_view_type& fda, const crd_view& vx, const scalar_view_type& vzeta,
+      const scalar_view_type& vsigma, const scalar_view_type& vh, const crd_view& fx,
+      const scalar_view_type& fzeta, const scalar_view_type& fsigma, const scalar_view_type& fa);
 
 };
 
@@ -4,6 +4,9 @@
 #include "LpmSWERK4.hpp"
 #include "LpmSWEKernels.hpp"
 #include "KokkosBlas.hpp"
+#include "LpmMemory.hpp"
+#include "LpmTimer.hpp"
+#include "LpmAutotune_Impl.hpp"
 #include "LpmUtilities.hpp"
 
 namespace Lpm {
@@ -42,8 +45,8 @@ std::string SWERK4<SeedType,ProblemType>::infoString(const std::string& label, c
 
 template <typename SeedType, typename ProblemType>
 void SWERK4<SeedType,ProblemType>::init() {;
-  vertex_policy = std::unique_ptr<ko::TeamPolicy<>>(new ko::TeamPolicy<>(nverts, ko::AUTO()));
-  face_policy = std::unique_ptr<ko::TeamPolicy<>>(new ko::TeamPolicy<>(nfaces, ko::AUTO()));
+  MemoryCategoryScope mem_scope(MemIntegrator);
+  LPM_THROW_IF(SeedType::geo::ndim == 3 && pse_cutoff > 0, "SWERK4 error: PSE cutoff is only implemented in the plane.");
 
   vertx1 = crd_view("vertx1",nverts);
   vertx2 = crd_view("vertx2",nverts);
@@ -102,23 +105,18 @@ void SWERK4<SeedType,ProblemType>::init() {;
 
 template <typename SeedType, typename ProblemType>
 void SWERK4<SeedType,ProblemType>::advance_timestep() {
+  LPM_TIMER_SCOPE("SWERK4::advance_timestep");
 
   /// RK Stage 1
-  ko::parallel_for("VertexSums-RK1", *vertex_policy,
-    PlanarSWEVertexSums(vertvel, vertddot, vertlaps, vertx, vertsfc,
-      facex, facevort, facediv, facearea, facesfc, eps_pse));
-  ko::parallel_for("PlanarSWEFaceSums-RK1", *face_policy,
-    PlanarSWEFaceSums(facevel, faceddot, facelaps, facex, facevort, facediv, facearea,
-     facesfc, eps_pse));
-
-  ko::parallel_for("VertexRHS-RK1", nverts,
-    PlanarSWEVertexRHS(vertx1, vertvort1, vertdiv1, verth1, vertx, vertvel, vertvort,
-      vertdiv, vertddot, vertlaps, vertdepth, f0, beta, g, dt));
-  ko::parallel_for("PlanarSWEFaceRHS", nfaces,
-    PlanarSWEFaceRHS(facex1, facevort1, facediv1, facearea1, facex, facevel, facevort,
-      facediv, faceddot, facelaps, facearea, facemask, f0, beta, g, dt));
+  LPM_TIMER_START("stage 1");
+  compute_direct_sums(vertx, facex, facevort, facediv, facearea);
+  compute_rhs(1, vertx1, vertvort1, vertdiv1, verth1, facex1, facevort1, facediv1, facearea1,
+    vertx, vertvort, vertdiv, vertdepth, facex, facevort, facediv, facearea);
+
+  LPM_TIMER_STOP();
 
   /// RK Stage 2
+  LPM_TIMER_START("stage 2");
   KokkosBlas::update(1.0, vertx,    0.5, vertx1,    0.0, vertxwork);
   KokkosBlas::update(1.0, vertvort, 0.5, vertvort1, 0.0, vertvortwork);
   KokkosBlas::update(1.0, vertdiv,  0.5, vertdiv1,  0.0, vertdivwork);
@@ -130,15 +128,14 @@ void SWERK4<SeedType,ProblemType>::advance_timestep() {
   KokkosBlas::update(1.0, facearea, 0.5, facearea1, 0.0, faceareawork);
 
   update_sfc();
-  compute_direct_sums();
+  compute_direct_sums(vertxwork, facexwork, facevortwork, facedivwork, faceareawork);
+  compute_rhs(2, vertx2, vertvort2, vertdiv2, verth2, facex2, facevort2, facediv2, facearea2,
+    vertxwork, vertvortwork, vertdivwork, verthwork, facexwork, facevortwork, facedivwork, faceareawork);
 
-  ko::parallel_for("VertexRHS-RK2", nverts,
-    PlanarSWEVertexRHS(vertx2, vertvort2, vertdiv2, verth2, vertxwork, vertvel, vertvortwork,
-      vertdivwork, vertddot, vertlaps, verthwork, f0, beta, g, dt));
-  ko::parallel_for("FaceRHS-RK2", nfaces,
-    PlanarSWEFaceRHS(facex2, facevort2, facediv2, facearea2, facexwork, facevel, facevortwork,
-      facedivwork, faceddot, facelaps, faceareawork, facemask, f0, beta, g, dt));
+  LPM_TIMER_STOP();
 
+  /// RK Stage 3
+  LPM_TIMER_START("stage 3");
   KokkosBlas::update(1.0, vertx,     0.5, vertx2,    0.0, vertxwork);
   KokkosBlas::update(1.0, vertvort,  0.5, vertvort2, 0.0, vertvortwork);
   KokkosBlas::update(1.0, vertdiv,   0.5, vertdiv2,  0.0, vertdivwork);
@@ -150,15 +147,14 @@ void SWERK4<SeedType,ProblemType>::advance_timestep() {
   KokkosBlas::update(1.0, facearea, 0.5, facearea2, 0.0, faceareawork);
 
   update_sfc();
-  compute_direct_sums();
+  compute_direct_sums(vertxwork, facexwork, facevortwork, facedivwork, faceareawork);
+  compute_rhs(3, vertx3, vertvort3, vertdiv3, verth3, facex3, facevort3, facediv3, facearea3,
+    vertxwork, vertvortwork, vertdivwork, verthwork, facexwork, facevortwork, facedivwork, faceareawork);
 
-  ko::parallel_for("VertexRHS-RK3", nverts,
-    PlanarSWEVertexRHS(vertx3, vertvort3, vertdiv3, verth3, vertxwork, vertvel, vertvortwork,
-      vertdivwork, vertddot, vertlaps, verthwork, f0, beta, g, dt));
-  ko::parallel_for("FaceRHS-RK3", nfaces,
-    PlanarSWEFaceRHS(facex3, facevort3, facediv3, facearea3, facexwork, facevel, facevortwork,
-      facedivwork, faceddot, facelaps, faceareawork, facemask, f0, beta, g, dt));
+  LPM_TIMER_STOP();
 
+  /// RK Stage 4
+  LPM_TIMER_START("stage 4");
   KokkosBlas::update(1.0, vertx,     1.0, vertx3,    0.0, vertxwork);
   KokkosBlas::update(1.0, vertvort,  1.0, vertvort3, 0.0, vertvortwork);
   KokkosBlas::update(1.0, vertdiv,   1.0, vertdiv3,  0.0, vertdivwork);
@@ -170,16 +166,14 @@ void SWERK4<SeedType,ProblemType>::advance_timestep() {
   KokkosBlas::update(1.0, facearea, 1.0, facearea3, 0.0, faceareawork);
 
   update_sfc();
-  compute_direct_sums();
+  compute_direct_sums(vertxwork, facexwork, facevortwork, facedivwork, faceareawork);
+  compute_rhs(4, vertx4, vertvort4, vertdiv4, verth4, facex4, facevort4, facediv4, facearea4,
+    vertxwork, vertvortwork, vertdivwork, verthwork, facexwork, facevortwork, facedivwork, faceareawork);
 
-  ko::parallel_for("VertexRHS-RK4", nverts,
-    PlanarSWEVertexRHS(vertx4, vertvort4, vertdiv4, verth4, vertxwork, vertvel, vertvortwork,
-      vertdivwork, vertddot, vertlaps, verthwork, f0, beta, g, dt));
-  ko::parallel_for("FaceRHS-RK4", nfaces,
-    PlanarSWEFaceRHS(facex4, facevort4, facediv4, facearea4, facexwork, facevel, facevortwork,
-      facedivwork, faceddot, facelaps, faceareawork, facemask, f0, beta, g, dt));
+  LPM_TIMER_STOP();
 
-  ko::parallel_for("VertPositionUpdate", ko::MDRangePolicy<ko::Rank<2>>({0,0},{nverts,2}),
+  LPM_TIMER_START("update");
+  ko::parallel_for("VertPositionUpdate", ko::MDRangePolicy<ko::Rank<2>>({0,0},{nverts,SeedType::geo::ndim}),
     PositionUpdate(vertx, vertx1, vertx2, vertx3, vertx4));
   ko::parallel_for("VertVortUpdate", nverts,
     ScalarUpdate(vertvort, vertvort1, vertvort2, vertvort3, vertvort4));
@@ -188,9 +182,9 @@ void SWERK4<SeedType,ProblemType>::advance_timestep() {
   ko::parallel_for("VertHUpdate", nverts,
     ScalarUpdate(vertdepth, verth1, verth2, verth3, verth4));
   ko::parallel_for("VertSfcUpdate", nverts,
-    PlanarSWESetVertexSfc<ProblemType>(vertsfc, verttopo, vertdepth, vertx));
+    SWESetVertexSfc<typename SeedType::geo,ProblemType>(vertsfc, verttopo, vertdepth, vertx));
 
-  ko::parallel_for("FacePositionUpdate", ko::MDRangePolicy<ko::Rank<2>>({0,0}, {nfaces,2}),
+  ko::parallel_for("FacePositionUpdate", ko::MDRangePolicy<ko::Rank<2>>({0,0}, {nfaces,SeedType::geo::ndim}),
     PositionUpdate(facex, facex1, facex2, facex3, facex4));
   ko::parallel_for("FaceVortUpdate", nfaces,
     ScalarUpdate(facevort, facevort1, facevort2, facevort3, facevort4));
@@ -199,27 +193,85 @@ void SWERK4<SeedType,ProblemType>::advance_timestep() {
   ko::parallel_for("FaceAreaUpdate", nfaces,
     ScalarUpdate(facearea, facearea1, facearea2, facearea3, facearea4));
   ko::parallel_for("FaceSfcUpdate", nfaces,
-    PlanarSWESetFaceSfc<ProblemType>(facesfc, facedepth, facetopo,
+    SWESetFaceSfc<typename SeedType::geo,ProblemType>(facesfc, facedepth, facetopo,
       facemass, facearea, facemask, facex));
+  LPM_TIMER_STOP();
+}
+
+template <typename SeedType, typename ProblemType>
+void SWERK4<SeedType,ProblemType>::compute_direct_sums(const crd_view& vx, const crd_view& fx,
+  const scalar_view_type& fzeta, const scalar_view_type& fdiv, const scalar_view_type& fa) {
+  LPM_TIMER_SCOPE("direct sums");
+  LPM_COUNTER_ADD("SWE direct sum pairs", Real(nverts + nfaces)*nfaces);
+  compute_direct_sums(typename SeedType::geo(), vx, fx, fzeta, fdiv, fa);
+}
+
+template <typename SeedType, typename ProblemType>
+void SWERK4<SeedType,ProblemType>::compute_direct_sums(const PlaneGeometry& geo, const crd_view& vx,
+  const crd_view& fx, const scalar_view_type& fzeta, const scalar_view_type& fdiv, const scalar_view_type& fa) {
+  rhs_engine.compute(vertvel, vertddot, vertlaps, vx, vertsfc, nverts,
+    facevel, faceddot, facelaps, fx, fzeta, fdiv, fa, facesfc, facemask, nfaces, eps_pse);
+}
+
+template <typename SeedType, typename ProblemType>
+void SWERK4<SeedType,ProblemType>::compute_direct_sums(const SphereGeometry& geo, const crd_view& vx,
+  const crd_view& fx, const scalar_view_type& fzeta, const scalar_view_type& fdiv, const scalar_view_type& fa) {
+  tunedParallelFor("VertexSums", "SphereSWESumsVerts", nverts, nfaces,
+    SphereSWESums(vertvel, vertddot, vertlaps, vx, vertsfc, fx, fzeta, fdiv, fa, facesfc,
+      facemask, eps_pse));
+  tunedParallelFor("FaceSums", "SphereSWESumsFaces", nfaces, nfaces,
+    SphereSWESums(facevel, faceddot, facelaps, fx, facesfc, fx, fzeta, fdiv, fa, facesfc,
+      facemask, eps_pse));
+}
+
+template <typename SeedType, typename ProblemType>
+void SWERK4<SeedType,ProblemType>::compute_rhs(const Int stage, crd_view& vdx, scalar_view_type& vdzeta,
+  scalar_view_type& vdsigma, scalar_view_type& vdh, crd_view& fdx, scalar_view_type& fdzeta,
+  scalar_view_type& fdsigma, scalar_view_type& fda, const crd_view& vx, const scalar_view_type& vzeta,
+  const scalar_view_type& vsigma, const scalar_view_type& vh, const crd_view& fx,
+  const scalar_view_type& fzeta, const scalar_view_type& fsigma, const scalar_view_type& fa) {
+  LPM_TIMER_SCOPE("rhs");
+  compute_rhs(typename SeedType::geo(), stage, vdx, vdzeta, vdsigma, vdh, fdx, fdzeta, fdsigma, fda,
+    vx, vzeta, vsigma, vh, fx, fzeta, fsigma, fa);
+}
+
+template <typename SeedType, typename ProblemType>
+void SWERK4<SeedType,ProblemType>::compute_rhs(const PlaneGeometry& geo, const Int stage, crd_view& vdx,
+  scalar_view_type& vdzeta, scalar_view_type& vdsigma, scalar_view_type& vdh, crd_view& fdx,
+  scalar_view_type& fdzeta, scalar_view_type& fdsigma, scalar_view_type& fda, const crd_view& vx,
+  const scalar_view_type& vzeta, const scalar_view_type& vsigma, const scalar_view_type& vh,
+  const crd_view& fx, const scalar_view_type& fzeta, const scalar_view_type& fsigma,
+  const scalar_view_type& fa) {
+  ko::parallel_for("VertexRHS-RK" + std::to_string(stage), nverts,
+    PlanarSWEVertexRHS(vdx, vdzeta, vdsigma, vdh, vx, vertvel, vzeta,
+      vsigma, vertddot, vertlaps, vh, f0, beta, g, dt));
+  ko::parallel_for("FaceRHS-RK" + std::to_string(stage), nfaces,
+    PlanarSWEFaceRHS(fdx, fdzeta, fdsigma, fda, fx, facevel, fzeta,
+      fsigma, faceddot, facelaps, fa, facemask, f0, beta, g, dt));
 }
 
 template <typename SeedType, typename ProblemType>
-void SWERK4<SeedType,ProblemType>::compute_direct_sums() {
-  ko::parallel_for("VertexSums", *vertex_policy,
-    PlanarSWEVertexSums(vertvel, vertddot, vertlaps, vertxwork, vertsfc,
-      facexwork, facevortwork, facedivwork, faceareawork, facesfc, eps_pse));
-  ko::parallel_for("FaceSums", *face_policy,
-    PlanarSWEFaceSums(facevel, faceddot, facelaps, facexwork, facevortwork, facedivwork,
-      faceareawork, facesfc, eps_pse));
+void SWERK4<SeedType,ProblemType>::compute_rhs(const SphereGeometry& geo, const Int stage, crd_view& vdx,
+  scalar_view_type& vdzeta, scalar_view_type& vdsigma, scalar_view_type& vdh, crd_view& fdx,
+  scalar_view_type& fdzeta, scalar_view_type& fdsigma, scalar_view_type& fda, const crd_view& vx,
+  const scalar_view_type& vzeta, const scalar_view_type& vsigma, const scalar_view_type& vh,
+  const crd_view& fx, const scalar_view_type& fzeta, const scalar_view_type& fsigma,
+  const scalar_view_type& fa) {
+  ko::parallel_for("VertexRHS-RK" + std::to_string(stage), nverts,
+    SphereSWEVertexRHS(vdx, vdzeta, vdsigma, vdh, vx, vertvel, vzeta,
+      vsigma, vertddot, vertlaps, vh, Omega, g, dt));
+  ko::parallel_for("FaceRHS-RK" + std::to_string(stage), nfaces,
+    SphereSWEFaceRHS(fdx, fdzeta, fdsigma, fda, fx, facevel, fzeta,
+      fsigma, faceddot, facelaps, fa, facemask, Omega, g, dt));
 }
 
 template <typename SeedType, typename ProblemType>
 void SWERK4<SeedType,ProblemType>::update_sfc() {
   ko::parallel_for("VertexSfcUpdate", nverts,
-    PlanarSWESetVertexSfc<ProblemType>(vertsfc, verttopo, verthwork, vertxwork));
+    SWESetVertexSfc<typename SeedType::geo,ProblemType>(vertsfc, verttopo, verthwork, vertxwork));
   ko::parallel_for("FaceSfcUpdate", nfaces,
-    PlanarSWESetFaceSfc<ProblemType>(facesfc, facedepth, facetopo, facemass, facearea,
-      facemask, facexwork));
+    SWESetFaceSfc<typename SeedType::geo,ProblemType>(facesfc, facedepth, facetopo, facemass,
+      faceareawork, facemask, facexwork));
 }
 
 
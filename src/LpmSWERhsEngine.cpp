@@ -0,0 +1,101 @@
+#include "LpmSWERhsEngine.hpp"
+#include "LpmSWEKernels.hpp"
+#include "LpmUtilities.hpp"
+#include <sstream>
+
+namespace Lpm {
+
+std::string swePSEMethodString(const SWEPSEMethod& m) {
+  std::string result;
+  switch (m) {
+    case (FusedPSE) : {
+      result = "fused";
+      break;
+    }
+    case (DirectPSE) : {
+      result = "direct";
+      break;
+    }
+    case (CutoffPSE) : {
+      result = "cutoff";
+      break;
+    }
+  }
+  return result;
+}
+
+void PlanarSWERhsEngine::compute(vec_view& vertvel, scalar_view_type& vertddot, scalar_view_type& vertlaps,
+  const crd_view& vx, const scalar_view_type& vsfc, const Index nv,
+  vec_view& facevel, scalar_view_type& faceddot, scalar_view_type& facelaps,
+  const crd_view& fx, const scalar_view_type& fzeta, const scalar_view_type& fdiv,
+  const scalar_view_type& fa, const scalar_view_type& fsfc, const mask_view_type& fmask,
+  const Index nf, const Real& eps) {
+
+  velocity_pass(vertvel, vertddot, vertlaps, vx, vsfc, nv, fx, fzeta, fdiv, fa, fsfc, nf, eps);
+  velocity_pass(facevel, faceddot, facelaps, fx, fsfc, nf, fx, fzeta, fdiv, fa, fsfc, nf, eps);
+
+  update_sources(fx, nf, fmask, eps);
+  pse_pass(vertlaps, vx, vsfc, nv, fx, fsfc, fa, nf, eps);
+  pse_pass(facelaps, fx, fsfc, nf, fx, fsfc, fa, nf, eps);
+}
+
+void PlanarSWERhsEngine::velocity_pass(vec_view& tvel, scalar_view_type& tddot, scalar_view_type& tlaps,
+  const crd_view& tx, const scalar_view_type& tsfc, const Index nt,
+  const crd_view& sx, const scalar_view_type& szeta, const scalar_view_type& sdiv,
+  const scalar_view_type& sa, const scalar_view_type& ssfc, const Index ns, const Real& eps) const {
+  const ko::TeamPolicy<> policy(nt, ko::AUTO());
+  if (pse_method == FusedPSE) {
+    ko::parallel_for("SWEFusedSums", policy,
+      PlanarSWEVertexSums(tvel, tddot, tlaps, tx, tsfc, sx, szeta, sdiv, sa, ssfc, eps, true));
+  }
+  else {
+    ko::parallel_for("SWEVelocitySums", policy,
+      PlanarSWEVelocitySums(tvel, tddot, tx, sx, szeta, sdiv, sa, ns));
+  }
+}
+
+void PlanarSWERhsEngine::pse_pass(scalar_view_type& tlaps, const crd_view& tx, const scalar_view_type& tsfc,
+  const Index nt, const crd_view& sx, const scalar_view_type& ssfc, const scalar_view_type& sa,
+  const Index ns, const Real& eps) const {
+  const ko::TeamPolicy<> policy(nt, ko::AUTO());
+  switch (pse_method) {
+    case (FusedPSE) : {
+      break;
+    }
+    case (DirectPSE) : {
+      ko::parallel_for("SWEPSEDirect", policy,
+        PlanePSELaplacian(tlaps, tx, tsfc, sx, ssfc, sa, eps, ns));
+      break;
+    }
+    case (CutoffPSE) : {
+      ko::parallel_for("SWEPSECutoff", policy,
+        PlanePSELaplacianCutoff(tlaps, tx, tsfc, sx, ssfc, sa, eps, src_cells, pse_cutoff));
+      break;
+    }
+  }
+}
+
+void PlanarSWERhsEngine::update_sources(const crd_view& sx, const Index ns, const mask_view_type& smask,
+  const Real& eps) {
+  if (pse_method == CutoffPSE) {
+    LPM_THROW_IF(!(pse_cutoff > 0), "PlanarSWERhsEngine error: cutoff must be positive.");
+    src_cells.build(sx, ns, pse_cutoff*eps, smask);
+  }
+}
+
+std::string PlanarSWERhsEngine::infoString(const std::string& label, const int& tab_level) const {
+  std::ostringstream ss;
+  const std::string tabstr = indentString(tab_level);
+  ss << tabstr << "PlanarSWERhsEngine " << label << " info:\n";
+  ss << tabstr << "\tvelocity: direct, pse: " << swePSEMethodString(pse_method);
+  if (pse_method == CutoffPSE) {
+    ss << " (" << pse_cutoff << " eps)\n";
+    ss << src_cells.infoString("sources", tab_level+1);
+  }
+  else {
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+}
@@ -0,0 +1,92 @@
+#ifndef LPM_SWE_RHS_ENGINE_HPP
+#define LPM_SWE_RHS_ENGINE_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmCellList.hpp"
+#include "LpmPSE.hpp"
+#include "Kokkos_Core.hpp"
+#include <string>
+
+namespace Lpm {
+
+/// Algorithm used for the PSE (short-range) surface Laplacian in the SWE right-hand side
+enum SWEPSEMethod {
+  FusedPSE, ///< same O(N^2) reduction as the velocity sums (PlanarSWEDirectSum)
+  DirectPSE, ///< separate O(N^2) pass (PlanePSELaplacian)
+  CutoffPSE ///< separate pass over sources within a cutoff radius (PlanePSELaplacianCutoff), O(N)
+};
+
+std::string swePSEMethodString(const SWEPSEMethod& m);
+
+/** @brief Evaluates the direct-sum terms of the planar SWE right-hand side.
+
+  The right-hand side needs two kinds of sums over the source panels:
+    1. velocity and velocity gradient (long-range Biot-Savart type kernels, every pair contributes)
+    2. surface Laplacian of the surface height (short-range PSE kernel)
+
+  Each is evaluated in its own pass, so that each can use the algorithm that suits it;
+  velocity_pass and pse_pass may also be scheduled separately.
+  The velocity pass is a direct sum.  With FusedPSE, the Laplacian is computed in the velocity pass
+  and pse_pass does nothing.
+
+  For CutoffPSE, update_sources must be called after the sources move and before pse_pass.
+*/
+class PlanarSWERhsEngine {
+  public:
+    typedef typename PlaneGeometry::crd_view_type crd_view;
+    typedef typename PlaneGeometry::vec_view_type vec_view;
+
+    SWEPSEMethod pse_method;
+    Real pse_cutoff; ///< cutoff radius, as a multiple of the PSE eps (CutoffPSE only)
+
+    PlanarSWERhsEngine(const SWEPSEMethod& m=FusedPSE, const Real& cutoff=PSE_CUTOFF_MULTIPLE) :
+      pse_method(m), pse_cutoff(cutoff) {}
+
+    /** @brief Computes all direct-sum terms at vertices and faces.
+
+      @hostfn
+
+      Source panels are the faces; masked (divided) faces are excluded from the PSE cell list and
+      have zero area, so they do not contribute to the velocity sums.
+    */
+    void compute(vec_view& vertvel, scalar_view_type& vertddot, scalar_view_type& vertlaps,
+      const crd_view& vx, const scalar_view_type& vsfc, const Index nv,
+      vec_view& facevel, scalar_view_type& faceddot, scalar_view_type& facelaps,
+      const crd_view& fx, const scalar_view_type& fzeta, const scalar_view_type& fdiv,
+      const scalar_view_type& fa, const scalar_view_type& fsfc, const mask_view_type& fmask,
+      const Index nf, const Real& eps);
+
+    /** @brief Far-field pass: velocity and double dot product at nt targets (and the Laplacian, if
+      pse_method == FusedPSE).
+
+      @hostfn
+    */
+    void velocity_pass(vec_view& tvel, scalar_view_type& tddot, scalar_view_type& tlaps,
+      const crd_view& tx, const scalar_view_type& tsfc, const Index nt,
+      const crd_view& sx, const scalar_view_type& szeta, const scalar_view_type& sdiv,
+      const scalar_view_type& sa, const scalar_view_type& ssfc, const Index ns, const Real& eps) const;
+
+    /** @brief Short-range pass: PSE Laplacian of the surface height at nt targets.
+
+      @hostfn
+    */
+    void pse_pass(scalar_view_type& tlaps, const crd_view& tx, const scalar_view_type& tsfc, const Index nt,
+      const crd_view& sx, const scalar_view_type& ssfc, const scalar_view_type& sa, const Index ns,
+      const Real& eps) const;
+
+    /** @brief Rebuilds source data structures (the cell list, for CutoffPSE).
+
+      @hostfn
+    */
+    void update_sources(const crd_view& sx, const Index ns, const mask_view_type& smask, const Real& eps);
+
+    std::string infoString(const std::string& label="", const int& tab_level=0) const;
+
+  protected:
+    PlaneCellList src_cells;
+};
+
+}
+#endif
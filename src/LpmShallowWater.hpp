@@ -17,10 +17,15 @@
 
 namespace Lpm {
 
+#ifdef LPM_HAVE_NETCDF
+  class NcTimeSeriesWriter; /// fwd. decl.
+  class NcWriter; /// fwd. decl.
+#endif
+
 template <typename SeedType> class ShallowWater : public PolyMesh2d<SeedType> {
   public:
     typedef scalar_view_type scalar_field;
-    typedef ko::View<Real*[SeedType::geo::ndim]> vector_field;
+    typedef typename SeedType::geo::vec_view_type vector_field;
 
     scalar_field relVortVerts;
     scalar_field potVortVerts;
@@ -52,6 +57,15 @@ template <typename SeedType> class ShallowWater : public PolyMesh2d<SeedType> {
     ShallowWater(const Index nmaxverts, const Index nmaxedges, const Index nmaxfaces,
        const Int& nq_scaler=0, const Int& nq_vector=0);
 
+#ifdef LPM_HAVE_NETCDF
+    /** @brief Restarts from a file written by writeCheckpoint; the simulation time is reader.getRealAtt("t").
+
+      Memory is allocated for exactly the mesh in the file.  Fields are read in bulk into host mirrors
+      and copied to device.
+    */
+    ShallowWater(const PolyMeshReader& reader);
+#endif
+
     template <typename Geo, typename CV> KOKKOS_INLINE_FUNCTION typename
     std::enable_if<std::is_same<Geo,PlaneGeometry>::value, Real>::type
     coriolis_f(const CV v) const {return f0 + beta*v[1];}
@@ -78,6 +92,18 @@ template <typename SeedType> class ShallowWater : public PolyMesh2d<SeedType> {
 
     void addFieldsToVtk(Polymesh2dVtkInterface<SeedType>& vtk) const;
 
+#ifdef LPM_HAVE_NETCDF
+    /** @brief Appends a time record (time, positions, face areas, all fields and tracers)
+      to a time series file.  Call writer.defineMesh(*this) once before the first record.
+    */
+    void writeNcTimestep(NcTimeSeriesWriter& writer, const Real& t) const;
+
+    /** @brief Writes a restart file: the mesh (including current face areas), all fields and tracers,
+      t, and the Coriolis parameters.
+    */
+    void writeCheckpoint(NcWriter& writer, const Real& t) const;
+#endif
+
     inline void set_coriolis(const Real& f, const Real& b) {f0 = f; beta = b;}
 
     inline void set_coriolis(const Real& rot_rate) {Omega = rot_rate;}
@@ -3,6 +3,10 @@
 
 #include "LpmShallowWater.hpp"
 #include "LpmUtilities.hpp"
+#ifdef LPM_HAVE_NETCDF
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#endif
 #include <sstream>
 
 namespace Lpm {
@@ -90,6 +94,128 @@ ShallowWater<SeedType>::ShallowWater(const Index nmaxverts, const Index nmaxedge
     }
 }
 
+#ifdef LPM_HAVE_NETCDF
+template <typename SeedType>
+ShallowWater<SeedType>::ShallowWater(const PolyMeshReader& reader) :
+  PolyMesh2d<SeedType>(reader),
+
+  relVortVerts("relative_vorticity_vertices", this->physVerts.crds.extent(0)),
+  potVortVerts("potential_vorticity_vertices", this->physVerts.crds.extent(0)),
+  divVerts("divergence_vertices", this->physVerts.crds.extent(0)),
+  velocityVerts("velocity_vertices", this->physVerts.crds.extent(0)),
+  surfaceHeightVerts("fluid_sfc_hght_vertices", this->physVerts.crds.extent(0)),
+  depthVerts("fluid_depth_vertices", this->physVerts.crds.extent(0)),
+  topoVerts("bottom_topography_vertices", this->physVerts.crds.extent(0)),
+
+  relVortFaces("relative_vorticity_faces", this->physFaces.crds.extent(0)),
+  potVortFaces("potential_vorticity_faces", this->physFaces.crds.extent(0)),
+  divFaces("divergence_faces", this->physFaces.crds.extent(0)),
+  surfaceHeightFaces("fluid_sfc_hgt_faces", this->physFaces.crds.extent(0)),
+  depthFaces("fluid_depth_faces", this->physFaces.crds.extent(0)),
+  topoFaces("bottom_topography_faces", this->physFaces.crds.extent(0)),
+  massFaces("mass_faces", this->physFaces.crds.extent(0)),
+  velocityFaces("velocity_faces", this->physFaces.crds.extent(0)),
+
+  f0(reader.getRealAtt("f0")), beta(reader.getRealAtt("beta")), Omega(reader.getRealAtt("Omega")) {
+
+    host_relVortVerts = ko::create_mirror_view(relVortVerts);
+    host_potVortVerts = ko::create_mirror_view(potVortVerts);
+    host_divVerts = ko::create_mirror_view(divVerts);
+    host_sfcVerts = ko::create_mirror_view(surfaceHeightVerts);
+    host_depthVerts = ko::create_mirror_view(depthVerts);
+    host_topoVerts = ko::create_mirror_view(topoVerts);
+    host_velocityVerts = ko::create_mirror_view(velocityVerts);
+
+    host_relVortFaces = ko::create_mirror_view(relVortFaces);
+    host_potVortFaces = ko::create_mirror_view(potVortFaces);
+    host_divFaces = ko::create_mirror_view(divFaces);
+    host_sfcFaces = ko::create_mirror_view(surfaceHeightFaces);
+    host_depthFaces = ko::create_mirror_view(depthFaces);
+    host_topoFaces = ko::create_mirror_view(topoFaces);
+    host_massFaces = ko::create_mirror_view(massFaces);
+    host_velocityFaces = ko::create_mirror_view(velocityFaces);
+
+    reader.fill_scalar_field(host_relVortVerts, "relative_vorticity_verts");
+    reader.fill_scalar_field(host_potVortVerts, "potential_vorticity_verts");
+    reader.fill_scalar_field(host_divVerts, "divergence_verts");
+    reader.fill_scalar_field(host_sfcVerts, "surface_height_verts");
+    reader.fill_scalar_field(host_depthVerts, "depth_verts");
+    reader.fill_scalar_field(host_topoVerts, "bottom_height_verts");
+    reader.fill_vector_field(host_velocityVerts, "velocity_verts");
+
+    reader.fill_scalar_field(host_relVortFaces, "relative_vorticity_faces");
+    reader.fill_scalar_field(host_potVortFaces, "potential_vorticity_faces");
+    reader.fill_scalar_field(host_divFaces, "divergence_faces");
+    reader.fill_scalar_field(host_sfcFaces, "surface_height_faces");
+    reader.fill_scalar_field(host_depthFaces, "depth_faces");
+    reader.fill_scalar_field(host_topoFaces, "bottom_height_faces");
+    reader.fill_scalar_field(host_massFaces, "mass_faces");
+    reader.fill_vector_field(host_velocityFaces, "velocity_faces");
+
+    std::ostringstream ss;
+    const Int nqs = reader.getIntAtt("nscalar_tracers");
+    for (Int k=0; k<nqs; ++k) {
+      ss << "scalar_tracer_name" << k;
+      const std::string name = reader.getStringAtt(ss.str());
+      ss.str("");
+      create_scalar_tracer(name);
+      reader.fill_scalar_field(host_scalar_tracer_verts[k], name + "_verts");
+      reader.fill_scalar_field(host_scalar_tracer_faces[k], name + "_faces");
+    }
+    const Int nqv = reader.getIntAtt("nvector_tracers");
+    for (Int k=0; k<nqv; ++k) {
+      ss << "vector_tracer_name" << k;
+      const std::string name = reader.getStringAtt(ss.str());
+      ss.str("");
+      create_vector_tracer(name);
+      reader.fill_vector_field(host_vector_tracer_verts[k], name + "_vec_verts");
+      reader.fill_vector_field(host_vector_tracer_faces[k], name + "_vec_faces");
+    }
+
+    ko::deep_copy(relVortVerts, host_relVortVerts);
+    ko::deep_copy(potVortVerts, host_potVortVerts);
+    ko::deep_copy(divVerts, host_divVerts);
+    ko::deep_copy(surfaceHeightVerts, host_sfcVerts);
+    ko::deep_copy(depthVerts, host_depthVerts);
+    ko::deep_copy(topoVerts, host_topoVerts);
+    ko::deep_copy(velocityVerts, host_velocityVerts);
+
+    ko::deep_copy(relVortFaces, host_relVortFaces);
+    ko::deep_copy(potVortFaces, host_potVortFaces);
+    ko::deep_copy(divFaces, host_divFaces);
+    ko::deep_copy(surfaceHeightFaces, host_sfcFaces);
+    ko::deep_copy(depthFaces, host_depthFaces);
+    ko::deep_copy(topoFaces, host_topoFaces);
+    ko::deep_copy(massFaces, host_massFaces);
+    ko::deep_copy(velocityFaces, host_velocityFaces);
+
+    for (Int k=0; k<nqs; ++k) {
+      ko::deep_copy(scalar_tracer_verts[k], host_scalar_tracer_verts[k]);
+      ko::deep_copy(scalar_tracer_faces[k], host_scalar_tracer_faces[k]);
+    }
+    for (Int k=0; k<nqv; ++k) {
+      ko::deep_copy(vector_tracer_verts[k], host_vector_tracer_verts[k]);
+      ko::deep_copy(vector_tracer_faces[k], host_vector_tracer_faces[k]);
+    }
+}
+#endif
+
+template <typename SeedType>
+void ShallowWater<SeedType>::create_scalar_tracer(const std::string& name) {
+  scalar_tracer_verts.push_back(scalar_field(name, relVortVerts.extent(0)));
+  host_scalar_tracer_verts.push_back(ko::create_mirror_view(scalar_tracer_verts.back()));
+  scalar_tracer_faces.push_back(scalar_field(name, relVortFaces.extent(0)));
+  host_scalar_tracer_faces.push_back(ko::create_mirror_view(scalar_tracer_faces.back()));
+}
+
+template <typename SeedType>
+void ShallowWater<SeedType>::create_vector_tracer(const std::string& name) {
+  vector_tracer_verts.push_back(vector_field(name, relVortVerts.extent(0)));
+  host_vector_tracer_verts.push_back(ko::create_mirror_view(vector_tracer_verts.back()));
+  vector_tracer_faces.push_back(vector_field(name, relVortFaces.extent(0)));
+  host_vector_tracer_faces.push_back(ko::create_mirror_view(vector_tracer_faces.back()));
+}
+
 template <typename SeedType> template <typename ProblemType>
 void ShallowWater<SeedType>::set_bottom_topography() {
   auto tvcopy = this->topoVerts;
@@ -245,6 +371,84 @@ void ShallowWater<SeedType>::addFieldsToVtk(Polymesh2dVtkInterface<SeedType>& vt
 //   }
 }
 
+#ifdef LPM_HAVE_NETCDF
+template <typename SeedType>
+void ShallowWater<SeedType>::writeNcTimestep(NcTimeSeriesWriter& writer, const Real& t) const {
+  writer.appendTime(t, *this);
+  writer.writeScalarField(relVortVerts, VertexField, "relative_vorticity_verts");
+  writer.writeScalarField(potVortVerts, VertexField, "potential_vorticity_verts");
+  writer.writeScalarField(divVerts, VertexField, "divergence_verts");
+  writer.writeScalarField(surfaceHeightVerts, VertexField, "surface_height_verts");
+  writer.writeScalarField(depthVerts, VertexField, "depth_verts");
+  writer.writeVectorField(velocityVerts, VertexField, "velocity_verts");
+
+  writer.writeScalarField(relVortFaces, FaceField, "relative_vorticity_faces");
+  writer.writeScalarField(potVortFaces, FaceField, "potential_vorticity_faces");
+  writer.writeScalarField(divFaces, FaceField, "divergence_faces");
+  writer.writeScalarField(surfaceHeightFaces, FaceField, "surface_height_faces");
+  writer.writeScalarField(depthFaces, FaceField, "depth_faces");
+  writer.writeScalarField(massFaces, FaceField, "mass_faces");
+  writer.writeScalarField(this->faces.area, FaceField, "face_area_t");
+  writer.writeVectorField(velocityFaces, FaceField, "velocity_faces");
+
+  for (Int k=0; k<scalar_tracer_verts.size(); ++k) {
+    writer.writeScalarField(scalar_tracer_verts[k], VertexField, scalar_tracer_verts[k].label() + "_verts");
+    writer.writeScalarField(scalar_tracer_faces[k], FaceField, scalar_tracer_faces[k].label() + "_faces");
+  }
+  for (Int k=0; k<vector_tracer_verts.size(); ++k) {
+    writer.writeVectorField(vector_tracer_verts[k], VertexField, vector_tracer_verts[k].label() + "_vec_verts");
+    writer.writeVectorField(vector_tracer_faces[k], FaceField, vector_tracer_faces[k].label() + "_vec_faces");
+  }
+}
+#endif
+
+#ifdef LPM_HAVE_NETCDF
+template <typename SeedType>
+void ShallowWater<SeedType>::writeCheckpoint(NcWriter& writer, const Real& t) const {
+  this->updateHost();
+  writer.writePolymesh(*this);
+  writer.writeAttribute("t", t);
+  writer.writeAttribute("f0", f0);
+  writer.writeAttribute("beta", beta);
+  writer.writeAttribute("Omega", Omega);
+  writer.writeAttribute("nscalar_tracers", nscalar_tracers());
+  writer.writeAttribute("nvector_tracers", nvector_tracers());
+
+  writer.writeScalarField(relVortVerts, VertexField, "relative_vorticity_verts");
+  writer.writeScalarField(potVortVerts, VertexField, "potential_vorticity_verts");
+  writer.writeScalarField(divVerts, VertexField, "divergence_verts");
+  writer.writeScalarField(surfaceHeightVerts, VertexField, "surface_height_verts");
+  writer.writeScalarField(depthVerts, VertexField, "depth_verts");
+  writer.writeScalarField(topoVerts, VertexField, "bottom_height_verts");
+  writer.writeVectorField(velocityVerts, VertexField, "velocity_verts");
+
+  writer.writeScalarField(relVortFaces, FaceField, "relative_vorticity_faces");
+  writer.writeScalarField(potVortFaces, FaceField, "potential_vorticity_faces");
+  writer.writeScalarField(divFaces, FaceField, "divergence_faces");
+  writer.writeScalarField(surfaceHeightFaces, FaceField, "surface_height_faces");
+  writer.writeScalarField(depthFaces, FaceField, "depth_faces");
+  writer.writeScalarField(topoFaces, FaceField, "bottom_height_faces");
+  writer.writeScalarField(massFaces, FaceField, "mass_faces");
+  writer.writeVectorField(velocityFaces, FaceField, "velocity_faces");
+
+  std::ostringstream ss;
+  for (Int k=0; k<scalar_tracer_verts.size(); ++k) {
+    ss << "scalar_tracer_name" << k;
+    writer.writeAttribute(ss.str(), scalar_tracer_verts[k].label());
+    ss.str("");
+    writer.writeScalarField(scalar_tracer_verts[k], VertexField, scalar_tracer_verts[k].label() + "_verts");
+    writer.writeScalarField(scalar_tracer_faces[k], FaceField, scalar_tracer_faces[k].label() + "_faces");
+  }
+  for (Int k=0; k<vector_tracer_verts.size(); ++k) {
+    ss << "vector_tracer_name" << k;
+    writer.writeAttribute(ss.str(), vector_tracer_verts[k].label());
+    ss.str("");
+    writer.writeVectorField(vector_tracer_verts[k], VertexField, vector_tracer_verts[k].label() + "_vec_verts");
+    writer.writeVectorField(vector_tracer_faces[k], FaceField, vector_tracer_faces[k].label() + "_vec_faces");
+  }
+}
+#endif
+
 template <typename SeedType>
 Real ShallowWater<SeedType>::total_mass() const {
   Real m;
@@ -9,6 +9,8 @@
 #include "LpmRossbyWaves.hpp"
 #include "Kokkos_Core.hpp"
 #include "LpmVtkIO.hpp"
+#include "LpmSymmetricPairKernels.hpp"
+#include "LpmAutotune_Impl.hpp"
 #include <cmath>
 #include <iomanip>
 
@@ -85,6 +87,9 @@ struct Init {
 */
 struct ReduceDistinct {
     typedef Real value_type; ///< required by kokkos for custom reducers
+    static constexpr Int flops_per_pair = 10; ///< work per pair (see PairWork)
+    static constexpr Int transcendentals_per_pair = 1;
+    static constexpr Int bytes_per_pair = 41;
     Index i; ///< index of target point in tgtx view
     crd_view tgtx; ///< view holding coordinates of target locations (usually, vertices)
     crd_view srcx; ///< view holding coordinates of source locations (usually, face centers)
@@ -100,8 +105,8 @@ struct ReduceDistinct {
     void operator() (const Index& j, value_type& pot) const {
         Real potential = 0;
         if (!facemask(j)) {
-            auto mytgt = ko::subview(tgtx,i,ko::ALL());
-            auto mysrc = ko::subview(srcx,j,ko::ALL());
+            const auto mytgt = vec_at<3>(tgtx, i);
+            const auto mysrc = vec_at<3>(srcx, j);
             greensFn(potential, mytgt, mysrc, srcf(j), srca(j));
         }
         pot += potential;
@@ -113,6 +118,9 @@ struct ReduceDistinct {
 */
 struct UReduceDistinct {
     typedef ko::Tuple<Real,3> value_type; ///< required by kokkos for custom reducers
+    static constexpr Int flops_per_pair = 23; ///< work per pair (see PairWork)
+    static constexpr Int transcendentals_per_pair = 0;
+    static constexpr Int bytes_per_pair = 41;
     Index i; ///< index of target point in tgtx view
     crd_view tgtx; ///< view holding coordinates of target locations (usually, vertices)
     crd_view srcx; ///< view holding coordinates of source locations (usually, face centers)
@@ -128,8 +136,8 @@ struct UReduceDistinct {
     void operator() (const Index& j, value_type& vel) const {
         ko::Tuple<Real,3> u;
         if (!facemask(j)) {
-            auto mytgt = ko::subview(tgtx, i, ko::ALL());
-            auto mysrc = ko::subview(srcx, j, ko::ALL());
+            const auto mytgt = vec_at<3>(tgtx, i);
+            const auto mysrc = vec_at<3>(srcx, j);
             biotSavart(u, mytgt, mysrc, srcf(j), srca(j));
         }
         vel += u;
@@ -147,6 +155,13 @@ struct UReduceDistinct {
 
 */
 struct VertexSolve {
+    /// work per pair: both reductions (see PairWork)
+    static constexpr Int flops_per_pair = ReduceDistinct::flops_per_pair +
+      UReduceDistinct::flops_per_pair;
+    static constexpr Int transcendentals_per_pair = ReduceDistinct::transcendentals_per_pair +
+      UReduceDistinct::transcendentals_per_pair;
+    static constexpr Int bytes_per_pair = ReduceDistinct::bytes_per_pair +
+      UReduceDistinct::bytes_per_pair;
     crd_view vertx; ///< [input] target coordinates
     crd_view facex; ///< [input] source coordinates
     scalar_view_type facef; ///< [input] source vorticity
@@ -179,6 +194,9 @@ struct VertexSolve {
 */
 struct ReduceCollocated {
     typedef Real value_type; ///< required by kokkos for custom reducers
+    static constexpr Int flops_per_pair = 10; ///< work per pair (see PairWork)
+    static constexpr Int transcendentals_per_pair = 1;
+    static constexpr Int bytes_per_pair = 41;
     Index i; ///< index of target coordinate vector
     crd_view srcx; ///< collection of source coordinate vectors
     scalar_view_type srcf; ///< source vorticity values
@@ -193,8 +211,8 @@ struct ReduceCollocated {
     void operator() (const Index& j, value_type& pot) const {
         Real potential = 0;
         if (!mask(j) && i != j) {
-            auto mtgt = ko::subview(srcx, i, ko::ALL());
-            auto msrc = ko::subview(srcx, j, ko::ALL());
+            const auto mtgt = vec_at<3>(srcx, i);
+            const auto msrc = vec_at<3>(srcx, j);
             greensFn(potential, mtgt, msrc, srcf(j), srca(j));
         }
         pot += potential;
@@ -206,6 +224,9 @@ struct ReduceCollocated {
 */
 struct UReduceCollocated {
     typedef ko::Tuple<Real,3> value_type; ///< required by kokkos for custom reducers
+    static constexpr Int flops_per_pair = 23; ///< work per pair (see PairWork)
+    static constexpr Int transcendentals_per_pair = 0;
+    static constexpr Int bytes_per_pair = 41;
     Index i; ///< index of target coordinate vector
     crd_view srcx; ///< collection of source coordinates
     scalar_view_type srcf; ///< source vorticity
@@ -220,8 +241,8 @@ struct UReduceCollocated {
     void operator() (const Index& j, value_type& vel) const {
         ko::Tuple<Real,3> u;
         if (!mask(j) && i != j) {
-            auto mtgt = ko::subview(srcx, i, ko::ALL());
-            auto msrc = ko::subview(srcx, j, ko::ALL());
+            const auto mtgt = vec_at<3>(srcx, i);
+            const auto msrc = vec_at<3>(srcx, j);
             biotSavart(u, mtgt, msrc, srcf(j), srca(j));
         }
         vel += u;
@@ -238,6 +259,13 @@ struct UReduceCollocated {
 
 */
 struct FaceSolve {
+    /// work per pair: both reductions (see PairWork)
+    static constexpr Int flops_per_pair = ReduceCollocated::flops_per_pair +
+      UReduceCollocated::flops_per_pair;
+    static constexpr Int transcendentals_per_pair = ReduceCollocated::transcendentals_per_pair +
+      UReduceCollocated::transcendentals_per_pair;
+    static constexpr Int bytes_per_pair = ReduceCollocated::bytes_per_pair +
+      UReduceCollocated::bytes_per_pair;
     crd_view facex;
     scalar_view_type facef;
     scalar_view_type facea;
@@ -423,29 +451,41 @@ template <typename SeedType> class SpherePoisson : public PolyMesh2d<SeedType> {
 
         /** @brief Solves the Poisson equation
 
-
+            @param nthreads team size (0 = TeamPolicyTuner parameters)
+            @param symmetric if true, the collocated face sums evaluate each pair once (sphereCollocatedSymmetricSolve)
         */
-        void solve(const int& nthreads=0) {
-            /** Set parallel team policy
-
-            */
-            ko::TeamPolicy<> vertex_policy(this->nvertsHost(), ko::AUTO());
-            ko::TeamPolicy<> face_policy(this->nfacesHost(), ko::AUTO());
-            if (nthreads != 0) {
-              vertex_policy = ko::TeamPolicy<>(this->nvertsHost(), nthreads);
-              face_policy = ko::TeamPolicy<>(this->nfacesHost(), nthreads);
-            }
+        void solve(const int& nthreads=0, const bool symmetric=SYMMETRIC_PAIRS_DEFAULT) {
+            const Index nv = this->nvertsHost();
+            const Index nf = this->nfacesHost();
 
             ko::Profiling::pushRegion("poisson solve");
             ko::Profiling::pushRegion("vertex solve");
             /// parallel vertex solve (kernel launch)
-            ko::parallel_for(vertex_policy, VertexSolve(this->getVertCrds(), this->getFaceCrds(), ffaces,
-                this->getFaceArea(), this->getFacemask(), psiverts, uverts));
+            const VertexSolve vsolve(this->getVertCrds(), this->getFaceCrds(), ffaces,
+                this->getFaceArea(), this->getFacemask(), psiverts, uverts);
+            if (nthreads != 0) {
+              ko::parallel_for(ko::TeamPolicy<>(nv, nthreads), vsolve);
+            }
+            else {
+              tunedParallelFor("vertex solve", "SpherePoissonVertexSolve", nv, nf, vsolve);
+            }
             ko::Profiling::popRegion();
             /// parallel face solve (kernel launch)
             ko::Profiling::pushRegion("face solve");
-            ko::parallel_for(face_policy, FaceSolve(this->getFaceCrds(), ffaces, this->getFaceArea(),
-                this->getFacemask(), psifaces, ufaces));
+            if (symmetric) {
+              sphereCollocatedSymmetricSolve(psifaces, ufaces, this->getFaceCrds(), ffaces, this->getFaceArea(),
+                this->getFacemask(), nf);
+            }
+            else {
+              const FaceSolve fsolve(this->getFaceCrds(), ffaces, this->getFaceArea(), this->getFacemask(),
+                psifaces, ufaces);
+              if (nthreads != 0) {
+                ko::parallel_for(ko::TeamPolicy<>(nf, nthreads), fsolve);
+              }
+              else {
+                tunedParallelFor("face solve", "SpherePoissonFaceSolve", nf, nf, fsolve);
+              }
+            }
             ko::Profiling::popRegion();
             ko::Profiling::popRegion();
 
@@ -0,0 +1,164 @@
+#ifndef LPM_SYMMETRIC_PAIR_KERNELS_HPP
+#define LPM_SYMMETRIC_PAIR_KERNELS_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmKokkosUtil.hpp"
+#include "Kokkos_Core.hpp"
+#include <cmath>
+
+namespace Lpm {
+
+/** @brief Whether collocated direct sums use symmetric-pair evaluation by default.
+
+  Symmetric evaluation scatters to both particles of each pair with atomics, which is
+  cheap on host backends (thread-private tile accumulators keep contention low) but not on GPUs.
+*/
+#ifdef LPM_HAVE_CUDA
+static constexpr bool SYMMETRIC_PAIRS_DEFAULT = false;
+#else
+static constexpr bool SYMMETRIC_PAIRS_DEFAULT = true;
+#endif
+
+/// Number of particles per tile (in each direction) for symmetric-pair evaluation
+static constexpr Int SYMMETRIC_PAIR_TILE = 32;
+
+/** @brief Maps a linear index t to the tile (ib, jb), ib <= jb, of the upper triangle of an nb x nb
+  array of tiles, enumerated row by row.
+
+  @device
+*/
+KOKKOS_INLINE_FUNCTION
+void upper_triangle_tile(Index& ib, Index& jb, const Index& t, const Index& nb) {
+  const Real b = 2*Real(nb) + 1;
+  ib = Index(std::floor(0.5*(b - std::sqrt(b*b - 8*Real(t)))));
+  /// guard against roundoff in the square root
+  while (ib > 0 && ib*(2*nb - ib + 1)/2 > t) --ib;
+  while ((ib+1)*(2*nb - ib)/2 <= t) ++ib;
+  jb = ib + t - ib*(2*nb - ib + 1)/2;
+}
+
+/** @brief Collocated stream function and velocity on the unit sphere, each unordered pair evaluated once.
+
+  Computes, for each i,
+    \f$\psi_i = -\frac{1}{4\pi}\sum_{j\ne i} \log(1-x_i\cdot x_j) f_j A_j\f$ and
+    \f$u_i = -\frac{1}{4\pi}\sum_{j\ne i}\frac{x_i\times x_j}{1-x_i\cdot x_j} f_j A_j\f$,
+  the same sums as BVEFaceSolve and FaceSolve (SpherePoisson).
+  The log kernel is symmetric and the cross product antisymmetric in (i,j), so each pair's
+  transcendental evaluations are shared by both particles.
+
+  Outputs are accumulated with atomics and must be zeroed before launch; use sphereCollocatedSymmetricSolve.
+  Masked sources do not contribute, but masked targets are still evaluated, as in the team kernels.
+
+  @device
+  @par Parallel pattern:
+  1 thread per tile of SYMMETRIC_PAIR_TILE x SYMMETRIC_PAIR_TILE pairs (upper triangle only);
+  row sums are accumulated in registers and column sums in a thread-private buffer, then added
+  to the output with 1 atomic per particle per tile.
+*/
+struct SphereCollocatedSymmetricTile {
+  typedef typename SphereGeometry::crd_view_type crd_view;
+  typedef typename SphereGeometry::vec_view_type vec_view;
+  scalar_view_type psi;
+  vec_view u;
+  crd_view x;
+  scalar_view_type f;
+  scalar_view_type area;
+  mask_view_type mask;
+  Index n;
+  Index nblocks;
+  bool do_psi;
+
+  SphereCollocatedSymmetricTile(scalar_view_type& p, vec_view& uu, const crd_view& xx,
+    const scalar_view_type& ff, const scalar_view_type& a, const mask_view_type& m, const Index& nn,
+    const bool dp=true) : psi(p), u(uu), x(xx), f(ff), area(a), mask(m), n(nn),
+    nblocks((nn + SYMMETRIC_PAIR_TILE - 1)/SYMMETRIC_PAIR_TILE), do_psi(dp) {}
+
+  /// number of tiles in the upper triangle
+  Index ntiles() const {return nblocks*(nblocks+1)/2;}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& t) const {
+    Index ib, jb;
+    upper_triangle_tile(ib, jb, t, nblocks);
+    const Index i0 = ib*SYMMETRIC_PAIR_TILE;
+    const Index i1 = (i0 + SYMMETRIC_PAIR_TILE < n ? i0 + SYMMETRIC_PAIR_TILE : n);
+    const Index j0 = jb*SYMMETRIC_PAIR_TILE;
+    const Index j1 = (j0 + SYMMETRIC_PAIR_TILE < n ? j0 + SYMMETRIC_PAIR_TILE : n);
+
+    Real colpsi[SYMMETRIC_PAIR_TILE];
+    Real colu[SYMMETRIC_PAIR_TILE][3];
+    for (Int k=0; k<SYMMETRIC_PAIR_TILE; ++k) {
+      colpsi[k] = 0;
+      colu[k][0] = 0;
+      colu[k][1] = 0;
+      colu[k][2] = 0;
+    }
+
+    const Real scale = -1/(4*PI);
+    for (Index i=i0; i<i1; ++i) {
+      const auto xi = vec_at<3>(x, i);
+      const bool srci = !mask(i);
+      const Real wi = (srci ? scale*f(i)*area(i) : 0);
+      Real rowpsi = 0;
+      Real rowu[3] = {0, 0, 0};
+      for (Index j=(ib == jb ? i+1 : j0); j<j1; ++j) {
+        const bool srcj = !mask(j);
+        if (srci || srcj) {
+          const auto xj = vec_at<3>(x, j);
+          const Real wj = (srcj ? scale*f(j)*area(j) : 0);
+          const Real one_minus_dot = 1 - SphereGeometry::dot(xi, xj);
+          const auto c = SphereGeometry::cross(xi, xj);
+          const Real inv_d = 1/one_minus_dot;
+          if (do_psi) {
+            const Real logd = std::log(one_minus_dot);
+            rowpsi += wj*logd;
+            colpsi[j-j0] += wi*logd;
+          }
+          for (Short k=0; k<3; ++k) {
+            rowu[k] += wj*c[k]*inv_d;
+            colu[j-j0][k] -= wi*c[k]*inv_d;
+          }
+        }
+      }
+      if (do_psi) ko::atomic_add(&psi(i), rowpsi);
+      for (Short k=0; k<3; ++k) {
+        ko::atomic_add(&u(i,k), rowu[k]);
+      }
+    }
+    for (Index j=j0; j<j1; ++j) {
+      if (do_psi) ko::atomic_add(&psi(j), colpsi[j-j0]);
+      for (Short k=0; k<3; ++k) {
+        ko::atomic_add(&u(j,k), colu[j-j0][k]);
+      }
+    }
+  }
+};
+
+/** @brief Zeros the outputs and launches SphereCollocatedSymmetricTile.
+
+  @hostfn
+
+  @param psi output stream function (not computed if do_psi is false)
+  @param u output velocity
+  @param x particle coordinates (sources and targets)
+  @param f source strength (e.g., vorticity)
+  @param area source panel areas
+  @param mask excludes divided panels as sources
+  @param n number of particles
+*/
+inline void sphereCollocatedSymmetricSolve(scalar_view_type& psi,
+  typename SphereGeometry::vec_view_type& u, const typename SphereGeometry::crd_view_type& x,
+  const scalar_view_type& f, const scalar_view_type& area, const mask_view_type& mask, const Index n,
+  const bool do_psi=true) {
+  const std::pair<Index,Index> range(0, n);
+  if (do_psi) ko::deep_copy(ko::subview(psi, range), 0.0);
+  ko::deep_copy(ko::subview(u, range, ko::ALL()), 0.0);
+  const SphereCollocatedSymmetricTile tiles(psi, u, x, f, area, mask, n, do_psi);
+  ko::parallel_for("SphereCollocatedSymmetricSolve",
+    ko::RangePolicy<ko::Schedule<ko::Dynamic>>(0, tiles.ntiles()), tiles);
+}
+
+}
+#endif
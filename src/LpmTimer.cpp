@@ -1,5 +1,11 @@
 #include "LpmTimer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 namespace Lpm {
 
@@ -9,4 +15,111 @@ std::string Timer::infoString() const {
   return ss.str();
 }
 
+/// open regions of the calling thread: (path, start time)
+static std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>>& open_regions() {
+  static thread_local std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>> stack;
+  return stack;
+}
+
+bool TimerRegistry::PathLess::operator() (const std::string& a, const std::string& b) const {
+  return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+    [] (const char x, const char y) {return (x == '/' ? '\0' : x) < (y == '/' ? '\0' : y);});
+}
+
+TimerRegistry::TimerRegistry() : main_thread(std::this_thread::get_id()), fence_on(false),
+  report_at_finalize(true) {
+  ko::push_finalize_hook([] () {
+    const auto& reg = TimerRegistry::instance();
+    if (reg.report_at_finalize && !reg.regions.empty()) {
+      std::cout << reg.summaryString();
+    }
+  });
+}
+
+TimerRegistry& TimerRegistry::instance() {
+  static TimerRegistry reg;
+  return reg;
+}
+
+void TimerRegistry::start(const std::string& name) {
+  auto& stack = open_regions();
+  const std::string path = (stack.empty() ? name : stack.back().first + "/" + name);
+  if (onMainThread()) {
+    ko::Profiling::pushRegion(name);
+    if (fence_on) ko::fence();
+  }
+  stack.emplace_back(path, std::chrono::steady_clock::now());
+}
+
+void TimerRegistry::stop() {
+  auto& stack = open_regions();
+  LPM_THROW_IF(stack.empty(), "TimerRegistry::stop error: no open region.");
+  const bool main = onMainThread();
+  if (main && fence_on) ko::fence();
+  const auto t1 = std::chrono::steady_clock::now();
+  const Real elapsed = std::chrono::duration<Real>(t1 - stack.back().second).count();
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& r = regions[stack.back().first];
+    r.min = (r.count == 0 ? elapsed : std::min(r.min, elapsed));
+    r.max = (r.count == 0 ? elapsed : std::max(r.max, elapsed));
+    r.total += elapsed;
+    ++r.count;
+  }
+  stack.pop_back();
+  if (main) ko::Profiling::popRegion();
+}
+
+void TimerRegistry::addCount(const std::string& name, const Real val) {
+  std::lock_guard<std::mutex> lock(mtx);
+  counters[name] += val;
+}
+
+TimerRegistry::RegionStats TimerRegistry::stats(const std::string& path) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto it = regions.find(path);
+  return (it == regions.end() ? RegionStats() : it->second);
+}
+
+Real TimerRegistry::counter(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto it = counters.find(name);
+  return (it == counters.end() ? 0 : it->second);
+}
+
+void TimerRegistry::reset() {
+  std::lock_guard<std::mutex> lock(mtx);
+  regions.clear();
+  counters.clear();
+}
+
+std::string TimerRegistry::summaryString() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  std::ostringstream ss;
+  const Int nw = 48;
+  const Int fw = 13;
+  ss << "Lpm timers:\n";
+  ss << std::left << std::setw(nw) << "region" << std::right << std::setw(8) << "calls"
+     << std::setw(fw) << "total (s)" << std::setw(fw) << "mean (s)" << std::setw(fw) << "min (s)"
+     << std::setw(fw) << "max (s)" << "\n";
+  for (const auto& r : regions) {
+    /// indent by nesting depth; print only the last path component
+    const auto depth = std::count(r.first.begin(), r.first.end(), '/');
+    const auto pos = r.first.find_last_of('/');
+    const std::string label = std::string(2*depth, ' ') +
+      (pos == std::string::npos ? r.first : r.first.substr(pos+1));
+    ss << std::left << std::setw(nw) << label << std::right << std::setw(8) << r.second.count
+       << std::setw(fw) << r.second.total << std::setw(fw) << r.second.mean()
+       << std::setw(fw) << r.second.min << std::setw(fw) << r.second.max << "\n";
+  }
+  if (!counters.empty()) {
+    ss << std::left << std::setw(nw) << "counter" << std::right << std::setw(fw) << "value" << "\n";
+    for (const auto& c : counters) {
+      ss << std::left << std::setw(nw) << c.first << std::right << std::setw(fw) << c.second << "\n";
+    }
+  }
+  ss << "max resident memory: " << get_memusage() << " MB\n";
+  return ss.str();
+}
+
 }
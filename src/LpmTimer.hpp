@@ -3,7 +3,11 @@
 
 #include "LpmConfig.h"
 #include "LpmDefs.hpp"
+#include "Kokkos_Core.hpp"
 #include <mpi.h>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <string>
 
 namespace Lpm {
@@ -29,5 +33,111 @@ class Timer {
 
 };
 
+/** @brief Process-wide registry of hierarchical timing regions and counters.
+
+  Regions nest: a region started while another is open is recorded under the path "outer/inner".
+  Each thread keeps its own stack of open regions, so regions may be used from AsyncOutput threads.
+  Regions on the main thread (the thread that first calls instance(), normally the one that initialized
+  Kokkos) are also forwarded to Kokkos Tools (Kokkos::Profiling::pushRegion/popRegion); regions on other
+  threads record host clock times only.
+
+  Library code uses the LPM_TIMER_* and LPM_COUNTER_ADD macros, which compile to nothing unless
+  LPM_ENABLE_TIMERS is defined; the registry itself is always available.  When enabled, the summary
+  table is printed at Kokkos::finalize (see setReportAtFinalize).
+*/
+class TimerRegistry {
+  public:
+    /// statistics for one region path
+    struct RegionStats {
+      Int count;
+      Real total;
+      Real min;
+      Real max;
+
+      RegionStats() : count(0), total(0), min(0), max(0) {}
+
+      inline Real mean() const {return (count > 0 ? total/count : 0);}
+    };
+
+    static TimerRegistry& instance();
+
+    /// opens a region nested in the calling thread's current region
+    void start(const std::string& name);
+
+    /// closes the calling thread's innermost region
+    void stop();
+
+    /// adds val to a named counter
+    void addCount(const std::string& name, const Real val=1);
+
+    /** if true, Kokkos::fence is called before reading the clock at start and stop (default: false).
+
+      Only the main thread fences or forwards regions to Kokkos Tools; see onMainThread.
+    */
+    inline void setFence(const bool f) {fence_on = f;}
+    inline bool fence() const {return fence_on;}
+
+    /** true if called from the thread that constructed the registry (the thread that initialized Kokkos).
+
+      Regions opened on other threads (e.g., AsyncOutput) record host clock times only, without
+      Kokkos::fence or Kokkos::Profiling calls, which are not safe off the main thread.
+    */
+    inline bool onMainThread() const {return std::this_thread::get_id() == main_thread;}
+
+    /// if true, summaryString is printed to std::cout at Kokkos::finalize (default: true)
+    inline void setReportAtFinalize(const bool r) {report_at_finalize = r;}
+
+    /// statistics for a region path, e.g., "BVERK4::advance_timestep/stage 1"
+    RegionStats stats(const std::string& path) const;
+
+    /// value of a counter (0 if it has not been used)
+    Real counter(const std::string& name) const;
+
+    /// clears all regions and counters
+    void reset();
+
+    /// table of all regions (indented by depth) and counters
+    std::string summaryString() const;
+
+  protected:
+    TimerRegistry();
+
+    /// orders region paths so that each region is followed by its nested regions
+    struct PathLess {
+      bool operator() (const std::string& a, const std::string& b) const;
+    };
+
+    mutable std::mutex mtx;
+    std::map<std::string, RegionStats, PathLess> regions;
+    std::map<std::string, Real> counters;
+    std::thread::id main_thread;
+    bool fence_on;
+    bool report_at_finalize;
+};
+
+/// Times a region for the lifetime of the object
+class ScopedTimer {
+  public:
+    ScopedTimer(const std::string& name) {TimerRegistry::instance().start(name);}
+    ~ScopedTimer() {TimerRegistry::instance().stop();}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
 }
+
+#define LPM_TIMER_CONCAT_IMPL(a,b) a##b
+#define LPM_TIMER_CONCAT(a,b) LPM_TIMER_CONCAT_IMPL(a,b)
+#ifdef LPM_ENABLE_TIMERS
+#define LPM_TIMER_SCOPE(name) ::Lpm::ScopedTimer LPM_TIMER_CONCAT(lpm_scoped_timer_, __LINE__)(name)
+#define LPM_TIMER_START(name) ::Lpm::TimerRegistry::instance().start(name)
+#define LPM_TIMER_STOP() ::Lpm::TimerRegistry::instance().stop()
+#define LPM_COUNTER_ADD(name, val) ::Lpm::TimerRegistry::instance().addCount(name, val)
+#else
+#define LPM_TIMER_SCOPE(name)
+#define LPM_TIMER_START(name) ((void)0)
+#define LPM_TIMER_STOP() ((void)0)
+#define LPM_COUNTER_ADD(name, val) ((void)0)
+#endif
 #endif
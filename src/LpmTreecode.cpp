@@ -0,0 +1,463 @@
+#include "LpmTreecode.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmUtilities.hpp"
+#include "LpmTimer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+namespace Lpm {
+
+using namespace Octree;
+
+/** @brief Far-field contribution of a cell with total strength gamma and dipole moment d about center c.
+
+  First-order Taylor expansion of greensFn and biotSavart about the cell center.
+*/
+template <typename VecType> KOKKOS_INLINE_FUNCTION
+void cellContribution(Real& psi, ko::Tuple<Real,3>& u, const VecType& x, const VecType& c, const Real gamma,
+  const VecType& d) {
+  const Real denom = 1 - SphereGeometry::dot(x, c);
+  const Real xd = SphereGeometry::dot(x, d);
+  psi += (-gamma*std::log(denom) + xd/denom)/(4*PI);
+  const auto xc = SphereGeometry::cross(x, c);
+  const auto xdc = SphereGeometry::cross(x, d);
+  for (Short j=0; j<3; ++j) {
+    u[j] -= ((gamma*xc[j] + xdc[j])/denom + xc[j]*xd/(denom*denom))/(4*PI);
+  }
+}
+
+/// Direct contribution of one source (coordinates, strength) to psi and u
+template <typename VecType> KOKKOS_INLINE_FUNCTION
+void sourceContribution(Real& psi, ko::Tuple<Real,3>& u, const VecType& x, const VecType& y, const Real s) {
+  Real p;
+  ko::Tuple<Real,3> v;
+  greensFn(p, x, y, s, 1);
+  biotSavart(v, x, y, s, 1);
+  psi += p;
+  u += v;
+}
+
+/** @brief Traverses the local tree for each target.
+ @device
+ @par Parallel pattern:
+ 1 thread per target; each thread walks the tree with its own stack
+*/
+struct TreecodeLocalSum {
+  scalar_view_type psi; ///< [output] stream function at targets
+  DistributedTreecode::vec_view_type u; ///< [output] velocity at targets
+  DistributedTreecode::crd_view_type tgtx; ///< [input] target coordinates
+  ko::View<Index*,Dev> tgt_ids; ///< [input] global source index of each target, or -1
+  DistributedTreecode::source_view srcs; ///< [input] sources in tree order
+  DistributedTreecode::moment_view moments; ///< [input] node moments
+  ko::View<Index*[2]> pt_inds; ///< [input] first source and source count of each node
+  ko::View<Index*[8]> kids; ///< [input] children of each node (index within the next level)
+  ko::View<Index*> base_address; ///< [input] index of each level's first node
+  Int max_depth; ///< [input] tree depth
+  Real theta; ///< [input] MAC parameter
+
+  TreecodeLocalSum(scalar_view_type& p, DistributedTreecode::vec_view_type& v,
+    const DistributedTreecode::crd_view_type& x, const ko::View<Index*,Dev>& ids,
+    const DistributedTreecode::source_view& s, const DistributedTreecode::moment_view& m, const Tree& tree,
+    const Real th) : psi(p), u(v), tgtx(x), tgt_ids(ids), srcs(s), moments(m), pt_inds(tree.node_pt_inds),
+    kids(tree.node_kids), base_address(tree.base_address), max_depth(tree.max_depth), theta(th) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& i) const {
+    const auto x = vec_at<3>(tgtx, i);
+    const Index myid = tgt_ids(i);
+    Real p = 0;
+    ko::Tuple<Real,3> vel;
+    Index stack_node[8*MAX_OCTREE_DEPTH+1];
+    Int stack_level[8*MAX_OCTREE_DEPTH+1];
+    Int top = 0;
+    stack_node[top] = 0;
+    stack_level[top++] = 0;
+    while (top > 0) {
+      --top;
+      const Index n = stack_node[top];
+      const Int lev = stack_level[top];
+      const Index npts = pt_inds(n,1);
+      if (npts == 0) continue;
+      const ko::Tuple<Real,3> c(moments(n,0), moments(n,1), moments(n,2));
+      Real dist = 0;
+      for (Short j=0; j<3; ++j) {
+        dist += square(x[j] - c[j]);
+      }
+      if (moments(n,7) < theta*std::sqrt(dist)) {
+        const ko::Tuple<Real,3> d(moments(n,4), moments(n,5), moments(n,6));
+        cellContribution(p, vel, x, c, moments(n,3), d);
+      }
+      else if (lev == max_depth) {
+        for (Index k=pt_inds(n,0); k<pt_inds(n,0)+npts; ++k) {
+          if (Index(srcs(k,4)) != myid) {
+            const ko::Tuple<Real,3> y(srcs(k,0), srcs(k,1), srcs(k,2));
+            sourceContribution(p, vel, x, y, srcs(k,3));
+          }
+        }
+      }
+      else {
+        for (Short j=0; j<8; ++j) {
+          const Index kid = kids(n,j);
+          if (kid != NULL_IND) {
+            stack_node[top] = base_address(lev+1) + kid;
+            stack_level[top++] = lev+1;
+          }
+        }
+      }
+    }
+    psi(i) = p;
+    for (Short j=0; j<3; ++j) {
+      u(i,j) = vel[j];
+    }
+  }
+};
+
+/** @brief Adds the contributions of LET cells and sources received from other ranks.
+ @device
+ @par Parallel pattern:
+ 1 thread team per target performs one reduction over cells and sources
+*/
+struct TreecodeRemoteSum {
+  scalar_view_type psi; ///< [in/out] stream function at targets
+  DistributedTreecode::vec_view_type u; ///< [in/out] velocity at targets
+  DistributedTreecode::crd_view_type tgtx; ///< [input] target coordinates
+  ko::View<Index*,Dev> tgt_ids; ///< [input] global source index of each target, or -1
+  ko::View<Real*[DistributedTreecode::ncell_reals], ko::LayoutRight, Dev> cells; ///< [input] LET cells
+  DistributedTreecode::source_view srcs; ///< [input] LET sources
+
+  TreecodeRemoteSum(scalar_view_type& p, DistributedTreecode::vec_view_type& v,
+    const DistributedTreecode::crd_view_type& x, const ko::View<Index*,Dev>& ids,
+    const ko::View<Real*[DistributedTreecode::ncell_reals], ko::LayoutRight, Dev>& c,
+    const DistributedTreecode::source_view& s) : psi(p), u(v), tgtx(x), tgt_ids(ids), cells(c), srcs(s) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const member_type& mbr) const {
+    const Index i = mbr.league_rank();
+    const auto x = vec_at<3>(tgtx, i);
+    const Index myid = tgt_ids(i);
+    const Index ncells = cells.extent(0);
+    const Index nsrcs = srcs.extent(0);
+    Real p = 0;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, ncells + nsrcs), [=] (const Index& k, Real& pot) {
+      ko::Tuple<Real,3> v;
+      if (k < ncells) {
+        const ko::Tuple<Real,3> c(cells(k,0), cells(k,1), cells(k,2));
+        const ko::Tuple<Real,3> d(cells(k,4), cells(k,5), cells(k,6));
+        cellContribution(pot, v, x, c, cells(k,3), d);
+      }
+      else if (Index(srcs(k-ncells,4)) != myid) {
+        const ko::Tuple<Real,3> y(srcs(k-ncells,0), srcs(k-ncells,1), srcs(k-ncells,2));
+        sourceContribution(pot, v, x, y, srcs(k-ncells,3));
+      }
+    }, p);
+    ko::Tuple<Real,3> vel;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, ncells + nsrcs), [=] (const Index& k, ko::Tuple<Real,3>& uk) {
+      Real pot = 0;
+      if (k < ncells) {
+        const ko::Tuple<Real,3> c(cells(k,0), cells(k,1), cells(k,2));
+        const ko::Tuple<Real,3> d(cells(k,4), cells(k,5), cells(k,6));
+        cellContribution(pot, uk, x, c, cells(k,3), d);
+      }
+      else if (Index(srcs(k-ncells,4)) != myid) {
+        const ko::Tuple<Real,3> y(srcs(k-ncells,0), srcs(k-ncells,1), srcs(k-ncells,2));
+        sourceContribution(pot, uk, x, y, srcs(k-ncells,3));
+      }
+    }, vel);
+    ko::single(ko::PerTeam(mbr), [=] () {
+      psi(i) += p;
+      for (Short j=0; j<3; ++j) {
+        u(i,j) += vel[j];
+      }
+    });
+  }
+};
+
+DistributedTreecode::DistributedTreecode(MPI_Comm c, const Real th, const Int depth) : comm(c),
+  mac_theta(th), max_depth(depth), nsrc_local(0), nlet_cells(0), nlet_sources(0) {
+  LPM_THROW_IF(depth < 1 || depth > MAX_OCTREE_DEPTH, "DistributedTreecode error: invalid tree depth.");
+  LPM_THROW_IF(th < 0 || th >= 1, "DistributedTreecode error: theta must be in [0,1).");
+  MPI_Comm_rank(comm, &comm_rank);
+  MPI_Comm_size(comm, &comm_size);
+}
+
+void DistributedTreecode::setSources(const crd_view_type& srcx, const scalar_view_type& vort,
+  const scalar_view_type& area, const ko::View<Index*,Dev>& src_inds) {
+  LPM_TIMER_SCOPE("DistributedTreecode::setSources");
+  nsrc_local = src_inds.extent(0);
+  tree.reset();
+  if (nsrc_local == 0) return;
+
+  ko::View<Real*[3]> pts("treecode_pts", nsrc_local);
+  scalar_view_type strength("treecode_strength", nsrc_local);
+  ko::parallel_for(nsrc_local, KOKKOS_LAMBDA (const Index& i) {
+    const Index k = src_inds(i);
+    for (Short j=0; j<3; ++j) {
+      pts(i,j) = srcx(k,j);
+    }
+    strength(i) = vort(k)*area(k);
+  });
+  tree = std::unique_ptr<Tree>(new Tree(pts, max_depth));
+
+  sorted_sources = source_view("treecode_sources", nsrc_local);
+  const auto sorted = sorted_sources;
+  const auto sorted_pts = tree->sorted_pts;
+  const auto orig_id = tree->pt_orig_id;
+  ko::parallel_for(nsrc_local, KOKKOS_LAMBDA (const Index& i) {
+    for (Short j=0; j<3; ++j) {
+      sorted(i,j) = sorted_pts(i,j);
+    }
+    sorted(i,3) = strength(orig_id(i));
+    sorted(i,4) = src_inds(orig_id(i));
+  });
+  computeMoments();
+
+  sorted_sources_host = ko::create_mirror_view(sorted_sources);
+  ko::deep_copy(sorted_sources_host, sorted_sources);
+  moments_host = ko::create_mirror_view(moments);
+  ko::deep_copy(moments_host, moments);
+  node_pt_inds_host = ko::create_mirror_view(tree->node_pt_inds);
+  ko::deep_copy(node_pt_inds_host, tree->node_pt_inds);
+  node_kids_host = ko::create_mirror_view(tree->node_kids);
+  ko::deep_copy(node_kids_host, tree->node_kids);
+}
+
+void DistributedTreecode::computeMoments() {
+  moments = moment_view("treecode_moments", tree->nnodes_total);
+  const auto mom = moments;
+  const auto srcs = sorted_sources;
+  const auto pt_inds = tree->node_pt_inds;
+  ko::parallel_for(tree->nnodes_total, KOKKOS_LAMBDA (const Index& n) {
+    for (Short j=0; j<8; ++j) {
+      mom(n,j) = 0;
+    }
+    const Index start = pt_inds(n,0);
+    const Index npts = pt_inds(n,1);
+    if (npts == 0) return;
+    /// center: weighted by |strength|, or the mean if all strengths are zero
+    Real wsum = 0;
+    Real c[3] = {0, 0, 0};
+    Real mean[3] = {0, 0, 0};
+    for (Index k=start; k<start+npts; ++k) {
+      const Real w = std::abs(srcs(k,3));
+      wsum += w;
+      for (Short j=0; j<3; ++j) {
+        c[j] += w*srcs(k,j);
+        mean[j] += srcs(k,j);
+      }
+    }
+    for (Short j=0; j<3; ++j) {
+      c[j] = (wsum > 0 ? c[j]/wsum : mean[j]/npts);
+      mom(n,j) = c[j];
+    }
+    Real r2 = 0;
+    for (Index k=start; k<start+npts; ++k) {
+      Real d2 = 0;
+      mom(n,3) += srcs(k,3);
+      for (Short j=0; j<3; ++j) {
+        const Real dy = srcs(k,j) - c[j];
+        mom(n,4+j) += srcs(k,3)*dy;
+        d2 += dy*dy;
+      }
+      r2 = (d2 > r2 ? d2 : r2);
+    }
+    mom(n,7) = std::sqrt(r2);
+  });
+}
+
+/// distance from a point to a box (0 inside the box)
+static Real box_distance(const Real* c, const BBox& box) {
+  const Real lo[3] = {box.xmin, box.ymin, box.zmin};
+  const Real hi[3] = {box.xmax, box.ymax, box.zmax};
+  Real d2 = 0;
+  for (Short j=0; j<3; ++j) {
+    const Real dj = std::max(Real(0), std::max(lo[j] - c[j], c[j] - hi[j]));
+    d2 += dj*dj;
+  }
+  return std::sqrt(d2);
+}
+
+void DistributedTreecode::buildLet(std::vector<Real>& cells, std::vector<Real>& sources,
+  const BBox& tgt_box) const {
+  std::vector<std::pair<Index,Int>> stack(1, std::make_pair(Index(0), Int(0)));
+  while (!stack.empty()) {
+    const Index n = stack.back().first;
+    const Int lev = stack.back().second;
+    stack.pop_back();
+    const Index npts = node_pt_inds_host(n,1);
+    if (npts == 0) continue;
+    const Real c[3] = {moments_host(n,0), moments_host(n,1), moments_host(n,2)};
+    if (moments_host(n,7) < mac_theta*box_distance(c, tgt_box)) {
+      for (Short j=0; j<ncell_reals; ++j) {
+        cells.push_back(moments_host(n,j));
+      }
+    }
+    else if (lev == max_depth) {
+      for (Index k=node_pt_inds_host(n,0); k<node_pt_inds_host(n,0)+npts; ++k) {
+        for (Short j=0; j<nsource_reals; ++j) {
+          sources.push_back(sorted_sources_host(k,j));
+        }
+      }
+    }
+    else {
+      for (Short j=0; j<8; ++j) {
+        const Index kid = node_kids_host(n,j);
+        if (kid != NULL_IND) {
+          stack.push_back(std::make_pair(tree->base_address_host(lev+1) + kid, lev+1));
+        }
+      }
+    }
+  }
+}
+
+void DistributedTreecode::compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx,
+  const ko::View<Index*,Dev>& tgt_ids) {
+  LPM_TIMER_SCOPE("DistributedTreecode::compute");
+  const Index ntgt = tgtx.extent(0);
+
+  /// target boxes of all ranks
+  BBox my_box;
+  ko::parallel_reduce(ntgt, KOKKOS_LAMBDA (const Index& i, BBox& bb) {
+    bb.xmin = (tgtx(i,0) < bb.xmin ? tgtx(i,0) : bb.xmin);
+    bb.xmax = (tgtx(i,0) > bb.xmax ? tgtx(i,0) : bb.xmax);
+    bb.ymin = (tgtx(i,1) < bb.ymin ? tgtx(i,1) : bb.ymin);
+    bb.ymax = (tgtx(i,1) > bb.ymax ? tgtx(i,1) : bb.ymax);
+    bb.zmin = (tgtx(i,2) < bb.zmin ? tgtx(i,2) : bb.zmin);
+    bb.zmax = (tgtx(i,2) > bb.zmax ? tgtx(i,2) : bb.zmax);
+  }, BBoxReducer<HostMem>(my_box));
+  const Real my_box_reals[6] = {my_box.xmin, my_box.xmax, my_box.ymin, my_box.ymax, my_box.zmin, my_box.zmax};
+  std::vector<Real> boxes(6*comm_size);
+  MPI_Allgather(my_box_reals, 6, mpi_real_type(), boxes.data(), 6, mpi_real_type(), comm);
+
+  /// locally essential trees for the other ranks
+  std::vector<Real> send_cells, send_sources;
+  std::vector<Int> cell_counts(comm_size, 0), cell_displs(comm_size, 0);
+  std::vector<Int> source_counts(comm_size, 0), source_displs(comm_size, 0);
+  {
+    LPM_TIMER_SCOPE("build LETs");
+    for (Int r=0; r<comm_size; ++r) {
+      cell_displs[r] = send_cells.size();
+      source_displs[r] = send_sources.size();
+      const Real* b = &boxes[6*r];
+      if (r != comm_rank && tree && b[0] <= b[1]) {
+        buildLet(send_cells, send_sources, BBox(b[0], b[1], b[2], b[3], b[4], b[5]));
+      }
+      cell_counts[r] = send_cells.size() - cell_displs[r];
+      source_counts[r] = send_sources.size() - source_displs[r];
+    }
+  }
+  std::vector<Int> send_counts(2*comm_size), recv_counts(2*comm_size);
+  for (Int r=0; r<comm_size; ++r) {
+    send_counts[2*r] = cell_counts[r];
+    send_counts[2*r+1] = source_counts[r];
+  }
+  MPI_Alltoall(send_counts.data(), 2, MPI_INT, recv_counts.data(), 2, MPI_INT, comm);
+  std::vector<Int> rcell_counts(comm_size), rcell_displs(comm_size);
+  std::vector<Int> rsource_counts(comm_size), rsource_displs(comm_size);
+  Int nrcell = 0;
+  Int nrsource = 0;
+  for (Int r=0; r<comm_size; ++r) {
+    rcell_counts[r] = recv_counts[2*r];
+    rcell_displs[r] = nrcell;
+    nrcell += rcell_counts[r];
+    rsource_counts[r] = recv_counts[2*r+1];
+    rsource_displs[r] = nrsource;
+    nrsource += rsource_counts[r];
+  }
+  nlet_cells = nrcell/ncell_reals;
+  nlet_sources = nrsource/nsource_reals;
+  typedef ko::View<Real*[ncell_reals], ko::LayoutRight, Dev> cell_view;
+  cell_view::HostMirror recv_cells("treecode_let_cells", nlet_cells);
+  source_view::HostMirror recv_sources("treecode_let_sources", nlet_sources);
+  MPI_Request reqs[2];
+  MPI_Ialltoallv(send_cells.data(), cell_counts.data(), cell_displs.data(), mpi_real_type(),
+    recv_cells.data(), rcell_counts.data(), rcell_displs.data(), mpi_real_type(), comm, &reqs[0]);
+  MPI_Ialltoallv(send_sources.data(), source_counts.data(), source_displs.data(), mpi_real_type(),
+    recv_sources.data(), rsource_counts.data(), rsource_displs.data(), mpi_real_type(), comm, &reqs[1]);
+
+  /// local tree traversal overlaps the LET exchange
+  if (tree) {
+    ko::parallel_for(ntgt, TreecodeLocalSum(psi, u, tgtx, tgt_ids, sorted_sources, moments, *tree, mac_theta));
+  }
+  else {
+    ko::deep_copy(psi, 0);
+    ko::deep_copy(u, 0);
+  }
+  ko::fence();
+  MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);
+
+  if (nlet_cells + nlet_sources > 0) {
+    cell_view cells("treecode_let_cells", nlet_cells);
+    source_view sources("treecode_let_sources", nlet_sources);
+    ko::deep_copy(cells, recv_cells);
+    ko::deep_copy(sources, recv_sources);
+    ko::parallel_for(ko::TeamPolicy<>(ntgt, ko::AUTO()),
+      TreecodeRemoteSum(psi, u, tgtx, tgt_ids, cells, sources));
+  }
+}
+
+template <typename SeedType>
+void DistributedTreecode::solve(scalar_view_type& vert_psi, vec_view_type& vert_u, scalar_view_type& face_psi,
+  vec_view_type& face_u, const PolyMesh2d<SeedType>& mesh, const scalar_view_type& face_vort,
+  const MortonDecomposition& decomp) {
+  const auto owned_verts = decomp.ownedVerts();
+  const auto owned_faces = decomp.ownedFaces();
+  setSources(mesh.physFaces.crds, face_vort, mesh.faces.area, owned_faces);
+
+  /// one target set: owned vertices, then owned faces
+  const Index nov = owned_verts.extent(0);
+  const Index nof = owned_faces.extent(0);
+  crd_view_type tgtx("treecode_tgts", nov + nof);
+  ko::View<Index*,Dev> tgt_ids("treecode_tgt_ids", nov + nof);
+  const auto vx = mesh.physVerts.crds;
+  const auto fx = mesh.physFaces.crds;
+  ko::parallel_for(nov + nof, KOKKOS_LAMBDA (const Index& i) {
+    const bool is_vert = (i < nov);
+    const Index k = (is_vert ? owned_verts(i) : owned_faces(i-nov));
+    for (Short j=0; j<3; ++j) {
+      tgtx(i,j) = (is_vert ? vx(k,j) : fx(k,j));
+    }
+    tgt_ids(i) = (is_vert ? NULL_IND : k);
+  });
+
+  scalar_view_type psi("treecode_psi", nov + nof);
+  vec_view_type u("treecode_u", nov + nof);
+  compute(psi, u, tgtx, tgt_ids);
+
+  ko::parallel_for(nov + nof, KOKKOS_LAMBDA (const Index& i) {
+    if (i < nov) {
+      const Index k = owned_verts(i);
+      vert_psi(k) = psi(i);
+      for (Short j=0; j<3; ++j) {
+        vert_u(k,j) = u(i,j);
+      }
+    }
+    else {
+      const Index k = owned_faces(i-nov);
+      face_psi(k) = psi(i);
+      for (Short j=0; j<3; ++j) {
+        face_u(k,j) = u(i,j);
+      }
+    }
+  });
+}
+
+std::string DistributedTreecode::infoString() const {
+  std::ostringstream ss;
+  ss << "DistributedTreecode info: rank " << comm_rank << " of " << comm_size << ", theta = " << mac_theta
+     << ", depth " << max_depth << ", " << nsrc_local << " local sources, "
+     << (tree ? tree->nnodes_total : 0) << " tree nodes; last LET received " << nlet_cells << " cells, "
+     << nlet_sources << " sources\n";
+  return ss.str();
+}
+
+/// ETI
+template void DistributedTreecode::solve(scalar_view_type& vert_psi, vec_view_type& vert_u,
+  scalar_view_type& face_psi, vec_view_type& face_u, const PolyMesh2d<IcosTriSphereSeed>& mesh,
+  const scalar_view_type& face_vort, const MortonDecomposition& decomp);
+template void DistributedTreecode::solve(scalar_view_type& vert_psi, vec_view_type& vert_u,
+  scalar_view_type& face_psi, vec_view_type& face_u, const PolyMesh2d<CubedSphereSeed>& mesh,
+  const scalar_view_type& face_vort, const MortonDecomposition& decomp);
+
+}
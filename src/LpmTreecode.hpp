@@ -0,0 +1,120 @@
+#ifndef LPM_TREECODE_HPP
+#define LPM_TREECODE_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmDecomposition.hpp"
+#include "LpmOctree.hpp"
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Lpm {
+
+/** @brief MPI-parallel treecode for the sphere's stream function and Biot-Savart velocity.
+
+  Approximates the sums computed by RingDirectSum (and BVEVertexSolve/BVEFaceSolve),
+    psi(x) = -sum_j log(1 - x.y_j) s_j / (4 pi),   u(x) = -sum_j (x cross y_j) s_j / (4 pi (1 - x.y_j)),
+  with s_j = zeta_j A_j.
+
+  Each rank builds an Octree::Tree over its own sources and computes, for every node, the total strength,
+  a center c, the dipole moment sum_j s_j (y_j - c), and the radius of the node's sources about c.  A node is
+  used in place of its sources if radius < theta * |x - c| (the multipole acceptance criterion, MAC);
+  otherwise its children are visited, and sources of leaves are summed directly.
+
+  Remote contributions use locally essential trees (LETs): ranks exchange the bounding boxes of their
+  targets, and each rank sends every other rank the smallest set of its nodes that satisfy the MAC for that
+  rank's whole target box, plus the sources of leaves that do not.  LETs are exchanged with non-blocking
+  MPI_Ialltoallv while the local tree is traversed.
+
+  theta = 0 reproduces the direct sum.
+*/
+class DistributedTreecode {
+  public:
+    typedef typename SphereGeometry::crd_view_type crd_view_type;
+    typedef typename SphereGeometry::vec_view_type vec_view_type;
+    /// node moments: center (3), total strength, dipole (3), radius
+    typedef ko::View<Real*[8],Dev> moment_view;
+    /// sources: coordinates (3), strength, global index
+    typedef ko::View<Real*[5], ko::LayoutRight, Dev> source_view;
+
+    static constexpr Int ncell_reals = 7;
+    static constexpr Int nsource_reals = 5;
+
+    /**
+      @param c communicator
+      @param mac_theta multipole acceptance parameter
+      @param depth maximum depth of each rank's octree
+    */
+    DistributedTreecode(MPI_Comm c=MPI_COMM_WORLD, const Real mac_theta=0.5, const Int depth=6);
+
+    /** @brief Builds this rank's tree over its sources.
+
+      @param srcx source coordinates (all rows)
+      @param vort source vorticity
+      @param area source areas
+      @param src_inds rows of srcx owned by this rank; these are also the sources' global indices
+    */
+    void setSources(const crd_view_type& srcx, const scalar_view_type& vort, const scalar_view_type& area,
+      const ko::View<Index*,Dev>& src_inds);
+
+    /** @brief Computes psi and u at this rank's targets.  Collective.
+
+      @param [out] psi stream function at targets
+      @param [out] u velocity at targets
+      @param [in] tgtx target coordinates
+      @param [in] tgt_ids global source index of each target (excluded from its own sum), or -1
+    */
+    void compute(scalar_view_type& psi, vec_view_type& u, const crd_view_type& tgtx,
+      const ko::View<Index*,Dev>& tgt_ids);
+
+    /** @brief Solves at the vertices and faces owned by this rank, with sources at its owned leaf faces.
+
+      Results are written to the owned rows of full-size arrays; other rows are unchanged.
+    */
+    template <typename SeedType>
+    void solve(scalar_view_type& vert_psi, vec_view_type& vert_u, scalar_view_type& face_psi,
+      vec_view_type& face_u, const PolyMesh2d<SeedType>& mesh, const scalar_view_type& face_vort,
+      const MortonDecomposition& decomp);
+
+    inline Real theta() const {return mac_theta;}
+
+    /// number of cells and sources this rank received in its most recent LET exchange
+    inline Index nLetCells() const {return nlet_cells;}
+    inline Index nLetSources() const {return nlet_sources;}
+
+    std::string infoString() const;
+
+  protected:
+    /// computes node moments of the local tree
+    void computeMoments();
+
+    /// appends the LET of the local tree for a target box to cells and sources (host)
+    void buildLet(std::vector<Real>& cells, std::vector<Real>& sources, const Octree::BBox& tgt_box) const;
+
+    MPI_Comm comm;
+    Int comm_rank;
+    Int comm_size;
+    Real mac_theta;
+    Int max_depth;
+
+    Index nsrc_local;
+    std::unique_ptr<Octree::Tree> tree;
+    source_view sorted_sources; ///< sources in tree order
+    moment_view moments;
+
+    typename source_view::HostMirror sorted_sources_host;
+    typename moment_view::HostMirror moments_host;
+    typename ko::View<Index*[2]>::HostMirror node_pt_inds_host;
+    typename ko::View<Index*[8]>::HostMirror node_kids_host;
+
+    Index nlet_cells;
+    Index nlet_sources;
+};
+
+}
+#endif
@@ -1,4 +1,5 @@
 #include "LpmUtilities.hpp"
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -55,6 +56,13 @@ std::string format_strings_as_list(const char** strings, const Short n) {
   return ss.str();
 }
 
+void blockRange(Index& offset, Index& nlocal, const Index nglobal, const Int rank, const Int nranks) {
+  const Index nbase = nglobal / nranks;
+  const Index nextra = nglobal % nranks;
+  nlocal = nbase + (rank < nextra ? 1 : 0);
+  offset = rank*nbase + std::min(Index(rank), nextra);
+}
+
 ProgressBar::ProgressBar(const std::string& name, const Int niterations,
   const Real write_freq, std::ostream& os) :
   name_(name), niter_(niterations), freq_(write_freq), it_(0), next_(0), os_(os) {
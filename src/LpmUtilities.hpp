@@ -4,6 +4,8 @@
 #include "LpmConfig.h"
 #include "LpmDefs.hpp"
 #include <string>
+#include <type_traits>
+#include <mpi.h>
 
 #include "Kokkos_Core.hpp"
 #include <cmath>
@@ -96,6 +98,17 @@ std::string& tolower(std::string& s);
 
 std::string format_strings_as_list(const char** strings, const Short n);
 
+/** @brief Block partition of nglobal rows over nranks ranks.
+
+  Rank r owns rows [offset, offset + nlocal); the first nglobal % nranks ranks own one extra row.
+*/
+void blockRange(Index& offset, Index& nlocal, const Index nglobal, const Int rank, const Int nranks);
+
+/// MPI datatype matching Real
+inline MPI_Datatype mpi_real_type() {
+  return (std::is_same<Real,double>::value ? MPI_DOUBLE : MPI_FLOAT);
+}
+
 class ProgressBar {
   std::string name_;
   Int niter_;
@@ -2,33 +2,88 @@
 #include "vtkDoubleArray.h"
 #include "vtkIntArray.h"
 #include "vtkPoints.h"
+#include <algorithm>
+#include <utility>
 
 
 namespace Lpm {
 
+/// host thread settings for vtk array preparation: (max threads, min items per thread)
+static std::pair<Int,Index>& vtk_host_threads() {
+  static std::pair<Int,Index> settings(
+    std::max(1, std::min(vtk_default_host_threads, Int(std::thread::hardware_concurrency()))), 16384);
+  return settings;
+}
+
+Int vtkHostThreads() {return vtk_host_threads().first;}
+
+void setVtkHostThreads(const Int nthreads, const Index min_block) {
+  LPM_THROW_IF(nthreads < 1 || min_block < 1, "setVtkHostThreads error: invalid settings.");
+  vtk_host_threads() = std::make_pair(nthreads, min_block);
+}
+
+Int vtkHostBlockCount(const Index n) {
+  const auto& settings = vtk_host_threads();
+  return std::max(1, std::min(settings.first, Int(n/settings.second)));
+}
+
+void setVtkXmlEncoding(vtkXMLPolyDataWriter* writer, const VtkXmlEncoding& enc) {
+  switch (enc) {
+    case (VtkXmlAscii) : {
+      writer->SetDataModeToAscii();
+      break;
+    }
+    case (VtkXmlAppendedRaw) : {
+      writer->SetDataModeToAppended();
+      writer->EncodeAppendedDataOff();
+      writer->SetCompressorTypeToNone();
+      writer->SetHeaderTypeToUInt64();
+      break;
+    }
+    case (VtkXmlAppendedZlib) : {
+      writer->SetDataModeToAppended();
+      writer->EncodeAppendedDataOff();
+      writer->SetCompressorTypeToZLib();
+      writer->SetHeaderTypeToUInt64();
+      break;
+    }
+    default : {
+      break;
+    }
+  }
+}
+
+void writeVtpFile(const std::string& fname, const vtkSmartPointer<vtkPolyData> pd,
+  const VtkXmlEncoding& enc) {
+  auto writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+  setVtkXmlEncoding(writer, enc);
+  writer->SetInputData(pd);
+  writer->SetFileName(fname.c_str());
+  writer->Write();
+}
+
 template <typename Geo, typename FacesType>
 vtkSmartPointer<vtkPolyData> VtkInterface<Geo, FacesType>::toVtkPolyData(const FacesType& faces, const Edges& edges,
     const Coords<Geo>& faceCrds, const Coords<Geo>& vertCrds, const vtkSmartPointer<vtkPointData>& ptdata,
             const vtkSmartPointer<vtkCellData>& cdata) const {
     auto result = vtkSmartPointer<vtkPolyData>::New();
-    vtkSmartPointer<vtkPoints> pts = vtkSmartPointer<vtkPoints>::New();
-    Real crdvec[Geo::ndim];
-    for (Index i=0; i<vertCrds.nh(); ++i) {
-        for (int j=0; j<Geo::ndim; ++j) {
-            crdvec[j] = vertCrds.getCrdComponentHost(i,j);
+    const Index nv = vertCrds.nh();
+    auto ptarr = vtkSmartPointer<vtkDoubleArray>::New();
+    ptarr->SetNumberOfComponents(3);
+    ptarr->SetNumberOfTuples(nv);
+    Real* ptr = ptarr->GetPointer(0);
+    vtkHostBlocks(nv, vtkHostBlockCount(nv), [&](const Index begin, const Index end, const Int b) {
+      for (Index i=begin; i<end; ++i) {
+        for (int j=0; j<3; ++j) {
+          ptr[3*vtkIdType(i)+j] = (j < Geo::ndim ? vertCrds.getCrdComponentHost(i,j) : 0.0);
         }
-        pts->InsertNextPoint(crdvec[0], crdvec[1], (Geo::ndim == 3 ? crdvec[2] : 0.0));
-    }
+      }
+    });
+    vtkSmartPointer<vtkPoints> pts = vtkSmartPointer<vtkPoints>::New();
+    pts->SetData(ptarr);
 //     std::cout << "vtk points done." << std::endl;
-    vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
-    for (Index i=0; i<faces.nh(); ++i) {
-        if (!faces.hasKidsHost(i)) {
-            polys->InsertNextCell(FacesType::nverts);
-            for (int j=0; j<FacesType::nverts; ++j) {
-                polys->InsertCellPoint(faces.getVertHost(i,j));
-            }
-        }
-    }
+    const VtkLeafCells leaves(faces);
+    vtkSmartPointer<vtkCellArray> polys = leaves.cells;
 //     std::cout << "vtk polys done." << std::endl;
     result->SetPoints(pts);
     result->SetPolys(polys);
@@ -176,7 +231,7 @@ void VtkInterface<Geo,FacesType>::addScalarToPointData(vtkSmartPointer<vtkPointD
 
 template <typename Geo, typename FacesType>
 void VtkInterface<Geo,FacesType>::addVectorToPointData(vtkSmartPointer<vtkPointData>& pd,
-    const typename ko::View<Real*[Geo::ndim],Dev>::HostMirror vf, const std::string& name, const Index nverts) const {
+    const typename Geo::vec_view_type::HostMirror vf, const std::string& name, const Index nverts) const {
     auto data = vtkSmartPointer<vtkDoubleArray>::New();
     data->SetName(name.c_str());
     data->SetNumberOfComponents(Geo::ndim);
@@ -216,7 +271,7 @@ void VtkInterface<Geo,FacesType>::addScalarToCellData(vtkSmartPointer<vtkCellDat
 
 template <typename Geo, typename FacesType>
 void VtkInterface<Geo,FacesType>::addVectorToCellData(vtkSmartPointer<vtkCellData>& cd,
-    const typename ko::View<Real*[Geo::ndim],Dev>::HostMirror vf, const std::string& name, const FacesType& faces) const {
+    const typename Geo::vec_view_type::HostMirror vf, const std::string& name, const FacesType& faces) const {
     auto data = vtkSmartPointer<vtkDoubleArray>::New();
     data->SetName(name.c_str());
     data->SetNumberOfComponents(Geo::ndim);
@@ -14,16 +14,185 @@
 #include "LpmSphereVoronoiPrimitives.hpp"
 #include "LpmSphereVoronoiMesh.hpp"
 
+#include <exception>
 #include <vector>
+#include <thread>
 
 #include "vtkSmartPointer.h"
+#include "vtkVersion.h"
+#include "vtkCellArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkPolyData.h"
 #include "vtkPolyDataWriter.h"
+#include "vtkXMLPolyDataWriter.h"
 #include "vtkPointData.h"
 #include "vtkCellData.h"
 
 namespace Lpm {
 
+/** @brief Data encoding for XML polydata (.vtp) files.
+
+  VtkXmlDefault keeps the writer's defaults.  VtkXmlAppendedRaw and VtkXmlAppendedZlib write binary
+  data (uncompressed or zlib-compressed) in an appended section with 64-bit block headers, so
+  arrays may exceed 4 GB.  VtkXmlAscii writes inline text, for debugging.
+*/
+enum VtkXmlEncoding {VtkXmlDefault, VtkXmlAscii, VtkXmlAppendedRaw, VtkXmlAppendedZlib};
+
+/// Sets a .vtp writer's data mode, encoding, and compression
+void setVtkXmlEncoding(vtkXMLPolyDataWriter* writer, const VtkXmlEncoding& enc);
+
+/// Writes polydata to a .vtp file
+void writeVtpFile(const std::string& fname, const vtkSmartPointer<vtkPolyData> pd,
+  const VtkXmlEncoding& enc=VtkXmlAppendedZlib);
+
+/// Number of host threads used to prepare vtk arrays (default: hardware concurrency, up to vtk_default_host_threads)
+Int vtkHostThreads();
+
+/** Default bound on vtkHostThreads.  These threads run alongside the Kokkos host thread pool (and often on the
+  AsyncOutput thread, concurrently with kernels), so the default is kept small to avoid oversubscription.
+*/
+static constexpr Int vtk_default_host_threads = 4;
+
+/** @brief Sets the number of host threads used to prepare vtk arrays; 1 disables threading.
+
+  @param nthreads maximum number of threads
+  @param min_block minimum number of items per thread; smaller arrays use fewer threads
+*/
+void setVtkHostThreads(const Int nthreads, const Index min_block=16384);
+
+/// Number of blocks used by vtkHostBlocks for n items
+Int vtkHostBlockCount(const Index n);
+
+/// Joins its threads on destruction, so that a joinable std::thread is never destroyed
+struct VtkThreadGroup {
+  std::vector<std::thread> threads;
+
+  ~VtkThreadGroup() {
+    for (auto& t : threads) {
+      if (t.joinable()) t.join();
+    }
+  }
+};
+
+/** @brief Calls f(begin, end, block) for contiguous blocks of [0,n), one std::thread per block.
+
+  Uses std::thread rather than Kokkos so that vtk arrays may be prepared on an AsyncOutput thread.
+  Blocks are ordered: block b covers indices before those of block b+1.
+  All blocks finish before this function returns; the first exception thrown by any block is then rethrown.
+*/
+template <typename F>
+void vtkHostBlocks(const Index n, const Int nblocks, const F& f) {
+  if (nblocks <= 1) {
+    f(0, n, 0);
+    return;
+  }
+  std::vector<std::exception_ptr> errors(nblocks);
+  auto run_block = [&](const Int b) {
+    try {
+      f(Index((size_t(n)*b)/nblocks), Index((size_t(n)*(b+1))/nblocks), b);
+    }
+    catch (...) {
+      errors[b] = std::current_exception();
+    }
+  };
+  {
+    VtkThreadGroup group;
+    group.threads.reserve(nblocks-1);
+    for (Int b=1; b<nblocks; ++b) {
+      try {
+        group.threads.emplace_back(run_block, b);
+      }
+      catch (...) {
+        run_block(b);
+      }
+    }
+    run_block(0);
+  }
+  for (const auto& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+/** @brief Leaf faces of a mesh as a vtk cell array.
+
+  Leaf positions are found with a block-wise count and scan, then connectivity and offsets are filled
+  in parallel and passed to vtk in one call, without per-cell Insert calls.
+*/
+struct VtkLeafCells {
+  std::vector<Index> leaf_ids; ///< position of each face in the cell array; -1 for divided faces
+  Index nleaves; ///< number of leaf faces
+  vtkSmartPointer<vtkCellArray> cells; ///< leaf face connectivity
+
+  template <typename FacesType>
+  VtkLeafCells(const FacesType& faces);
+};
+
+template <typename FacesType>
+VtkLeafCells::VtkLeafCells(const FacesType& faces) {
+  const Index nf = faces.nh();
+  const Int nfv = FacesType::nverts;
+  const Int nblocks = vtkHostBlockCount(nf);
+  const auto fverts = faces.getVertsHost();
+  leaf_ids.resize(nf);
+
+  /// count leaves in each block, then scan over blocks
+  std::vector<Index> block_start(nblocks+1, 0);
+  vtkHostBlocks(nf, nblocks, [&](const Index begin, const Index end, const Int b) {
+    Index count = 0;
+    for (Index i=begin; i<end; ++i) {
+      if (!faces.hasKidsHost(i)) ++count;
+    }
+    block_start[b+1] = count;
+  });
+  for (Int b=0; b<nblocks; ++b) {
+    block_start[b+1] += block_start[b];
+  }
+  nleaves = block_start[nblocks];
+
+  auto conn = vtkSmartPointer<vtkIdTypeArray>::New();
+#if VTK_MAJOR_VERSION >= 9
+  auto offsets = vtkSmartPointer<vtkIdTypeArray>::New();
+  offsets->SetNumberOfValues(vtkIdType(nleaves)+1);
+  conn->SetNumberOfValues(vtkIdType(nleaves)*nfv);
+  vtkIdType* optr = offsets->GetPointer(0);
+  vtkIdType* cptr = conn->GetPointer(0);
+  const Int stride = nfv;
+  optr[nleaves] = vtkIdType(nleaves)*nfv;
+#else
+  /// legacy cell array layout: (nverts, v0, v1, ...) for each cell
+  conn->SetNumberOfValues(vtkIdType(nleaves)*(nfv+1));
+  vtkIdType* cptr = conn->GetPointer(0);
+  const Int stride = nfv+1;
+#endif
+  vtkHostBlocks(nf, nblocks, [&](const Index begin, const Index end, const Int b) {
+    Index k = block_start[b];
+    for (Index i=begin; i<end; ++i) {
+      if (faces.hasKidsHost(i)) {
+        leaf_ids[i] = -1;
+      }
+      else {
+        vtkIdType* cell = cptr + vtkIdType(k)*stride;
+#if VTK_MAJOR_VERSION >= 9
+        optr[k] = vtkIdType(k)*nfv;
+#else
+        *cell++ = nfv;
+#endif
+        for (Int j=0; j<nfv; ++j) {
+          cell[j] = fverts(i,j);
+        }
+        leaf_ids[i] = k++;
+      }
+    }
+  });
+
+  cells = vtkSmartPointer<vtkCellArray>::New();
+#if VTK_MAJOR_VERSION >= 9
+  cells->SetData(offsets, conn);
+#else
+  cells->SetCells(nleaves, conn);
+#endif
+}
+
 template <typename Geo, typename FacesType> class VtkInterface {
     public:
         vtkSmartPointer<vtkPolyData> toVtkPolyData(const FacesType& faces, const Edges& edges,
@@ -36,13 +205,13 @@ template <typename Geo, typename FacesType> class VtkInterface {
             const typename scalar_view_type::HostMirror sf, const std::string& name, const Index nverts) const;
 
         void addVectorToPointData(vtkSmartPointer<vtkPointData>& pd,
-            const typename ko::View<Real*[Geo::ndim],Dev>::HostMirror vf, const std::string& name, const Index nverts) const;
+            const typename Geo::vec_view_type::HostMirror vf, const std::string& name, const Index nverts) const;
 
         void addScalarToCellData(vtkSmartPointer<vtkCellData>& cd,
             const typename scalar_view_type::HostMirror sf, const std::string& name, const FacesType& faces) const;
 
         void addVectorToCellData(vtkSmartPointer<vtkCellData>& cd,
-            const typename ko::View<Real*[Geo::ndim],Dev>::HostMirror vf, const std::string& name, const FacesType& faces) const;
+            const typename Geo::vec_view_type::HostMirror vf, const std::string& name, const FacesType& faces) const;
 
     protected:
         vtkSmartPointer<vtkPolyDataWriter> pdwriter;
@@ -0,0 +1,180 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmBVESphere.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmVorticityGallery.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmBVERK4_Impl.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2dVtkInterface.hpp"
+#include "LpmPolyMesh2dVtkInterface_Impl.hpp"
+#include "LpmAsyncOutput.hpp"
+#ifdef LPM_HAVE_NETCDF
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#include <netcdf>
+#endif
+
+#include "Kokkos_Core.hpp"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+using namespace Lpm;
+
+/**
+  Runs a few BVE time steps, writing output both synchronously and through AsyncOutput,
+  and checks that the files written by the background thread match the synchronous output.
+*/
+
+/// true if the two files have identical contents
+bool same_file(const std::string& fname0, const std::string& fname1) {
+  std::ifstream f0(fname0, std::ios::binary);
+  std::ifstream f1(fname1, std::ios::binary);
+  LPM_THROW_IF(!f0.is_open() || !f1.is_open(), "cannot open output files.");
+  const std::string s0((std::istreambuf_iterator<char>(f0)), std::istreambuf_iterator<char>());
+  const std::string s1((std::istreambuf_iterator<char>(f1)), std::istreambuf_iterator<char>());
+  return (!s0.empty() && s0 == s1);
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 3;
+  const Int nsteps = 4;
+  const Real dt = 0.01;
+
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  auto sphere = std::shared_ptr<BVESphere<seed_type>>(new BVESphere<seed_type>(nmaxverts, nmaxedges, nmaxfaces, 0));
+  sphere->treeInit(tree_depth, seed);
+  const auto relvort = std::shared_ptr<VorticityInitialCondition>(new SolidBodyRotation());
+  sphere->set_omega(0);
+  sphere->init_vorticity(relvort);
+  const auto tracer_ind = sphere->create_tracer("tracer0");
+  const auto facex = sphere->physFaces.crds;
+  auto q = sphere->tracer_faces[tracer_ind];
+  ko::parallel_for(sphere->nfacesHost(), KOKKOS_LAMBDA (const Index& i) {
+    q(i) = facex(i,2);
+  });
+
+  BVERK4 solver(dt, 2*PI);
+  solver.init(sphere->nvertsHost(), sphere->nfacesHost());
+
+  std::vector<std::string> sync_files;
+  std::vector<std::string> async_files;
+
+#ifdef LPM_HAVE_NETCDF
+  const std::string sync_nc = "async_output_test_sync.nc";
+  const std::string async_nc = "async_output_test_async.nc";
+  auto sync_writer = std::shared_ptr<NcTimeSeriesWriter>(new NcTimeSeriesWriter(sync_nc));
+  sync_writer->defineMesh(*sphere);
+  auto async_writer = std::shared_ptr<NcTimeSeriesWriter>(new NcTimeSeriesWriter(async_nc));
+  async_writer->defineMesh(*sphere);
+#endif
+
+  Real sync_time = 0;
+  Real stage_time = 0;
+  {
+    AsyncOutput out;
+    LPM_THROW_IF(!out.isAsync(), "expected an output thread.");
+    for (Int time_ind=0; time_ind<=nsteps; ++time_ind) {
+      if (time_ind > 0) {
+        solver.advance_timestep(sphere->physVerts.crds, sphere->relVortVerts, sphere->velocityVerts,
+          sphere->physFaces.crds, sphere->relVortFaces, sphere->velocityFaces, sphere->faces.area,
+          sphere->faces.mask);
+        sphere->t = time_ind*dt;
+      }
+      std::ostringstream ss;
+      ss << "async_output_test_sync" << std::setfill('0') << std::setw(4) << time_ind << ".vtp";
+      sync_files.push_back(ss.str());
+      ss.str("");
+      ss << "async_output_test_async" << std::setfill('0') << std::setw(4) << time_ind << ".vtp";
+      async_files.push_back(ss.str());
+
+      /// synchronous path
+      auto t0 = tic();
+      sphere->updateHost();
+      Polymesh2dVtkInterface<seed_type> vtk(sphere);
+      sphere->addFieldsToVtk(vtk);
+      vtk.write(sync_files.back());
+#ifdef LPM_HAVE_NETCDF
+      sphere->writeNcTimestep(*sync_writer);
+#endif
+      sync_time += toc(t0);
+
+      /// asynchronous path; the time loop only pays for staging
+      t0 = tic();
+      auto& snap = out.acquire();
+      sphere->stageOutput(snap);
+      const std::string async_fname = async_files.back();
+      const std::shared_ptr<PolyMesh2d<seed_type>> mesh = sphere;
+#ifdef LPM_HAVE_NETCDF
+      out.submit([async_fname, mesh, async_writer] (const OutputSnapshot& s) {
+        writeVtkSnapshot<seed_type>(async_fname, s, mesh);
+        writeNcSnapshot(*async_writer, s);
+      });
+#else
+      out.submit([async_fname, mesh] (const OutputSnapshot& s) {
+        writeVtkSnapshot<seed_type>(async_fname, s, mesh);
+      });
+#endif
+      stage_time += toc(t0);
+    }
+    out.flush();
+    LPM_THROW_IF(out.nCompleted() != nsteps+1, "wrong number of completed output jobs.");
+
+    /// an acquired buffer that is never submitted must not block flush, and release frees it
+    out.acquire();
+    out.flush();
+    out.release();
+    out.acquire();
+    out.release();
+    out.acquire();
+    out.submit([] (const OutputSnapshot& s) {});
+    out.flush();
+    LPM_THROW_IF(out.nCompleted() != nsteps+2, "released buffer not reusable.");
+  }
+
+  std::cout << "output time, synchronous: " << sync_time << " s; time loop cost with AsyncOutput: "
+            << stage_time << " s\n";
+
+  for (Int k=0; k<=nsteps; ++k) {
+    LPM_THROW_IF(!same_file(sync_files[k], async_files[k]),
+      "asynchronous vtk output differs from synchronous output: " << async_files[k]);
+  }
+
+#ifdef LPM_HAVE_NETCDF
+  LPM_THROW_IF(async_writer->nRecords() != nsteps+1, "wrong number of asynchronous NetCDF records.");
+  sync_writer.reset();
+  async_writer.reset();
+  {
+    netCDF::NcFile f0(sync_nc, netCDF::NcFile::read);
+    netCDF::NcFile f1(async_nc, netCDF::NcFile::read);
+    const size_t nrec = f0.getDim("time").getSize();
+    LPM_THROW_IF(f1.getDim("time").getSize() != nrec, "time record count mismatch.");
+    const std::vector<std::string> names = {"time", "phys_crds_verts_t", "phys_crds_faces_t",
+      "relvort_verts", "relvort_faces", "absvort_verts", "absvort_faces", "stream_fn_verts",
+      "stream_fn_faces", "velocity_verts", "velocity_faces", "tracer0_verts", "tracer0_faces"};
+    for (const auto& name : names) {
+      const auto v0 = f0.getVar(name);
+      const auto v1 = f1.getVar(name);
+      LPM_THROW_IF(v1.isNull(), "variable " << name << " missing from asynchronous output.");
+      size_t n = 1;
+      for (const auto& d : v0.getDims()) n *= d.getSize();
+      std::vector<Real> d0(n), d1(n);
+      v0.getVar(d0.data());
+      v1.getVar(d1.data());
+      LPM_THROW_IF(d0 != d1, "asynchronous NetCDF output differs from synchronous output: " << name);
+    }
+  }
+#endif
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
@@ -0,0 +1,135 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmAutotune.hpp"
+#include "LpmAutotune_Impl.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmBVEKernels.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace Lpm;
+
+/**
+  Checks that TeamPolicyTuner tunes a kernel once per size bucket, that tuned launches reproduce the
+  Kokkos::AUTO result, that tuned parameters persist to the cache file and are reloaded without tuning, and
+  that Cached and Off modes never tune.
+*/
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  const std::string cache_file = "lpm_autotune_test_cache.txt";
+  std::remove(cache_file.c_str());
+
+  LPM_THROW_IF(TeamPolicyTuner::sizeBucket(1) != 0, "sizeBucket(1) should be 0.");
+  LPM_THROW_IF(TeamPolicyTuner::sizeBucket(1024) != 10, "sizeBucket(1024) should be 10.");
+  LPM_THROW_IF(TeamPolicyTuner::sizeBucket(1025) != 11, "sizeBucket(1025) should be 11.");
+
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 3;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  PolyMesh2d<seed_type> mesh(nmaxverts, nmaxedges, nmaxfaces);
+  mesh.treeInit(tree_depth, seed);
+  const Index nv = mesh.nvertsHost();
+  const Index nf = mesh.nfacesHost();
+  scalar_view_type zeta("zeta", nf);
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    zeta(i) = std::sin(Real(i));
+  });
+  scalar_view_type psi("psi", nv);
+  vec_view u("u", nv);
+  scalar_view_type psi_auto("psi_auto", nv);
+  vec_view u_auto("u_auto", nv);
+  const BVEVertexSolve f(psi, u, mesh.physVerts.crds, mesh.physFaces.crds, zeta, mesh.faces.area,
+    mesh.faces.mask, nf);
+  ko::parallel_for(ko::TeamPolicy<>(nv, ko::AUTO()), BVEVertexSolve(psi_auto, u_auto, mesh.physVerts.crds,
+    mesh.physFaces.crds, zeta, mesh.faces.area, mesh.faces.mask, nf));
+
+  auto& tuner = TeamPolicyTuner::instance();
+  tuner.setCacheFile(cache_file);
+
+  /// cached mode with an empty cache: no tuning
+  tuner.setMode(TuneCached);
+  tunedParallelFor("vertex solve", "BVEVertexSolve", nv, nf, f);
+  LPM_THROW_IF(tuner.nTuned() != 0, "cached mode should not tune.");
+
+  /// tuning mode: tune once, then reuse
+  tuner.setMode(TuneOn);
+  tunedParallelFor("vertex solve", "BVEVertexSolve", nv, nf, f);
+  LPM_THROW_IF(tuner.nTuned() != 1, "first launch should tune.");
+  tunedParallelFor("vertex solve", "BVEVertexSolve", nv, nf, f);
+  LPM_THROW_IF(tuner.nTuned() != 1, "second launch should use cached parameters.");
+  TeamParams params;
+  LPM_THROW_IF(!tuner.lookup(params, "BVEVertexSolve", nv), "tuned parameters not cached.");
+  LPM_THROW_IF(!tuner.lookup(params, "BVEVertexSolve", (Index(1) << TeamPolicyTuner::sizeBucket(nv))),
+    "targets in the same bucket should share parameters.");
+  LPM_THROW_IF(tuner.lookup(params, "BVEVertexSolve", 4*nv), "a different bucket should not be cached.");
+  std::cout << tuner.infoString();
+
+  auto psih = ko::create_mirror_view(psi);
+  auto psi_autoh = ko::create_mirror_view(psi_auto);
+  auto uh = ko::create_mirror_view(u);
+  auto u_autoh = ko::create_mirror_view(u_auto);
+  ko::deep_copy(psih, psi);
+  ko::deep_copy(psi_autoh, psi_auto);
+  ko::deep_copy(uh, u);
+  ko::deep_copy(u_autoh, u_auto);
+  Real max_diff = 0;
+  for (Index i=0; i<nv; ++i) {
+    max_diff = std::max(max_diff, std::abs(psih(i) - psi_autoh(i)));
+    for (Short j=0; j<3; ++j) {
+      max_diff = std::max(max_diff, std::abs(uh(i,j) - u_autoh(i,j)));
+    }
+  }
+  std::cout << "max difference from ko::AUTO launch: " << max_diff << "\n";
+  LPM_THROW_IF(max_diff > 1e-12, "tuned launch does not reproduce the ko::AUTO result.");
+
+  /// a new run: parameters reload from the file with no tuning
+  std::ifstream cf(cache_file);
+  LPM_THROW_IF(!cf.is_open(), "cache file not written.");
+  cf.close();
+  tuner.setCacheFile(cache_file);
+  TeamParams reloaded;
+  LPM_THROW_IF(!tuner.lookup(reloaded, "BVEVertexSolve", nv), "cached parameters not reloaded.");
+  LPM_THROW_IF(reloaded.team_size != params.team_size || reloaded.vector_length != params.vector_length,
+    "reloaded parameters differ.");
+  tunedParallelFor("vertex solve", "BVEVertexSolve", nv, nf, f);
+  LPM_THROW_IF(tuner.nTuned() != 1, "reloaded parameters should not be retuned.");
+
+  /// malformed lines are skipped on load
+  {
+    std::ofstream af(cache_file, std::ios::app);
+    af << "BVEVertexSolve 3 not-a-number\n";
+  }
+  tuner.setCacheFile(cache_file);
+  LPM_THROW_IF(!tuner.lookup(reloaded, "BVEVertexSolve", nv), "valid entries lost with a malformed line.");
+
+  /// tuned launches are recorded when the roofline registry is enabled
+  auto& roofline = RooflineRegistry::instance();
+  roofline.reset();
+  roofline.setEnabled(true);
+  tunedParallelFor("vertex solve", "BVEVertexSolve", nv, nf, f);
+  roofline.setEnabled(false);
+  const auto rs = roofline.stats("BVEVertexSolve");
+  LPM_THROW_IF(rs.launches != 1 || rs.pairs != Real(nv)*nf, "tuned launch not recorded.");
+  LPM_THROW_IF(rs.work.flops != BVEVertexSolve::flops_per_pair, "tuned launch work not recorded.");
+
+  /// off mode never tunes
+  tuner.setMode(TuneOff);
+  tunedParallelFor("vertex solve", "BVEVertexSolveUntuned", nv, nf, f);
+  LPM_THROW_IF(tuner.nTuned() != 1, "off mode should not tune.");
+
+  tuner.setMode(TuneCached);
+  std::remove(cache_file.c_str());
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
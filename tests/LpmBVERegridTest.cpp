@@ -0,0 +1,134 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmBVESphere.hpp"
+#include "LpmBVERegrid.hpp"
+#include "LpmVorticityGallery.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmBVERK4_Impl.hpp"
+#include "LpmLatLonMesh.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <netcdf>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+using namespace Lpm;
+using namespace netCDF;
+
+/**
+  Advects solid body rotation for a few steps, regrids the particle data to a lat-lon grid at each
+  output step, and streams the results to two time series files: one with the mesh and the lat-lon
+  grid, and one with the lat-lon grid only.  Checks the regridded data against the exact solution
+  and against the file contents.
+*/
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 4;
+  const Int nsteps = 3;
+  const Real dt = 0.01;
+  const Int nlat = 31;
+  const Int nlon = 60;
+  const std::string mesh_fname = "bve_regrid_mesh.nc";
+  const std::string ll_fname = "bve_regrid_ll.nc";
+
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  auto sphere = std::shared_ptr<BVESphere<seed_type>>(new BVESphere<seed_type>(nmaxverts, nmaxedges, nmaxfaces, 0));
+  sphere->treeInit(tree_depth, seed);
+  const auto relvort = std::shared_ptr<VorticityInitialCondition>(new SolidBodyRotation());
+  sphere->set_omega(0);
+  sphere->init_vorticity(relvort);
+
+  LatLonMesh ll(nlat, nlon);
+  BVERegrid regrid(ll);
+
+  BVERK4 solver(dt, 0);
+  solver.init(sphere->nvertsHost(), sphere->nfacesHost());
+
+  Real regrid_time = 0;
+  {
+    NcTimeSeriesWriter mesh_writer(mesh_fname);
+    mesh_writer.defineMesh(*sphere);
+    mesh_writer.defineLatLon(ll);
+    NcTimeSeriesWriter ll_writer(ll_fname);
+    ll_writer.defineLatLon(ll);
+    for (Int time_ind=0; time_ind<=nsteps; ++time_ind) {
+      if (time_ind > 0) {
+        solver.advance_timestep(sphere->physVerts.crds, sphere->relVortVerts, sphere->velocityVerts,
+          sphere->physFaces.crds, sphere->relVortFaces, sphere->velocityFaces, sphere->faces.area, sphere->faces.mask);
+        sphere->t = time_ind*dt;
+      }
+      auto t0 = tic();
+      regrid.compute(*sphere);
+      ko::fence();
+      regrid_time += toc(t0);
+
+      sphere->writeNcTimestep(mesh_writer);
+      regrid.writeNcTimestep(mesh_writer);
+      ll_writer.appendTime(sphere->t);
+      regrid.writeNcTimestep(ll_writer);
+    }
+    LPM_THROW_IF(mesh_writer.nRecords() != nsteps+1 || ll_writer.nRecords() != nsteps+1,
+      "wrong number of records.");
+  }
+  std::cout << "nfaces = " << sphere->nfacesHost() << ", ntgt = " << regrid.nTargets()
+            << ": average regrid time " << regrid_time/(nsteps+1) << " s\n";
+
+  /// the flow is steady, so regridded data match the initial condition at every step
+  const auto hzeta = ko::create_mirror_view(regrid.relvort);
+  const auto hu = ko::create_mirror_view(regrid.velocity);
+  ko::deep_copy(hzeta, regrid.relvort);
+  ko::deep_copy(hu, regrid.velocity);
+  Real max_zeta_err = 0;
+  Real max_u_err = 0;
+  for (Index i=0; i<regrid.nTargets(); ++i) {
+    const Real x = ll.pts_host(i,0);
+    const Real y = ll.pts_host(i,1);
+    const Real z = ll.pts_host(i,2);
+    Real uex, vex, wex;
+    SolidBodyRotation().init_velocity(uex, vex, wex, x, y, z);
+    max_zeta_err = std::max(max_zeta_err, std::abs(hzeta(i) - relvort->eval(x, y, z)));
+    max_u_err = std::max(max_u_err, std::abs(hu(i,0) - uex));
+    max_u_err = std::max(max_u_err, std::abs(hu(i,1) - vex));
+    max_u_err = std::max(max_u_err, std::abs(hu(i,2) - wex));
+  }
+  std::cout << "max vorticity error = " << max_zeta_err << ", max velocity error = " << max_u_err << "\n";
+  LPM_THROW_IF(max_zeta_err > 1.0e-3*SolidBodyRotation::OMEGA, "regridded vorticity error too large.");
+  LPM_THROW_IF(max_u_err > 5.0e-2*SolidBodyRotation::OMEGA, "regridded velocity error too large.");
+
+  /// file contents
+  for (const auto& fname : {mesh_fname, ll_fname}) {
+    NcFile ncfile(fname, NcFile::read);
+    const auto nrec = ncfile.getDim("time").getSize();
+    LPM_THROW_IF(nrec != nsteps+1, fname << ": wrong time dimension size.");
+    LPM_THROW_IF(ncfile.getDim("nlat").getSize() != nlat || ncfile.getDim("nlon").getSize() != nlon,
+      fname << ": wrong lat-lon dimensions.");
+    std::vector<Real> zeta_nc(nlat*nlon);
+    std::vector<Real> u_nc(3*nlat*nlon);
+    ncfile.getVar("relvort_ll").getVar({nrec-1, 0, 0}, {1, size_t(nlat), size_t(nlon)}, zeta_nc.data());
+    ncfile.getVar("velocity_ll").getVar({nrec-1, 0, 0, 0}, {1, size_t(nlat), size_t(nlon), 3}, u_nc.data());
+    for (Index i=0; i<nlat*nlon; ++i) {
+      LPM_THROW_IF(zeta_nc[i] != hzeta(i), fname << ": vorticity mismatch.");
+      for (Short j=0; j<3; ++j) {
+        LPM_THROW_IF(u_nc[3*i+j] != hu(i,j), fname << ": velocity mismatch.");
+      }
+    }
+    std::cout << fname << ": " << nrec << " time records\n";
+  }
+  {
+    NcFile ncfile(ll_fname, NcFile::read);
+    LPM_THROW_IF(!ncfile.getVar("relvort_faces").isNull(), "lat-lon file should not contain mesh data.");
+  }
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
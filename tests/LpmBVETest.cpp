@@ -64,10 +64,10 @@ ko::initialize(argc, argv);
     sphere->physFaces.crds, sphere->velocityFaces));
   const auto vorticity_err_ind = sphere->create_tracer("abs(vorticity_error)");
 
-  ko::View<Real*[3]> vert_velocity_error("vertex_velocity_error", sphere->nvertsHost());
-  ko::View<Real*[3]> face_velocity_error("face_velocity_error", sphere->nfacesHost());
-  ko::View<Real*[3]> vert_position_error("vertex_position_error", sphere->nvertsHost());
-  ko::View<Real*[3]> face_position_error("face_position_error", sphere->nfacesHost());
+  SphereGeometry::vec_view_type vert_velocity_error("vertex_velocity_error", sphere->nvertsHost());
+  SphereGeometry::vec_view_type face_velocity_error("face_velocity_error", sphere->nfacesHost());
+  SphereGeometry::vec_view_type vert_position_error("vertex_position_error", sphere->nvertsHost());
+  SphereGeometry::vec_view_type face_position_error("face_position_error", sphere->nfacesHost());
 
   const Real tfinal = input.tfinal;
   const Int ntimesteps = std::floor(tfinal/input.dt);
@@ -115,7 +115,7 @@ ko::initialize(argc, argv);
     ko::Profiling::pushRegion("initial solve");
 
     const auto facex = sphere->physFaces.crds;
-    ko::View<Real*[3]> fexactvel("exact_velocity", sphere->nfacesHost());
+    SphereGeometry::vec_view_type fexactvel("exact_velocity", sphere->nfacesHost());
     ko::parallel_for("initial face vel. err.", sphere->nfacesHost(), KOKKOS_LAMBDA (const Index& i) {
       const auto myx = ko::subview(facex,i,ko::ALL());
       fexactvel(i,0) = -Omega*myx(1);
@@ -244,7 +244,7 @@ ko::initialize(argc, argv);
     ko::Profiling::pushRegion("final error norms at faces");
 
     const auto facex = sphere->physFaces.crds;
-    ko::View<Real*[3]> fexactvel("exact_velocity", sphere->nfacesHost());
+    SphereGeometry::vec_view_type fexactvel("exact_velocity", sphere->nfacesHost());
     ko::parallel_for("final face vel. err.",sphere->nfacesHost(), KOKKOS_LAMBDA (const Index& i) {
       const auto myx = ko::subview(facex,i,ko::ALL());
       fexactvel(i,0) = -Omega*myx(1);
@@ -0,0 +1,155 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmBVESphere.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmVorticityGallery.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmBVERK4_Impl.hpp"
+#include "LpmShallowWater.hpp"
+#include "LpmShallowWater_Impl.hpp"
+#include "LpmSWEGallery.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <iostream>
+#include <sstream>
+
+using namespace Lpm;
+
+/**
+  Writes BVESphere and ShallowWater checkpoints, restarts from them, and checks that the restarted
+  objects hold the same data.  The BVE run is continued from both the original and the restarted
+  state, and the results must agree exactly.
+*/
+
+/// true if rows [0,n) of two device views are identical
+template <typename ViewType>
+bool same_rows(const ViewType& a, const ViewType& b, const Index n) {
+  const auto ha = ko::create_mirror_view(a);
+  const auto hb = ko::create_mirror_view(b);
+  ko::deep_copy(ha, a);
+  ko::deep_copy(hb, b);
+  const Int ncomp = (ViewType::rank == 1 ? 1 : a.extent(1));
+  for (Index i=0; i<n; ++i) {
+    for (Int j=0; j<ncomp; ++j) {
+      if (ha.access(i,j) != hb.access(i,j)) return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 3;
+  const Real dt = 0.01;
+  const std::string bve_fname = "bve_checkpoint.nc";
+
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  auto sphere = std::shared_ptr<BVESphere<seed_type>>(new BVESphere<seed_type>(nmaxverts, nmaxedges, nmaxfaces, 0));
+  sphere->treeInit(tree_depth, seed);
+  const auto relvort = std::shared_ptr<VorticityInitialCondition>(new SolidBodyRotation());
+  sphere->set_omega(0);
+  sphere->init_vorticity(relvort);
+  const auto tracer_ind = sphere->create_tracer("tracer0");
+  const auto facex = sphere->physFaces.crds;
+  auto q = sphere->tracer_faces[tracer_ind];
+  ko::parallel_for(sphere->nfacesHost(), KOKKOS_LAMBDA (const Index& i) {
+    q(i) = facex(i,2);
+  });
+
+  BVERK4 solver(dt, 0);
+  solver.init(sphere->nvertsHost(), sphere->nfacesHost());
+  for (Int time_ind=0; time_ind<2; ++time_ind) {
+    solver.advance_timestep(sphere->physVerts.crds, sphere->relVortVerts, sphere->velocityVerts,
+      sphere->physFaces.crds, sphere->relVortFaces, sphere->velocityFaces, sphere->faces.area, sphere->faces.mask);
+    sphere->t += dt;
+  }
+
+  auto t0 = tic();
+  {
+    NcWriter writer(bve_fname);
+    sphere->writeCheckpoint(writer);
+    solver.writeSettings(writer);
+  }
+  const Real write_time = toc(t0);
+
+  t0 = tic();
+  PolyMeshReader reader(bve_fname);
+  auto restart = std::shared_ptr<BVESphere<seed_type>>(new BVESphere<seed_type>(reader));
+  BVERK4 restart_solver(reader);
+  ko::fence();
+  const Real read_time = toc(t0);
+  std::cout << "BVE checkpoint: write " << write_time << " s, restart " << read_time << " s\n";
+
+  const Index nv = sphere->nvertsHost();
+  const Index nf = sphere->nfacesHost();
+  LPM_THROW_IF(restart->nvertsHost() != nv || restart->nfacesHost() != nf, "BVE mesh size mismatch.");
+  LPM_THROW_IF(restart->t != sphere->t || restart->Omega != sphere->Omega, "BVE t or Omega mismatch.");
+  LPM_THROW_IF(restart_solver.dt != solver.dt || restart_solver.Omega != solver.Omega ||
+    restart_solver.symmetric_faces != solver.symmetric_faces, "BVERK4 settings mismatch.");
+  LPM_THROW_IF(restart->tracer_faces.size() != 1 || restart->tracer_faces[0].label() != "tracer0",
+    "BVE tracer mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->physVerts.crds, restart->physVerts.crds, nv), "vertex position mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->physFaces.crds, restart->physFaces.crds, nf), "face position mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->relVortVerts, restart->relVortVerts, nv), "vertex vorticity mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->relVortFaces, restart->relVortFaces, nf), "face vorticity mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->absVortFaces, restart->absVortFaces, nf), "face abs. vorticity mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->streamFnFaces, restart->streamFnFaces, nf), "face stream fn. mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->velocityVerts, restart->velocityVerts, nv), "vertex velocity mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->velocityFaces, restart->velocityFaces, nf), "face velocity mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->faces.area, restart->faces.area, nf), "face area mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->tracer_verts[0], restart->tracer_verts[0], nv), "vertex tracer mismatch.");
+  LPM_THROW_IF(!same_rows(sphere->tracer_faces[0], restart->tracer_faces[0], nf), "face tracer mismatch.");
+
+  /// continuing from the restart gives the same result as continuing the original run
+  restart_solver.init(restart->nvertsHost(), restart->nfacesHost());
+  solver.advance_timestep(sphere->physVerts.crds, sphere->relVortVerts, sphere->velocityVerts,
+    sphere->physFaces.crds, sphere->relVortFaces, sphere->velocityFaces, sphere->faces.area, sphere->faces.mask);
+  restart_solver.advance_timestep(restart->physVerts.crds, restart->relVortVerts, restart->velocityVerts,
+    restart->physFaces.crds, restart->relVortFaces, restart->velocityFaces, restart->faces.area,
+    restart->faces.mask);
+  LPM_THROW_IF(!same_rows(sphere->physFaces.crds, restart->physFaces.crds, nf),
+    "restarted run diverges from original run.");
+
+  /// shallow water
+  {
+    typedef IcosTriSphereSeed swe_seed_type;
+    const std::string swe_fname = "swe_checkpoint.nc";
+    const Real swe_t = 0.5;
+    MeshSeed<swe_seed_type> swe_seed;
+    swe_seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+    auto swe = std::shared_ptr<ShallowWater<swe_seed_type>>(new ShallowWater<swe_seed_type>(
+      nmaxverts, nmaxedges, nmaxfaces, 1, 0));
+    swe->treeInit(tree_depth, swe_seed);
+    swe->init_problem<SphereGeostrophicBalance>();
+    {
+      NcWriter writer(swe_fname);
+      swe->writeCheckpoint(writer, swe_t);
+    }
+    PolyMeshReader swe_reader(swe_fname);
+    auto swe_restart = std::shared_ptr<ShallowWater<swe_seed_type>>(new ShallowWater<swe_seed_type>(swe_reader));
+    const Index snv = swe->nvertsHost();
+    const Index snf = swe->nfacesHost();
+    LPM_THROW_IF(swe_reader.getRealAtt("t") != swe_t, "SWE time mismatch.");
+    LPM_THROW_IF(swe_restart->Omega != swe->Omega || swe_restart->f0 != swe->f0 || swe_restart->beta != swe->beta,
+      "SWE Coriolis parameter mismatch.");
+    LPM_THROW_IF(swe_restart->nscalar_tracers() != 1, "SWE tracer count mismatch.");
+    LPM_THROW_IF(!same_rows(swe->physFaces.crds, swe_restart->physFaces.crds, snf), "SWE face position mismatch.");
+    LPM_THROW_IF(!same_rows(swe->surfaceHeightFaces, swe_restart->surfaceHeightFaces, snf), "SWE surface mismatch.");
+    LPM_THROW_IF(!same_rows(swe->depthVerts, swe_restart->depthVerts, snv), "SWE depth mismatch.");
+    LPM_THROW_IF(!same_rows(swe->massFaces, swe_restart->massFaces, snf), "SWE mass mismatch.");
+    LPM_THROW_IF(!same_rows(swe->velocityFaces, swe_restart->velocityFaces, snf), "SWE velocity mismatch.");
+    LPM_THROW_IF(!same_rows(swe->topoVerts, swe_restart->topoVerts, snv), "SWE topography mismatch.");
+  }
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
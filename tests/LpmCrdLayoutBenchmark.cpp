@@ -0,0 +1,176 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmKokkosUtil.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <iomanip>
+#include <sstream>
+
+using namespace Lpm;
+
+/**
+  Benchmarks the BVE collocated velocity direct sum (same arithmetic as BVEFaceVelocity)
+  with coordinates stored in each CrdLayout policy, independent of the library's configured policy.
+
+  usage: lpmCrdLayoutBenchmark [-d tree_depth] [-n nrepeat]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Int max_depth;
+  Int nrepeat;
+};
+
+template <typename LayoutPolicy> struct LayoutBenchVelocityReduce {
+  typedef ko::Tuple<Real,3> value_type;
+  typedef ko::View<Real*[3], typename LayoutPolicy::array_layout, Dev> view_type;
+  Index i;
+  view_type srcx;
+  scalar_view_type srcf;
+  scalar_view_type srca;
+  mask_view_type mask;
+
+  KOKKOS_INLINE_FUNCTION
+  LayoutBenchVelocityReduce(const Index& ii, const view_type& x, const scalar_view_type& f,
+    const scalar_view_type& a, const mask_view_type& m) : i(ii), srcx(x), srcf(f), srca(a), mask(m) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const Index& j, value_type& vel) const {
+    ko::Tuple<Real,3> u;
+    if (!mask(j) && i != j) {
+      const auto mtgt = vec_at<3>(srcx, i);
+      const auto msrc = vec_at<3>(srcx, j);
+      biotSavart(u, mtgt, msrc, srcf(j), srca(j));
+    }
+    vel += u;
+  }
+};
+
+template <typename LayoutPolicy> struct LayoutBenchFaceVelocity {
+  typedef ko::View<Real*[3], typename LayoutPolicy::array_layout, Dev> view_type;
+  view_type faceu;
+  view_type facex;
+  scalar_view_type facevort;
+  scalar_view_type facearea;
+  mask_view_type facemask;
+  Index nf;
+
+  LayoutBenchFaceVelocity(view_type& u, const view_type& x, const scalar_view_type& zeta,
+    const scalar_view_type& a, const mask_view_type& fm, const Index& nsrc) :
+    faceu(u), facex(x), facevort(zeta), facearea(a), facemask(fm), nf(nsrc) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const member_type& mbr) const {
+    const Index i = mbr.league_rank();
+    ko::Tuple<Real,3> u;
+    ko::parallel_reduce(ko::TeamThreadRange(mbr, nf),
+      LayoutBenchVelocityReduce<LayoutPolicy>(i, facex, facevort, facearea, facemask), u);
+    for (Short j=0; j<3; ++j) {
+      faceu(i,j) = u[j];
+    }
+  }
+};
+
+/// Copies coordinates into LayoutPolicy storage, runs the velocity sum nrepeat times, returns the avg. time.
+template <typename LayoutPolicy, typename CrdViewType>
+Real run_layout(typename ko::View<Real*[3], typename LayoutPolicy::array_layout, Dev>::HostMirror& hu,
+  const CrdViewType& crds, const scalar_view_type& zeta, const scalar_view_type& area,
+  const mask_view_type& mask, const Index nf, const Int nrepeat) {
+  typedef ko::View<Real*[3], typename LayoutPolicy::array_layout, Dev> view_type;
+  view_type x("x", nf);
+  view_type u("u", nf);
+  auto hx = ko::create_mirror_view(x);
+  auto hcrds = ko::create_mirror_view(crds);
+  ko::deep_copy(hcrds, crds);
+  for (Index i=0; i<nf; ++i) {
+    for (Short j=0; j<3; ++j) {
+      hx(i,j) = hcrds(i,j);
+    }
+  }
+  ko::deep_copy(x, hx);
+
+  ko::Profiling::pushRegion("layout benchmark " + LayoutPolicy::idString());
+  ko::parallel_for(ko::TeamPolicy<>(nf, ko::AUTO()),
+    LayoutBenchFaceVelocity<LayoutPolicy>(u, x, zeta, area, mask, nf)); // warm up
+  auto t0 = tic();
+  for (Int k=0; k<nrepeat; ++k) {
+    ko::parallel_for(ko::TeamPolicy<>(nf, ko::AUTO()),
+      LayoutBenchFaceVelocity<LayoutPolicy>(u, x, zeta, area, mask, nf));
+  }
+  const Real elapsed = toc(t0)/nrepeat;
+  ko::Profiling::popRegion();
+
+  hu = ko::create_mirror_view(u);
+  ko::deep_copy(hu, u);
+  return elapsed;
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+  typedef IcosTriSphereSeed seed_type;
+
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, input.max_depth);
+  PolyMesh2d<seed_type> sphere(nmaxverts, nmaxedges, nmaxfaces);
+  sphere.treeInit(input.max_depth, seed);
+
+  const Index nf = sphere.nfacesHost();
+  scalar_view_type zeta("zeta", nf);
+  const auto facex = sphere.physFaces.crds;
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    zeta(i) = facex(i,2);
+  });
+
+  typename ko::View<Real*[3], AoSCrdLayout::array_layout, Dev>::HostMirror aos_u;
+  typename ko::View<Real*[3], SoACrdLayout::array_layout, Dev>::HostMirror soa_u;
+  const Real aos_time = run_layout<AoSCrdLayout>(aos_u, facex, zeta, sphere.faces.area,
+    sphere.faces.mask, nf, input.nrepeat);
+  const Real soa_time = run_layout<SoACrdLayout>(soa_u, facex, zeta, sphere.faces.area,
+    sphere.faces.mask, nf, input.nrepeat);
+
+  Real max_diff = 0;
+  for (Index i=0; i<nf; ++i) {
+    for (Short j=0; j<3; ++j) {
+      max_diff = max(max_diff, std::abs(aos_u(i,j) - soa_u(i,j)));
+    }
+  }
+
+  const Real ninteractions = Real(nf)*Real(sphere.faces.nLeavesHost());
+  std::cout << "coordinate layout benchmark: " << DevExe::name() << ", " << seed_type::idString()
+            << " depth " << input.max_depth << ", nfaces = " << nf
+            << ", configured layout = " << CrdLayout::idString() << "\n";
+  std::cout << std::setw(8) << "layout" << std::setw(16) << "time (s)" << std::setw(20) << "interactions/s\n";
+  std::cout << std::setw(8) << AoSCrdLayout::idString() << std::setw(16) << aos_time
+            << std::setw(20) << ninteractions/aos_time << "\n";
+  std::cout << std::setw(8) << SoACrdLayout::idString() << std::setw(16) << soa_time
+            << std::setw(20) << ninteractions/soa_time << "\n";
+  std::cout << "SoA speedup = " << aos_time/soa_time << "\n";
+  std::cout << "max |u_aos - u_soa| = " << max_diff << "\n";
+  LPM_THROW_IF(max_diff > 1.0e-13, "layouts produce different results.");
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  max_depth = 4;
+  nrepeat = 5;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-d") {
+      max_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-n") {
+      nrepeat = std::stoi(argv[++i]);
+    }
+  }
+}
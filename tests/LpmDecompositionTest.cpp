@@ -0,0 +1,128 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmDecomposition.hpp"
+#include "LpmDecomposition_Impl.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <cmath>
+#include <iostream>
+
+using namespace Lpm;
+
+/**
+  Each MPI rank builds the same mesh and partitions it with MortonDecomposition.  Checks that leaf faces and
+  vertices are each owned by exactly one rank, that skewed measured work triggers a rebalance that evens out
+  the load, and that migrate delivers particle data to the new owners.
+
+  usage: mpirun -np <n> lpmDecompositionTest
+*/
+
+/// value of the test field at global face index i
+KOKKOS_INLINE_FUNCTION
+Real face_value(const Index i) {return 2.0*i + 1;}
+
+int main(int argc, char* argv[]) {
+MPI_Init(&argc, &argv);
+ko::initialize(argc, argv);
+{
+  Int rank, nranks;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 4;
+
+  MeshSeed<seed_type> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  PolyMesh2d<seed_type> mesh(nmaxverts, nmaxedges, nmaxfaces);
+  mesh.treeInit(tree_depth, seed);
+  const Index nv = mesh.nvertsHost();
+  const Index nf = mesh.nfacesHost();
+  const Index nleaves = mesh.faces.nLeavesHost();
+
+  MortonDecomposition decomp(MPI_COMM_WORLD);
+  decomp.init(mesh);
+  std::cout << decomp.infoString();
+
+  /// ownership
+  Index nowned[2] = {Index(decomp.ownedFacesHost().extent(0)), Index(decomp.ownedVertsHost().extent(0))};
+  Index ntotal[2];
+  MPI_Allreduce(nowned, ntotal, 2, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  LPM_THROW_IF(ntotal[0] != nleaves, "leaf faces not partitioned.");
+  LPM_THROW_IF(ntotal[1] != nv, "vertices not partitioned.");
+  const auto face_owner = decomp.faceOwnersHost();
+  const auto vert_owner = decomp.vertOwnersHost();
+  const auto fverts = mesh.faces.getVertsHost();
+  for (Index i=0; i<nf; ++i) {
+    LPM_THROW_IF(mesh.faces.hasKidsHost(i) != (face_owner(i) < 0), "divided faces must not be owned.");
+    if (face_owner(i) >= 0) {
+      for (Short j=0; j<seed_type::nfaceverts; ++j) {
+        LPM_THROW_IF(vert_owner(fverts(i,j)) > face_owner(i), "vertex owner is not the lowest adjacent rank.");
+      }
+    }
+  }
+  LPM_THROW_IF(std::abs(decomp.imbalance() - 1) > Real(nranks)/nleaves, "initial partition is unbalanced.");
+
+  /// balanced work: no rebalance
+  decomp.setRankWork(1.0);
+  LPM_THROW_IF(decomp.rebalance(1.1), "balanced work should not trigger a rebalance.");
+
+  /// field data valid only at owned faces
+  scalar_view_type f("f", nf);
+  auto fh = ko::create_mirror_view(f);
+  for (Index i=0; i<nf; ++i) {
+    fh(i) = (face_owner(i) == rank ? face_value(i) : -1);
+  }
+  ko::deep_copy(f, fh);
+  auto vxh = mesh.physVerts.getHostCrdView();
+  for (Index i=0; i<nv; ++i) {
+    if (vert_owner(i) != rank) {
+      for (Short j=0; j<3; ++j) {
+        vxh(i,j) = 0;
+      }
+    }
+  }
+  mesh.physVerts.updateDevice();
+
+  /// rank 0 is slow: rebalance should move leaves away from it
+  const Index nowned_before = decomp.ownedFacesHost().extent(0);
+  const Int nowned0_before = decomp.leafOffset(1) - decomp.leafOffset(0);
+  decomp.setRankWork(rank == 0 ? 4.0 : 1.0);
+  if (nranks > 1) {
+    LPM_THROW_IF(decomp.imbalance() <= 1.1, "imbalance not detected.");
+    LPM_THROW_IF(!decomp.rebalance(1.1), "skewed work should trigger a rebalance.");
+    LPM_THROW_IF(decomp.leafOffset(1) - decomp.leafOffset(0) >= nowned0_before, "rank 0 should own fewer leaves.");
+    LPM_THROW_IF(decomp.imbalance() > 1.1, "rebalanced partition should be balanced.");
+  }
+  if (rank == 0) {
+    std::cout << "rank 0 leaves: " << nowned_before << " before rebalance, "
+              << decomp.ownedFacesHost().extent(0) << " after\n";
+  }
+
+  decomp.migrate(f, FaceField);
+  decomp.migrate(mesh);
+  ko::deep_copy(fh, f);
+  const auto owned_faces = decomp.ownedFacesHost();
+  for (Index k=0; k<Index(owned_faces.extent(0)); ++k) {
+    LPM_THROW_IF(fh(owned_faces(k)) != face_value(owned_faces(k)), "face data not migrated.");
+  }
+  const auto lxh = mesh.lagVerts.getHostCrdView();
+  const auto owned_verts = decomp.ownedVertsHost();
+  for (Index k=0; k<Index(owned_verts.extent(0)); ++k) {
+    for (Short j=0; j<3; ++j) {
+      LPM_THROW_IF(vxh(owned_verts(k),j) != lxh(owned_verts(k),j), "vertex coordinates not migrated.");
+    }
+  }
+}
+MPI_Barrier(MPI_COMM_WORLD);
+int rank;
+MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+if (rank == 0) std::cout << "tests pass" << std::endl;
+ko::finalize();
+MPI_Finalize();
+return 0;
+}
@@ -0,0 +1,228 @@
+#include "LpmKernelBenchmark.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmSWEKernels.hpp"
+#include "LpmPSE.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace Lpm;
+
+/**
+  Sweeps seed type, tree depth, team size, and vector length for the direct-sum N-body kernels
+  (BVEVertexSolve, BVEFaceSolve, VertexSolve, FaceSolve, PlanarSWEVertexSums, PlanePSELaplacian) and
+  reports time per launch, pair interactions per second, and approximate GFLOP/s and GB/s from the work each
+  kernel functor declares (see PairWork), as percentages of the machine peaks measured by MachinePeaks.
+
+  Results are written to <prefix>.csv and <prefix>.json for regression tracking and for choosing
+  launch parameters on a given machine.
+
+  usage: lpmKernelBenchmark [-min min_depth] [-max max_depth] [-t team_size ...] [-v vector_length ...]
+    [-n nrepeat] [-o output_prefix] [-s stream_size]
+*/
+
+/// BVEVertexSolve and BVEFaceSolve on one sphere mesh
+template <typename SeedType>
+void bve_bench(std::vector<KernelBenchResult>& results, const KernelBenchInput& input, const Int depth) {
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<SeedType> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+  PolyMesh2d<SeedType> sphere(nmaxverts, nmaxedges, nmaxfaces);
+  sphere.treeInit(depth, seed);
+
+  const Index nv = sphere.nvertsHost();
+  const Index nf = sphere.nfacesHost();
+  const Real nleaves = sphere.faces.nLeavesHost();
+  const auto facex = sphere.physFaces.crds;
+  scalar_view_type zeta("zeta", nf);
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    zeta(i) = facex(i,2);
+  });
+  scalar_view_type psiverts("psiverts", nv);
+  scalar_view_type psifaces("psifaces", nf);
+  vec_view uverts("uverts", nv);
+  vec_view ufaces("ufaces", nf);
+
+  benchTeamKernel(results, input, BVEVertexSolve(psiverts, uverts, sphere.physVerts.crds, facex, zeta,
+    sphere.faces.area, sphere.faces.mask, nf), "BVEVertexSolve", SeedType::idString(), depth, nv, nf,
+    nv*nleaves);
+  benchTeamKernel(results, input, BVEFaceSolve(psifaces, ufaces, facex, zeta, sphere.faces.area,
+    sphere.faces.mask, nf), "BVEFaceSolve", SeedType::idString(), depth, nf, nf,
+    nf*nleaves);
+}
+
+/// PlanarSWEVertexSums and PlanePSELaplacian on one planar mesh; vertices are targets, faces are sources
+template <typename SeedType>
+void plane_bench(std::vector<KernelBenchResult>& results, const KernelBenchInput& input, const Int depth) {
+  typedef typename PlaneGeometry::crd_view_type plane_crd_view;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<SeedType> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+  PolyMesh2d<SeedType> plane(nmaxverts, nmaxedges, nmaxfaces);
+  plane.treeInit(depth, seed);
+
+  const Index nv = plane.nvertsHost();
+  const Index nf = plane.nfacesHost();
+  const Real eps = 2*std::sqrt(plane.faces.surfAreaHost()/plane.faces.nLeavesHost());
+  const auto vertx = plane.physVerts.crds;
+  const auto facex = plane.physFaces.crds;
+  scalar_view_type vsfc("vsfc", nv);
+  scalar_view_type fzeta("fzeta", nf);
+  scalar_view_type fdiv("fdiv", nf);
+  scalar_view_type fsfc("fsfc", nf);
+  ko::parallel_for(nv, KOKKOS_LAMBDA (const Index& i) {
+    vsfc(i) = std::exp(-square(vertx(i,0)) - square(vertx(i,1)));
+  });
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    fzeta(i) = std::exp(-square(facex(i,0)) - square(facex(i,1)));
+    fdiv(i) = facex(i,0)*facex(i,1);
+    fsfc(i) = fzeta(i);
+  });
+  typename PlaneGeometry::vec_view_type vvel("vvel", nv);
+  scalar_view_type vddot("vddot", nv);
+  scalar_view_type vlap("vlap", nv);
+
+  benchTeamKernel(results, input, PlanarSWEVertexSums(vvel, vddot, vlap, vertx, vsfc, facex, fzeta, fdiv,
+    plane.faces.area, fsfc, eps), "PlanarSWEVertexSums", SeedType::idString(), depth, nv, nf,
+    Real(nv)*nf);
+  benchTeamKernel(results, input, PlanePSELaplacian(vlap, vertx, vsfc, facex, fsfc, plane.faces.area,
+    eps, nf), "PlanePSELaplacian", SeedType::idString(), depth, nv, nf,
+    Real(nv)*nf);
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  KernelBenchInput input(argc, argv);
+  std::vector<KernelBenchResult> results;
+  const MachinePeaks peaks = MachinePeaks::measure(input.stream_size);
+  std::cout << peaks.infoString();
+  RooflineRegistry::instance().setPeaks(peaks);
+
+  std::cout << "N-body kernel benchmark: depths " << input.min_depth << "-" << input.max_depth
+            << ", " << input.nrepeat << " repetitions per configuration\n";
+  for (Int depth=input.min_depth; depth<=input.max_depth; ++depth) {
+    bve_bench<CubedSphereSeed>(results, input, depth);
+    bve_bench<IcosTriSphereSeed>(results, input, depth);
+    plane_bench<QuadRectSeed>(results, input, depth);
+    plane_bench<TriHexSeed>(results, input, depth);
+  }
+  poissonKernelBenchmarks(results, input);
+
+  LPM_THROW_IF(results.empty(), "no kernel configurations could be launched.");
+  for (const auto& r : results) {
+    LPM_THROW_IF(!(r.time > 0), r.kernel << ": invalid timing.");
+    LPM_THROW_IF(!(r.work.bytes > 0 && r.work.flops > 0), r.kernel << ": kernel work not declared.");
+  }
+  std::cout << RooflineRegistry::instance().summaryString();
+  writeKernelBenchResults(results, peaks, input.output_prefix);
+  std::cout << "results written to " << input.output_prefix << ".csv and " << input.output_prefix << ".json\n";
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+namespace Lpm {
+
+std::string KernelBenchResult::csvHeader() {
+  return "kernel,seed,depth,ntargets,nsources,npairs,team_size,vector_length,nrepeat,time_s,"
+    "flops_per_pair,transcendentals_per_pair,bytes_per_pair,flops_per_byte,pairs_per_s,gflops,gbytes_per_s,"
+    "pct_peak_flops,pct_peak_bw,bound";
+}
+
+std::string KernelBenchResult::csvRow() const {
+  std::ostringstream ss;
+  ss << std::setprecision(8);
+  ss << kernel << "," << seed << "," << depth << "," << ntargets << "," << nsources << ","
+     << npairs << "," << team_size << "," << vector_length << "," << nrepeat << "," << time << ","
+     << work.flops << "," << work.transcendentals << "," << work.bytes << "," << work.intensity() << ","
+     << pairs_per_second << "," << gflops << "," << gbytes_per_s << "," << pct_peak_flops << ","
+     << pct_peak_bw << "," << bound;
+  return ss.str();
+}
+
+std::string KernelBenchResult::jsonObject() const {
+  std::ostringstream ss;
+  ss << std::setprecision(8);
+  ss << "{\"kernel\": \"" << kernel << "\", \"seed\": \"" << seed << "\", \"depth\": " << depth
+     << ", \"ntargets\": " << ntargets << ", \"nsources\": " << nsources << ", \"npairs\": " << npairs
+     << ", \"team_size\": " << team_size << ", \"vector_length\": " << vector_length
+     << ", \"nrepeat\": " << nrepeat << ", \"time_s\": " << time
+     << ", \"flops_per_pair\": " << work.flops << ", \"transcendentals_per_pair\": " << work.transcendentals
+     << ", \"bytes_per_pair\": " << work.bytes << ", \"flops_per_byte\": " << work.intensity()
+     << ", \"pairs_per_s\": " << pairs_per_second << ", \"gflops\": " << gflops
+     << ", \"gbytes_per_s\": " << gbytes_per_s << ", \"pct_peak_flops\": " << pct_peak_flops
+     << ", \"pct_peak_bw\": " << pct_peak_bw << ", \"bound\": \"" << bound << "\"}";
+  return ss.str();
+}
+
+std::string KernelBenchResult::infoString() const {
+  std::ostringstream ss;
+  ss << std::setw(20) << kernel << std::setw(18) << seed << std::setw(4) << depth
+     << std::setw(8) << (team_size > 0 ? std::to_string(team_size) : std::string("auto"))
+     << std::setw(4) << vector_length << std::setw(14) << time << " s" << std::setw(14) << pairs_per_second
+     << " pairs/s" << std::setw(10) << gflops << " GFLOP/s" << std::setw(10) << gbytes_per_s << " GB/s  "
+     << bound << "\n";
+  return ss.str();
+}
+
+void writeKernelBenchResults(const std::vector<KernelBenchResult>& results, const MachinePeaks& peaks,
+  const std::string& prefix) {
+  std::ofstream csv(prefix + ".csv");
+  csv << KernelBenchResult::csvHeader() << "\n";
+  for (const auto& r : results) {
+    csv << r.csvRow() << "\n";
+  }
+  csv.close();
+
+  std::ofstream json(prefix + ".json");
+  json << "{\n  \"execution_space\": \"" << ko::DefaultExecutionSpace::name() << "\",\n"
+       << "  \"peak_gflops\": " << peaks.gflops << ",\n"
+       << "  \"peak_gbytes_per_s\": " << peaks.gbytes_per_s << ",\n"
+       << "  \"results\": [\n";
+  for (size_t i=0; i<results.size(); ++i) {
+    json << "    " << results[i].jsonObject() << (i+1 < results.size() ? ",\n" : "\n");
+  }
+  json << "  ]\n}\n";
+  json.close();
+}
+
+KernelBenchInput::KernelBenchInput(int argc, char* argv[]) {
+  min_depth = 2;
+  max_depth = 4;
+  nrepeat = 5;
+  output_prefix = "lpm_kernel_benchmark";
+  stream_size = (1<<24);
+  team_sizes = {0};
+  vector_lengths = {1};
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-min") {
+      min_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-max") {
+      max_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-n") {
+      nrepeat = std::stoi(argv[++i]);
+    }
+    else if (token == "-o") {
+      output_prefix = argv[++i];
+    }
+    else if (token == "-s") {
+      stream_size = std::stoi(argv[++i]);
+    }
+    else if (token == "-t" || token == "-v") {
+      std::vector<Int>& vals = (token == "-t" ? team_sizes : vector_lengths);
+      vals.clear();
+      while (i+1 < argc && argv[i+1][0] != '-') {
+        vals.push_back(std::stoi(argv[++i]));
+      }
+    }
+  }
+  LPM_THROW_IF(team_sizes.empty() || vector_lengths.empty(), "KernelBenchInput: empty team size or vector length list.");
+}
+
+}
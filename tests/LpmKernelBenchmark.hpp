@@ -0,0 +1,126 @@
+#ifndef LPM_KERNEL_BENCHMARK_HPP
+#define LPM_KERNEL_BENCHMARK_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmRoofline.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Lpm {
+
+/// One timed configuration of one kernel
+struct KernelBenchResult {
+  std::string kernel;
+  std::string seed;
+  Int depth;
+  Index ntargets;
+  Index nsources;
+  Real npairs; ///< source-target interactions per kernel launch
+  Int team_size; ///< 0 for Kokkos::AUTO
+  Int vector_length;
+  Int nrepeat;
+  Real time; ///< average seconds per launch
+  PairWork work; ///< per pair, as declared by the kernel functor
+  Real pairs_per_second;
+  Real gflops; ///< transcendental calls count as 1 flop
+  Real gbytes_per_s; ///< source data requested (see PairWork)
+  Real pct_peak_flops; ///< percent of MachinePeaks::gflops
+  Real pct_peak_bw; ///< percent of MachinePeaks::gbytes_per_s
+  std::string bound; ///< "compute" or "memory" (see RooflineRegistry::bound)
+
+  static std::string csvHeader();
+  std::string csvRow() const;
+  std::string jsonObject() const;
+  std::string infoString() const;
+};
+
+/** @brief Benchmark options.
+
+  usage: lpmKernelBenchmark [-min min_depth] [-max max_depth] [-t team_size ...] [-v vector_length ...]
+    [-n nrepeat] [-o output_prefix] [-s stream_size]
+
+  Team size 0 means Kokkos::AUTO.  Results go to <output_prefix>.csv and <output_prefix>.json.
+  stream_size is the array length of the STREAM triad probe (see MachinePeaks).
+*/
+struct KernelBenchInput {
+  KernelBenchInput(int argc, char* argv[]);
+
+  Int min_depth;
+  Int max_depth;
+  std::vector<Int> team_sizes;
+  std::vector<Int> vector_lengths;
+  Int nrepeat;
+  std::string output_prefix;
+  Index stream_size;
+};
+
+/** @brief Times a team kernel (1 team per target) for each team size and vector length.
+
+  Configurations the backend cannot launch (team or vector size too large) are skipped.  Rates use the
+  functor's declared PairWork and are compared to the peaks set in the RooflineRegistry; each configuration
+  is also recorded in the registry.
+*/
+template <typename FunctorType>
+void benchTeamKernel(std::vector<KernelBenchResult>& results, const KernelBenchInput& input,
+  const FunctorType& f, const std::string& kernel, const std::string& seed, const Int depth,
+  const Index ntgt, const Index nsrc, const Real npairs) {
+  RooflineRegistry& roofline = RooflineRegistry::instance();
+  const MachinePeaks& peaks = roofline.machinePeaks();
+  const PairWork work = pairWork<FunctorType>();
+  const Int max_vlen = ko::TeamPolicy<>::vector_length_max();
+  for (const auto& vlen : input.vector_lengths) {
+    if (vlen > max_vlen) continue;
+    for (const auto& team_size : input.team_sizes) {
+      ko::TeamPolicy<> policy = (team_size > 0 ? ko::TeamPolicy<>(ntgt, team_size, vlen) :
+        ko::TeamPolicy<>(ntgt, ko::AUTO(), vlen));
+      if (team_size > 0 && team_size > policy.team_size_max(f, ko::ParallelForTag())) continue;
+
+      ko::Profiling::pushRegion("benchmark " + kernel);
+      ko::parallel_for(policy, f); // warm up
+      auto t0 = tic();
+      for (Int k=0; k<input.nrepeat; ++k) {
+        ko::parallel_for(policy, f);
+      }
+      const Real elapsed = toc(t0)/input.nrepeat;
+      ko::Profiling::popRegion();
+
+      KernelBenchResult r;
+      r.kernel = kernel;
+      r.seed = seed;
+      r.depth = depth;
+      r.ntargets = ntgt;
+      r.nsources = nsrc;
+      r.npairs = npairs;
+      r.team_size = team_size;
+      r.vector_length = vlen;
+      r.nrepeat = input.nrepeat;
+      r.time = elapsed;
+      r.work = work;
+      r.pairs_per_second = npairs/elapsed;
+      r.gflops = npairs*work.totalFlops()/elapsed*1.0e-9;
+      r.gbytes_per_s = npairs*work.bytes/elapsed*1.0e-9;
+      r.pct_peak_flops = (peaks.gflops > 0 ? 100*r.gflops/peaks.gflops : 0);
+      r.pct_peak_bw = (peaks.gbytes_per_s > 0 ? 100*r.gbytes_per_s/peaks.gbytes_per_s : 0);
+      r.bound = roofline.bound(work);
+      roofline.record(kernel, work, npairs*input.nrepeat, elapsed*input.nrepeat, input.nrepeat);
+      std::cout << r.infoString();
+      results.push_back(r);
+    }
+  }
+}
+
+/// VertexSolve and FaceSolve (SpherePoisson) benchmarks; defined in a separate translation unit
+void poissonKernelBenchmarks(std::vector<KernelBenchResult>& results, const KernelBenchInput& input);
+
+/// Writes all results, and the machine peaks, to <prefix>.csv and <prefix>.json
+void writeKernelBenchResults(const std::vector<KernelBenchResult>& results, const MachinePeaks& peaks,
+  const std::string& prefix);
+
+}
+#endif
@@ -0,0 +1,43 @@
+#include "LpmKernelBenchmark.hpp"
+#include "LpmSpherePoisson.hpp"
+
+namespace Lpm {
+
+/// VertexSolve and FaceSolve on one sphere mesh
+template <typename SeedType>
+void poissonBench(std::vector<KernelBenchResult>& results, const KernelBenchInput& input, const Int depth) {
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<SeedType> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+  PolyMesh2d<SeedType> sphere(nmaxverts, nmaxedges, nmaxfaces);
+  sphere.treeInit(depth, seed);
+
+  const Index nv = sphere.nvertsHost();
+  const Index nf = sphere.nfacesHost();
+  const Real nleaves = sphere.faces.nLeavesHost();
+  const auto facex = sphere.physFaces.crds;
+  scalar_view_type zeta("zeta", nf);
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    zeta(i) = facex(i,2);
+  });
+  scalar_view_type psiverts("psiverts", nv);
+  scalar_view_type psifaces("psifaces", nf);
+  vec_view uverts("uverts", nv);
+  vec_view ufaces("ufaces", nf);
+
+  benchTeamKernel(results, input, VertexSolve(sphere.physVerts.crds, facex, zeta, sphere.faces.area,
+    sphere.faces.mask, psiverts, uverts), "VertexSolve", SeedType::idString(), depth, nv, nf,
+    nv*nleaves);
+  benchTeamKernel(results, input, FaceSolve(facex, zeta, sphere.faces.area, sphere.faces.mask,
+    psifaces, ufaces), "FaceSolve", SeedType::idString(), depth, nf, nf,
+    nf*nleaves);
+}
+
+void poissonKernelBenchmarks(std::vector<KernelBenchResult>& results, const KernelBenchInput& input) {
+  for (Int depth=input.min_depth; depth<=input.max_depth; ++depth) {
+    poissonBench<CubedSphereSeed>(results, input, depth);
+    poissonBench<IcosTriSphereSeed>(results, input, depth);
+  }
+}
+
+}
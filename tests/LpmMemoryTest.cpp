@@ -0,0 +1,100 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMemory.hpp"
+#include "LpmBVESphere.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmOctree.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <iostream>
+#include <memory>
+
+using namespace Lpm;
+
+/**
+  Checks that MemoryAccounting attributes mesh, field, integrator, and tree allocations to their
+  categories, that scopes override labels, and that deallocations reduce live bytes but not
+  high-water marks.
+*/
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 3;
+  const std::string dev_space = ko::DefaultExecutionSpace::memory_space::name();
+
+  auto& mem = MemoryAccounting::instance();
+  mem.enable();
+  mem.reset();
+  LPM_THROW_IF(!mem.enabled(), "accounting not enabled.");
+
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  auto sphere = std::shared_ptr<BVESphere<seed_type>>(new BVESphere<seed_type>(nmaxverts, nmaxedges, nmaxfaces, 0));
+  sphere->treeInit(tree_depth, seed);
+
+  /// physical and Lagrangian vertex and face coordinates alone
+  const uint64_t min_mesh_bytes = 2*(nmaxverts + nmaxfaces)*3*sizeof(Real);
+  LPM_THROW_IF(mem.usage(MemMesh, dev_space).live < min_mesh_bytes, "mesh allocations not counted.");
+  /// 4 scalar and 1 vector field on vertices and faces
+  const uint64_t min_field_bytes = (nmaxverts + nmaxfaces)*(4+3)*sizeof(Real);
+  LPM_THROW_IF(mem.usage(MemFields, dev_space).live < min_field_bytes, "field allocations not counted.");
+
+  /// BVERK4: 5 coordinate arrays and 5 scalar arrays on vertices and faces
+  const Index nv = sphere->nvertsHost();
+  const Index nf = sphere->nfacesHost();
+  {
+    BVERK4 solver(0.01, 0);
+    solver.init(nv, nf);
+    const uint64_t rk_bytes = 5*(nv + nf)*(3+1)*sizeof(Real);
+    LPM_THROW_IF(mem.usage(MemIntegrator, dev_space).live != rk_bytes, "wrong integrator byte count.");
+  }
+  LPM_THROW_IF(mem.usage(MemIntegrator, dev_space).live != 0, "integrator deallocations not counted.");
+  LPM_THROW_IF(mem.usage(MemIntegrator, dev_space).high_water != 5*(nv + nf)*(3+1)*sizeof(Real),
+    "integrator high water mark lost.");
+
+  /// octree on the face coordinates
+  {
+    ko::View<Real*[3]> pts("pts", nf);
+    ko::deep_copy(pts, sphere->physFaces.crds);
+    Octree::Tree tree(pts, 3);
+    LPM_THROW_IF(mem.usage(MemTree, dev_space).live < nf*3*sizeof(Real), "tree allocations not counted.");
+  }
+
+  /// scopes override labels
+  {
+    MemoryCategoryScope remap_scope(MemRemap);
+    ko::View<Real*> v("crds", 1000);
+    LPM_THROW_IF(mem.usage(MemRemap, dev_space).live != 1000*sizeof(Real), "scope not applied.");
+    {
+      MemoryCategoryScope field_scope(MemFields);
+      LPM_THROW_IF(MemoryCategoryScope::current() != MemFields, "nested scope not applied.");
+    }
+    LPM_THROW_IF(MemoryCategoryScope::current() != MemRemap, "scope not restored.");
+  }
+  LPM_THROW_IF(MemoryCategoryScope::current() != MemNCategories, "scope not closed.");
+
+  /// user labels
+  mem.setLabelCategory("my_field", MemFields);
+  const uint64_t field_bytes = mem.usage(MemFields, dev_space).live;
+  {
+    scalar_view_type f("my_field", 100);
+    LPM_THROW_IF(mem.usage(MemFields, dev_space).live != field_bytes + 100*sizeof(Real), "label rule not applied.");
+  }
+  {
+    scalar_view_type u("unlabeled_scratch", 100);
+    LPM_THROW_IF(mem.usage(MemOther, dev_space).live < 100*sizeof(Real), "other allocations not counted.");
+  }
+
+  const auto total = mem.spaceUsage(dev_space);
+  LPM_THROW_IF(total.high_water < total.live, "inconsistent total.");
+
+  std::cout << mem.breakdownString();
+  mem.setReportAtFinalize(false);
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
@@ -0,0 +1,163 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmMeshCache.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace Lpm;
+
+/**
+  Builds meshes with treeInit, writes them to mesh cache files, reloads them, and checks that
+  every host array matches exactly.  Reports build and load times.
+
+  usage: lpmMeshCacheTest [-d tree_depth]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Int depth;
+};
+
+/// true if rows [0,n) of two host views are identical
+template <typename ViewType>
+bool same_rows(const ViewType& a, const ViewType& b, const Index n) {
+  const Int ncomp = (ViewType::rank == 1 ? 1 : a.extent(1));
+  for (Index i=0; i<n; ++i) {
+    for (Int j=0; j<ncomp; ++j) {
+      if (a.access(i,j) != b.access(i,j)) return false;
+    }
+  }
+  return true;
+}
+
+template <typename SeedType>
+void compare_meshes(const PolyMesh2d<SeedType>& a, const PolyMesh2d<SeedType>& b) {
+  const std::string id = SeedType::idString();
+  const Index nv = a.nvertsHost();
+  const Index ne = a.nedgesHost();
+  const Index nf = a.nfacesHost();
+  LPM_THROW_IF(b.nvertsHost() != nv || b.nedgesHost() != ne || b.nfacesHost() != nf, id << ": size mismatch.");
+  LPM_THROW_IF(b.edges.nLeavesHost() != a.edges.nLeavesHost() || b.faces.nLeavesHost() != a.faces.nLeavesHost(),
+    id << ": leaf count mismatch.");
+  LPM_THROW_IF(b.baseTreeDepth != a.baseTreeDepth, id << ": depth mismatch.");
+  LPM_THROW_IF(!same_rows(a.physVerts.getHostCrdView(), b.physVerts.getHostCrdView(), nv), id << ": physVerts.");
+  LPM_THROW_IF(!same_rows(a.lagVerts.getHostCrdView(), b.lagVerts.getHostCrdView(), nv), id << ": lagVerts.");
+  LPM_THROW_IF(!same_rows(a.edges.getOrigsHost(), b.edges.getOrigsHost(), ne), id << ": edge origs.");
+  LPM_THROW_IF(!same_rows(a.edges.getDestsHost(), b.edges.getDestsHost(), ne), id << ": edge dests.");
+  LPM_THROW_IF(!same_rows(a.edges.getLeftsHost(), b.edges.getLeftsHost(), ne), id << ": edge lefts.");
+  LPM_THROW_IF(!same_rows(a.edges.getRightsHost(), b.edges.getRightsHost(), ne), id << ": edge rights.");
+  LPM_THROW_IF(!same_rows(a.edges.getParentsHost(), b.edges.getParentsHost(), ne), id << ": edge parents.");
+  LPM_THROW_IF(!same_rows(a.edges.getKidsHost(), b.edges.getKidsHost(), ne), id << ": edge kids.");
+  LPM_THROW_IF(!same_rows(a.faces.getVertsHost(), b.faces.getVertsHost(), nf), id << ": face verts.");
+  LPM_THROW_IF(!same_rows(a.faces.getEdgesHost(), b.faces.getEdgesHost(), nf), id << ": face edges.");
+  LPM_THROW_IF(!same_rows(a.faces.getCentersHost(), b.faces.getCentersHost(), nf), id << ": face centers.");
+  LPM_THROW_IF(!same_rows(a.faces.getLevelsHost(), b.faces.getLevelsHost(), nf), id << ": face levels.");
+  LPM_THROW_IF(!same_rows(a.faces.getParentsHost(), b.faces.getParentsHost(), nf), id << ": face parents.");
+  LPM_THROW_IF(!same_rows(a.faces.getKidsHost(), b.faces.getKidsHost(), nf), id << ": face kids.");
+  LPM_THROW_IF(!same_rows(a.faces.getMaskHost(), b.faces.getMaskHost(), nf), id << ": face mask.");
+  LPM_THROW_IF(!same_rows(a.faces.getAreaHost(), b.faces.getAreaHost(), nf), id << ": face area.");
+  LPM_THROW_IF(!same_rows(a.physFaces.getHostCrdView(), b.physFaces.getHostCrdView(), nf), id << ": physFaces.");
+  LPM_THROW_IF(!same_rows(a.lagFaces.getHostCrdView(), b.lagFaces.getHostCrdView(), nf), id << ": lagFaces.");
+
+  /// device data were copied, too
+  auto dmask = ko::create_mirror_view(b.faces.mask);
+  ko::deep_copy(dmask, b.faces.mask);
+  LPM_THROW_IF(!same_rows(a.faces.getMaskHost(), dmask, nf), id << ": device face mask.");
+}
+
+template <typename SeedType>
+void run_test(const Int depth) {
+  const std::string fname = meshCacheFilename(SeedType::idString(), depth);
+  std::remove(fname.c_str());
+
+  MeshSeed<SeedType> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+
+  auto t0 = tic();
+  PolyMesh2d<SeedType> built(nmaxverts, nmaxedges, nmaxfaces);
+  const bool first_loaded = built.treeInitCached(depth, seed);
+  const Real build_time = toc(t0);
+  LPM_THROW_IF(first_loaded, "expected treeInit to build the mesh when no cache exists.");
+
+  t0 = tic();
+  PolyMesh2d<SeedType> cached(nmaxverts, nmaxedges, nmaxfaces);
+  const bool second_loaded = cached.treeInitCached(depth, seed);
+  ko::fence();
+  const Real load_time = toc(t0);
+  LPM_THROW_IF(!second_loaded, "expected the mesh to load from the cache file.");
+
+  std::cout << SeedType::idString() << " depth " << depth << ": nfaces = " << built.nfacesHost()
+            << ", treeInit + write " << build_time << " s, cache load " << load_time << " s\n";
+
+  compare_meshes(built, cached);
+
+  MeshCacheReader cache(fname);
+  PolyMesh2d<SeedType> exact(cache);
+  compare_meshes(built, exact);
+  LPM_THROW_IF(exact.physVerts.nMax() != built.nvertsHost(), "cache constructor should allocate exactly.");
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+  run_test<CubedSphereSeed>(input.depth);
+  run_test<IcosTriSphereSeed>(input.depth);
+  run_test<QuadRectSeed>(input.depth);
+
+  /// a cache for one seed type cannot initialize another
+  bool caught = false;
+  try {
+    MeshCacheReader cache(meshCacheFilename(CubedSphereSeed::idString(), input.depth));
+    PolyMesh2d<QuadRectSeed> wrong(cache);
+  }
+  catch (std::logic_error&) {
+    caught = true;
+  }
+  LPM_THROW_IF(!caught, "seed type mismatch not detected.");
+
+  /// a header with no arrays (e.g., left by an interrupted writer) is not a valid empty mesh
+  const std::string empty_fname = "lpm_mesh_cache_test_empty.lpmcache";
+  {
+    MeshCacheHeader header;
+    std::memset(&header, 0, sizeof(MeshCacheHeader));
+    std::memcpy(header.magic, "LPMMESH", 8);
+    header.version = mesh_cache_version;
+    header.depth = input.depth;
+    std::ofstream os(empty_fname, std::ios::binary);
+    os.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+  }
+  caught = false;
+  try {
+    MeshCacheReader cache(empty_fname);
+  }
+  catch (std::logic_error&) {
+    caught = true;
+  }
+  std::remove(empty_fname.c_str());
+  LPM_THROW_IF(!caught, "empty mesh cache header not rejected.");
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  depth = 4;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-d") {
+      depth = std::stoi(argv[++i]);
+    }
+  }
+}
@@ -0,0 +1,105 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmBVESphere.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmVorticityGallery.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmBVERK4_Impl.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <netcdf>
+#include <iostream>
+#include <sstream>
+
+using namespace Lpm;
+using namespace netCDF;
+
+/**
+  Writes several BVE time steps to one file with NcTimeSeriesWriter and checks the file contents.
+*/
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 3;
+  const Int nsteps = 3;
+  const Real dt = 0.01;
+  const std::string fname = "bve_time_series.nc";
+
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  auto sphere = std::shared_ptr<BVESphere<seed_type>>(new BVESphere<seed_type>(nmaxverts, nmaxedges, nmaxfaces, 0));
+  sphere->treeInit(tree_depth, seed);
+  const auto relvort = std::shared_ptr<VorticityInitialCondition>(new SolidBodyRotation());
+  sphere->set_omega(0);
+  sphere->init_vorticity(relvort);
+  const auto tracer_ind = sphere->create_tracer("tracer0");
+  const auto facex = sphere->physFaces.crds;
+  auto q = sphere->tracer_faces[tracer_ind];
+  ko::parallel_for(sphere->nfacesHost(), KOKKOS_LAMBDA (const Index& i) {
+    q(i) = facex(i,2);
+  });
+
+  BVERK4 solver(dt, 2*PI);
+  solver.init(sphere->nvertsHost(), sphere->nfacesHost());
+
+  {
+    NcTimeSeriesWriter writer(fname, NcVarStorage(0, 1, true));
+    writer.defineMesh(*sphere);
+    sphere->writeNcTimestep(writer);
+    for (Int time_ind=0; time_ind<nsteps; ++time_ind) {
+      solver.advance_timestep(sphere->physVerts.crds, sphere->relVortVerts, sphere->velocityVerts,
+        sphere->physFaces.crds, sphere->relVortFaces, sphere->velocityFaces, sphere->faces.area, sphere->faces.mask);
+      sphere->t = (time_ind+1)*dt;
+      sphere->writeNcTimestep(writer);
+    }
+    LPM_THROW_IF(writer.nRecords() != nsteps+1, "wrong number of records.");
+  }
+
+  NcFile ncfile(fname, NcFile::read);
+  const auto nrec = ncfile.getDim("time").getSize();
+  std::cout << fname << ": " << nrec << " time records\n";
+  LPM_THROW_IF(nrec != nsteps+1, "wrong time dimension size.");
+  LPM_THROW_IF(!ncfile.getDim("time").isUnlimited(), "time dimension is not unlimited.");
+  LPM_THROW_IF(ncfile.getVar("face_verts").getDimCount() != 2, "topology should not depend on time.");
+
+  std::vector<Real> times(nrec);
+  ncfile.getVar("time").getVar(times.data());
+  for (Int k=0; k<nrec; ++k) {
+    LPM_THROW_IF(std::abs(times[k] - k*dt) > 1.0e-14, "time value mismatch.");
+  }
+
+  /// last record matches the current state
+  const Index nf = sphere->nfacesHost();
+  sphere->updateHost();
+  const auto hzeta = ko::create_mirror_view(sphere->relVortFaces);
+  ko::deep_copy(hzeta, sphere->relVortFaces);
+  const auto hx = ko::create_mirror_view(sphere->physFaces.crds);
+  ko::deep_copy(hx, sphere->physFaces.crds);
+  std::vector<Real> zeta_nc(nf);
+  std::vector<Real> x_nc(3*nf);
+  ncfile.getVar("relvort_faces").getVar({nrec-1, 0}, {1, size_t(nf)}, zeta_nc.data());
+  ncfile.getVar("phys_crds_faces_t").getVar({nrec-1, 0, 0}, {1, size_t(nf), 3}, x_nc.data());
+  for (Index i=0; i<nf; ++i) {
+    LPM_THROW_IF(zeta_nc[i] != hzeta(i), "face vorticity mismatch.");
+    for (Short j=0; j<3; ++j) {
+      LPM_THROW_IF(x_nc[3*i+j] != hx(i,j), "face position mismatch.");
+    }
+  }
+
+  /// the tracer is advected, not changed, so every record holds the initial values
+  std::vector<Real> q0(nf), qlast(nf);
+  ncfile.getVar("tracer0_faces").getVar({0, 0}, {1, size_t(nf)}, q0.data());
+  ncfile.getVar("tracer0_faces").getVar({nrec-1, 0}, {1, size_t(nf)}, qlast.data());
+  for (Index i=0; i<nf; ++i) {
+    LPM_THROW_IF(q0[i] != qlast[i], "tracer mismatch.");
+  }
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
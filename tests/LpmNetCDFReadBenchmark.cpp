@@ -0,0 +1,121 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmEdges.hpp"
+#include "LpmFaces.hpp"
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+using namespace Lpm;
+
+/**
+  Times loading a saved mesh (PolyMeshReader + PolyMesh2d(reader)) at a range of tree depths,
+  and checks that the mesh read from file matches the mesh that was written.
+
+  usage: lpmNetCDFReadBenchmark [-min min_depth] [-max max_depth]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Int min_depth;
+  Int max_depth;
+};
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+  typedef CubedSphereSeed seed_type;
+
+  const Int fw = 14;
+  std::cout << "NetCDF mesh read benchmark: " << seed_type::idString() << "\n";
+  std::cout << std::setw(fw) << "depth" << std::setw(fw) << "nverts" << std::setw(fw) << "nfaces"
+            << std::setw(fw) << "write (s)" << std::setw(fw) << "read (s)" << "\n";
+  for (Int depth=input.min_depth; depth<=input.max_depth; ++depth) {
+    MeshSeed<seed_type> seed;
+    Index nmaxverts, nmaxedges, nmaxfaces;
+    seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+    auto mesh = std::shared_ptr<PolyMesh2d<seed_type>>(new
+      PolyMesh2d<seed_type>(nmaxverts, nmaxedges, nmaxfaces));
+    mesh->treeInit(depth, seed);
+    mesh->updateDevice();
+
+    std::ostringstream ss;
+    ss << "read_benchmark_" << depth << ".nc";
+    auto t0 = tic();
+    {
+      NcWriter writer(ss.str());
+      writer.writePolymesh(mesh);
+    }
+    const Real write_time = toc(t0);
+
+    t0 = tic();
+    PolyMeshReader reader(ss.str());
+    const auto mesh_from_nc = std::shared_ptr<PolyMesh2d<seed_type>>(new
+      PolyMesh2d<seed_type>(reader));
+    ko::fence();
+    const Real read_time = toc(t0);
+
+    std::cout << std::setw(fw) << depth << std::setw(fw) << mesh->nvertsHost()
+              << std::setw(fw) << mesh->nfacesHost() << std::setw(fw) << write_time
+              << std::setw(fw) << read_time << "\n";
+
+    LPM_THROW_IF(mesh_from_nc->nvertsHost() != mesh->nvertsHost(), "vertex count mismatch.");
+    LPM_THROW_IF(mesh_from_nc->nedgesHost() != mesh->nedgesHost(), "edge count mismatch.");
+    LPM_THROW_IF(mesh_from_nc->nfacesHost() != mesh->nfacesHost(), "face count mismatch.");
+    const auto ek = mesh->edges.getKidsHost();
+    const auto ek_nc = mesh_from_nc->edges.getKidsHost();
+    for (Index i=0; i<mesh->nedgesHost(); ++i) {
+      LPM_THROW_IF(ek(i,0) != ek_nc(i,0) || ek(i,1) != ek_nc(i,1), "edge tree mismatch.");
+    }
+    const auto fv = mesh->faces.getVertsHost();
+    const auto fv_nc = mesh_from_nc->faces.getVertsHost();
+    const auto fe = mesh->faces.getEdgesHost();
+    const auto fe_nc = mesh_from_nc->faces.getEdgesHost();
+    const auto fk = mesh->faces.getKidsHost();
+    const auto fk_nc = mesh_from_nc->faces.getKidsHost();
+    for (Index i=0; i<mesh->nfacesHost(); ++i) {
+      for (Short j=0; j<seed_type::nfaceverts; ++j) {
+        LPM_THROW_IF(fv(i,j) != fv_nc(i,j), "face vertex mismatch.");
+        LPM_THROW_IF(fe(i,j) != fe_nc(i,j), "face edge mismatch.");
+      }
+      for (Short j=0; j<4; ++j) {
+        LPM_THROW_IF(fk(i,j) != fk_nc(i,j), "face tree mismatch.");
+      }
+    }
+    const auto hx = mesh->physFaces.getHostCrdView();
+    const auto hx_nc = mesh_from_nc->physFaces.getHostCrdView();
+    for (Index i=0; i<mesh->nfacesHost(); ++i) {
+      for (Short j=0; j<seed_type::geo::ndim; ++j) {
+        LPM_THROW_IF(hx(i,j) != hx_nc(i,j), "face coordinate mismatch.");
+      }
+    }
+  }
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  min_depth = 5;
+  max_depth = 9;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-min") {
+      min_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-max") {
+      max_depth = std::stoi(argv[++i]);
+    }
+  }
+}
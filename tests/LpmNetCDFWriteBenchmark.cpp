@@ -0,0 +1,107 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+using namespace Lpm;
+
+/**
+  Reports write time and file size of NcWriter::writePolymesh for several storage options
+  at a range of tree depths, and checks that coordinates survive the round trip.
+
+  usage: lpmNetCDFWriteBenchmark [-min min_depth] [-max max_depth] [-z deflate_level]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Int min_depth;
+  Int max_depth;
+  Int deflate_level;
+};
+
+size_t file_size(const std::string& fname) {
+  std::ifstream f(fname, std::ios::binary | std::ios::ate);
+  return f.tellg();
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+  typedef CubedSphereSeed seed_type;
+
+  const std::vector<std::string> labels = {"contiguous", "chunked", "deflate+shuffle"};
+  const std::vector<NcVarStorage> storage = {NcVarStorage(),
+    NcVarStorage(NC_WRITE_CHUNK_ROWS), NcVarStorage(0, input.deflate_level, true)};
+
+  const Int fw = 18;
+  std::cout << "NetCDF mesh write benchmark: " << seed_type::idString() << "\n";
+  std::cout << std::setw(fw) << "depth" << std::setw(fw) << "nfaces" << std::setw(fw) << "storage"
+            << std::setw(fw) << "write (s)" << std::setw(fw) << "size (MB)" << "\n";
+  for (Int depth=input.min_depth; depth<=input.max_depth; ++depth) {
+    MeshSeed<seed_type> seed;
+    Index nmaxverts, nmaxedges, nmaxfaces;
+    seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+    auto mesh = std::shared_ptr<PolyMesh2d<seed_type>>(new
+      PolyMesh2d<seed_type>(nmaxverts, nmaxedges, nmaxfaces));
+    mesh->treeInit(depth, seed);
+    mesh->updateDevice();
+
+    for (size_t k=0; k<storage.size(); ++k) {
+      std::ostringstream ss;
+      ss << "write_benchmark_" << depth << "_" << k << ".nc";
+      auto t0 = tic();
+      {
+        NcWriter writer(ss.str(), storage[k]);
+        writer.writePolymesh(mesh);
+      }
+      const Real write_time = toc(t0);
+      std::cout << std::setw(fw) << depth << std::setw(fw) << mesh->nfacesHost() << std::setw(fw) << labels[k]
+                << std::setw(fw) << write_time << std::setw(fw) << file_size(ss.str())/1.0e6 << "\n";
+
+      PolyMeshReader reader(ss.str());
+      const auto hx = mesh->physVerts.getHostCrdView();
+      const auto rcrds = reader.getVertPhysCrdView();
+      const auto rx = ko::create_mirror_view(rcrds);
+      ko::deep_copy(rx, rcrds);
+      for (Index i=0; i<mesh->nvertsHost(); ++i) {
+        for (Short j=0; j<seed_type::geo::ndim; ++j) {
+          LPM_THROW_IF(hx(i,j) != rx(i,j), "vertex coordinate mismatch after write.");
+        }
+      }
+    }
+  }
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  min_depth = 3;
+  max_depth = 7;
+  deflate_level = 4;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-min") {
+      min_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-max") {
+      max_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-z") {
+      deflate_level = std::stoi(argv[++i]);
+    }
+  }
+}
@@ -0,0 +1,128 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmNetCDF.hpp"
+#include "LpmNetCDF_Impl.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <iostream>
+#include <sstream>
+
+using namespace Lpm;
+
+/**
+  Each MPI rank builds the same mesh, then all ranks write one shared NetCDF-4 file collectively:
+  the mesh is split into blocks of rows, and a face field is written as distributed ranges.
+  The file is read back collectively with a different partition, and serially on rank 0.
+
+  usage: mpirun -np <n> lpmParallelNetCDFTest
+*/
+
+/// value of the test field at global face index i
+KOKKOS_INLINE_FUNCTION
+Real face_value(const Index i) {return 0.5*i + 1;}
+
+int main(int argc, char* argv[]) {
+MPI_Init(&argc, &argv);
+ko::initialize(argc, argv);
+{
+  Int rank, nranks;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 3;
+  const std::string fname = "parallel_netcdf_test.nc";
+
+  MeshSeed<seed_type> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  PolyMesh2d<seed_type> mesh(nmaxverts, nmaxedges, nmaxfaces);
+  mesh.treeInit(tree_depth, seed);
+  const Index nf = mesh.nfacesHost();
+
+  /// this rank's block of faces
+  Index offset, nlocal;
+  blockRange(offset, nlocal, nf, rank, nranks);
+  scalar_view_type local_scalar("local_scalar", nlocal);
+  typename SphereGeometry::vec_view_type local_vec("local_vec", nlocal);
+  const auto fx = mesh.physFaces.crds;
+  ko::parallel_for(nlocal, KOKKOS_LAMBDA (const Index& i) {
+    local_scalar(i) = face_value(offset + i);
+    for (Short j=0; j<3; ++j) {
+      local_vec(i,j) = fx(offset + i, j);
+    }
+  });
+
+  auto t0 = tic();
+  {
+    NcWriter writer(fname, MPI_COMM_WORLD);
+    LPM_THROW_IF(!writer.isParallel(), "expected a parallel writer.");
+    writer.writePolymesh(mesh);
+    writer.writeScalarFieldRange(local_scalar, offset, nlocal, FaceField, "face_scalar");
+    writer.writeVectorFieldRange(local_vec, offset, nlocal, FaceField, "face_vec");
+    writer.writeAttribute("nranks", nranks);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  const Real write_time = toc(t0);
+  if (rank == 0) {
+    std::cout << nranks << " ranks, " << nf << " faces: collective write " << write_time << " s\n";
+  }
+
+  /// collective read, with ranks in reverse order
+  {
+    PolyMeshReader reader(fname, MPI_COMM_WORLD);
+    LPM_THROW_IF(reader.fieldRows("face_scalar") != nf, "global field size mismatch.");
+    Index roffset, rnlocal;
+    blockRange(roffset, rnlocal, nf, nranks-1-rank, nranks);
+    typename scalar_view_type::HostMirror hs("hs", rnlocal);
+    typename SphereGeometry::vec_view_type::HostMirror hv("hv", rnlocal);
+    reader.fill_scalar_field_range(hs, "face_scalar", roffset, rnlocal);
+    reader.fill_vector_field_range(hv, "face_vec", roffset, rnlocal);
+    const auto hfx = mesh.physFaces.getHostCrdView();
+    for (Index i=0; i<rnlocal; ++i) {
+      LPM_THROW_IF(hs(i) != face_value(roffset + i), "collective scalar read mismatch.");
+      for (Short j=0; j<3; ++j) {
+        LPM_THROW_IF(hv(i,j) != hfx(roffset + i, j), "collective vector read mismatch.");
+      }
+    }
+  }
+
+  /// serial read of the whole file on one rank
+  if (rank == 0) {
+    PolyMeshReader reader(fname);
+    LPM_THROW_IF(reader.getIntAtt("nranks") != nranks, "attribute mismatch.");
+    PolyMesh2d<seed_type> copy(reader);
+    LPM_THROW_IF(copy.nvertsHost() != mesh.nvertsHost() || copy.nfacesHost() != nf, "mesh size mismatch.");
+    const auto hx0 = mesh.physVerts.getHostCrdView();
+    const auto hx1 = copy.physVerts.getHostCrdView();
+    const auto fv0 = mesh.faces.getVertsHost();
+    const auto fv1 = copy.faces.getVertsHost();
+    for (Index i=0; i<mesh.nvertsHost(); ++i) {
+      for (Short j=0; j<3; ++j) {
+        LPM_THROW_IF(hx0(i,j) != hx1(i,j), "vertex coordinate mismatch.");
+      }
+    }
+    for (Index i=0; i<nf; ++i) {
+      for (Short j=0; j<seed_type::nfaceverts; ++j) {
+        LPM_THROW_IF(fv0(i,j) != fv1(i,j), "face connectivity mismatch.");
+      }
+    }
+    typename scalar_view_type::HostMirror hs("hs", nf);
+    reader.fill_scalar_field(hs, "face_scalar");
+    for (Index i=0; i<nf; ++i) {
+      LPM_THROW_IF(hs(i) != face_value(i), "serial scalar read mismatch.");
+    }
+  }
+}
+MPI_Barrier(MPI_COMM_WORLD);
+int rank;
+MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+if (rank == 0) std::cout << "tests pass" << std::endl;
+ko::finalize();
+MPI_Finalize();
+return 0;
+}
@@ -0,0 +1,254 @@
+#include "LpmPerfRegression.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmBVERK4_Impl.hpp"
+#include "LpmOctree.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+using namespace Lpm;
+
+/**
+  Runs a fixed set of kernel and end-to-end workloads and compares their times to a stored baseline for
+  this machine.  Fails if any workload is slower than its baseline by more than the tolerance, e.g., after
+  a Kokkos or Trilinos upgrade.
+
+  Baselines are only meaningful for the machine, build type, and Kokkos execution space that recorded
+  them; record one with -w (or by running with a baseline file that does not exist yet).
+
+  usage: lpmPerfRegression [-b baseline_file] [-tol tolerance] [-n nrepeat] [-w]
+*/
+
+/// BVERK4 time steps on a cubed sphere
+PerfWorkload bve_workload(const Int depth, const Int nsteps) {
+  typedef CubedSphereSeed seed_type;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+  auto mesh = std::make_shared<PolyMesh2d<seed_type>>(nmaxverts, nmaxedges, nmaxfaces);
+  mesh->treeInit(depth, seed);
+  const Index nv = mesh->nvertsHost();
+  const Index nf = mesh->nfacesHost();
+  scalar_view_type vzeta("vzeta", nv);
+  scalar_view_type fzeta("fzeta", nf);
+  vec_view vvel("vvel", nv);
+  vec_view fvel("fvel", nf);
+  const auto vx = mesh->physVerts.crds;
+  const auto fx = mesh->physFaces.crds;
+  ko::parallel_for(nv, KOKKOS_LAMBDA (const Index& i) {
+    vzeta(i) = vx(i,2) + 0.5*vx(i,0)*vx(i,1);
+  });
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    fzeta(i) = fx(i,2) + 0.5*fx(i,0)*fx(i,1);
+  });
+  auto solver = std::make_shared<BVERK4>(0.01, 2*PI);
+  solver->init(nv, nf);
+
+  std::ostringstream ss;
+  ss << "BVERK4_" << seed_type::idString() << depth << "_" << nsteps << "steps";
+  PerfWorkload w;
+  w.name = ss.str();
+  w.run = [=] () mutable {
+    for (Int k=0; k<nsteps; ++k) {
+      solver->advance_timestep(mesh->physVerts.crds, vzeta, vvel, mesh->physFaces.crds, fzeta, fvel,
+        mesh->faces.area, mesh->faces.mask);
+    }
+  };
+  return w;
+}
+
+/// Octree construction over npts points on the unit sphere (Fibonacci lattice)
+PerfWorkload octree_workload(const Index npts, const Int depth) {
+  ko::View<Real*[3]> pts("octree_pts", npts);
+  const Real golden_angle = PI*(3 - std::sqrt(5.0));
+  ko::parallel_for(npts, KOKKOS_LAMBDA (const Index& i) {
+    const Real z = 1 - (2*i + 1)/Real(npts);
+    const Real r = std::sqrt(1 - z*z);
+    pts(i,0) = r*std::cos(golden_angle*i);
+    pts(i,1) = r*std::sin(golden_angle*i);
+    pts(i,2) = z;
+  });
+
+  std::ostringstream ss;
+  ss << "OctreeBuild_" << npts << "pts_depth" << depth;
+  PerfWorkload w;
+  w.name = ss.str();
+  w.run = [pts, depth] () {
+    Octree::Tree tree(pts, depth);
+  };
+  return w;
+}
+
+/// Mesh allocation and uniform refinement
+template <typename SeedType>
+PerfWorkload tree_init_workload(const Int depth) {
+  std::ostringstream ss;
+  ss << "treeInit_" << SeedType::idString() << depth;
+  PerfWorkload w;
+  w.name = ss.str();
+  w.run = [depth] () {
+    Index nmaxverts, nmaxedges, nmaxfaces;
+    MeshSeed<SeedType> seed;
+    seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+    PolyMesh2d<SeedType> mesh(nmaxverts, nmaxedges, nmaxfaces);
+    mesh.treeInit(depth, seed);
+  };
+  return w;
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+bool pass = true;
+{
+  PerfInput input(argc, argv);
+  const std::string exec_space = ko::DefaultExecutionSpace::name();
+
+  std::vector<PerfWorkload> workloads;
+  poissonWorkloads(workloads);
+  workloads.push_back(bve_workload(5, 10));
+  workloads.push_back(octree_workload(1000000, 8));
+  workloads.push_back(tree_init_workload<CubedSphereSeed>(7));
+
+  std::cout << "performance regression: " << workloads.size() << " workloads, " << input.nrepeat
+            << " repetitions each, execution space " << exec_space << "\n";
+  auto results = runWorkloads(workloads, input.nrepeat);
+  workloads.clear();
+
+  PerfBaseline baseline;
+  const bool have_baseline = baseline.read(input.baseline_file);
+  if (have_baseline && !input.write_baseline) {
+    LPM_THROW_IF(baseline.execution_space != exec_space, "baseline " << input.baseline_file
+      << " was recorded with execution space " << baseline.execution_space << ", not " << exec_space
+      << "; record a new baseline with -w.");
+    Int nregressed = 0;
+    for (auto& r : results) {
+      const auto it = baseline.times.find(r.name);
+      r.baseline = (it != baseline.times.end() ? it->second : 0);
+      std::cout << r.infoString(input.tolerance);
+      if (r.regressed(input.tolerance)) ++nregressed;
+    }
+    if (nregressed > 0) {
+      std::cout << nregressed << " workload(s) regressed by more than " << 100*input.tolerance
+                << "% relative to " << input.baseline_file << "\n";
+      pass = false;
+    }
+  }
+  else {
+    baseline.execution_space = exec_space;
+    baseline.times.clear();
+    for (const auto& r : results) {
+      std::cout << r.infoString(input.tolerance);
+      baseline.times[r.name] = r.time;
+    }
+    baseline.write(input.baseline_file);
+    std::cout << "baseline written to " << input.baseline_file << "\n";
+  }
+}
+if (pass) std::cout << "tests pass" << std::endl;
+ko::finalize();
+return (pass ? 0 : 1);
+}
+
+namespace Lpm {
+
+std::vector<PerfResult> runWorkloads(const std::vector<PerfWorkload>& workloads, const Int nrepeat) {
+  std::vector<PerfResult> results;
+  for (const auto& w : workloads) {
+    ko::Profiling::pushRegion("perf " + w.name);
+    w.run(); // warm up
+    ko::fence();
+    Real best = std::numeric_limits<Real>::max();
+    for (Int k=0; k<nrepeat; ++k) {
+      auto t0 = tic();
+      w.run();
+      best = std::min(best, Real(toc(t0)));
+    }
+    ko::Profiling::popRegion();
+    PerfResult r;
+    r.name = w.name;
+    r.time = best;
+    r.baseline = 0;
+    results.push_back(r);
+  }
+  return results;
+}
+
+std::string PerfResult::infoString(const Real tol) const {
+  std::ostringstream ss;
+  ss << std::setw(36) << std::left << name << std::right << std::setw(14) << time << " s";
+  if (baseline > 0) {
+    ss << std::setw(14) << baseline << " s baseline" << std::setw(10) << std::setprecision(3) << ratio()
+       << "x" << (regressed(tol) ? "  ** REGRESSION **" : "");
+  }
+  else {
+    ss << "  (no baseline)";
+  }
+  ss << "\n";
+  return ss.str();
+}
+
+bool PerfBaseline::read(const std::string& fname) {
+  std::ifstream f(fname);
+  if (!f.is_open()) return false;
+  execution_space.clear();
+  times.clear();
+  std::string line;
+  while (std::getline(f, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    if (!(ss >> key)) continue;
+    if (key == "#") {
+      std::string field;
+      if (ss >> field && field == "execution_space") ss >> execution_space;
+      continue;
+    }
+    Real t;
+    LPM_THROW_IF(!(ss >> t), "PerfBaseline::read error: bad line '" << line << "' in " << fname);
+    times[key] = t;
+  }
+  return true;
+}
+
+void PerfBaseline::write(const std::string& fname) const {
+  std::ofstream f(fname);
+  LPM_THROW_IF(!f.is_open(), "PerfBaseline::write error: cannot open " << fname);
+  f << "# lpmPerfRegression baseline: workload, fastest time (s)\n";
+  f << "# execution_space " << execution_space << "\n";
+  f << std::setprecision(8);
+  for (const auto& t : times) {
+    f << t.first << " " << t.second << "\n";
+  }
+}
+
+PerfInput::PerfInput(int argc, char* argv[]) {
+  baseline_file = "lpm_perf_baseline.txt";
+  tolerance = 0.25;
+  nrepeat = 3;
+  write_baseline = false;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-b") {
+      baseline_file = argv[++i];
+    }
+    else if (token == "-tol") {
+      tolerance = std::stod(argv[++i]);
+    }
+    else if (token == "-n") {
+      nrepeat = std::stoi(argv[++i]);
+    }
+    else if (token == "-w") {
+      write_baseline = true;
+    }
+  }
+  LPM_THROW_IF(tolerance < 0, "PerfInput: tolerance must be nonnegative.");
+  LPM_THROW_IF(nrepeat < 1, "PerfInput: nrepeat must be positive.");
+}
+
+}
@@ -0,0 +1,70 @@
+#ifndef LPM_PERF_REGRESSION_HPP
+#define LPM_PERF_REGRESSION_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Lpm {
+
+/** @brief Performance regression options.
+
+  usage: lpmPerfRegression [-b baseline_file] [-tol tolerance] [-n nrepeat] [-w]
+
+  Each workload is timed nrepeat times (after one untimed warm-up run) and its fastest time is compared to
+  the baseline.  A workload regresses if time > (1 + tolerance) * baseline time.  With -w, or if the
+  baseline file does not exist, the measured times are written to the baseline file instead.
+*/
+struct PerfInput {
+  PerfInput(int argc, char* argv[]);
+
+  std::string baseline_file;
+  Real tolerance;
+  Int nrepeat;
+  bool write_baseline;
+};
+
+/// Timing of one workload and its comparison to the baseline
+struct PerfResult {
+  std::string name;
+  Real time; ///< fastest of nrepeat runs, seconds
+  Real baseline; ///< baseline time, seconds, or 0 if the workload is not in the baseline
+
+  inline Real ratio() const {return (baseline > 0 ? time/baseline : 0);}
+  inline bool regressed(const Real tol) const {return baseline > 0 && time > (1 + tol)*baseline;}
+  std::string infoString(const Real tol) const;
+};
+
+/// A named workload; setup belongs in the enclosing scope so that only the call to run is timed
+struct PerfWorkload {
+  std::string name;
+  std::function<void()> run;
+};
+
+/** @brief Stored workload times for one machine and Kokkos execution space.
+
+  File format: one "name seconds" pair per line; lines starting with '#' are comments, except for the
+  "# execution_space <name>" line.
+*/
+struct PerfBaseline {
+  std::string execution_space;
+  std::map<std::string, Real> times;
+
+  /// returns false if the file cannot be opened
+  bool read(const std::string& fname);
+  void write(const std::string& fname) const;
+};
+
+/// Times each workload; returns the fastest of nrepeat runs for each
+std::vector<PerfResult> runWorkloads(const std::vector<PerfWorkload>& workloads, const Int nrepeat);
+
+/// SpherePoisson workloads; defined in a separate translation unit
+void poissonWorkloads(std::vector<PerfWorkload>& workloads);
+
+}
+#endif
@@ -0,0 +1,35 @@
+#include "LpmPerfRegression.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmSpherePoisson.hpp"
+
+#include <memory>
+#include <sstream>
+
+namespace Lpm {
+
+/// SpherePoisson solve (vertex and face direct sums plus error norms) on an icosahedral sphere
+template <typename SeedType>
+PerfWorkload poissonWorkload(const Int depth) {
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<SeedType> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+  auto sphere = std::make_shared<SpherePoisson<SeedType>>(nmaxverts, nmaxedges, nmaxfaces);
+  sphere->treeInit(depth, seed);
+  sphere->updateDevice();
+  sphere->init();
+
+  std::ostringstream ss;
+  ss << "SpherePoisson_" << SeedType::idString() << depth;
+  PerfWorkload w;
+  w.name = ss.str();
+  w.run = [sphere] () {
+    sphere->solve();
+  };
+  return w;
+}
+
+void poissonWorkloads(std::vector<PerfWorkload>& workloads) {
+  workloads.push_back(poissonWorkload<IcosTriSphereSeed>(5));
+}
+
+}
@@ -35,6 +35,7 @@ struct Input {
 
   Int max_depth;
   std::string case_name;
+  Real cutoff;
 };
 
 struct Output {
@@ -47,10 +48,17 @@ struct Output {
   std::vector<Real> lap_linf_rate_verts;
   std::vector<Real> lap_linf_rate_faces;
   std::vector<Real> lap_l2_rate_faces;;
+  std::vector<Real> lap_cutoff_diff;
+  std::vector<Real> interp_cutoff_diff;
+  std::vector<Real> full_time;
+  std::vector<Real> cutoff_time;
+  Real cutoff;
 
-  Output(const int ntrials) : nsrc(ntrials), dx(ntrials), eps(ntrials),
+  Output(const int ntrials, const Real k) : nsrc(ntrials), dx(ntrials), eps(ntrials),
     lap_linf_verts(ntrials), lap_l2_faces(ntrials), lap_linf_faces(ntrials),
-    lap_linf_rate_verts(ntrials), lap_l2_rate_faces(ntrials), lap_linf_rate_faces(ntrials) {}
+    lap_linf_rate_verts(ntrials), lap_l2_rate_faces(ntrials), lap_linf_rate_faces(ntrials),
+    lap_cutoff_diff(ntrials), interp_cutoff_diff(ntrials), full_time(ntrials), cutoff_time(ntrials),
+    cutoff(k) {}
 
   std::string infoString() const;
 
@@ -70,7 +78,7 @@ ko::initialize(argc, argv);
   Index nv, ne, nf;
 
   const Short ntrials = max_tree_depth - 2 +1;
-  Output output(ntrials);
+  Output output(ntrials, input.cutoff);
 
   for (Short trial_ind = 0; trial_ind < ntrials; ++trial_ind) {
 
@@ -112,12 +120,62 @@ ko::initialize(argc, argv);
     });
 
     ko::TeamPolicy<> vertex_policy(plane->nvertsHost(), ko::AUTO());
+    ko::TeamPolicy<> face_policy(plane->nfacesHost(), ko::AUTO());
+    scalar_view_type vert_interp("vert_interp", plane->nvertsHost());
+    auto full_start = tic();
     ko::parallel_for(vertex_policy, PlanePSELaplacian(vert_lap_pse, vx, vert_data,
       fx, face_data, plane->faces.area, eps, plane->nfacesHost()));
-
-    ko::TeamPolicy<> face_policy(plane->nfacesHost(), ko::AUTO());
     ko::parallel_for(face_policy, PlanePSELaplacian(face_lap_pse, fx, face_data,
       fx, face_data, plane->faces.area, eps, plane->nfacesHost()));
+    ko::parallel_for(vertex_policy, PlanePSEScalarInterp(vert_interp, vx, fx, face_data,
+      plane->faces.area, plane->faces.mask, eps, plane->nfacesHost()));
+    output.full_time[trial_ind] = toc(full_start);
+
+    /// compact (cutoff) evaluation of the same quantities
+    scalar_view_type vert_lap_cutoff("vert_lap_cutoff", plane->nvertsHost());
+    scalar_view_type face_lap_cutoff("face_lap_cutoff", plane->nfacesHost());
+    scalar_view_type vert_interp_cutoff("vert_interp_cutoff", plane->nvertsHost());
+    auto cutoff_start = tic();
+    PlaneCellList face_cells;
+    face_cells.build(fx, plane->nfacesHost(), input.cutoff*eps, plane->faces.mask);
+    ko::parallel_for(vertex_policy, PlanePSELaplacianCutoff(vert_lap_cutoff, vx, vert_data,
+      fx, face_data, plane->faces.area, eps, face_cells, input.cutoff));
+    ko::parallel_for(face_policy, PlanePSELaplacianCutoff(face_lap_cutoff, fx, face_data,
+      fx, face_data, plane->faces.area, eps, face_cells, input.cutoff));
+    ko::parallel_for(vertex_policy, PlanePSEScalarInterpCutoff(vert_interp_cutoff, vx, fx, face_data,
+      plane->faces.area, plane->faces.mask, eps, face_cells, input.cutoff));
+    output.cutoff_time[trial_ind] = toc(cutoff_start);
+    std::cout << face_cells.infoString("faces", 1);
+
+    Real lap_max = 0;
+    Real lap_diff = 0;
+    Real interp_max = 0;
+    Real interp_diff = 0;
+    ko::parallel_reduce(plane->nvertsHost(), KOKKOS_LAMBDA (const Index& i, Real& m) {
+      if (std::abs(vert_lap_pse(i)) > m) m = std::abs(vert_lap_pse(i));
+    }, ko::Max<Real>(lap_max));
+    ko::parallel_reduce(plane->nvertsHost(), KOKKOS_LAMBDA (const Index& i, Real& m) {
+      const Real d = std::abs(vert_lap_pse(i) - vert_lap_cutoff(i));
+      if (d > m) m = d;
+    }, ko::Max<Real>(lap_diff));
+    Real face_lap_diff = 0;
+    ko::parallel_reduce(plane->nfacesHost(), KOKKOS_LAMBDA (const Index& i, Real& m) {
+      const Real d = std::abs(face_lap_pse(i) - face_lap_cutoff(i));
+      if (d > m) m = d;
+    }, ko::Max<Real>(face_lap_diff));
+    ko::parallel_reduce(plane->nvertsHost(), KOKKOS_LAMBDA (const Index& i, Real& m) {
+      if (std::abs(vert_interp(i)) > m) m = std::abs(vert_interp(i));
+    }, ko::Max<Real>(interp_max));
+    ko::parallel_reduce(plane->nvertsHost(), KOKKOS_LAMBDA (const Index& i, Real& m) {
+      const Real d = std::abs(vert_interp(i) - vert_interp_cutoff(i));
+      if (d > m) m = d;
+    }, ko::Max<Real>(interp_diff));
+    output.lap_cutoff_diff[trial_ind] = max(lap_diff, face_lap_diff)/lap_max;
+    output.interp_cutoff_diff[trial_ind] = interp_diff/interp_max;
+    if (input.cutoff >= PSE_CUTOFF_MULTIPLE) {
+      LPM_THROW_IF(output.lap_cutoff_diff[trial_ind] > 1.0e-8, "PSE Laplacian cutoff error too large.");
+      LPM_THROW_IF(output.interp_cutoff_diff[trial_ind] > 1.0e-8, "PSE interpolation cutoff error too large.");
+    }
 
     scalar_view_type vert_err("vert_err", plane->nvertsHost());
     ko::parallel_for(plane->nvertsHost(), KOKKOS_LAMBDA (const Index& i) {
@@ -187,6 +245,13 @@ std::string Output::infoString() const {
     ss << std::setw(fw) << lap_linf_faces[i] << std::setw(fw) << lap_linf_rate_faces[i];
     ss << '\n';
   }
+  ss << "PSE cutoff (" << cutoff << " eps) vs. full sum, max relative difference:\n";
+  ss << std::setw(fw) << "nsrc" << std::setw(fw) << "laplacian" << std::setw(fw) << "interp"
+     << std::setw(fw) << "t_full" << std::setw(fw) << "t_cutoff" << '\n';
+  for (int i=0; i<nsrc.size(); ++i) {
+    ss << std::setw(fw) << nsrc[i] << std::setw(fw) << lap_cutoff_diff[i] << std::setw(fw)
+       << interp_cutoff_diff[i] << std::setw(fw) << full_time[i] << std::setw(fw) << cutoff_time[i] << '\n';
+  }
 
   return ss.str();
 }
@@ -194,6 +259,7 @@ std::string Output::infoString() const {
 Input::Input(int argc, char* argv[]) {
   max_depth = 3;
   case_name = "pse_test";
+  cutoff = PSE_CUTOFF_MULTIPLE;
   for (Int i=1; i<argc; ++i) {
     const std::string& token = argv[i];
     if (token == "-d") {
@@ -202,5 +268,8 @@ Input::Input(int argc, char* argv[]) {
     else if (token == "-o") {
       case_name = argv[++i];
     }
+    else if (token == "-k") {
+      cutoff = std::stod(argv[++i]);
+    }
   }
 }
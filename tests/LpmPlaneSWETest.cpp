@@ -29,6 +29,7 @@ struct Input {
   Int max_depth;
   Int output_interval;
   Real mesh_radius;
+  Real pse_cutoff;
 
 };
 
@@ -64,7 +65,7 @@ ko::initialize(argc, argv);
   const Real f0 = problem_type::f0;
   const Real beta = problem_type::beta;
   const Real eps = pse_eps(plane->appx_mesh_size());
-  SWERK4<seed_type,problem_type> solver(plane, dt, eps);
+  SWERK4<seed_type,problem_type> solver(plane, dt, eps, input.pse_cutoff);
 //   std::cout << solver.infoString();
 
   Timer single_output_timer("output");
@@ -123,6 +124,7 @@ Input::Input(int argc, char* argv[]) {
   max_depth = 3;
   output_interval = 1;
   mesh_radius = 6.0;
+  pse_cutoff = 0;
   for (Int i=1; i<argc; ++i) {
     const std::string& token = argv[i];
     if (token == "-d") {
@@ -143,5 +145,8 @@ Input::Input(int argc, char* argv[]) {
     else if (token == "-r") {
       mesh_radius = std::stod(argv[++i]);
     }
+    else if (token == "-k") {
+      pse_cutoff = std::stod(argv[++i]);
+    }
   }
 }
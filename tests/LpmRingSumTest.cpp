@@ -0,0 +1,158 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmRingSum.hpp"
+#include "LpmBVERK4.hpp"
+#include "LpmBVERK4_Impl.hpp"
+#include "LpmTestUtil.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <cmath>
+#include <iostream>
+
+using namespace Lpm;
+
+/**
+  Each MPI rank builds the same mesh; the stream function and velocity at vertices and faces are computed
+  with RingDirectSum and compared to the single-process results of BVEVertexSolve and BVEFaceSolve.
+  A BVERK4 time step with ring velocity sums is compared to a single-process step.
+
+  usage: mpirun -np <n> lpmRingSumTest
+*/
+
+int main(int argc, char* argv[]) {
+MPI_Init(&argc, &argv);
+ko::initialize(argc, argv);
+{
+  Int rank, nranks;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 4;
+  const Real tol = 1.0e-12;
+
+  MeshSeed<seed_type> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  PolyMesh2d<seed_type> mesh(nmaxverts, nmaxedges, nmaxfaces);
+  mesh.treeInit(tree_depth, seed);
+  const Index nv = mesh.nvertsHost();
+  const Index nf = mesh.nfacesHost();
+
+  /// Rossby-Haurwitz-like vorticity
+  scalar_view_type zeta("zeta", nf);
+  const auto fx = mesh.physFaces.crds;
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    zeta(i) = fx(i,2) + 0.5*fx(i,0)*fx(i,1);
+  });
+
+  /// reference: single-process direct sums
+  scalar_view_type vpsi_ref("vpsi_ref", nv);
+  vec_view vu_ref("vu_ref", nv);
+  scalar_view_type fpsi_ref("fpsi_ref", nf);
+  vec_view fu_ref("fu_ref", nf);
+  ko::parallel_for(ko::TeamPolicy<>(nv, ko::AUTO()), BVEVertexSolve(vpsi_ref, vu_ref, mesh.physVerts.crds,
+    fx, zeta, mesh.faces.area, mesh.faces.mask, nf));
+  ko::parallel_for(ko::TeamPolicy<>(nf, ko::AUTO()), BVEFaceSolve(fpsi_ref, fu_ref, fx, zeta,
+    mesh.faces.area, mesh.faces.mask, nf));
+
+  /// distributed
+  RingDirectSum ring(MPI_COMM_WORLD);
+  scalar_view_type vpsi("vpsi", nv);
+  vec_view vu("vu", nv);
+  scalar_view_type fpsi("fpsi", nf);
+  vec_view fu("fu", nf);
+  MPI_Barrier(MPI_COMM_WORLD);
+  auto t0 = tic();
+  ring.solve(vpsi, vu, fpsi, fu, mesh, zeta);
+  const Real ring_time = toc(t0);
+  std::cout << ring.infoString();
+
+  Index nleaves;
+  const Index nlocal = ring.nLocalSources();
+  MPI_Allreduce(&nlocal, &nleaves, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  LPM_THROW_IF(nleaves != mesh.faces.nLeavesHost(), "sources lost in compaction.");
+
+  const Real vpsi_err = max_rel_diff(vpsi_ref, vpsi, nv);
+  const Real vu_err = max_rel_diff(vu_ref, vu, nv);
+  const Real fpsi_err = max_rel_diff(fpsi_ref, fpsi, nf);
+  const Real fu_err = max_rel_diff(fu_ref, fu, nf);
+  if (rank == 0) {
+    std::cout << nranks << " ranks, " << nv << " vertices, " << nf << " faces: ring solve " << ring_time << " s\n";
+    std::cout << "rel. diff. vs. single process: vertex psi " << vpsi_err << ", vertex u " << vu_err
+              << ", face psi " << fpsi_err << ", face u " << fu_err << "\n";
+  }
+  LPM_THROW_IF(vpsi_err > tol || vu_err > tol, "vertex results differ from single-process sums.");
+  LPM_THROW_IF(fpsi_err > tol || fu_err > tol, "face results differ from single-process sums.");
+
+  /// second solve reuses the buffers
+  ring.solve(vpsi, vu, fpsi, fu, mesh, zeta);
+  LPM_THROW_IF(max_rel_diff(fu_ref, fu, nf) > tol, "repeated solve differs.");
+
+  /// velocity only, vertices and faces in one ring pass
+  scalar_view_type nopsi;
+  vec_view vu_only("vu_only", nv);
+  vec_view fu_only("fu_only", nf);
+  ring.computeGathered(nopsi, vu_only, nopsi, fu_only, mesh.physVerts.crds, nv, fx, nf);
+  LPM_THROW_IF(max_rel_diff(vu_ref, vu_only, nv) > tol || max_rel_diff(fu_ref, fu_only, nf) > tol,
+    "velocity-only ring sum differs.");
+
+  /// BVERK4 time step, single-process (k = 0) and distributed (k = 1)
+  const auto vx0 = mesh.physVerts.crds;
+  crd_view step_vx[2];
+  scalar_view_type step_vzeta[2];
+  vec_view step_vu[2];
+  crd_view step_fx[2];
+  scalar_view_type step_fzeta[2];
+  vec_view step_fu[2];
+  for (Int k=0; k<2; ++k) {
+    step_vx[k] = crd_view("step_vx", nv);
+    step_vzeta[k] = scalar_view_type("step_vzeta", nv);
+    step_vu[k] = vec_view("step_vu", nv);
+    step_fx[k] = crd_view("step_fx", nf);
+    step_fzeta[k] = scalar_view_type("step_fzeta", nf);
+    step_fu[k] = vec_view("step_fu", nf);
+    ko::deep_copy(step_vx[k], vx0);
+    ko::deep_copy(step_vu[k], vu_ref);
+    ko::deep_copy(step_fx[k], fx);
+    ko::deep_copy(step_fzeta[k], zeta);
+    ko::deep_copy(step_fu[k], fu_ref);
+    auto vzeta = step_vzeta[k];
+    ko::parallel_for(nv, KOKKOS_LAMBDA (const Index& i) {
+      vzeta(i) = vx0(i,2) + 0.5*vx0(i,0)*vx0(i,1);
+    });
+  }
+  BVERK4 local_solver(0.01, 2*PI);
+  local_solver.symmetric_faces = false;
+  local_solver.init(nv, nf);
+  local_solver.advance_timestep(step_vx[0], step_vzeta[0], step_vu[0], step_fx[0], step_fzeta[0], step_fu[0],
+    mesh.faces.area, mesh.faces.mask);
+  BVERK4 ring_solver(0.01, 2*PI);
+  ring_solver.time_velocity = true;
+  ring_solver.init(nv, nf);
+  ring_solver.set_ring(std::shared_ptr<RingDirectSum>(new RingDirectSum(MPI_COMM_WORLD)));
+  ring_solver.advance_timestep(step_vx[1], step_vzeta[1], step_vu[1], step_fx[1], step_fzeta[1], step_fu[1],
+    mesh.faces.area, mesh.faces.mask);
+  LPM_THROW_IF(ring_solver.velocity_time <= 0, "velocity time not recorded.");
+  LPM_THROW_IF(local_solver.velocity_time != 0, "velocity time recorded without time_velocity.");
+
+  const Real step_vx_err = max_rel_diff(step_vx[0], step_vx[1], nv);
+  const Real step_fu_err = max_rel_diff(step_fu[0], step_fu[1], nf);
+  if (rank == 0) {
+    std::cout << "BVERK4 step rel. diff. vs. single process: vertex x " << step_vx_err << ", face u "
+              << step_fu_err << "\n";
+  }
+  LPM_THROW_IF(step_vx_err > tol || step_fu_err > tol, "distributed BVERK4 step differs from single process.");
+}
+MPI_Barrier(MPI_COMM_WORLD);
+int rank;
+MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+if (rank == 0) std::cout << "tests pass" << std::endl;
+ko::finalize();
+MPI_Finalize();
+return 0;
+}
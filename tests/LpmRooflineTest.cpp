@@ -0,0 +1,75 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmRoofline.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmSWEKernels.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <iostream>
+
+using namespace Lpm;
+
+/**
+  Checks that kernel functors declare consistent PairWork, that the machine peak probes return positive
+  rates, and that rooflineParallelFor records launches, pairs, and time only when enabled.
+*/
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  /// team functors declare the sum of their reductions
+  const PairWork stream = pairWork<StreamReduceDistinct>();
+  const PairWork vel = pairWork<VelocityReduceDistinct>();
+  const PairWork solve = pairWork<BVEVertexSolve>();
+  LPM_THROW_IF(solve.flops != stream.flops + vel.flops, "BVEVertexSolve flops inconsistent.");
+  LPM_THROW_IF(solve.bytes != stream.bytes + vel.bytes, "BVEVertexSolve bytes inconsistent.");
+  LPM_THROW_IF(pairWork<PlanarSWEDirectSum>().transcendentals < 1, "PSE exponential not counted.");
+  LPM_THROW_IF(pairWork<PlanarSWEDirectSum>().flops <= pairWork<PlanarSWEVelocityReduce>().flops,
+    "PSE term not counted.");
+
+  const MachinePeaks peaks = MachinePeaks::measure(1<<20, 2);
+  std::cout << peaks.infoString();
+  LPM_THROW_IF(!(peaks.gflops > 0 && peaks.gbytes_per_s > 0), "machine peaks not measured.");
+
+  typedef CubedSphereSeed seed_type;
+  const Int tree_depth = 3;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+  PolyMesh2d<seed_type> mesh(nmaxverts, nmaxedges, nmaxfaces);
+  mesh.treeInit(tree_depth, seed);
+  const Index nv = mesh.nvertsHost();
+  const Index nf = mesh.nfacesHost();
+  const Real npairs = Real(nv)*mesh.faces.nLeavesHost();
+  scalar_view_type zeta("zeta", nf);
+  scalar_view_type psi("psi", nv);
+  vec_view u("u", nv);
+  ko::deep_copy(zeta, 1);
+  const BVEVertexSolve f(psi, u, mesh.physVerts.crds, mesh.physFaces.crds, zeta, mesh.faces.area,
+    mesh.faces.mask, nf);
+
+  auto& roofline = RooflineRegistry::instance();
+  roofline.setPeaks(peaks);
+  roofline.reset();
+  rooflineParallelFor("BVEVertexSolve", ko::TeamPolicy<>(nv, ko::AUTO()), f, npairs);
+  LPM_THROW_IF(roofline.stats("BVEVertexSolve").launches != 0, "disabled registry should not record.");
+
+  roofline.setEnabled(true);
+  for (Int k=0; k<3; ++k) {
+    rooflineParallelFor("BVEVertexSolve", ko::TeamPolicy<>(nv, ko::AUTO()), f, npairs);
+  }
+  const auto s = roofline.stats("BVEVertexSolve");
+  std::cout << roofline.summaryString();
+  LPM_THROW_IF(s.launches != 3, "launches not recorded.");
+  LPM_THROW_IF(s.pairs != 3*npairs, "pairs not recorded.");
+  LPM_THROW_IF(!(s.seconds > 0 && s.gflops() > 0 && s.gbytesPerSecond() > 0), "rates not computed.");
+  LPM_THROW_IF(s.work.flops != solve.flops, "kernel work not recorded.");
+  const std::string b = roofline.bound(solve);
+  LPM_THROW_IF(b != "compute" && b != "memory", "invalid bound.");
+  roofline.setEnabled(false);
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
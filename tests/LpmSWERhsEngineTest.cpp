@@ -0,0 +1,135 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmUtilities.hpp"
+#include "LpmPSE.hpp"
+#include "LpmSWEKernels.hpp"
+#include "LpmSWERhsEngine.hpp"
+#include "LpmTestUtil.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+using namespace Lpm;
+
+/**
+  Compares the PSE methods of PlanarSWERhsEngine against the fused direct sum and reports timings.
+
+  usage: lpmSWERhsEngineTest [-d tree_depth] [-k cutoff_multiple]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Int max_depth;
+  Real cutoff;
+};
+
+struct EngineResult {
+  typedef typename PlaneGeometry::vec_view_type vec_view;
+  vec_view vertvel;
+  scalar_view_type vertddot;
+  scalar_view_type vertlaps;
+  vec_view facevel;
+  scalar_view_type faceddot;
+  scalar_view_type facelaps;
+  Real elapsed;
+
+  EngineResult(const Index nv, const Index nf) : vertvel("vertvel", nv), vertddot("vertddot", nv),
+    vertlaps("vertlaps", nv), facevel("facevel", nf), faceddot("faceddot", nf), facelaps("facelaps", nf),
+    elapsed(0) {}
+};
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+  typedef QuadRectSeed seed_type;
+  const Real mesh_radius = 6;
+  MeshSeed<seed_type> seed(mesh_radius);
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, input.max_depth);
+  PolyMesh2d<seed_type> plane(nmaxverts, nmaxedges, nmaxfaces);
+  plane.treeInit(input.max_depth, seed);
+
+  const Index nv = plane.nvertsHost();
+  const Index nf = plane.nfacesHost();
+  const Real eps = pse_eps(plane.appx_mesh_size());
+
+  /// smooth vorticity, divergence, and surface height
+  const auto vx = plane.physVerts.crds;
+  const auto fx = plane.physFaces.crds;
+  const auto fmask = plane.faces.mask;
+  scalar_view_type vsfc("vert_sfc", nv);
+  scalar_view_type fsfc("face_sfc", nf);
+  scalar_view_type fzeta("face_zeta", nf);
+  scalar_view_type fdiv("face_div", nf);
+  ko::parallel_for(nv, KOKKOS_LAMBDA (const Index& i) {
+    vsfc(i) = 1 + 0.1*std::exp(-(square(vx(i,0)) + square(vx(i,1))));
+  });
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    const Real gauss = std::exp(-(square(fx(i,0)) + square(fx(i,1))));
+    fsfc(i) = 1 + 0.1*gauss;
+    fzeta(i) = (fmask(i) ? 0 : gauss);
+    fdiv(i) = (fmask(i) ? 0 : fx(i,0)*gauss);
+  });
+
+  const SWEPSEMethod methods[3] = {FusedPSE, DirectPSE, CutoffPSE};
+  std::vector<EngineResult> results;
+  for (Int k=0; k<3; ++k) {
+    PlanarSWERhsEngine engine(methods[k], input.cutoff);
+    EngineResult r(nv, nf);
+    engine.compute(r.vertvel, r.vertddot, r.vertlaps, vx, vsfc, nv,
+      r.facevel, r.faceddot, r.facelaps, fx, fzeta, fdiv, plane.faces.area, fsfc, fmask, nf, eps); // warm up
+    auto t0 = tic();
+    engine.compute(r.vertvel, r.vertddot, r.vertlaps, vx, vsfc, nv,
+      r.facevel, r.faceddot, r.facelaps, fx, fzeta, fdiv, plane.faces.area, fsfc, fmask, nf, eps);
+    r.elapsed = toc(t0);
+    std::cout << engine.infoString(swePSEMethodString(methods[k]));
+    results.push_back(r);
+  }
+
+  const Int fw = 14;
+  std::cout << "planar SWE rhs engine: " << seed_type::idString() << " depth " << input.max_depth
+            << ", nverts = " << nv << ", nfaces = " << nf << ", eps = " << eps << "\n";
+  std::cout << std::setw(fw) << "pse method" << std::setw(fw) << "time (s)" << std::setw(fw)
+            << "vel. diff" << std::setw(fw) << "ddot diff" << std::setw(fw) << "lap. diff" << "\n";
+  for (Int k=0; k<3; ++k) {
+    const Real vel_diff = max(max_rel_diff(results[0].vertvel, results[k].vertvel, nv),
+      max_rel_diff(results[0].facevel, results[k].facevel, nf));
+    const Real ddot_diff = max(max_rel_diff(results[0].vertddot, results[k].vertddot, nv),
+      max_rel_diff(results[0].faceddot, results[k].faceddot, nf));
+    const Real lap_diff = max(max_rel_diff(results[0].vertlaps, results[k].vertlaps, nv),
+      max_rel_diff(results[0].facelaps, results[k].facelaps, nf));
+    std::cout << std::setw(fw) << swePSEMethodString(methods[k]) << std::setw(fw) << results[k].elapsed
+              << std::setw(fw) << vel_diff << std::setw(fw) << ddot_diff << std::setw(fw) << lap_diff << "\n";
+    LPM_THROW_IF(vel_diff > 1.0e-12, "velocity differs between engine methods.");
+    LPM_THROW_IF(ddot_diff > 1.0e-12, "velocity gradient differs between engine methods.");
+    if (input.cutoff >= PSE_CUTOFF_MULTIPLE) {
+      LPM_THROW_IF(lap_diff > 1.0e-8, "PSE Laplacian differs between engine methods.");
+    }
+  }
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  max_depth = 4;
+  cutoff = PSE_CUTOFF_MULTIPLE;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-d") {
+      max_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-k") {
+      cutoff = std::stod(argv[++i]);
+    }
+  }
+}
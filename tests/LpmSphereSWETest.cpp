@@ -0,0 +1,144 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmShallowWater.hpp"
+#include "LpmShallowWater_Impl.hpp"
+#include "LpmSWEGallery.hpp"
+#include "LpmSWEKernels.hpp"
+#include "LpmTimer.hpp"
+#include "LpmSWERK4.hpp"
+#include "LpmSWERK4_Impl.hpp"
+#include "LpmPSE.hpp"
+#include "LpmErrorNorms.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+using namespace Lpm;
+
+/**
+  Advances the steady geostrophic balance test case (Williamson et al. 1992, case 2)
+  on the rotating sphere and measures the departure from the initial state.
+
+  usage: lpmSWESphereTest [-d tree_depth] [-dt time_step] [-tf final_time]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Real dt;
+  Real tfinal;
+  Int max_depth;
+};
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Timer total_timer("total");
+  total_timer.start();
+
+  Input input(argc, argv);
+  typedef IcosTriSphereSeed seed_type;
+  typedef SphereGeostrophicBalance problem_type;
+
+  const Index tree_depth = input.max_depth;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  MeshSeed<seed_type> seed;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, tree_depth);
+
+  auto sphere = std::shared_ptr<ShallowWater<seed_type>>(new ShallowWater<seed_type>(
+    nmaxverts, nmaxedges, nmaxfaces));
+  sphere->treeInit(tree_depth, seed);
+  sphere->init_problem<problem_type>();
+  const Real mass0 = sphere->total_mass_integral();
+
+  const Real eps = pse_eps(sphere->appx_mesh_size());
+  const Int ntimesteps = std::floor(input.tfinal/input.dt);
+  const Real dt = input.tfinal/ntimesteps;
+  SWERK4<seed_type,problem_type> solver(sphere, dt, eps);
+  std::cout << sphere->infoString("sphere_swe_init", 0, (tree_depth < 2));
+  std::cout << "\tdt = " << dt << ", eps = " << eps << ", nsteps = " << ntimesteps << "\n";
+
+  Timer step_timer("time steps");
+  step_timer.start();
+  for (Int time_ind = 0; time_ind < ntimesteps; ++time_ind) {
+    solver.advance_timestep();
+  }
+  step_timer.stop();
+
+  /// the flow is steady and zonally symmetric; compare with the initial condition at current positions
+  const Index nf = sphere->nfacesHost();
+  const auto facex = sphere->physFaces.crds;
+  const auto facesfc = sphere->surfaceHeightFaces;
+  const auto facediv = sphere->divFaces;
+  const auto fmask = sphere->faces.mask;
+  SphereGeometry::vec_view_type face_velocity_error("face_velocity_error", nf);
+  SphereGeometry::vec_view_type fexactvel("exact_velocity", nf);
+  scalar_view_type face_sfc_error("face_sfc_error", nf);
+  scalar_view_type fexactsfc("exact_sfc", nf);
+  ko::parallel_for("exact solution", nf, KOKKOS_LAMBDA (const Index& i) {
+    const auto mcrd = ko::subview(facex, i, ko::ALL());
+    auto uv = ko::subview(fexactvel, i, ko::ALL());
+    problem_type::u0(uv, mcrd);
+    fexactsfc(i) = problem_type::sfc0(mcrd);
+  });
+  Real max_div;
+  ko::parallel_reduce("max divergence", nf, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    const Real absdiv = (fmask(i) ? 0 : std::abs(facediv(i)));
+    if (absdiv > m) m = absdiv;
+  }, ko::Max<Real>(max_div));
+
+  ErrNorms<> vel_err(face_velocity_error, sphere->velocityFaces, fexactvel, sphere->faces.area);
+  ErrNorms<> sfc_err(face_sfc_error, facesfc, fexactsfc, sphere->faces.area);
+  const Real mass_err = std::abs(sphere->total_mass_integral() - mass0)/mass0;
+
+  std::cout << vel_err.infoString("face velocity error");
+  std::cout << sfc_err.infoString("face surface height error");
+  std::cout << "max |divergence| = " << max_div << "\n";
+  std::cout << "relative mass change = " << mass_err << "\n";
+
+  total_timer.stop();
+  std::cout << step_timer.infoString();
+  std::cout << total_timer.infoString();
+
+  /** tolerances follow the O(h^2) quadrature error of the direct sums (h ~ 0.1 at the default depth 3).
+    The balanced state has zero divergence, so divergence measures the discrete imbalance; it is
+    compared with the vorticity scale, 2 u_max.  Surface height only changes through that divergence.
+  */
+  const Real h = sphere->appx_mesh_size();
+  const Real vel_tol = 2*square(h);
+  const Real sfc_tol = 0.1*square(h);
+  const Real div_tol = 2*square(h)*(2*problem_type::u_max);
+  std::cout << "tolerances: velocity " << vel_tol << ", surface height " << sfc_tol
+            << ", divergence " << div_tol << "\n";
+  LPM_THROW_IF(!(vel_err.l2 < vel_tol), "velocity error too large.");
+  LPM_THROW_IF(!(sfc_err.l2 < sfc_tol), "surface height error too large.");
+  LPM_THROW_IF(!(max_div < div_tol), "balanced flow developed divergence.");
+  LPM_THROW_IF(!(mass_err < 1.0e-10), "mass not conserved.");
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  dt = 0.01;
+  tfinal = 3*dt;
+  max_depth = 3;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-d") {
+      max_depth = std::stoi(argv[++i]);
+    }
+    else if (token == "-dt") {
+      dt = std::stod(argv[++i]);
+    }
+    else if (token == "-tf") {
+      tfinal = std::stod(argv[++i]);
+    }
+  }
+}
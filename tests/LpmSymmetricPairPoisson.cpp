@@ -0,0 +1,44 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmSpherePoisson.hpp"
+#include "LpmTestUtil.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include <iostream>
+
+namespace Lpm {
+
+/** @brief Compares SpherePoisson::solve with symmetric-pair face sums (sphereCollocatedSymmetricSolve)
+  against its team kernel (FaceSolve).
+
+  Kept in its own translation unit because the Poisson and BVE kernel headers cannot be included together.
+*/
+void symmetricPairPoissonTest(const Int depth) {
+  typedef IcosTriSphereSeed seed_type;
+  MeshSeed<seed_type> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, depth);
+  SpherePoisson<seed_type> sphere(nmaxverts, nmaxedges, nmaxfaces);
+  sphere.treeInit(depth, seed);
+  sphere.init();
+  const Index nf = sphere.nfacesHost();
+
+  sphere.solve(0, false);
+  scalar_view_type psi_team("psi_team", sphere.psifaces.extent(0));
+  vec_view u_team("u_team", sphere.ufaces.extent(0));
+  ko::deep_copy(psi_team, sphere.psifaces);
+  ko::deep_copy(u_team, sphere.ufaces);
+
+  sphere.solve(0, true);
+  const Real psi_diff = max_rel_diff(psi_team, sphere.psifaces, nf);
+  const Real vel_diff = max_rel_diff(u_team, sphere.ufaces, nf);
+  std::cout << "SpherePoisson face sums, symmetric vs. FaceSolve: psi diff " << psi_diff << ", vel. diff "
+            << vel_diff << "\n";
+
+  LPM_THROW_IF(psi_diff > 1.0e-12, "symmetric Poisson stream function differs from FaceSolve.");
+  LPM_THROW_IF(vel_diff > 1.0e-12, "symmetric Poisson velocity differs from FaceSolve.");
+}
+
+}
@@ -0,0 +1,131 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmGeometry.hpp"
+#include "LpmUtilities.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmSymmetricPairKernels.hpp"
+#include "LpmTestUtil.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+using namespace Lpm;
+
+namespace Lpm {
+/// SpherePoisson::solve, symmetric vs. FaceSolve (LpmSymmetricPairPoisson.cpp)
+void symmetricPairPoissonTest(const Int depth);
+}
+
+/**
+  Compares symmetric-pair evaluation of the collocated face sums (sphereCollocatedSymmetricSolve)
+  against the team kernels (BVEFaceSolve, and the Poisson FaceSolve via SpherePoisson::solve) and
+  reports timings.
+
+  usage: lpmSymmetricPairTest [-d tree_depth]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Int max_depth;
+};
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+
+  /// every tile of the upper triangle is visited exactly once, in row order
+  for (Index nb=1; nb<40; ++nb) {
+    Index t = 0;
+    for (Index ib=0; ib<nb; ++ib) {
+      for (Index jb=ib; jb<nb; ++jb) {
+        Index ii, jj;
+        upper_triangle_tile(ii, jj, t++, nb);
+        LPM_THROW_IF(ii != ib || jj != jb, "upper_triangle_tile error.");
+      }
+    }
+  }
+
+  typedef IcosTriSphereSeed seed_type;
+  MeshSeed<seed_type> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, input.max_depth);
+  PolyMesh2d<seed_type> sphere(nmaxverts, nmaxedges, nmaxfaces);
+  sphere.treeInit(input.max_depth, seed);
+
+  const Index nf = sphere.nfacesHost();
+  const auto fx = sphere.physFaces.crds;
+  const auto fa = sphere.faces.area;
+  const auto fmask = sphere.faces.mask;
+  scalar_view_type fzeta("face_zeta", nf);
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    fzeta(i) = (fmask(i) ? 0 : fx(i,2) + 3*fx(i,0)*fx(i,1)*fx(i,2));
+  });
+
+  scalar_view_type psi_team("psi_team", nf);
+  vec_view u_team("u_team", nf);
+  scalar_view_type psi_sym("psi_sym", nf);
+  vec_view u_sym("u_sym", nf);
+  vec_view u_sym_only("u_sym_only", nf);
+  scalar_view_type nopsi;
+
+  const ko::TeamPolicy<> policy(nf, ko::AUTO());
+  ko::parallel_for(policy, BVEFaceSolve(psi_team, u_team, fx, fzeta, fa, fmask, nf)); // warm up
+  auto t0 = tic();
+  ko::parallel_for(policy, BVEFaceSolve(psi_team, u_team, fx, fzeta, fa, fmask, nf));
+  ko::fence();
+  const Real team_time = toc(t0);
+
+  sphereCollocatedSymmetricSolve(psi_sym, u_sym, fx, fzeta, fa, fmask, nf); // warm up
+  t0 = tic();
+  sphereCollocatedSymmetricSolve(psi_sym, u_sym, fx, fzeta, fa, fmask, nf);
+  ko::fence();
+  const Real sym_time = toc(t0);
+
+  t0 = tic();
+  sphereCollocatedSymmetricSolve(nopsi, u_sym_only, fx, fzeta, fa, fmask, nf, false);
+  ko::fence();
+  const Real sym_vel_time = toc(t0);
+
+  const Real psi_diff = max_rel_diff(psi_team, psi_sym, nf);
+  const Real vel_diff = max_rel_diff(u_team, u_sym, nf);
+  const Real vel_only_diff = max_rel_diff(u_team, u_sym_only, nf);
+
+  const Int fw = 16;
+  std::cout << "collocated face sums: " << seed_type::idString() << " depth " << input.max_depth
+            << ", nfaces = " << nf << ", tile = " << SYMMETRIC_PAIR_TILE << "\n";
+  std::cout << std::setw(fw) << "method" << std::setw(fw) << "time (s)" << std::setw(fw)
+            << "psi diff" << std::setw(fw) << "vel. diff" << "\n";
+  std::cout << std::setw(fw) << "team" << std::setw(fw) << team_time << std::setw(fw) << 0
+            << std::setw(fw) << 0 << "\n";
+  std::cout << std::setw(fw) << "symmetric" << std::setw(fw) << sym_time << std::setw(fw) << psi_diff
+            << std::setw(fw) << vel_diff << "\n";
+  std::cout << std::setw(fw) << "symmetric, u" << std::setw(fw) << sym_vel_time << std::setw(fw) << "--"
+            << std::setw(fw) << vel_only_diff << "\n";
+
+  LPM_THROW_IF(psi_diff > 1.0e-12, "symmetric stream function differs from team kernel.");
+  LPM_THROW_IF(vel_diff > 1.0e-12, "symmetric velocity differs from team kernel.");
+  LPM_THROW_IF(vel_only_diff > 1.0e-12, "symmetric velocity (no stream fn.) differs from team kernel.");
+
+  symmetricPairPoissonTest(input.max_depth);
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  max_depth = 4;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-d") {
+      max_depth = std::stoi(argv[++i]);
+    }
+  }
+}
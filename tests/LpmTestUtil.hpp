@@ -0,0 +1,46 @@
+#ifndef LPM_TEST_UTIL_HPP
+#define LPM_TEST_UTIL_HPP
+
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <cmath>
+
+namespace Lpm {
+
+/// max. difference between two views, relative to the max. magnitude of the first
+template <typename ViewType>
+Real max_rel_diff(const ViewType& ref, const ViewType& val, const Index n) {
+  Real diff = 0;
+  Real refmax = 0;
+  const Int ncomp = ref.extent(1);
+  ko::parallel_reduce(n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    for (Int j=0; j<ncomp; ++j) {
+      const Real d = std::abs(ref(i,j) - val(i,j));
+      if (d > m) m = d;
+    }
+  }, ko::Max<Real>(diff));
+  ko::parallel_reduce(n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    for (Int j=0; j<ncomp; ++j) {
+      if (std::abs(ref(i,j)) > m) m = std::abs(ref(i,j));
+    }
+  }, ko::Max<Real>(refmax));
+  return diff/refmax;
+}
+
+inline Real max_rel_diff(const scalar_view_type& ref, const scalar_view_type& val, const Index n) {
+  Real diff = 0;
+  Real refmax = 0;
+  ko::parallel_reduce(n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    const Real d = std::abs(ref(i) - val(i));
+    if (d > m) m = d;
+  }, ko::Max<Real>(diff));
+  ko::parallel_reduce(n, KOKKOS_LAMBDA (const Index& i, Real& m) {
+    if (std::abs(ref(i)) > m) m = std::abs(ref(i));
+  }, ko::Max<Real>(refmax));
+  return diff/refmax;
+}
+
+}
+#endif
@@ -0,0 +1,102 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmTimer.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <iostream>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using namespace Lpm;
+
+/**
+  Checks TimerRegistry nesting, statistics, counters, and per-thread region stacks, and that the
+  LPM_TIMER_* macros record regions only when LPM_ENABLE_TIMERS is defined.
+*/
+
+/// sleeps for a few milliseconds inside nested regions
+void timed_work(const Int ms) {
+  ScopedTimer outer("outer");
+  {
+    ScopedTimer inner("inner");
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  }
+  TimerRegistry::instance().addCount("work calls");
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  auto& reg = TimerRegistry::instance();
+  reg.reset();
+  reg.setFence(true);
+
+  const Int ncalls = 3;
+  for (Int i=0; i<ncalls; ++i) {
+    timed_work(2*(i+1));
+  }
+
+  const auto outer = reg.stats("outer");
+  const auto inner = reg.stats("outer/inner");
+  LPM_THROW_IF(outer.count != ncalls || inner.count != ncalls, "wrong call count.");
+  LPM_THROW_IF(reg.stats("inner").count != 0, "nested region recorded at top level.");
+  LPM_THROW_IF(!(inner.min <= inner.mean() && inner.mean() <= inner.max), "inconsistent statistics.");
+  LPM_THROW_IF(inner.min < 1.0e-3 || inner.max < 5.0e-3, "region times too short.");
+  LPM_THROW_IF(outer.total < inner.total, "outer region shorter than nested region.");
+  LPM_THROW_IF(reg.counter("work calls") != ncalls, "counter mismatch.");
+  LPM_THROW_IF(reg.counter("unused") != 0, "unused counter should be zero.");
+
+  /// each thread has its own stack of open regions; only the main thread fences
+  LPM_THROW_IF(!reg.onMainThread(), "test thread should be the registry main thread.");
+  bool worker_main = true;
+  {
+    ScopedTimer main_region("main thread");
+    std::thread worker([&worker_main] () {
+      worker_main = TimerRegistry::instance().onMainThread();
+      timed_work(1);
+    });
+    worker.join();
+  }
+  reg.setFence(false);
+  LPM_THROW_IF(worker_main, "worker thread taken as registry main thread.");
+  LPM_THROW_IF(reg.stats("outer").count != ncalls+1, "worker thread region should not nest in main thread.");
+  LPM_THROW_IF(reg.stats("main thread/outer").count != 0, "regions nested across threads.");
+
+  /// mismatched stop
+  bool caught = false;
+  try {
+    reg.stop();
+  }
+  catch (std::logic_error&) {
+    caught = true;
+  }
+  LPM_THROW_IF(!caught, "stop without start not detected.");
+
+  /// macros
+  {
+    LPM_TIMER_SCOPE("macro scope");
+    LPM_TIMER_START("macro region");
+    LPM_COUNTER_ADD("macro counter", 2);
+    LPM_TIMER_STOP();
+  }
+#ifdef LPM_ENABLE_TIMERS
+  LPM_THROW_IF(reg.stats("macro scope/macro region").count != 1, "macro region not recorded.");
+  LPM_THROW_IF(reg.counter("macro counter") != 2, "macro counter not recorded.");
+#else
+  LPM_THROW_IF(reg.stats("macro scope").count != 0, "disabled macros should not record regions.");
+  LPM_THROW_IF(reg.counter("macro counter") != 0, "disabled macros should not record counters.");
+#endif
+
+  const std::string summary = reg.summaryString();
+  std::cout << summary;
+  LPM_THROW_IF(summary.find("inner") == std::string::npos || summary.find("work calls") == std::string::npos,
+    "summary is missing entries.");
+
+  reg.reset();
+  LPM_THROW_IF(reg.stats("outer").count != 0, "reset failed.");
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
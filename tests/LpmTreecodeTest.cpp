@@ -0,0 +1,137 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmBVEKernels.hpp"
+#include "LpmDecomposition.hpp"
+#include "LpmTreecode.hpp"
+
+#include "Kokkos_Core.hpp"
+#include <mpi.h>
+#include <cmath>
+#include <iostream>
+
+using namespace Lpm;
+
+/**
+  Each MPI rank builds the same mesh and owns the leaf faces and vertices given by a MortonDecomposition.
+  DistributedTreecode results at owned vertices and faces are compared to the single-process direct sums of
+  BVEVertexSolve and BVEFaceSolve:  theta = 0 must reproduce them to round-off, and the error must decrease
+  with theta.
+
+  usage: mpirun -np <n> lpmTreecodeTest
+*/
+
+/// max. abs. difference and max. abs. reference value over the given rows of two host arrays
+template <typename HostView, typename RowView>
+void owned_diff(Real& diff, Real& amax, const HostView& ref, const HostView& a, const RowView& rows) {
+  for (Index k=0; k<Index(rows.extent(0)); ++k) {
+    const Index i = rows(k);
+    for (Index j=0; j<Index(a.extent(1)); ++j) {
+      diff = std::max(diff, std::abs(ref.access(i,j) - a.access(i,j)));
+      amax = std::max(amax, std::abs(ref.access(i,j)));
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+MPI_Init(&argc, &argv);
+ko::initialize(argc, argv);
+{
+  Int rank, nranks;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  typedef CubedSphereSeed seed_type;
+  const Int mesh_depth = 5;
+  const Int octree_depth = 4;
+  const Real thetas[3] = {0, 0.3, 0.7};
+
+  MeshSeed<seed_type> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, mesh_depth);
+  PolyMesh2d<seed_type> mesh(nmaxverts, nmaxedges, nmaxfaces);
+  mesh.treeInit(mesh_depth, seed);
+  const Index nv = mesh.nvertsHost();
+  const Index nf = mesh.nfacesHost();
+
+  /// Rossby-Haurwitz-like vorticity
+  scalar_view_type zeta("zeta", nf);
+  const auto fx = mesh.physFaces.crds;
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    zeta(i) = fx(i,2) + 0.5*fx(i,0)*fx(i,1);
+  });
+
+  /// reference: single-process direct sums
+  scalar_view_type vpsi_ref("vpsi_ref", nv);
+  vec_view vu_ref("vu_ref", nv);
+  scalar_view_type fpsi_ref("fpsi_ref", nf);
+  vec_view fu_ref("fu_ref", nf);
+  ko::parallel_for(ko::TeamPolicy<>(nv, ko::AUTO()), BVEVertexSolve(vpsi_ref, vu_ref, mesh.physVerts.crds,
+    fx, zeta, mesh.faces.area, mesh.faces.mask, nf));
+  ko::parallel_for(ko::TeamPolicy<>(nf, ko::AUTO()), BVEFaceSolve(fpsi_ref, fu_ref, fx, zeta,
+    mesh.faces.area, mesh.faces.mask, nf));
+  auto vpsi_ref_h = ko::create_mirror_view(vpsi_ref);
+  auto vu_ref_h = ko::create_mirror_view(vu_ref);
+  auto fpsi_ref_h = ko::create_mirror_view(fpsi_ref);
+  auto fu_ref_h = ko::create_mirror_view(fu_ref);
+  ko::deep_copy(vpsi_ref_h, vpsi_ref);
+  ko::deep_copy(vu_ref_h, vu_ref);
+  ko::deep_copy(fpsi_ref_h, fpsi_ref);
+  ko::deep_copy(fu_ref_h, fu_ref);
+
+  MortonDecomposition decomp(MPI_COMM_WORLD);
+  decomp.init(mesh);
+  const auto owned_verts = decomp.ownedVertsHost();
+  const auto owned_faces = decomp.ownedFacesHost();
+
+  scalar_view_type vpsi("vpsi", nv);
+  vec_view vu("vu", nv);
+  scalar_view_type fpsi("fpsi", nf);
+  vec_view fu("fu", nf);
+  auto vpsi_h = ko::create_mirror_view(vpsi);
+  auto vu_h = ko::create_mirror_view(vu);
+  auto fpsi_h = ko::create_mirror_view(fpsi);
+  auto fu_h = ko::create_mirror_view(fu);
+
+  Real psi_err[3];
+  Real u_err[3];
+  for (Int t=0; t<3; ++t) {
+    DistributedTreecode treecode(MPI_COMM_WORLD, thetas[t], octree_depth);
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto t0 = tic();
+    treecode.solve(vpsi, vu, fpsi, fu, mesh, zeta, decomp);
+    const Real tc_time = toc(t0);
+    std::cout << treecode.infoString();
+
+    ko::deep_copy(vpsi_h, vpsi);
+    ko::deep_copy(vu_h, vu);
+    ko::deep_copy(fpsi_h, fpsi);
+    ko::deep_copy(fu_h, fu);
+    Real local[4] = {0, 0, 0, 0};
+    owned_diff(local[0], local[1], vpsi_ref_h, vpsi_h, owned_verts);
+    owned_diff(local[0], local[1], fpsi_ref_h, fpsi_h, owned_faces);
+    owned_diff(local[2], local[3], vu_ref_h, vu_h, owned_verts);
+    owned_diff(local[2], local[3], fu_ref_h, fu_h, owned_faces);
+    Real global[4];
+    MPI_Allreduce(local, global, 4, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    psi_err[t] = global[0]/global[1];
+    u_err[t] = global[2]/global[3];
+    if (rank == 0) {
+      std::cout << "theta = " << thetas[t] << ": rel. err. psi " << psi_err[t] << ", u " << u_err[t]
+                << ", time " << tc_time << " s\n";
+    }
+  }
+  LPM_THROW_IF(psi_err[0] > 1.0e-12 || u_err[0] > 1.0e-12, "theta = 0 should reproduce the direct sum.");
+  LPM_THROW_IF(psi_err[2] > 1.0e-2 || u_err[2] > 1.0e-2, "treecode error too large.");
+  LPM_THROW_IF(psi_err[1] > psi_err[2], "treecode stream function error should grow with theta.");
+  LPM_THROW_IF(u_err[1] > u_err[2], "treecode velocity error should grow with theta.");
+}
+MPI_Barrier(MPI_COMM_WORLD);
+int rank;
+MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+if (rank == 0) std::cout << "tests pass" << std::endl;
+ko::finalize();
+MPI_Finalize();
+return 0;
+}
@@ -0,0 +1,206 @@
+#include "LpmConfig.h"
+#include "LpmDefs.hpp"
+#include "LpmMeshSeed.hpp"
+#include "LpmPolyMesh2d.hpp"
+#include "LpmPolyMesh2dVtkInterface.hpp"
+#include "LpmPolyMesh2dVtkInterface_Impl.hpp"
+#include "LpmVtkIO.hpp"
+#include "LpmUtilities.hpp"
+
+#include "Kokkos_Core.hpp"
+#include "vtkXMLPolyDataReader.h"
+#include "vtkIdList.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+using namespace Lpm;
+
+/**
+  Writes the same mesh and fields with each VtkXmlEncoding, reports file sizes and write times,
+  and checks that every file reads back to the same points, cells, and data.
+
+  usage: lpmVtpWriterTest [-d tree_depth]
+*/
+
+struct Input {
+  Input(int argc, char* argv[]);
+
+  Int depth;
+};
+
+/// file size in bytes
+Index file_size(const std::string& fname) {
+  std::ifstream f(fname, std::ios::binary | std::ios::ate);
+  return f.tellg();
+}
+
+int main(int argc, char* argv[]) {
+ko::initialize(argc, argv);
+{
+  Input input(argc, argv);
+  typedef CubedSphereSeed seed_type;
+
+  MeshSeed<seed_type> seed;
+  Index nmaxverts, nmaxedges, nmaxfaces;
+  seed.setMaxAllocations(nmaxverts, nmaxedges, nmaxfaces, input.depth);
+  auto mesh = std::shared_ptr<PolyMesh2d<seed_type>>(new
+    PolyMesh2d<seed_type>(nmaxverts, nmaxedges, nmaxfaces));
+  mesh->treeInit(input.depth, seed);
+  mesh->updateDevice();
+
+  const Index nv = mesh->nvertsHost();
+  const Index nf = mesh->nfacesHost();
+  const auto vx = mesh->physVerts.crds;
+  const auto fx = mesh->physFaces.crds;
+  scalar_view_type vscalar("vert_scalar", nv);
+  typename SphereGeometry::vec_view_type fvec("face_vector", nf);
+  ko::parallel_for(nv, KOKKOS_LAMBDA (const Index& i) {
+    vscalar(i) = vx(i,0)*vx(i,1) + vx(i,2);
+  });
+  ko::parallel_for(nf, KOKKOS_LAMBDA (const Index& i) {
+    fvec(i,0) = -fx(i,1);
+    fvec(i,1) = fx(i,0);
+    fvec(i,2) = 0;
+  });
+
+  const std::vector<VtkXmlEncoding> encodings = {VtkXmlDefault, VtkXmlAppendedRaw, VtkXmlAppendedZlib};
+  const std::vector<std::string> names = {"default", "appended_raw", "appended_zlib"};
+
+  const Int fw = 16;
+  std::cout << "vtp writer: " << seed_type::idString() << " depth " << input.depth << ", nverts = "
+            << nv << ", nleaves = " << mesh->faces.nLeavesHost() << "\n";
+  std::cout << std::setw(fw) << "encoding" << std::setw(fw) << "build (s)" << std::setw(fw) << "write (s)"
+            << std::setw(fw) << "size (MB)" << "\n";
+
+  vtkSmartPointer<vtkPolyData> ref;
+  for (Int e=0; e<encodings.size(); ++e) {
+    const std::string fname = "vtp_writer_test_" + names[e] + ".vtp";
+    auto t0 = tic();
+    Polymesh2dVtkInterface<seed_type> vtk(mesh);
+    vtk.addScalarPointData(vscalar);
+    vtk.addVectorCellData(fvec);
+    const Real build_time = toc(t0);
+    vtk.setEncoding(encodings[e]);
+    t0 = tic();
+    vtk.write(fname);
+    const Real write_time = toc(t0);
+    std::cout << std::setw(fw) << names[e] << std::setw(fw) << build_time << std::setw(fw) << write_time
+              << std::setw(fw) << file_size(fname)/1.0e6 << "\n";
+
+    auto reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+    reader->SetFileName(fname.c_str());
+    reader->Update();
+    vtkSmartPointer<vtkPolyData> pd = reader->GetOutput();
+    LPM_THROW_IF(pd->GetNumberOfPoints() != nv, names[e] << ": point count mismatch.");
+    LPM_THROW_IF(pd->GetNumberOfCells() != mesh->faces.nLeavesHost(), names[e] << ": cell count mismatch.");
+    if (e == 0) {
+      ref = pd;
+      /// check against the mesh
+      const auto hx = mesh->physVerts.getHostCrdView();
+      for (Index i=0; i<nv; ++i) {
+        double p[3];
+        pd->GetPoint(i, p);
+        for (Short j=0; j<3; ++j) {
+          LPM_THROW_IF(p[j] != hx(i,j), "point coordinate mismatch.");
+        }
+      }
+      auto ids = vtkSmartPointer<vtkIdList>::New();
+      Index ctr = 0;
+      for (Index i=0; i<nf; ++i) {
+        if (!mesh->faces.hasKidsHost(i)) {
+          pd->GetCellPoints(ctr++, ids);
+          LPM_THROW_IF(ids->GetNumberOfIds() != seed_type::nfaceverts, "cell size mismatch.");
+          for (Short j=0; j<seed_type::nfaceverts; ++j) {
+            LPM_THROW_IF(ids->GetId(j) != mesh->faces.getVertHost(i,j), "cell connectivity mismatch.");
+          }
+        }
+      }
+    }
+    else {
+      /// binary files match the default encoding exactly
+      for (Index i=0; i<nv; ++i) {
+        double p[3], pref[3];
+        pd->GetPoint(i, p);
+        ref->GetPoint(i, pref);
+        LPM_THROW_IF(p[0] != pref[0] || p[1] != pref[1] || p[2] != pref[2], names[e] << ": point mismatch.");
+      }
+      auto ids = vtkSmartPointer<vtkIdList>::New();
+      auto ref_ids = vtkSmartPointer<vtkIdList>::New();
+      for (Index i=0; i<pd->GetNumberOfCells(); ++i) {
+        pd->GetCellPoints(i, ids);
+        ref->GetCellPoints(i, ref_ids);
+        for (Short j=0; j<seed_type::nfaceverts; ++j) {
+          LPM_THROW_IF(ids->GetId(j) != ref_ids->GetId(j), names[e] << ": cell mismatch.");
+        }
+      }
+      const std::vector<std::string> point_arrays = {"vert_scalar"};
+      for (const auto& a : point_arrays) {
+        const auto arr = pd->GetPointData()->GetArray(a.c_str());
+        const auto ref_arr = ref->GetPointData()->GetArray(a.c_str());
+        LPM_THROW_IF(!arr || !ref_arr, names[e] << ": missing point array " << a);
+        for (Index i=0; i<nv; ++i) {
+          LPM_THROW_IF(arr->GetTuple1(i) != ref_arr->GetTuple1(i), names[e] << ": " << a << " mismatch.");
+        }
+      }
+      const std::vector<std::string> cell_arrays = {"area", "face_vector"};
+      for (const auto& a : cell_arrays) {
+        const auto arr = pd->GetCellData()->GetArray(a.c_str());
+        const auto ref_arr = ref->GetCellData()->GetArray(a.c_str());
+        LPM_THROW_IF(!arr || !ref_arr, names[e] << ": missing cell array " << a);
+        const Int ncomp = arr->GetNumberOfComponents();
+        LPM_THROW_IF(ncomp != ref_arr->GetNumberOfComponents(), names[e] << ": " << a << " component mismatch.");
+        for (Index i=0; i<pd->GetNumberOfCells(); ++i) {
+          for (Int j=0; j<ncomp; ++j) {
+            LPM_THROW_IF(arr->GetComponent(i,j) != ref_arr->GetComponent(i,j),
+              names[e] << ": " << a << " mismatch.");
+          }
+        }
+      }
+    }
+  }
+
+  /// threaded cell preparation matches the serial result
+  setVtkHostThreads(1);
+  auto t0 = tic();
+  const VtkLeafCells serial_cells(mesh->faces);
+  const Real serial_time = toc(t0);
+  setVtkHostThreads(8, 64);
+  LPM_THROW_IF(vtkHostBlockCount(nf) < 2, "expected more than one block.");
+  t0 = tic();
+  const VtkLeafCells threaded_cells(mesh->faces);
+  const Real threaded_time = toc(t0);
+  std::cout << "leaf cells: serial " << serial_time << " s, " << vtkHostBlockCount(nf) << " blocks "
+            << threaded_time << " s\n";
+  LPM_THROW_IF(serial_cells.nleaves != mesh->faces.nLeavesHost() ||
+    threaded_cells.nleaves != serial_cells.nleaves, "leaf count mismatch.");
+  LPM_THROW_IF(threaded_cells.leaf_ids != serial_cells.leaf_ids, "leaf id mismatch.");
+  auto ids = vtkSmartPointer<vtkIdList>::New();
+  auto ref_ids = vtkSmartPointer<vtkIdList>::New();
+  serial_cells.cells->InitTraversal();
+  threaded_cells.cells->InitTraversal();
+  for (Index k=0; k<serial_cells.nleaves; ++k) {
+    serial_cells.cells->GetNextCell(ref_ids);
+    threaded_cells.cells->GetNextCell(ids);
+    LPM_THROW_IF(ids->GetNumberOfIds() != seed_type::nfaceverts, "threaded cell size mismatch.");
+    for (Short j=0; j<seed_type::nfaceverts; ++j) {
+      LPM_THROW_IF(ids->GetId(j) != ref_ids->GetId(j), "threaded cell connectivity mismatch.");
+    }
+  }
+}
+std::cout << "tests pass" << std::endl;
+ko::finalize();
+return 0;
+}
+
+Input::Input(int argc, char* argv[]) {
+  depth = 5;
+  for (Int i=1; i<argc; ++i) {
+    const std::string& token = argv[i];
+    if (token == "-d") {
+      depth = std::stoi(argv[++i]);
+    }
+  }
+}